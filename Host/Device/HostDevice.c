@@ -0,0 +1,182 @@
+/**
+ * @file HostDevice.c
+ * @brief Virtual time base, RCC/DWT models and plain register blocks
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "HostDevice.h"
+#include "HostI2c.h"
+#include "HostUart.h"
+#include "stm32f303x8.h"
+#include "system_stm32f3xx.h"
+#include <stdint.h>
+#include <string.h>
+
+uint32_t SystemCoreClock = HSI_VALUE;
+const uint8_t AHBPrescTable[16] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 6, 7, 8, 9 };
+const uint8_t APBPrescTable[8] = { 0, 0, 0, 0, 1, 2, 3, 4 };
+
+GPIO_TypeDef Host_GPIOA;
+FLASH_TypeDef Host_FLASH;
+DMA_Channel_TypeDef Host_DMA1_Channel7;
+CoreDebug_Type Host_CoreDebug;
+SysTick_Type Host_SysTick;
+TIM_TypeDef Host_TIM2;
+SCB_Type Host_SCB;
+SYSCFG_TypeDef Host_SYSCFG;
+
+static RCC_TypeDef host_rcc;        /**< RCC (ready flags follow their enables) */
+static DWT_Type host_dwt;           /**< DWT (CYCCNT mirrors the virtual time) */
+static uint64_t host_cycles = 0;    /**< Virtual time (core cycles) */
+
+/**
+ * @brief Let every model react to the register writes and the time elapsed
+ * @return void
+ */
+static void Host_Sync(void) {
+    // Oscillators lock and clock switches complete within one access
+    if (host_rcc.CR & RCC_CR_PLLON) {
+        host_rcc.CR |= RCC_CR_PLLRDY;
+    } else {
+        host_rcc.CR &= ~RCC_CR_PLLRDY;
+    }
+    host_rcc.CFGR = (host_rcc.CFGR & ~RCC_CFGR_SWS) | ((host_rcc.CFGR & RCC_CFGR_SW) << 2);
+    HostI2c_Sync();
+    HostUart_Sync();
+}
+
+/**
+ * @brief Reset every register model and the virtual time
+ * @return void
+ */
+void Host_Reset(void) {
+    memset(&host_rcc, 0, sizeof(host_rcc));
+    memset(&host_dwt, 0, sizeof(host_dwt));
+    memset(&Host_GPIOA, 0, sizeof(Host_GPIOA));
+    memset(&Host_FLASH, 0, sizeof(Host_FLASH));
+    memset(&Host_DMA1_Channel7, 0, sizeof(Host_DMA1_Channel7));
+    memset(&Host_CoreDebug, 0, sizeof(Host_CoreDebug));
+    memset(&Host_SysTick, 0, sizeof(Host_SysTick));
+    memset(&Host_TIM2, 0, sizeof(Host_TIM2));
+    memset(&Host_SCB, 0, sizeof(Host_SCB));
+    memset(&Host_SYSCFG, 0, sizeof(Host_SYSCFG));
+    host_cycles = 0;
+    SystemCoreClock = HSI_VALUE;
+    HostI2c_Reset();
+    HostUart_Reset();
+}
+
+/**
+ * @brief Current virtual time
+ * @return Core cycles since Host_Reset()
+ */
+uint64_t Host_Cycles(void) {
+    return host_cycles;
+}
+
+/**
+ * @brief Let virtual time pass
+ * @param cycles - Cycles to advance
+ * @return void
+ */
+void Host_Advance(uint64_t cycles) {
+    host_cycles += cycles;
+    Host_Sync();
+}
+
+/**
+ * @brief Let virtual time pass up to an absolute time
+ * @param cycle - Target time
+ * @return void
+ */
+void Host_AdvanceTo(uint64_t cycle) {
+    if (cycle > host_cycles) {
+        Host_Advance(cycle - host_cycles);
+    }
+}
+
+/**
+ * @brief Charge one register access and let the models react
+ * @return void
+ */
+void Host_Access(void) {
+    host_cycles += HOST_ACCESS_CYCLES;
+    Host_Sync();
+}
+
+/**
+ * @brief RCC accessor
+ * @return RCC register block
+ */
+RCC_TypeDef *Host_Rcc(void) {
+    Host_Access();
+    return &host_rcc;
+}
+
+/**
+ * @brief DWT accessor, CYCCNT updated to the virtual time
+ * @return DWT register block
+ */
+DWT_Type *Host_Dwt(void) {
+    Host_Access();
+    host_dwt.CYCCNT = (uint32_t)host_cycles;
+    return &host_dwt;
+}
+
+/**
+ * @brief HCLK from the modelled RCC (CMSIS SystemCoreClockUpdate)
+ * @return void
+ */
+void SystemCoreClockUpdate(void) {
+    uint32_t cfgr = host_rcc.CFGR;
+    uint32_t sysclk;
+    switch (cfgr & RCC_CFGR_SWS) {
+        case RCC_CFGR_SWS_HSE:
+            sysclk = HSE_VALUE;
+            break;
+        case RCC_CFGR_SWS_PLL: {
+            uint32_t mul = ((cfgr & RCC_CFGR_PLLMUL) >> RCC_CFGR_PLLMUL_Pos) + 2u;
+            if (mul > 16u) {
+                mul = 16u;
+            }
+            uint32_t in = (cfgr & RCC_CFGR_PLLSRC) ? HSE_VALUE / ((host_rcc.CFGR2 & RCC_CFGR2_PREDIV) + 1u)
+                                                   : HSI_VALUE / 2u;
+            sysclk = in * mul;
+            break;
+        }
+        default:
+            sysclk = HSI_VALUE;
+            break;
+    }
+    SystemCoreClock = sysclk >> AHBPrescTable[(cfgr & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos];
+}
+
+/**
+ * @brief NVIC stubs: handlers are entered by the models, not by priority
+ */
+void NVIC_EnableIRQ(IRQn_Type irq) {
+    (void)irq;
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq) {
+    (void)irq;
+}
+
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority) {
+    (void)irq;
+    (void)priority;
+}
+
+/**
+ * @brief Load SysTick (the tick itself is driven by the simulation loop)
+ * @param ticks - Cycles per tick
+ * @return 0 (success)
+ */
+uint32_t SysTick_Config(uint32_t ticks) {
+    Host_SysTick.LOAD = ticks - 1u;
+    Host_SysTick.VAL = 0;
+    Host_SysTick.CTRL = 7u;
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file HostDevice.h
+ * @brief Virtual time base and reset of the host register models
+ * @details The firmware runs unmodified on the build machine against register models
+ *          instead of the STM32F303K8. Time is virtual: a 64-bit count of core cycles that
+ *          advances by HOST_ACCESS_CYCLES on every access to a modelled peripheral (the
+ *          polling loops of the drivers therefore make progress) and by explicit
+ *          Host_Advance() calls (the tick loop of a simulation). DWT->CYCCNT is its low
+ *          32 bits.
+ *
+ * ### Rules of the Models
+ *  - A register write takes effect at the next access to any modelled peripheral, the
+ *    way the write buffer of the bus matrix delays it by a few cycles on target
+ *  - Interrupt handlers are only entered where the model says so (HostUart.h); code
+ *    that waits on an ISR-updated variable without touching a peripheral would hang
+ *  - The core clock is fixed at HOST_CORE_HZ; call clk_config() first, as main() does,
+ *    so SystemCoreClock (and every µs-to-cycles conversion in the firmware) matches it
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see HostI2c.h, HostUart.h
+ */
+
+#ifndef HOST_DEVICE_H_
+#define HOST_DEVICE_H_
+
+#include <stdint.h>
+#include "stm32f303x8.h"
+
+#define     HOST_CORE_HZ            64000000u   /**< Virtual core clock (Hz), the PLL setting of clk_config() */
+#define     HOST_ACCESS_CYCLES      4u          /**< Cycles charged per modelled register access */
+#define     HOST_US_TO_CYCLES(us)   ((uint64_t)(us) * (HOST_CORE_HZ / 1000000u))
+
+/**
+ * @brief Reset every register model and the virtual time
+ * @details RCC returns to its reset state (HSI, SystemCoreClock = HSI_VALUE); models
+ *          keep their attached targets and sinks.
+ * @return void
+ */
+void Host_Reset(void);
+
+/**
+ * @brief Current virtual time
+ * @return Core cycles since Host_Reset()
+ */
+uint64_t Host_Cycles(void);
+
+/**
+ * @brief Let virtual time pass (core idle)
+ * @param cycles - Cycles to advance
+ * @return void
+ */
+void Host_Advance(uint64_t cycles);
+
+/**
+ * @brief Let virtual time pass up to an absolute time
+ * @param cycle - Target time; nothing happens if it is already past
+ * @return void
+ */
+void Host_AdvanceTo(uint64_t cycle);
+
+/**
+ * @brief Charge one register access and let the models react (accessor macros)
+ * @return void
+ */
+void Host_Access(void);
+
+#endif /* HOST_DEVICE_H_ */
@@ -0,0 +1,146 @@
+/**
+ * @file HostDsp.c
+ * @brief Host implementation of the CMSIS-DSP subset used by the firmware
+ * @details Scalar versions of the CMSIS-DSP reference algorithms: same state layout,
+ *          same coefficient conventions and the same operation order per sample.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "arm_math.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Initialize a direct form II transposed biquad cascade
+ * @param S - [out] Instance
+ * @param numStages - Number of 2nd order stages
+ * @param pCoeffs - [in] 5 coefficients per stage
+ * @param pState - [out] 2 × numStages state values, cleared
+ * @return void
+ */
+void arm_biquad_cascade_df2T_init_f32(arm_biquad_cascade_df2T_instance_f32 *S, uint8_t numStages,
+                                      const float32_t *pCoeffs, float32_t *pState) {
+    S->numStages = numStages;
+    S->pCoeffs = pCoeffs;
+    memset(pState, 0, 2u * numStages * sizeof(float32_t));
+    S->pState = pState;
+}
+
+/**
+ * @brief Run a direct form II transposed biquad cascade (in place allowed)
+ * @param S - [in,out] Instance
+ * @param pSrc - [in] Input block
+ * @param pDst - [out] Output block
+ * @param blockSize - Samples in the block
+ * @return void
+ */
+void arm_biquad_cascade_df2T_f32(const arm_biquad_cascade_df2T_instance_f32 *S, const float32_t *pSrc,
+                                 float32_t *pDst, uint32_t blockSize) {
+    const float32_t *coeffs = S->pCoeffs;
+    float32_t *state = S->pState;
+    const float32_t *in = pSrc;
+
+    for (uint8_t stage = 0; stage < S->numStages; stage++) {
+        float32_t b0 = coeffs[0], b1 = coeffs[1], b2 = coeffs[2], a1 = coeffs[3], a2 = coeffs[4];
+        float32_t d1 = state[0], d2 = state[1];
+        for (uint32_t i = 0; i < blockSize; i++) {
+            float32_t x = in[i];
+            float32_t y = b0 * x + d1;
+            d1 = b1 * x + a1 * y + d2;
+            d2 = b2 * x + a2 * y;
+            pDst[i] = y;
+        }
+        state[0] = d1;
+        state[1] = d2;
+        coeffs += 5;
+        state += 2;
+        in = pDst;  // Later stages filter the previous stage's output
+    }
+}
+
+/**
+ * @brief Initialize a normalized LMS filter
+ * @param S - [out] Instance
+ * @param numTaps - Number of coefficients
+ * @param pCoeffs - [in] Initial coefficients (time reversed)
+ * @param pState - [out] numTaps + blockSize - 1 state values, cleared
+ * @param mu - Step size
+ * @param blockSize - Largest block passed to arm_lms_norm_f32()
+ * @return void
+ */
+void arm_lms_norm_init_f32(arm_lms_norm_instance_f32 *S, uint16_t numTaps, float32_t *pCoeffs,
+                           float32_t *pState, float32_t mu, uint32_t blockSize) {
+    S->numTaps = numTaps;
+    S->pCoeffs = pCoeffs;
+    memset(pState, 0, (numTaps + blockSize - 1u) * sizeof(float32_t));
+    S->pState = pState;
+    S->mu = mu;
+    S->recipTable = NULL;
+    S->energy = 0.0f;
+    S->x0 = 0.0f;
+}
+
+/**
+ * @brief Run a normalized LMS filter over a block
+ * @details Per sample: output = coefficients · input window, error = reference - output,
+ *          coefficients += mu · error / (window energy + eps) · input window.
+ * @param S - [in,out] Instance
+ * @param pSrc - [in] Input block
+ * @param pRef - [in] Reference (desired) block
+ * @param pOut - [out] Filter output
+ * @param pErr - [out] Error (reference - output)
+ * @param blockSize - Samples in the block
+ * @return void
+ */
+void arm_lms_norm_f32(arm_lms_norm_instance_f32 *S, const float32_t *pSrc, float32_t *pRef,
+                      float32_t *pOut, float32_t *pErr, uint32_t blockSize) {
+    float32_t *state = S->pState;
+    float32_t *coeffs = S->pCoeffs;
+    uint32_t taps = S->numTaps;
+    float32_t *cur = &state[taps - 1u];
+    float32_t energy = S->energy;
+    float32_t x0 = S->x0;
+
+    for (uint32_t n = 0; n < blockSize; n++) {
+        float32_t in = pSrc[n];
+        *cur++ = in;
+        energy -= x0 * x0;
+        energy += in * in;
+        float32_t acc = 0.0f;
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += state[k] * coeffs[k];
+        }
+        pOut[n] = acc;
+        float32_t e = pRef[n] - acc;
+        pErr[n] = e;
+        float32_t w = (e * S->mu) / (energy + 0.000000119209289f);
+        for (uint32_t k = 0; k < taps; k++) {
+            coeffs[k] += w * state[k];
+        }
+        x0 = *state;
+        state++;
+    }
+    S->energy = energy;
+    S->x0 = x0;
+    // Keep the newest taps - 1 inputs at the start of the state buffer
+    memmove(S->pState, state, (taps - 1u) * sizeof(float32_t));
+}
+
+/**
+ * @brief Square root
+ * @param in - Input value
+ * @param pOut - [out] Square root, 0 for negative input
+ * @return ARM_MATH_SUCCESS, or ARM_MATH_ARGUMENT_ERROR for negative input
+ */
+arm_status arm_sqrt_f32(float32_t in, float32_t *pOut) {
+    if (in >= 0.0f) {
+        *pOut = sqrtf(in);
+        return ARM_MATH_SUCCESS;
+    }
+    *pOut = 0.0f;
+    return ARM_MATH_ARGUMENT_ERROR;
+}
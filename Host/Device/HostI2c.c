@@ -0,0 +1,445 @@
+/**
+ * @file HostI2c.c
+ * @brief Host model of I2C1 and its PB6/PB7 bus pins
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "HostI2c.h"
+#include "HostDevice.h"
+#include "stm32f303x8.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define HOSTI2C_ISR_ERRORS  (I2C_ISR_NACKF | I2C_ISR_STOPF | I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_OVR)
+#define HOSTI2C_MODE(gpio, pin) (((gpio).MODER >> (2u * (pin))) & 3u)
+#define HOSTI2C_MODE_OUTPUT     1u
+#define HOSTI2C_MODE_AF         2u
+
+/** @brief Transfer state of the master */
+typedef enum {
+    HOSTI2C_IDLE = 0,   /**< No transfer, bus free */
+    HOSTI2C_ADDR,       /**< START + address byte on the wire */
+    HOSTI2C_TX_WAIT,    /**< TXIS set, waiting for TXDR */
+    HOSTI2C_TX_BYTE,    /**< Data byte on the wire (write) */
+    HOSTI2C_RX_BYTE,    /**< Data byte on the wire (read) */
+    HOSTI2C_RX_WAIT,    /**< RXNE set, waiting for the RXDR read */
+    HOSTI2C_HOLD,       /**< TC set, SCL held low until a repeated START */
+    HOSTI2C_STOP,       /**< STOP on the wire */
+    HOSTI2C_STALLED,    /**< No progress (SDA held low, SCL stretched, arbitration lost) until PE reset */
+} HostI2c_Phase;
+
+static struct {
+    I2C_TypeDef regs;               /**< I2C1 registers */
+    GPIO_TypeDef gpio;              /**< GPIOB registers */
+    uint32_t cr1;                   /**< CR1 at the previous sync (PE edges) */
+    uint32_t odr;                   /**< ODR at the previous sync (pin edges) */
+    HostI2c_Phase phase;            /**< Transfer state */
+    uint64_t due;                   /**< Time the byte/condition on the wire completes */
+    uint64_t busy_since;            /**< Time BUSY was set */
+    uint8_t addr;                   /**< Address of the transfer (8-bit form) */
+    uint8_t read;                   /**< RD_WRN of the transfer */
+    uint8_t nbytes;                 /**< NBYTES of the transfer */
+    uint8_t count;                  /**< Data bytes done */
+    uint8_t autoend;                /**< AUTOEND of the transfer */
+    uint8_t data;                   /**< Byte being transmitted */
+    uint8_t xfer_byte;              /**< Bytes since the START from idle (fault position) */
+    uint32_t accesses;              /**< I2C1 register accesses */
+    uint32_t rx_shown;              /**< Access that first saw RXNE (0 = not yet) */
+    HostI2c_Fault fault;            /**< Armed fault */
+    uint8_t fault_byte;             /**< Byte the armed fault hits */
+    uint8_t sda_hold;               /**< SCL pulses before the target releases SDA (0 = released) */
+    uint8_t scl_hold;               /**< Target stretching SCL */
+    const HostI2c_Target *target;   /**< Devices on the bus */
+    void *ctx;                      /**< Target context */
+    HostI2c_Stats stats;            /**< Activity counters */
+} m;
+
+/**
+ * @brief One SCL period from TIMINGR
+ * @return Period in core cycles
+ */
+static uint64_t HostI2c_SclCycles(void) {
+    uint32_t t = m.regs.TIMINGR;
+    uint32_t presc = (t >> I2C_TIMINGR_PRESC_Pos) & 0xFu;
+    uint32_t high = (t >> I2C_TIMINGR_SCLH_Pos) & 0xFFu;
+    uint32_t low = (t >> I2C_TIMINGR_SCLL_Pos) & 0xFFu;
+    return (uint64_t)(low + 1u + high + 1u) * (presc + 1u) + HOSTI2C_EDGE_CYCLES;
+}
+
+/**
+ * @brief Take the armed fault if it hits the byte now completing
+ * @return Fault, or HOSTI2C_FAULT_NONE
+ */
+static HostI2c_Fault HostI2c_FaultNow(void) {
+    HostI2c_Fault f = HOSTI2C_FAULT_NONE;
+    if (m.fault != HOSTI2C_FAULT_NONE && m.xfer_byte == m.fault_byte) {
+        f = m.fault;
+        m.fault = HOSTI2C_FAULT_NONE;
+    }
+    return f;
+}
+
+/**
+ * @brief Apply a fault that stops the transfer
+ * @param f - Fault
+ * @return 1 if the transfer is stalled by the fault
+ */
+static uint8_t HostI2c_Stall(HostI2c_Fault f) {
+    switch (f) {
+        case HOSTI2C_FAULT_BERR:
+            m.regs.ISR |= I2C_ISR_BERR;
+            break;
+        case HOSTI2C_FAULT_ARLO:
+            m.regs.ISR |= I2C_ISR_ARLO;
+            break;
+        case HOSTI2C_FAULT_STRETCH:
+            m.scl_hold = 1;
+            break;
+        default:
+            return 0;
+    }
+    m.phase = HOSTI2C_STALLED;
+    return 1;
+}
+
+/**
+ * @brief Put a STOP on the wire
+ * @param t - Time the previous byte completed
+ * @return void
+ */
+static void HostI2c_Stop(uint64_t t) {
+    m.phase = HOSTI2C_STOP;
+    m.due = t + HostI2c_SclCycles();
+}
+
+/**
+ * @brief Last data byte done: STOP (AUTOEND) or TC
+ * @param t - Time the byte completed
+ * @return void
+ */
+static void HostI2c_End(uint64_t t) {
+    if (m.autoend) {
+        HostI2c_Stop(t);
+    } else {
+        m.regs.ISR |= I2C_ISR_TC;
+        m.phase = HOSTI2C_HOLD;
+    }
+}
+
+/**
+ * @brief Bus released: account the busy time
+ * @param t - Time of release
+ * @return void
+ */
+static void HostI2c_Release(uint64_t t) {
+    if (m.regs.ISR & I2C_ISR_BUSY) {
+        m.stats.busy_cycles += t - m.busy_since;
+    }
+    m.regs.ISR &= ~I2C_ISR_BUSY;
+}
+
+/**
+ * @brief Complete the byte or condition on the wire at time m.due
+ * @return void
+ */
+static void HostI2c_Step(void) {
+    uint64_t t = m.due;
+    HostI2c_Fault f;
+    uint8_t ack;
+
+    switch (m.phase) {
+        case HOSTI2C_ADDR:
+            f = HostI2c_FaultNow();
+            if (HostI2c_Stall(f)) {
+                return;
+            }
+            ack = (f != HOSTI2C_FAULT_NACK && m.target) ? m.target->start(m.ctx, m.addr, m.read) : 0;
+            m.stats.bytes++;
+            m.xfer_byte++;
+            if (!ack) {
+                m.regs.ISR |= I2C_ISR_NACKF;
+                HostI2c_Stop(t);
+            } else if (m.nbytes == 0) {
+                HostI2c_End(t);
+            } else if (m.read) {
+                m.phase = HOSTI2C_RX_BYTE;
+                m.due = t + 9u * HostI2c_SclCycles();
+            } else {
+                m.regs.ISR |= I2C_ISR_TXIS;
+                m.phase = HOSTI2C_TX_WAIT;
+            }
+            break;
+        case HOSTI2C_TX_BYTE:
+            f = HostI2c_FaultNow();
+            if (HostI2c_Stall(f)) {
+                return;
+            }
+            ack = (f != HOSTI2C_FAULT_NACK) ? m.target->write(m.ctx, m.data) : 0;
+            m.stats.bytes++;
+            m.xfer_byte++;
+            m.count++;
+            if (!ack) {
+                m.regs.ISR |= I2C_ISR_NACKF;
+                HostI2c_Stop(t);
+            } else if (m.count < m.nbytes) {
+                m.regs.ISR |= I2C_ISR_TXIS;
+                m.phase = HOSTI2C_TX_WAIT;
+            } else {
+                HostI2c_End(t);
+            }
+            break;
+        case HOSTI2C_RX_BYTE:
+            if (HostI2c_Stall(HostI2c_FaultNow())) {
+                return;
+            }
+            m.regs.RXDR = m.target->read(m.ctx);
+            m.regs.ISR |= I2C_ISR_RXNE;
+            m.stats.bytes++;
+            m.xfer_byte++;
+            m.count++;
+            m.rx_shown = 0;
+            m.phase = HOSTI2C_RX_WAIT;
+            break;
+        case HOSTI2C_STOP:
+            m.regs.ISR |= I2C_ISR_STOPF;
+            HostI2c_Release(t);
+            m.stats.stops++;
+            m.phase = HOSTI2C_IDLE;
+            if (m.target) {
+                m.target->stop(m.ctx);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Start (or repeat-start) the transfer programmed in CR2
+ * @param now - Current time
+ * @return void
+ */
+static void HostI2c_Start(uint64_t now) {
+    uint32_t cr2 = m.regs.CR2;
+    if (m.phase != HOSTI2C_IDLE && m.phase != HOSTI2C_HOLD) {
+        return;
+    }
+    if (m.sda_hold || m.scl_hold) {
+        // No START condition can be generated on a held bus
+        m.phase = HOSTI2C_STALLED;
+        return;
+    }
+    if (m.phase == HOSTI2C_IDLE) {
+        m.xfer_byte = 0;
+        m.busy_since = now;
+    }
+    m.addr = (uint8_t)(cr2 & 0xFEu);
+    m.read = (cr2 & I2C_CR2_RD_WRN) ? 1u : 0u;
+    m.nbytes = (uint8_t)((cr2 & I2C_CR2_NBYTES) >> I2C_CR2_NBYTES_Pos);
+    m.autoend = (cr2 & I2C_CR2_AUTOEND) ? 1u : 0u;
+    m.count = 0;
+    m.regs.ISR &= ~I2C_ISR_TC;
+    m.regs.ISR |= I2C_ISR_BUSY;
+    m.stats.starts++;
+    m.phase = HOSTI2C_ADDR;
+    m.due = now + 10u * HostI2c_SclCycles();
+}
+
+/**
+ * @brief Software reset (PE cleared): state machine and flags back to reset values
+ * @return void
+ */
+static void HostI2c_Abort(void) {
+    if (m.phase != HOSTI2C_IDLE && m.target) {
+        m.target->stop(m.ctx);
+    }
+    HostI2c_Release(Host_Cycles());
+    m.regs.ISR = I2C_ISR_TXE;
+    m.regs.TXDR = HOSTI2C_TXDR_EMPTY;
+    m.phase = HOSTI2C_IDLE;
+    m.scl_hold = 0;     // A stretching target gives up once the master lets go
+    m.rx_shown = 0;
+    m.stats.pe_resets++;
+}
+
+/**
+ * @brief Apply BSRR/BRR writes to ODR, watch the driven edges and update IDR
+ * @return void
+ */
+static void HostI2c_GpioSync(void) {
+    uint32_t odr = m.gpio.ODR;
+    const uint32_t scl = 1u << HOSTI2C_PIN_SCL;
+    const uint32_t sda = 1u << HOSTI2C_PIN_SDA;
+
+    if (m.gpio.BSRR) {
+        odr |= m.gpio.BSRR & 0xFFFFu;
+        odr &= ~(m.gpio.BSRR >> 16);
+        m.gpio.BSRR = 0;
+    }
+    if (m.gpio.BRR) {
+        odr &= ~(m.gpio.BRR & 0xFFFFu);
+        m.gpio.BRR = 0;
+    }
+    uint8_t scl_out = HOSTI2C_MODE(m.gpio, HOSTI2C_PIN_SCL) == HOSTI2C_MODE_OUTPUT;
+    uint8_t sda_out = HOSTI2C_MODE(m.gpio, HOSTI2C_PIN_SDA) == HOSTI2C_MODE_OUTPUT;
+    if (scl_out && !(m.odr & scl) && (odr & scl) && !m.scl_hold) {
+        m.stats.scl_pulses++;
+        if (m.sda_hold > 0) {
+            m.sda_hold--;   // The target shifts out one more bit and lets SDA go after the last
+        }
+    }
+    if (sda_out && !(m.odr & sda) && (odr & sda) && (odr & scl) && !m.sda_hold) {
+        m.stats.gpio_stops++;
+    }
+    m.odr = odr;
+    m.gpio.ODR = odr;
+
+    uint32_t idr = 0;
+    if (!m.scl_hold && (!scl_out || (odr & scl))) {
+        idr |= scl;
+    }
+    if (!m.sda_hold && (!sda_out || (odr & sda))) {
+        idr |= sda;
+    }
+    m.gpio.IDR = idr;
+}
+
+/**
+ * @brief React to register writes and elapsed time
+ * @return void
+ */
+void HostI2c_Sync(void) {
+    uint64_t now = Host_Cycles();
+
+    HostI2c_GpioSync();
+    if ((m.cr1 & I2C_CR1_PE) && !(m.regs.CR1 & I2C_CR1_PE)) {
+        HostI2c_Abort();
+    }
+    m.cr1 = m.regs.CR1;
+    if (m.regs.ICR) {
+        m.regs.ISR &= ~(m.regs.ICR & HOSTI2C_ISR_ERRORS);
+        m.regs.ICR = 0;
+    }
+    if (!(m.regs.CR1 & I2C_CR1_PE)) {
+        m.regs.CR2 &= ~I2C_CR2_START;
+        m.regs.TXDR = HOSTI2C_TXDR_EMPTY;
+        return;
+    }
+    if (m.regs.CR2 & I2C_CR2_START) {
+        m.regs.CR2 &= ~I2C_CR2_START;
+        HostI2c_Start(now);
+    }
+    if (m.regs.TXDR != HOSTI2C_TXDR_EMPTY) {
+        uint8_t data = (uint8_t)m.regs.TXDR;
+        m.regs.TXDR = HOSTI2C_TXDR_EMPTY;
+        if (m.phase == HOSTI2C_TX_WAIT) {
+            m.data = data;
+            m.regs.ISR &= ~I2C_ISR_TXIS;
+            m.phase = HOSTI2C_TX_BYTE;
+            m.due = now + 9u * HostI2c_SclCycles();
+        }
+    }
+    if (m.phase == HOSTI2C_RX_WAIT && m.rx_shown && m.accesses >= m.rx_shown + 2u) {
+        // RXDR was read: next byte, or the end of the transfer
+        m.regs.ISR &= ~I2C_ISR_RXNE;
+        m.rx_shown = 0;
+        if (m.count < m.nbytes) {
+            m.phase = HOSTI2C_RX_BYTE;
+            m.due = now + 9u * HostI2c_SclCycles();
+        } else {
+            HostI2c_End(now);
+        }
+    }
+    while ((m.phase == HOSTI2C_ADDR || m.phase == HOSTI2C_TX_BYTE || m.phase == HOSTI2C_RX_BYTE ||
+            m.phase == HOSTI2C_STOP) && m.due <= now) {
+        HostI2c_Step();
+    }
+}
+
+/**
+ * @brief I2C1 accessor
+ * @return I2C1 register block
+ */
+I2C_TypeDef *HostI2c_Regs(void) {
+    m.accesses++;
+    Host_Access();
+    if (m.phase == HOSTI2C_RX_WAIT && !m.rx_shown) {
+        m.rx_shown = m.accesses;
+    }
+    return &m.regs;
+}
+
+/**
+ * @brief GPIOB accessor, IDR updated to the line levels
+ * @return GPIOB register block
+ */
+GPIO_TypeDef *HostI2c_Gpio(void) {
+    Host_Access();
+    return &m.gpio;
+}
+
+/**
+ * @brief Connect the devices on the bus
+ * @param target - [in] Target callbacks (NULL: nothing answers)
+ * @param ctx - Context passed to the callbacks
+ * @return void
+ */
+void HostI2c_SetTarget(const HostI2c_Target *target, void *ctx) {
+    m.target = target;
+    m.ctx = ctx;
+}
+
+/**
+ * @brief Arm a one-shot fault
+ * @param fault - Fault type
+ * @param byte - Byte of the next transfer it hits
+ * @param param - SCL pulses needed to free SDA (HOSTI2C_FAULT_SDA_STUCK)
+ * @return void
+ */
+void HostI2c_InjectFault(HostI2c_Fault fault, uint8_t byte, uint8_t param) {
+    if (fault == HOSTI2C_FAULT_SDA_STUCK) {
+        m.sda_hold = param ? param : 1u;
+        HostI2c_GpioSync();
+        return;
+    }
+    m.fault = fault;
+    m.fault_byte = byte;
+}
+
+/**
+ * @brief Bus activity counters
+ * @return Counters since Host_Reset()
+ */
+const HostI2c_Stats *HostI2c_GetStats(void) {
+    return &m.stats;
+}
+
+/**
+ * @brief Check that bus and peripheral are back in their idle state
+ * @return 1 if idle
+ */
+uint8_t HostI2c_BusIdle(void) {
+    const uint32_t lines = (1u << HOSTI2C_PIN_SCL) | (1u << HOSTI2C_PIN_SDA);
+    return (m.regs.CR1 & I2C_CR1_PE) && !(m.regs.ISR & I2C_ISR_BUSY) && m.phase == HOSTI2C_IDLE &&
+           (m.gpio.IDR & lines) == lines &&
+           HOSTI2C_MODE(m.gpio, HOSTI2C_PIN_SCL) == HOSTI2C_MODE_AF &&
+           HOSTI2C_MODE(m.gpio, HOSTI2C_PIN_SDA) == HOSTI2C_MODE_AF;
+}
+
+/**
+ * @brief Reset the model; the target stays connected
+ * @return void
+ */
+void HostI2c_Reset(void) {
+    const HostI2c_Target *target = m.target;
+    void *ctx = m.ctx;
+    memset(&m, 0, sizeof(m));
+    m.target = target;
+    m.ctx = ctx;
+    m.regs.ISR = I2C_ISR_TXE;
+    m.regs.TXDR = HOSTI2C_TXDR_EMPTY;
+    m.gpio.IDR = (1u << HOSTI2C_PIN_SCL) | (1u << HOSTI2C_PIN_SDA);
+}
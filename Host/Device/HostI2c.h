@@ -0,0 +1,124 @@
+/**
+ * @file HostI2c.h
+ * @brief Host model of I2C1 and its PB6/PB7 bus pins, with fault injection
+ * @details Register-level model of the STM32F3 I2C master as the driver uses it
+ *          (CR2-started transfers with NBYTES/AUTOEND, TXIS/RXNE/TC/STOPF handshakes,
+ *          NACKF/BERR/ARLO errors, PE software reset) and of the two GPIOB pins the
+ *          driver bit-bangs during a bus clear.
+ *
+ * ### Timing
+ *  - One SCL period follows TIMINGR: (SCLL + 1 + SCLH + 1) × (PRESC + 1) kernel clocks
+ *    plus the rise/fall time; a byte is 9 periods, START and STOP one period each
+ *  - The kernel clock is the core clock (RCC_CFGR3_I2C1SW = SYSCLK, as I2C1_Config sets)
+ *
+ * ### Register Protocol
+ *  - TXDR reads as HOSTI2C_TXDR_EMPTY until written; a write starts the byte on the wire
+ *  - RXDR is considered read at the second I2C1 access after RXNE was first visible
+ *    (the ISR poll that saw it, then the RXDR read), which is how the driver's loop
+ *    accesses it
+ *  - A non-zero ICR clears the matching ISR flags and reads back as 0
+ *
+ * ### Bus Target
+ *  - All addresses are routed to one HostI2c_Target (the simulator puts the mux and the
+ *    sensors behind it); without a target every address is NACKed
+ *
+ * ### Faults
+ *  - HostI2c_InjectFault() arms one fault for a byte of the next transfer (START to
+ *    STOP, address bytes included, byte 0 = first address byte)
+ *  - HOSTI2C_FAULT_SDA_STUCK starts at once: the target holds SDA low, so no START can
+ *    be generated, until the given number of SCL pulses has been clocked as GPIO
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see HostDevice.h, I2C1_Recover
+ */
+
+#ifndef HOST_I2C_H_
+#define HOST_I2C_H_
+
+#include <stdint.h>
+
+#define     HOSTI2C_TXDR_EMPTY      0xFFFFFFFFu /**< TXDR value while no byte is pending */
+#define     HOSTI2C_EDGE_CYCLES     24u         /**< Rise + fall time per SCL period (≈ 375 ns at 64 MHz) */
+#define     HOSTI2C_PIN_SCL         6           /**< PB6 */
+#define     HOSTI2C_PIN_SDA         7           /**< PB7 */
+
+/**
+ * @struct HostI2c_Target
+ * @brief Devices on the bus, seen byte by byte
+ */
+typedef struct {
+    uint8_t (*start)(void *ctx, uint8_t addr, uint8_t read);   /**< Address byte (8-bit form); returns 1 for ACK */
+    uint8_t (*write)(void *ctx, uint8_t data);                 /**< Byte written by the master; returns 1 for ACK */
+    uint8_t (*read)(void *ctx);                                /**< Byte read by the master */
+    void    (*stop)(void *ctx);                                /**< STOP condition or master reset */
+} HostI2c_Target;
+
+/** @brief Injectable bus faults */
+typedef enum {
+    HOSTI2C_FAULT_NONE = 0,
+    HOSTI2C_FAULT_NACK,         /**< Byte not acknowledged (address or written byte) */
+    HOSTI2C_FAULT_BERR,         /**< Misplaced START/STOP during the byte */
+    HOSTI2C_FAULT_ARLO,         /**< Arbitration lost during the byte; the other master keeps the bus busy */
+    HOSTI2C_FAULT_STRETCH,      /**< Target stretches SCL from this byte on until the master resets */
+    HOSTI2C_FAULT_SDA_STUCK     /**< Target holds SDA low until param SCL pulses are clocked */
+} HostI2c_Fault;
+
+/**
+ * @struct HostI2c_Stats
+ * @brief Bus activity since Host_Reset()
+ */
+typedef struct {
+    uint32_t starts;        /**< START conditions, repeated STARTs included */
+    uint32_t bytes;         /**< Bytes on the wire, address bytes included */
+    uint32_t stops;         /**< STOP conditions generated by the peripheral */
+    uint32_t pe_resets;     /**< PE 1 → 0 transitions (software resets) */
+    uint32_t scl_pulses;    /**< SCL rising edges driven as GPIO */
+    uint32_t gpio_stops;    /**< STOP conditions driven as GPIO (SDA rising while SCL high) */
+    uint64_t busy_cycles;   /**< Cycles with the bus busy (START to STOP) */
+} HostI2c_Stats;
+
+/**
+ * @brief Connect the devices on the bus
+ * @param target - [in] Target callbacks (NULL: nothing answers)
+ * @param ctx - Context passed to the callbacks
+ * @return void
+ */
+void HostI2c_SetTarget(const HostI2c_Target *target, void *ctx);
+
+/**
+ * @brief Arm a one-shot fault
+ * @param fault - Fault type
+ * @param byte - Byte of the next transfer it hits (0 = first address byte; ignored for SDA_STUCK)
+ * @param param - SCL pulses needed to free SDA (HOSTI2C_FAULT_SDA_STUCK), unused otherwise
+ * @return void
+ */
+void HostI2c_InjectFault(HostI2c_Fault fault, uint8_t byte, uint8_t param);
+
+/**
+ * @brief Bus activity counters
+ * @return Counters since Host_Reset()
+ */
+const HostI2c_Stats *HostI2c_GetStats(void);
+
+/**
+ * @brief Check that bus and peripheral are back in their idle state
+ * @details PE set, BUSY clear, no transfer in progress, SCL and SDA high and both pins
+ *          in alternate-function mode.
+ * @return 1 if idle
+ */
+uint8_t HostI2c_BusIdle(void);
+
+/**
+ * @brief Reset the model (registers, pins, faults, counters); the target stays connected
+ * @return void
+ */
+void HostI2c_Reset(void);
+
+/**
+ * @brief React to register writes and elapsed time (called on every modelled access)
+ * @return void
+ */
+void HostI2c_Sync(void);
+
+#endif /* HOST_I2C_H_ */
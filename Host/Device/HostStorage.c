@@ -0,0 +1,166 @@
+/**
+ * @file HostStorage.c
+ * @brief File-backed Storage_Backend implementation
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "HostStorage.h"
+#include "Storage.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static FILE *hs_file = NULL;
+static uint32_t hs_erases[HOSTSTORAGE_MAX_PAGES];  /**< Erase cycles per page */
+static Storage_Backend hs_backend;
+
+/**
+ * @brief Check that a byte range lies inside the medium
+ * @param offset - Byte offset
+ * @param len - Number of bytes
+ * @return 1 if valid
+ */
+static uint8_t HostStorage_InRange(uint32_t offset, uint16_t len) {
+    return hs_file != NULL && offset + len <= hs_backend.page_size * hs_backend.num_pages;
+}
+
+/**
+ * @brief Erase one page
+ * @param page - Page index
+ * @return Storage_Status
+ */
+static Storage_Status HostStorage_Erase(uint16_t page) {
+    uint8_t ff[256];
+    if (hs_file == NULL || page >= hs_backend.num_pages) {
+        return STORAGE_ERR_RANGE;
+    }
+    memset(ff, 0xFF, sizeof(ff));
+    if (fseek(hs_file, (long)page * (long)hs_backend.page_size, SEEK_SET) != 0) {
+        return STORAGE_ERR_ERASE;
+    }
+    for (uint32_t done = 0; done < hs_backend.page_size; done += sizeof(ff)) {
+        uint32_t n = hs_backend.page_size - done;
+        n = (n < sizeof(ff)) ? n : (uint32_t)sizeof(ff);
+        if (fwrite(ff, 1, n, hs_file) != n) {
+            return STORAGE_ERR_ERASE;
+        }
+    }
+    fflush(hs_file);
+    hs_erases[page]++;
+    return STORAGE_OK;
+}
+
+/**
+ * @brief Read bytes
+ * @param offset - Byte offset
+ * @param data - [out] Destination
+ * @param len - Number of bytes
+ * @return Storage_Status
+ */
+static Storage_Status HostStorage_Read(uint32_t offset, uint8_t *data, uint16_t len) {
+    if (!HostStorage_InRange(offset, len)) {
+        return STORAGE_ERR_RANGE;
+    }
+    if (fseek(hs_file, (long)offset, SEEK_SET) != 0 || fread(data, 1, len, hs_file) != len) {
+        return STORAGE_ERR_RANGE;
+    }
+    return STORAGE_OK;
+}
+
+/**
+ * @brief Program bytes (bits only clear)
+ * @param offset - Byte offset (even)
+ * @param data - [in] Bytes to program
+ * @param len - Number of bytes (even)
+ * @return Storage_Status
+ */
+static Storage_Status HostStorage_Program(uint32_t offset, const uint8_t *data, uint16_t len) {
+    uint8_t cur[256];
+    if ((offset | len) & 1u || !HostStorage_InRange(offset, len)) {
+        return STORAGE_ERR_RANGE;
+    }
+    Storage_Status status = STORAGE_OK;
+    for (uint16_t done = 0; done < len; ) {
+        uint16_t n = (uint16_t)(len - done);
+        n = (n < sizeof(cur)) ? n : (uint16_t)sizeof(cur);
+        if (HostStorage_Read(offset + done, cur, n) != STORAGE_OK) {
+            return STORAGE_ERR_PROGRAM;
+        }
+        for (uint16_t i = 0; i < n; i++) {
+            cur[i] &= data[done + i];
+            if (cur[i] != data[done + i]) {
+                status = STORAGE_ERR_PROGRAM;
+            }
+        }
+        if (fseek(hs_file, (long)(offset + done), SEEK_SET) != 0 || fwrite(cur, 1, n, hs_file) != n) {
+            return STORAGE_ERR_PROGRAM;
+        }
+        done = (uint16_t)(done + n);
+    }
+    fflush(hs_file);
+    return status;
+}
+
+/**
+ * @brief Open (or create) the backing file
+ * @param path - [in] File path
+ * @param page_size - Erase unit in bytes
+ * @param num_pages - Number of pages
+ * @return Backend, or NULL
+ */
+const Storage_Backend *HostStorage_Open(const char *path, uint32_t page_size, uint16_t num_pages) {
+    if (num_pages > HOSTSTORAGE_MAX_PAGES || (page_size & 1u)) {
+        return NULL;
+    }
+    HostStorage_Close();
+    hs_backend.page_size = page_size;
+    hs_backend.num_pages = num_pages;
+    hs_backend.erase = HostStorage_Erase;
+    hs_backend.program = HostStorage_Program;
+    hs_backend.read = HostStorage_Read;
+
+    hs_file = fopen(path, "r+b");
+    long size = -1;
+    if (hs_file != NULL && fseek(hs_file, 0, SEEK_END) == 0) {
+        size = ftell(hs_file);
+    }
+    if (size != (long)page_size * num_pages) {
+        // New medium: create it erased
+        if (hs_file != NULL) {
+            fclose(hs_file);
+        }
+        hs_file = fopen(path, "w+b");
+        if (hs_file == NULL) {
+            return NULL;
+        }
+        memset(hs_erases, 0, sizeof(hs_erases));
+        for (uint16_t p = 0; p < num_pages; p++) {
+            HostStorage_Erase(p);
+        }
+        memset(hs_erases, 0, sizeof(hs_erases));
+    }
+    return &hs_backend;
+}
+
+/**
+ * @brief Close the backing file
+ * @return void
+ */
+void HostStorage_Close(void) {
+    if (hs_file != NULL) {
+        fclose(hs_file);
+        hs_file = NULL;
+    }
+}
+
+/**
+ * @brief Erase cycles of a page
+ * @param page - Page index
+ * @return Erase count
+ */
+uint32_t HostStorage_GetEraseCount(uint16_t page) {
+    return (page < HOSTSTORAGE_MAX_PAGES) ? hs_erases[page] : 0;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file HostStorage.h
+ * @brief File-backed Storage_Backend for the session recorder on a host
+ * @details Keeps num_pages × page_size bytes in a regular file, so a log survives a
+ *          simulated reboot (HostStorage_Close() followed by HostStorage_Open() on the
+ *          same path) exactly as the flash log survives a power cycle.
+ *
+ * ### Medium Model
+ *  - A new or wrongly sized file is created fully erased (0xFF)
+ *  - Erase sets one page to 0xFF and counts the erase cycle of that page
+ *  - Program ANDs the data into the medium (bits only clear), in even-length chunks at
+ *    even offsets; a result that differs from the data (programming over non-erased
+ *    bits) returns STORAGE_ERR_PROGRAM, as the flash read-back verify does
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Storage_Backend, Flash_Backend
+ */
+
+#ifndef HOST_STORAGE_H_
+#define HOST_STORAGE_H_
+
+#include <stdint.h>
+#include "Storage.h"
+
+#define     HOSTSTORAGE_MAX_PAGES   64u     /**< Pages with an erase counter */
+
+/**
+ * @brief Open (or create) the backing file
+ * @param path - [in] File path
+ * @param page_size - Erase unit in bytes (even)
+ * @param num_pages - Number of pages (up to HOSTSTORAGE_MAX_PAGES)
+ * @return Backend on the file, or NULL if it cannot be opened
+ */
+const Storage_Backend *HostStorage_Open(const char *path, uint32_t page_size, uint16_t num_pages);
+
+/**
+ * @brief Close the backing file (the contents stay on disk)
+ * @return void
+ */
+void HostStorage_Close(void);
+
+/**
+ * @brief Erase cycles of a page since the file was created by HostStorage_Open()
+ * @param page - Page index
+ * @return Erase count
+ */
+uint32_t HostStorage_GetEraseCount(uint16_t page);
+
+#endif /* HOST_STORAGE_H_ */
@@ -0,0 +1,186 @@
+/**
+ * @file HostUart.c
+ * @brief Host model of USART2 and DMA1 channel 6
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "HostUart.h"
+#include "HostDevice.h"
+#include "stm32f303x8.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+void USART2_IRQHandler(void);    /**< Firmware handler (UART.c), declared by the startup code on target */
+
+#define HOSTUART_DMA_CH6_FLAGS  (DMA_ISR_GIF6 | DMA_ISR_TCIF6 | DMA_ISR_HTIF6 | DMA_ISR_TEIF6)
+
+static struct {
+    USART_TypeDef regs;         /**< USART2 registers */
+    DMA_TypeDef dma;            /**< DMA1 interrupt flags */
+    DMA_Channel_TypeDef rx;     /**< DMA1 channel 6 */
+    uint32_t rx_ccr;            /**< Channel 6 CCR at the previous sync (EN edge) */
+    uint32_t rx_size;           /**< CNDTR loaded when the channel was enabled */
+    uint8_t draining;           /**< Inside the TX drain */
+    uint32_t tx_bytes;          /**< Bytes transmitted */
+    HostUart_Sink sink;         /**< TX byte receiver */
+    void *ctx;                  /**< Sink context */
+} u;
+
+/**
+ * @brief Put a byte written to TDR on the line
+ * @return void
+ */
+static void HostUart_Transmit(void) {
+    if (u.regs.TDR != HOSTUART_TDR_EMPTY) {
+        uint8_t byte = (uint8_t)u.regs.TDR;
+        u.regs.TDR = HOSTUART_TDR_EMPTY;
+        u.tx_bytes++;
+        if (u.sink) {
+            u.sink(u.ctx, byte);
+        }
+    }
+}
+
+/**
+ * @brief React to register writes
+ * @return void
+ */
+void HostUart_Sync(void) {
+    HostUart_Transmit();
+    if (u.regs.ICR) {
+        if (u.regs.ICR & USART_ICR_IDLECF) u.regs.ISR &= ~USART_ISR_IDLE;
+        if (u.regs.ICR & USART_ICR_ORECF)  u.regs.ISR &= ~USART_ISR_ORE;
+        u.regs.ICR = 0;
+    }
+    if (u.dma.IFCR) {
+        if (u.dma.IFCR & DMA_IFCR_CGIF6) u.dma.ISR &= ~HOSTUART_DMA_CH6_FLAGS;
+        u.dma.IFCR = 0;
+    }
+    if (!(u.rx_ccr & DMA_CCR_EN) && (u.rx.CCR & DMA_CCR_EN)) {
+        u.rx_size = u.rx.CNDTR;
+    }
+    u.rx_ccr = u.rx.CCR;
+}
+
+/**
+ * @brief Run the TXE interrupt until the firmware's TX ring is empty
+ * @return void
+ */
+static void HostUart_Drain(void) {
+    const uint32_t masked = USART_ISR_IDLE | USART_ISR_ORE;
+    if (u.draining || (u.regs.CR1 & (USART_CR1_UE | USART_CR1_TE)) != (USART_CR1_UE | USART_CR1_TE)) {
+        return;
+    }
+    u.draining = 1;
+    uint32_t held = u.regs.ISR & masked;
+    u.regs.ISR &= ~masked;
+    u.regs.CR1 |= USART_CR1_TXEIE;
+    while (u.regs.CR1 & USART_CR1_TXEIE) {
+        USART2_IRQHandler();
+        HostUart_Transmit();
+    }
+    u.regs.ISR |= held;
+    u.draining = 0;
+}
+
+/**
+ * @brief USART2 accessor
+ * @return USART2 register block
+ */
+USART_TypeDef *HostUart_Regs(void) {
+    Host_Access();
+    HostUart_Drain();
+    return &u.regs;
+}
+
+/**
+ * @brief DMA1 accessor
+ * @return DMA1 interrupt flag registers
+ */
+DMA_TypeDef *HostUart_Dma(void) {
+    Host_Access();
+    return &u.dma;
+}
+
+/**
+ * @brief DMA1 channel 6 accessor
+ * @return Channel 6 registers
+ */
+DMA_Channel_TypeDef *HostUart_RxChannel(void) {
+    Host_Access();
+    return &u.rx;
+}
+
+/**
+ * @brief Route transmitted bytes
+ * @param sink - Receiver (NULL: bytes are only counted)
+ * @param ctx - Context passed to the sink
+ * @return void
+ */
+void HostUart_SetTxSink(HostUart_Sink sink, void *ctx) {
+    u.sink = sink;
+    u.ctx = ctx;
+}
+
+/**
+ * @brief Bytes transmitted since Host_Reset()
+ * @return Byte count
+ */
+uint32_t HostUart_GetTxBytes(void) {
+    return u.tx_bytes;
+}
+
+/**
+ * @brief Receive bytes by DMA
+ * @param data - [in] Bytes arriving on RX
+ * @param len - Number of bytes
+ * @return Bytes stored (0 if the DMA channel is not enabled)
+ */
+uint16_t HostUart_Receive(const uint8_t *data, uint16_t len) {
+    if (!(u.rx.CCR & DMA_CCR_EN) || u.rx_size == 0) {
+        return 0;
+    }
+    uint8_t *buf = (uint8_t *)(uintptr_t)u.rx.CMAR;
+    for (uint16_t i = 0; i < len; i++) {
+        u.regs.RDR = data[i];
+        buf[u.rx_size - u.rx.CNDTR] = data[i];
+        if (--u.rx.CNDTR == u.rx_size / 2u) {
+            u.dma.ISR |= DMA_ISR_GIF6 | DMA_ISR_HTIF6;
+        }
+        if (u.rx.CNDTR == 0) {
+            u.dma.ISR |= DMA_ISR_GIF6 | DMA_ISR_TCIF6;
+            if (u.rx.CCR & DMA_CCR_CIRC) {
+                u.rx.CNDTR = u.rx_size;
+            } else {
+                u.rx.CCR &= ~DMA_CCR_EN;
+                return (uint16_t)(i + 1u);
+            }
+        }
+    }
+    return len;
+}
+
+/**
+ * @brief Signal an idle line (IDLE flag)
+ * @return void
+ */
+void HostUart_LineIdle(void) {
+    u.regs.ISR |= USART_ISR_IDLE;
+}
+
+/**
+ * @brief Reset the model; the sink stays connected
+ * @return void
+ */
+void HostUart_Reset(void) {
+    HostUart_Sink sink = u.sink;
+    void *ctx = u.ctx;
+    memset(&u, 0, sizeof(u));
+    u.sink = sink;
+    u.ctx = ctx;
+    u.regs.ISR = USART_ISR_TXE | USART_ISR_TC;
+    u.regs.TDR = HOSTUART_TDR_EMPTY;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file HostUart.h
+ * @brief Host model of USART2 and its receive DMA channel (DMA1 channel 6)
+ * @details
+ * ### Transmit
+ *  - The line is infinitely fast: every USART2 access from outside the interrupt
+ *    handler enters USART2_IRQHandler() with TXEIE forced on until the handler turns it
+ *    off (TX ring empty), so USART2_Write() and USART2_Flush() never wait
+ *  - IDLE and ORE are masked during that drain; they are delivered only when the test
+ *    calls the handler itself
+ *  - Every byte written to TDR goes to the TX sink and is counted
+ *
+ * ### Receive
+ *  - HostUart_Receive() moves bytes through RDR into the circular DMA buffer programmed
+ *    in CMAR/CNDTR, and sets HTIF6/TCIF6 (with GIF6) at the half and full marks
+ *  - HostUart_LineIdle() sets the IDLE flag
+ *  - No handler is entered by the receive path: the test calls DMA1_Channel6_IRQHandler()
+ *    and USART2_IRQHandler() in the order it wants to exercise, which is how HT/TC/IDLE
+ *    interleavings (late, merged or missing interrupts) are reproduced
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see HostDevice.h, UART.h
+ */
+
+#ifndef HOST_UART_H_
+#define HOST_UART_H_
+
+#include <stdint.h>
+
+#define     HOSTUART_TDR_EMPTY      0xFFFFFFFFu /**< TDR value while no byte is pending */
+
+/**
+ * @brief Receiver of transmitted bytes
+ * @param ctx - Context given to HostUart_SetTxSink()
+ * @param byte - Transmitted byte
+ */
+typedef void (*HostUart_Sink)(void *ctx, uint8_t byte);
+
+/**
+ * @brief Route transmitted bytes
+ * @param sink - Receiver (NULL: bytes are only counted)
+ * @param ctx - Context passed to the sink
+ * @return void
+ */
+void HostUart_SetTxSink(HostUart_Sink sink, void *ctx);
+
+/**
+ * @brief Bytes transmitted since Host_Reset()
+ * @return Byte count
+ */
+uint32_t HostUart_GetTxBytes(void);
+
+/**
+ * @brief Receive bytes by DMA
+ * @param data - [in] Bytes arriving on RX
+ * @param len - Number of bytes
+ * @return Bytes stored (0 if the DMA channel is not enabled)
+ */
+uint16_t HostUart_Receive(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief Signal an idle line after the last received byte (IDLE flag)
+ * @return void
+ */
+void HostUart_LineIdle(void);
+
+/**
+ * @brief Reset the model; the sink stays connected
+ * @return void
+ */
+void HostUart_Reset(void);
+
+/**
+ * @brief React to register writes (called on every modelled access)
+ * @return void
+ */
+void HostUart_Sync(void);
+
+#endif /* HOST_UART_H_ */
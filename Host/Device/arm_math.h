@@ -0,0 +1,54 @@
+/**
+ * @file arm_math.h
+ * @brief Host stand-in for the CMSIS-DSP subset used by the firmware
+ * @details Instance layouts and prototypes of the biquad cascade, normalized LMS and
+ *          square root functions; HostDsp.c implements them with the CMSIS-DSP reference
+ *          algorithms so host results match the target to float rounding.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#ifndef ARM_MATH_H_
+#define ARM_MATH_H_
+
+#include "arm_math_types.h"
+#include "stm32f303x8.h"
+
+#define PI  3.14159265358979f
+
+/** @brief Function status */
+typedef enum {
+    ARM_MATH_SUCCESS = 0,           /**< No error */
+    ARM_MATH_ARGUMENT_ERROR = -1    /**< Argument out of range */
+} arm_status;
+
+/** @brief Biquad cascade, direct form II transposed */
+typedef struct {
+    uint8_t numStages;          /**< Number of 2nd order stages */
+    float32_t *pState;          /**< 2 × numStages state values */
+    const float32_t *pCoeffs;   /**< {b0, b1, b2, a1, a2} per stage (a1, a2 negated) */
+} arm_biquad_cascade_df2T_instance_f32;
+
+/** @brief Normalized LMS filter */
+typedef struct {
+    uint16_t numTaps;           /**< Number of coefficients */
+    float32_t *pState;          /**< numTaps + blockSize - 1 state values */
+    float32_t *pCoeffs;         /**< numTaps coefficients, time reversed */
+    float32_t mu;               /**< Step size */
+    float32_t *recipTable;      /**< Unused in the f32 version */
+    float32_t energy;           /**< Energy of the input in the state window */
+    float32_t x0;               /**< Oldest input of the previous window */
+} arm_lms_norm_instance_f32;
+
+void arm_biquad_cascade_df2T_init_f32(arm_biquad_cascade_df2T_instance_f32 *S, uint8_t numStages,
+                                      const float32_t *pCoeffs, float32_t *pState);
+void arm_biquad_cascade_df2T_f32(const arm_biquad_cascade_df2T_instance_f32 *S, const float32_t *pSrc,
+                                 float32_t *pDst, uint32_t blockSize);
+void arm_lms_norm_init_f32(arm_lms_norm_instance_f32 *S, uint16_t numTaps, float32_t *pCoeffs,
+                           float32_t *pState, float32_t mu, uint32_t blockSize);
+void arm_lms_norm_f32(arm_lms_norm_instance_f32 *S, const float32_t *pSrc, float32_t *pRef,
+                      float32_t *pOut, float32_t *pErr, uint32_t blockSize);
+arm_status arm_sqrt_f32(float32_t in, float32_t *pOut);
+
+#endif /* ARM_MATH_H_ */
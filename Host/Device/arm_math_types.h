@@ -0,0 +1,21 @@
+/**
+ * @file arm_math_types.h
+ * @brief Host stand-in for the CMSIS-DSP base types
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#ifndef ARM_MATH_TYPES_H_
+#define ARM_MATH_TYPES_H_
+
+#include <stdint.h>
+#include "cmsis_compiler.h"
+
+typedef float   float32_t;  /**< 32-bit floating point */
+typedef double  float64_t;  /**< 64-bit floating point */
+typedef int8_t  q7_t;       /**< 8-bit fractional */
+typedef int16_t q15_t;      /**< 16-bit fractional */
+typedef int32_t q31_t;      /**< 32-bit fractional */
+
+#endif /* ARM_MATH_TYPES_H_ */
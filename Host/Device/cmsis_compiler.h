@@ -0,0 +1,41 @@
+/**
+ * @file cmsis_compiler.h
+ * @brief Host stand-in for the CMSIS compiler abstraction
+ * @details The intrinsics used by the firmware, for GCC/Clang on the build machine.
+ *          __ARM_FEATURE_DSP is not defined here, so the portable code paths are built.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#ifndef CMSIS_COMPILER_H_
+#define CMSIS_COMPILER_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define __STATIC_INLINE             static inline
+#define __STATIC_FORCEINLINE        static inline __attribute__((always_inline))
+#define __ALIGNED(x)                __attribute__((aligned(x)))
+#define __WEAK                      __attribute__((weak))
+
+/** Single-core host: a compiler barrier orders the ring indices like the DMB does on target */
+#define __DMB()                     __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#define __DSB()                     __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#define __ISB()                     __atomic_signal_fence(__ATOMIC_SEQ_CST)
+#define __NOP()                     ((void)0)
+#define __WFI()                     ((void)0)
+#define __disable_irq()             ((void)0)
+#define __enable_irq()              ((void)0)
+
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t value) {
+    return __builtin_bswap32(value);
+}
+
+__STATIC_FORCEINLINE uint32_t __UNALIGNED_UINT32_READ(const void *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+#endif /* CMSIS_COMPILER_H_ */
@@ -0,0 +1,215 @@
+/**
+ * @file stm32f303x8.h
+ * @brief Host stand-in for the STM32F303x8 device header
+ * @details Register layouts and bit definitions used by the firmware, so the modules in
+ *          Project/ compile unchanged on the build machine.
+ *
+ *          Peripherals with behaviour the firmware depends on (I2C1 and its GPIOB pins,
+ *          USART2 and its DMA channel, the DWT cycle counter, RCC ready flags) are
+ *          accessor calls into the register models (HostDevice.h): every access advances
+ *          the virtual time and lets the model react to the previous register write.
+ *          All other peripherals are plain register blocks.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see HostDevice.h, HostI2c.h, HostUart.h
+ */
+
+#ifndef STM32F303X8_H_
+#define STM32F303X8_H_
+
+#include <stdint.h>
+#include "cmsis_compiler.h"
+#include "system_stm32f3xx.h"
+
+#define __IO    volatile
+
+typedef struct { __IO uint32_t CR, CFGR, CIR, APB2RSTR, APB1RSTR, AHBENR, APB2ENR, APB1ENR, BDCR, CSR, AHBRSTR, CFGR2, CFGR3; } RCC_TypeDef;
+typedef struct { __IO uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2], BRR; } GPIO_TypeDef;
+typedef struct { __IO uint32_t CR1, CR2, OAR1, OAR2, TIMINGR, TIMEOUTR, ISR, ICR, PECR, RXDR, TXDR; } I2C_TypeDef;
+typedef struct { __IO uint32_t CR1, CR2, CR3, BRR, GTPR, RTOR, RQR, ISR, ICR, RDR, TDR; } USART_TypeDef;
+typedef struct { __IO uint32_t ACR, KEYR, OPTKEYR, SR, CR, AR, RESERVED, OBR, WRPR; } FLASH_TypeDef;
+typedef struct { __IO uint32_t CCR, CNDTR, CPAR, CMAR; } DMA_Channel_TypeDef;
+typedef struct { __IO uint32_t ISR, IFCR; } DMA_TypeDef;
+typedef struct { __IO uint32_t CTRL, CYCCNT; } DWT_Type;
+typedef struct { __IO uint32_t DHCSR, DCRSR, DCRDR, DEMCR; } CoreDebug_Type;
+typedef struct { __IO uint32_t CTRL, LOAD, VAL, CALIB; } SysTick_Type;
+typedef struct { __IO uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR; } TIM_TypeDef;
+typedef struct { __IO uint32_t ICSR, SCR; } SCB_Type;
+typedef struct { __IO uint32_t CFGR1, RCR, EXTICR[4], CFGR2; } SYSCFG_TypeDef;
+
+/* Modelled peripherals: accessor calls (HostDevice.c, HostI2c.c, HostUart.c) */
+RCC_TypeDef *Host_Rcc(void);
+DWT_Type *Host_Dwt(void);
+I2C_TypeDef *HostI2c_Regs(void);
+GPIO_TypeDef *HostI2c_Gpio(void);
+USART_TypeDef *HostUart_Regs(void);
+DMA_TypeDef *HostUart_Dma(void);
+DMA_Channel_TypeDef *HostUart_RxChannel(void);
+
+#define RCC             (Host_Rcc())
+#define DWT             (Host_Dwt())
+#define I2C1            (HostI2c_Regs())
+#define GPIOB           (HostI2c_Gpio())
+#define USART2          (HostUart_Regs())
+#define DMA1            (HostUart_Dma())
+#define DMA1_Channel6   (HostUart_RxChannel())
+
+/* Plain register blocks (HostDevice.c) */
+extern GPIO_TypeDef Host_GPIOA;
+extern FLASH_TypeDef Host_FLASH;
+extern DMA_Channel_TypeDef Host_DMA1_Channel7;
+extern CoreDebug_Type Host_CoreDebug;
+extern SysTick_Type Host_SysTick;
+extern TIM_TypeDef Host_TIM2;
+extern SCB_Type Host_SCB;
+extern SYSCFG_TypeDef Host_SYSCFG;
+
+#define GPIOA           (&Host_GPIOA)
+#define FLASH           (&Host_FLASH)
+#define DMA1_Channel7   (&Host_DMA1_Channel7)
+#define CoreDebug       (&Host_CoreDebug)
+#define SysTick         (&Host_SysTick)
+#define TIM2            (&Host_TIM2)
+#define SCB             (&Host_SCB)
+#define SYSCFG          (&Host_SYSCFG)
+
+typedef enum {
+    SysTick_IRQn = -1,
+    DMA1_Channel6_IRQn = 16,
+    DMA1_Channel7_IRQn = 17,
+    I2C1_EV_IRQn = 31,
+    USART2_IRQn = 38
+} IRQn_Type;
+
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority);
+uint32_t SysTick_Config(uint32_t ticks);
+
+#define SCB_ICSR_VECTACTIVE_Msk     0x1FFu
+
+#define RCC_CR_HSEON                (1u << 16)
+#define RCC_CR_PLLON                (1u << 24)
+#define RCC_CR_PLLRDY               (1u << 25)
+#define RCC_CFGR_SW                 (3u)
+#define RCC_CFGR_SW_PLL             (2u)
+#define RCC_CFGR_SWS                (0xCu)
+#define RCC_CFGR_SWS_HSI            (0u)
+#define RCC_CFGR_SWS_HSE            (4u)
+#define RCC_CFGR_SWS_PLL            (8u)
+#define RCC_CFGR_HPRE_Pos           4
+#define RCC_CFGR_HPRE               (0xFu << RCC_CFGR_HPRE_Pos)
+#define RCC_CFGR_PPRE1_Pos          8
+#define RCC_CFGR_PPRE1              (0x7u << RCC_CFGR_PPRE1_Pos)
+#define RCC_CFGR_PPRE1_DIV1         (0u)
+#define RCC_CFGR_PPRE1_DIV2         (0x4u << RCC_CFGR_PPRE1_Pos)
+#define RCC_CFGR_PPRE2_Pos          11
+#define RCC_CFGR_PPRE2              (0x7u << RCC_CFGR_PPRE2_Pos)
+#define RCC_CFGR_PLLSRC             (1u << 16)
+#define RCC_CFGR_PLLMUL_Pos         18
+#define RCC_CFGR_PLLMUL             (0xFu << RCC_CFGR_PLLMUL_Pos)
+#define RCC_CFGR2_PREDIV            (0xFu)
+#define RCC_CFGR3_I2C1SW            (1u << 4)
+#define RCC_CFGR3_USART2SW_Pos      16
+#define RCC_CFGR3_USART2SW          (3u << RCC_CFGR3_USART2SW_Pos)
+#define RCC_AHBENR_DMA1EN           (1u << 0)
+#define RCC_AHBENR_GPIOAEN          (1u << 17)
+#define RCC_AHBENR_GPIOBEN          (1u << 18)
+#define RCC_APB1ENR_TIM2EN          (1u << 0)
+#define RCC_APB1ENR_USART2EN        (1u << 17)
+#define RCC_APB1ENR_I2C1EN          (1u << 21)
+#define RCC_APB1RSTR_I2C1RST        (1u << 21)
+#define RCC_APB2ENR_SYSCFGEN        (1u << 0)
+
+#define SYSCFG_CFGR1_I2C_PB6_FMP    (1u << 16)
+#define SYSCFG_CFGR1_I2C_PB7_FMP    (1u << 17)
+
+#define I2C_CR1_PE                  (1u << 0)
+#define I2C_CR1_DNF                 (0xFu << 8)
+#define I2C_CR1_ANFOFF              (1u << 12)
+#define I2C_CR2_SADD                (0x3FFu)
+#define I2C_CR2_RD_WRN              (1u << 10)
+#define I2C_CR2_START               (1u << 13)
+#define I2C_CR2_STOP                (1u << 14)
+#define I2C_CR2_NBYTES_Pos          16
+#define I2C_CR2_NBYTES              (0xFFu << I2C_CR2_NBYTES_Pos)
+#define I2C_CR2_RELOAD              (1u << 24)
+#define I2C_CR2_AUTOEND             (1u << 25)
+#define I2C_ISR_TXE                 (1u << 0)
+#define I2C_ISR_TXIS                (1u << 1)
+#define I2C_ISR_RXNE                (1u << 2)
+#define I2C_ISR_NACKF               (1u << 4)
+#define I2C_ISR_STOPF               (1u << 5)
+#define I2C_ISR_TC                  (1u << 6)
+#define I2C_ISR_TCR                 (1u << 7)
+#define I2C_ISR_BERR                (1u << 8)
+#define I2C_ISR_ARLO                (1u << 9)
+#define I2C_ISR_OVR                 (1u << 10)
+#define I2C_ISR_TIMEOUT             (1u << 12)
+#define I2C_ISR_BUSY                (1u << 15)
+#define I2C_ICR_NACKCF              (1u << 4)
+#define I2C_ICR_STOPCF              (1u << 5)
+#define I2C_ICR_BERRCF              (1u << 8)
+#define I2C_ICR_ARLOCF              (1u << 9)
+#define I2C_ICR_OVRCF               (1u << 10)
+#define I2C_TIMINGR_SCLL_Pos        0
+#define I2C_TIMINGR_SCLH_Pos        8
+#define I2C_TIMINGR_SDADEL_Pos      16
+#define I2C_TIMINGR_SCLDEL_Pos      20
+#define I2C_TIMINGR_PRESC_Pos       28
+
+#define USART_CR1_UE                (1u << 0)
+#define USART_CR1_RE                (1u << 2)
+#define USART_CR1_TE                (1u << 3)
+#define USART_CR1_IDLEIE            (1u << 4)
+#define USART_CR1_RXNEIE            (1u << 5)
+#define USART_CR1_TCIE              (1u << 6)
+#define USART_CR1_TXEIE             (1u << 7)
+#define USART_CR1_OVER8             (1u << 15)
+#define USART_CR3_DMAR              (1u << 6)
+#define USART_CR3_DMAT              (1u << 7)
+#define USART_CR3_OVRDIS            (1u << 12)
+#define USART_ISR_ORE               (1u << 3)
+#define USART_ISR_IDLE              (1u << 4)
+#define USART_ISR_RXNE              (1u << 5)
+#define USART_ISR_TC                (1u << 6)
+#define USART_ISR_TXE               (1u << 7)
+#define USART_ICR_ORECF             (1u << 3)
+#define USART_ICR_IDLECF            (1u << 4)
+
+#define FLASH_ACR_LATENCY           (7u)
+#define FLASH_KEYR_KEY1             0x45670123u
+#define FLASH_KEYR_KEY2             0xCDEF89ABu
+#define FLASH_SR_BSY                (1u << 0)
+#define FLASH_SR_PGERR              (1u << 2)
+#define FLASH_SR_WRPERR             (1u << 4)
+#define FLASH_SR_EOP                (1u << 5)
+#define FLASH_CR_PG                 (1u << 0)
+#define FLASH_CR_PER                (1u << 1)
+#define FLASH_CR_STRT               (1u << 6)
+#define FLASH_CR_LOCK               (1u << 7)
+
+#define DMA_CCR_EN                  (1u << 0)
+#define DMA_CCR_TCIE                (1u << 1)
+#define DMA_CCR_HTIE                (1u << 2)
+#define DMA_CCR_TEIE                (1u << 3)
+#define DMA_CCR_DIR                 (1u << 4)
+#define DMA_CCR_CIRC                (1u << 5)
+#define DMA_CCR_MINC                (1u << 7)
+#define DMA_CCR_PL_1                (1u << 13)
+#define DMA_ISR_GIF6                (1u << 20)
+#define DMA_ISR_TCIF6               (1u << 21)
+#define DMA_ISR_HTIF6               (1u << 22)
+#define DMA_ISR_TEIF6               (1u << 23)
+#define DMA_ISR_TCIF7               (1u << 25)
+#define DMA_IFCR_CGIF6              (1u << 20)
+#define DMA_IFCR_CGIF7              (1u << 24)
+
+#define DWT_CTRL_CYCCNTENA_Msk      (1u << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1u << 24)
+
+#define TIM_CR1_CEN                 (1u << 0)
+#define TIM_EGR_UG                  (1u << 0)
+
+#endif /* STM32F303X8_H_ */
@@ -0,0 +1,26 @@
+/**
+ * @file system_stm32f3xx.h
+ * @brief Host stand-in for the CMSIS system header of the STM32F3 series
+ * @details Oscillator values and the SystemCoreClock variable, as provided by the device
+ *          pack; SystemCoreClockUpdate() derives the clock from the modelled RCC.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#ifndef SYSTEM_STM32F3XX_H_
+#define SYSTEM_STM32F3XX_H_
+
+#include <stdint.h>
+
+#define HSE_VALUE   8000000u    /**< External oscillator (Hz) */
+#define HSI_VALUE   8000000u    /**< Internal RC oscillator (Hz) */
+#define LSE_VALUE   32768u      /**< Low-speed external crystal (Hz) */
+
+extern uint32_t SystemCoreClock;            /**< HCLK (Hz), HSI_VALUE after reset */
+extern const uint8_t AHBPrescTable[16];     /**< AHB prescaler shift per HPRE code */
+extern const uint8_t APBPrescTable[8];      /**< APB prescaler shift per PPREx code */
+
+void SystemCoreClockUpdate(void);
+
+#endif /* SYSTEM_STM32F3XX_H_ */
@@ -0,0 +1,511 @@
+/**
+ * @file Sim.c
+ * @brief Host simulator: virtual MAX30101 sensors behind a TCA9548A
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Sim.h"
+#include "Acquisition.h"
+#include "HostDevice.h"
+#include "HostI2c.h"
+#include "I2C.h"
+#include "PLL.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define SIM_MODE_MASK       0x07u   /**< MODE_CONFIG mode field */
+#define SIM_PW_MS           0.411   /**< LED pulse width of the profile (ms) */
+#define SIM_TARGET_NONE     0xFFu   /**< No device addressed */
+#define SIM_TARGET_MUX      0xFEu   /**< The mux is addressed */
+
+/**
+ * @struct Sim_Sensor
+ * @brief One virtual MAX30101
+ */
+typedef struct {
+    uint8_t present;                                                /**< Answers its address */
+    uint8_t regs[256];                                              /**< Register file (FIFO pointers kept below) */
+    uint8_t ptr;                                                    /**< Register pointer */
+    uint8_t fifo[MAX30101_FIFO_DEPTH][MAX30101_BYTES_PER_SAMPLE];   /**< FIFO entries */
+    uint8_t wr;                                                     /**< FIFO write pointer */
+    uint8_t rd;                                                     /**< FIFO read pointer */
+    uint8_t ovf;                                                    /**< Overflow counter */
+    uint8_t level;                                                  /**< Unread entries (0..32) */
+    uint8_t byte;                                                   /**< Byte of the entry being read */
+    uint8_t prox;                                                   /**< In proximity mode */
+    uint8_t flip[256];                                              /**< Bits inverted on register writes */
+    uint64_t next_conv;                                             /**< Time of the next conversion */
+    uint64_t temp_due;                                              /**< Time TEMP_EN self-clears */
+    uint32_t acc_n;                                                 /**< Conversions accumulated for averaging */
+    double acc[2];                                                  /**< Accumulated counts (Red, IR) */
+    Sim_SensorStats stats;                                          /**< Activity counters */
+} Sim_Sensor;
+
+static struct {
+    Sim_Sensor sensor[ACQ_MAX_SENSORS];     /**< Virtual sensors, index = mux channel */
+    MAX30101_Handle handle[ACQ_MAX_SENSORS];/**< Their firmware handles */
+    MAX30101_Handle active[ACQ_MAX_SENSORS];/**< Handles registered by Sim_Boot() */
+    uint8_t num;                            /**< Sensors in use */
+    uint8_t mux_ctrl;                       /**< TCA9548A control register */
+    uint8_t target;                         /**< Addressed device: sensor index, SIM_TARGET_MUX or _NONE */
+    uint8_t first;                          /**< Next written byte is the register pointer */
+    uint8_t written;                        /**< A register was written in this transfer */
+    Sim_Signal signal;                      /**< Optical path */
+    void *ctx;                              /**< Signal context */
+    uint32_t poll_max;                      /**< Longest Acquisition_Poll() (cycles) */
+} sim;
+
+/**
+ * @brief Default optical path
+ * @param ctx - Unused
+ * @param sensor - Sensor index
+ * @param channel - Sim_Channel
+ * @param t_s - Time (s)
+ * @return nA per mA
+ */
+float32_t Sim_DefaultSignal(void *ctx, uint8_t sensor, uint8_t channel, double t_s) {
+    (void)ctx;
+    double base = (channel == SIM_CH_IR) ? SIM_IR_NA_PER_MA : SIM_RED_NA_PER_MA;
+    double pulse = sin(2.0 * M_PI * SIM_PULSE_HZ * t_s + 0.5 * sensor);
+    return (float32_t)(base * (1.0 - SIM_PULSE_DEPTH * pulse));
+}
+
+/**
+ * @brief ADC conversion period of the current SPO2_CONFIG
+ * @param s - [in] Sensor
+ * @return Period in core cycles
+ */
+static uint64_t Sim_ConvCycles(const Sim_Sensor *s) {
+    static const uint16_t rate_hz[] = { 50, 100, 200, 400, 800, 1000, 1600, 3200 };
+    return HOST_CORE_HZ / rate_hz[(s->regs[SPO2_CONFIG] >> MAX30101_SR_Pos) & 0x07u];
+}
+
+/**
+ * @brief Photocurrent of one channel as an 18-bit count of the active range
+ * @param s - [in] Sensor
+ * @param index - Sensor index
+ * @param channel - Sim_Channel
+ * @param led_ma - LED drive current (mA)
+ * @param t - Time of the conversion (cycles)
+ * @return ADC count
+ */
+static double Sim_Convert(const Sim_Sensor *s, uint8_t index, uint8_t channel, double led_ma, uint64_t t) {
+    uint8_t range = (s->regs[SPO2_CONFIG] >> MAX30101_ADC_RGE_Pos) & 0x03u;
+    double na = sim.signal(sim.ctx, index, channel, (double)t / HOST_CORE_HZ) * led_ma;
+    double count = floor(na / MAX30101_RANGE_FULLSCALE_NA(range) * (1u << MAX30101_ADC_BITS));
+    if (count < 0.0) {
+        count = 0.0;
+    }
+    return (count > MAX30101_ADC_MAX) ? MAX30101_ADC_MAX : count;
+}
+
+/**
+ * @brief Store one averaged sample in the FIFO
+ * @param s - [in,out] Sensor
+ * @param red - Red count
+ * @param ir - IR count
+ * @return void
+ */
+static void Sim_Push(Sim_Sensor *s, uint32_t red, uint32_t ir) {
+    if (s->level == MAX30101_FIFO_DEPTH) {
+        s->stats.overflows++;
+        if (s->ovf < 0x1Fu) {
+            s->ovf++;
+        }
+        if (!(s->regs[FIFO_CONFIG] & MAX30101_FIFO_ROLLOVER_EN)) {
+            return;
+        }
+        s->rd = (s->rd + 1u) & 0x1Fu;   // Oldest entry overwritten
+        s->level--;
+    }
+    uint8_t *e = s->fifo[s->wr];
+    e[0] = (uint8_t)(red >> 16);
+    e[1] = (uint8_t)(red >> 8);
+    e[2] = (uint8_t)red;
+    e[3] = (uint8_t)(ir >> 16);
+    e[4] = (uint8_t)(ir >> 8);
+    e[5] = (uint8_t)ir;
+    s->wr = (s->wr + 1u) & 0x1Fu;
+    s->level++;
+    s->stats.samples++;
+}
+
+/**
+ * @brief One ADC conversion at time t
+ * @param s - [in,out] Sensor
+ * @param index - Sensor index
+ * @param t - Time (cycles)
+ * @return void
+ */
+static void Sim_Conversion(Sim_Sensor *s, uint8_t index, uint64_t t) {
+    if (s->prox) {
+        double pilot = MAX30101_LED_REG_TO_MA(s->regs[PILOT_PA]);
+        double count = Sim_Convert(s, index, SIM_CH_IR, pilot, t);
+        s->stats.led_charge_uc += pilot * SIM_PW_MS;
+        s->stats.conversions++;
+        if (((uint32_t)count >> (MAX30101_ADC_BITS - 8)) > s->regs[PROX_INT_THRESH]) {
+            // Skin contact: flag it and run the mode that was written
+            s->regs[INTR_STATUS1] |= MAX30101_INT_PROX;
+            s->prox = 0;
+            s->acc_n = 0;
+            s->stats.prox_wakeups++;
+        }
+        return;
+    }
+    double red_ma = MAX30101_LED_REG_TO_MA(s->regs[LED1_PAMPLI]);
+    double ir_ma = MAX30101_LED_REG_TO_MA(s->regs[LED2_PAMPLI]);
+    uint8_t ir_on = (s->regs[MODE_CONFIG] & SIM_MODE_MASK) != MAX30101_MODE_HR;
+    s->acc[0] += Sim_Convert(s, index, SIM_CH_RED, red_ma, t);
+    s->acc[1] += ir_on ? Sim_Convert(s, index, SIM_CH_IR, ir_ma, t) : 0.0;
+    s->stats.led_charge_uc += (red_ma + (ir_on ? ir_ma : 0.0)) * SIM_PW_MS;
+    s->stats.conversions++;
+    uint32_t n = 1u << ((s->regs[FIFO_CONFIG] >> MAX30101_SMP_AVE_Pos) & 0x07u);
+    if (n > 32u) {
+        n = 32u;
+    }
+    if (++s->acc_n >= n) {
+        Sim_Push(s, (uint32_t)(s->acc[0] / n), (uint32_t)(s->acc[1] / n));
+        s->acc[0] = s->acc[1] = 0.0;
+        s->acc_n = 0;
+    }
+}
+
+/**
+ * @brief Run the sensor's conversions and temperature up to the current time
+ * @param index - Sensor index
+ * @return void
+ */
+static void Sim_Update(uint8_t index) {
+    Sim_Sensor *s = &sim.sensor[index];
+    uint64_t now = Host_Cycles();
+    uint8_t mode = s->regs[MODE_CONFIG] & SIM_MODE_MASK;
+    uint8_t running = !(s->regs[MODE_CONFIG] & MAX30101_MODE_SHDN) &&
+                      (mode == MAX30101_MODE_HR || mode == MAX30101_MODE_SPO2 || mode == MAX30101_MODE_MULTI_LED);
+
+    if (!running) {
+        s->next_conv = now + Sim_ConvCycles(s);
+    } else {
+        while (s->next_conv <= now) {
+            Sim_Conversion(s, index, s->next_conv);
+            s->next_conv += Sim_ConvCycles(s);
+        }
+    }
+    if ((s->regs[DIE_TEMPCFG] & MAX30101_TEMP_EN) && now >= s->temp_due) {
+        float32_t frac = SIM_DIE_TEMP_C - floorf(SIM_DIE_TEMP_C);
+        s->regs[DIE_TEMPINT] = (uint8_t)(int8_t)floorf(SIM_DIE_TEMP_C);
+        s->regs[DIE_TEMPFRC] = (uint8_t)(frac / MAX30101_TEMP_FRAC_DEGC);
+        s->regs[DIE_TEMPCFG] &= (uint8_t)~MAX30101_TEMP_EN;
+    }
+}
+
+/**
+ * @brief Power-on / MODE_CONFIG RESET state
+ * @param s - [out] Sensor
+ * @return void
+ */
+static void Sim_PowerOn(Sim_Sensor *s) {
+    memset(s->regs, 0, sizeof(s->regs));
+    s->ptr = 0;
+    s->wr = s->rd = s->ovf = s->level = s->byte = 0;
+    s->prox = 0;
+    s->acc_n = 0;
+    s->acc[0] = s->acc[1] = 0.0;
+    s->next_conv = Host_Cycles();
+}
+
+/**
+ * @brief Register write with its side effects
+ * @param index - Sensor index
+ * @param reg - Register
+ * @param value - Value
+ * @return void
+ */
+static void Sim_WriteReg(uint8_t index, uint8_t reg, uint8_t value) {
+    Sim_Sensor *s = &sim.sensor[index];
+    value ^= s->flip[reg];
+    switch (reg) {
+        case FIFO_WRITPTR:
+            s->wr = value & 0x1Fu;
+            break;
+        case OVRF_COUNTER:
+            s->ovf = value & 0x1Fu;
+            break;
+        case FIFO_READPTR:
+            s->rd = value & 0x1Fu;
+            s->byte = 0;
+            break;
+        case MODE_CONFIG:
+            if (value & MAX30101_MODE_RESET) {
+                Sim_PowerOn(s);
+                return;
+            }
+            s->regs[reg] = value;
+            s->prox = (s->regs[INTR_ENABLE1] & MAX30101_INT_PROX) ? 1u : 0u;
+            s->acc_n = 0;
+            s->acc[0] = s->acc[1] = 0.0;
+            s->next_conv = Host_Cycles() + Sim_ConvCycles(s);
+            return;
+        case DIE_TEMPCFG:
+            if (value & MAX30101_TEMP_EN) {
+                s->temp_due = Host_Cycles() + HOST_US_TO_CYCLES(MAX30101_TEMP_CONV_MS * 1000u);
+            }
+            break;
+        default:
+            break;
+    }
+    if (reg == FIFO_WRITPTR || reg == OVRF_COUNTER || reg == FIFO_READPTR) {
+        s->level = (uint8_t)((s->wr - s->rd) & 0x1Fu);
+        if (s->level == 0 && s->ovf) {
+            s->level = MAX30101_FIFO_DEPTH;
+        }
+        return;
+    }
+    s->regs[reg] = value;
+}
+
+/**
+ * @brief Register read with its side effects
+ * @param index - Sensor index
+ * @param reg - Register
+ * @return Value
+ */
+static uint8_t Sim_ReadReg(uint8_t index, uint8_t reg) {
+    Sim_Sensor *s = &sim.sensor[index];
+    uint8_t value;
+    switch (reg) {
+        case INTR_STATUS1:
+            value = s->regs[reg];
+            s->regs[reg] = 0;
+            return value;
+        case FIFO_WRITPTR:
+            return s->wr;
+        case OVRF_COUNTER:
+            return s->ovf;
+        case FIFO_READPTR:
+            return s->rd;
+        case FIFO_DATAREG:
+            value = s->fifo[s->rd][s->byte];
+            if (++s->byte == MAX30101_BYTES_PER_SAMPLE) {
+                s->byte = 0;
+                s->rd = (s->rd + 1u) & 0x1Fu;
+                s->ovf = 0;
+                if (s->level > 0) {
+                    s->level--;
+                    s->stats.samples_read++;
+                }
+            }
+            return value;
+        default:
+            return s->regs[reg];
+    }
+}
+
+/**
+ * @brief Address byte: the mux, or the sensor on the enabled channel
+ * @param ctx - Unused
+ * @param addr - Address (8-bit form)
+ * @param read - Read transfer
+ * @return 1 for ACK
+ */
+static uint8_t Sim_Start(void *ctx, uint8_t addr, uint8_t read) {
+    (void)ctx;
+    sim.target = SIM_TARGET_NONE;
+    if (addr == MUX_ADDR_TCA9548A) {
+        sim.target = SIM_TARGET_MUX;
+    } else if (addr == SENSOR_ADDR) {
+        for (uint8_t i = 0; i < sim.num; i++) {
+            if ((sim.mux_ctrl & (1u << i)) && sim.sensor[i].present) {
+                sim.target = i;
+                break;
+            }
+        }
+    }
+    if (sim.target == SIM_TARGET_NONE) {
+        return 0;
+    }
+    if (sim.target != SIM_TARGET_MUX) {
+        Sim_Update(sim.target);
+        sim.sensor[sim.target].stats.read_bursts += read;
+    }
+    sim.first = !read;
+    sim.written = 0;
+    return 1;
+}
+
+/**
+ * @brief Byte written by the master
+ * @param ctx - Unused
+ * @param data - Byte
+ * @return 1 for ACK
+ */
+static uint8_t Sim_Write(void *ctx, uint8_t data) {
+    (void)ctx;
+    if (sim.target == SIM_TARGET_MUX) {
+        sim.mux_ctrl = data;
+    } else if (sim.first) {
+        sim.sensor[sim.target].ptr = data;
+        sim.sensor[sim.target].byte = 0;
+        sim.first = 0;
+    } else {
+        Sim_Sensor *s = &sim.sensor[sim.target];
+        s->stats.write_bursts += sim.written ? 0u : 1u;
+        s->stats.reg_writes++;
+        sim.written = 1;
+        Sim_WriteReg(sim.target, s->ptr, data);
+        if (s->ptr != FIFO_DATAREG) {
+            s->ptr++;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Byte read by the master
+ * @param ctx - Unused
+ * @return Byte
+ */
+static uint8_t Sim_Read(void *ctx) {
+    (void)ctx;
+    if (sim.target == SIM_TARGET_MUX) {
+        return sim.mux_ctrl;
+    }
+    Sim_Sensor *s = &sim.sensor[sim.target];
+    uint8_t value = Sim_ReadReg(sim.target, s->ptr);
+    if (s->ptr != FIFO_DATAREG) {
+        s->ptr++;
+    }
+    return value;
+}
+
+/**
+ * @brief STOP condition
+ * @param ctx - Unused
+ * @return void
+ */
+static void Sim_Stop(void *ctx) {
+    (void)ctx;
+    sim.target = SIM_TARGET_NONE;
+}
+
+static const HostI2c_Target sim_target = { Sim_Start, Sim_Write, Sim_Read, Sim_Stop };
+
+/**
+ * @brief Reset the device models and connect the mux with its sensors
+ * @param num_sensors - Sensors on mux channels 0..num_sensors-1
+ * @return void
+ */
+void Sim_Init(uint8_t num_sensors) {
+    memset(&sim, 0, sizeof(sim));
+    Host_Reset();
+    sim.num = (num_sensors > ACQ_MAX_SENSORS) ? ACQ_MAX_SENSORS : num_sensors;
+    sim.target = SIM_TARGET_NONE;
+    sim.signal = Sim_DefaultSignal;
+    for (uint8_t i = 0; i < sim.num; i++) {
+        sim.sensor[i].present = 1;
+        Sim_PowerOn(&sim.sensor[i]);
+        sim.handle[i] = (MAX30101_Handle){ i, SENSOR_ADDR, MUX_ADDR_TCA9548A, i };
+    }
+    HostI2c_SetTarget(&sim_target, NULL);
+}
+
+/**
+ * @brief Bring the firmware up as main() does
+ * @return Sensors registered
+ */
+uint8_t Sim_Boot(void) {
+    uint8_t up = 0;
+    clk_config();
+    I2C1_Config();
+    for (uint8_t i = 0; i < sim.num; i++) {
+        uint8_t mismatches;
+        if (MAX30101_InitNIRSLite(&sim.handle[i], &mismatches) == I2C_OK && mismatches == 0u) {
+            sim.active[up++] = sim.handle[i];
+        }
+    }
+    Acquisition_Init(sim.active, up);
+    return up;
+}
+
+/**
+ * @brief Set the optical path of every sensor
+ * @param signal - Signal (NULL: default)
+ * @param ctx - Context passed to the signal
+ * @return void
+ */
+void Sim_SetSignal(Sim_Signal signal, void *ctx) {
+    for (uint8_t i = 0; i < sim.num; i++) {
+        Sim_Update(i);  // Conversions so far used the previous path
+    }
+    sim.signal = signal ? signal : Sim_DefaultSignal;
+    sim.ctx = ctx;
+}
+
+/**
+ * @brief Connect or disconnect a sensor
+ * @param sensor - Sensor index
+ * @param present - 1 to connect
+ * @return void
+ */
+void Sim_SetPresent(uint8_t sensor, uint8_t present) {
+    if (sensor < sim.num) {
+        sim.sensor[sensor].present = present;
+    }
+}
+
+/**
+ * @brief Corrupt the writes to one register of a sensor
+ * @param sensor - Sensor index
+ * @param reg - Register
+ * @param flip - Bits inverted in every value written
+ * @return void
+ */
+void Sim_SetRegisterFault(uint8_t sensor, uint8_t reg, uint8_t flip) {
+    if (sensor < sim.num) {
+        sim.sensor[sensor].flip[reg] = flip;
+    }
+}
+
+/**
+ * @brief Handles of the virtual sensors
+ * @return Handle array
+ */
+const MAX30101_Handle *Sim_Sensors(void) {
+    return sim.handle;
+}
+
+/**
+ * @brief One SysTick period
+ * @return Samples pushed to the acquisition ring
+ */
+uint8_t Sim_Tick(void) {
+    uint64_t start = Host_Cycles();
+    uint8_t pushed = Acquisition_Poll();
+    uint64_t run = Host_Cycles() - start;
+    if (run > sim.poll_max) {
+        sim.poll_max = (uint32_t)run;
+    }
+    Host_AdvanceTo(start + SIM_TICK_CYCLES);
+    return pushed;
+}
+
+/**
+ * @brief Longest Acquisition_Poll() of Sim_Tick()
+ * @return Cycles
+ */
+uint32_t Sim_GetMaxPollCycles(void) {
+    return sim.poll_max;
+}
+
+/**
+ * @brief Activity of a virtual sensor
+ * @param sensor - Sensor index
+ * @return Statistics
+ */
+const Sim_SensorStats *Sim_GetSensorStats(uint8_t sensor) {
+    Sim_Update(sensor);
+    return &sim.sensor[sensor].stats;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file Sim.h
+ * @brief Host simulator: virtual MAX30101 sensors behind a TCA9548A on the I2C1 model
+ * @details Puts up to ACQ_MAX_SENSORS virtual MAX30101 on the channels 0..n-1 of a
+ *          TCA9548A (MUX_ADDR_TCA9548A) and runs the unmodified firmware drivers against
+ *          them on the register models of HostDevice.h.
+ *
+ * ### Sensor Model
+ *  - Register file with auto-incrementing register pointer (not on FIFO_DATA), reset by
+ *    MODE_CONFIG RESET, INTR_STATUS1 cleared on read
+ *  - The ADC converts at the SPO2_CONFIG rate on the virtual time base; 2^SMP_AVE
+ *    conversions are averaged into one 32-sample FIFO entry (Red, IR, 3 bytes each),
+ *    with FIFO_CONFIG roll-over and the overflow counter
+ *  - Photocurrent = Sim_Signal (nA per mA) × LED drive current, quantized to 18 bits of
+ *    the active ADC range and clipped at full scale
+ *  - Proximity mode (PROX_INT_EN set before the mode write): only the IR pilot
+ *    (PILOT_PA) converts and nothing is stored; when the 8 MSBs of the count exceed
+ *    PROX_INT_THRESH the sensor sets PROX_INT and resumes the mode written
+ *  - DIE_TEMPCFG TEMP_EN self-clears MAX30101_TEMP_CONV_MS after the write; the result
+ *    is SIM_DIE_TEMP_C
+ *  - LED charge and conversions are counted per sensor for power estimates, register
+ *    transfers for bus-traffic checks
+ *  - Sim_SetRegisterFault() flips bits of every write to a register (a corrupted
+ *    configuration that read-back verification must catch)
+ *
+ * ### Time
+ *  - Sim_Tick() runs Acquisition_Poll() as SysTick_Handler would and then lets virtual
+ *    time pass to the next 50 Hz tick; the poll duration is measured on the same clock
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see HostDevice.h, HostI2c.h, Acquisition_Poll
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include "arm_math_types.h"
+#include "HostDevice.h"
+#include "MAX30101.h"
+
+#define     SIM_TICK_HZ         50u     /**< SysTick rate of the firmware (SYSTICK_FREQ_HZ) */
+#define     SIM_TICK_CYCLES     (HOST_CORE_HZ / SIM_TICK_HZ) /**< Core cycles per tick */
+#define     SIM_DIE_TEMP_C      30.25f  /**< Die temperature reported by every sensor */
+#define     SIM_IR_NA_PER_MA    100.0f  /**< Default IR signal (nA per mA of LED current) */
+#define     SIM_RED_NA_PER_MA   60.0f   /**< Default Red signal (nA per mA of LED current) */
+#define     SIM_PULSE_HZ        1.2f    /**< Default cardiac pulse frequency */
+#define     SIM_PULSE_DEPTH     0.01f   /**< Default pulsatile fraction of the signal */
+
+/** @brief Optical channels of a sensor */
+typedef enum {
+    SIM_CH_RED = 0,     /**< LED1 */
+    SIM_CH_IR           /**< LED2 (and the proximity pilot) */
+} Sim_Channel;
+
+/**
+ * @brief Optical path of the virtual sensors
+ * @param ctx - Context given to Sim_SetSignal()
+ * @param sensor - Sensor index (mux channel)
+ * @param channel - Sim_Channel
+ * @param t_s - Time of the conversion (s)
+ * @return Photocurrent per mA of LED drive (nA/mA)
+ */
+typedef float32_t (*Sim_Signal)(void *ctx, uint8_t sensor, uint8_t channel, double t_s);
+
+/**
+ * @struct Sim_SensorStats
+ * @brief Activity of one virtual sensor since Sim_Init()
+ */
+typedef struct {
+    uint32_t conversions;       /**< ADC conversions (LED pulses per channel) */
+    uint32_t samples;           /**< Samples stored in the FIFO */
+    uint32_t samples_read;      /**< Samples read out of the FIFO */
+    uint32_t overflows;         /**< Samples lost or overwritten in a full FIFO */
+    uint32_t prox_wakeups;      /**< Proximity threshold crossings */
+    uint32_t write_bursts;      /**< Write transfers that wrote at least one register */
+    uint32_t reg_writes;        /**< Registers written */
+    uint32_t read_bursts;       /**< Read transfers */
+    double led_charge_uc;       /**< LED charge drawn (µC = mA × ms) */
+} Sim_SensorStats;
+
+/**
+ * @brief Reset the device models and connect the mux with its sensors
+ * @param num_sensors - Sensors on mux channels 0..num_sensors-1 (1 to ACQ_MAX_SENSORS)
+ * @return void
+ */
+void Sim_Init(uint8_t num_sensors);
+
+/**
+ * @brief Bring the firmware up as main() does: clock, I2C1, sensor profile, acquisition
+ * @details Only sensors whose profile was written and read back intact are registered
+ *          with Acquisition_Init() (main() retries first).
+ * @return Sensors registered
+ */
+uint8_t Sim_Boot(void);
+
+/**
+ * @brief Set the optical path of every sensor
+ * @param signal - Signal (NULL: default Red/IR with a SIM_PULSE_HZ pulse)
+ * @param ctx - Context passed to the signal
+ * @return void
+ */
+void Sim_SetSignal(Sim_Signal signal, void *ctx);
+
+/**
+ * @brief Connect or disconnect a sensor (a missing sensor NACKs its address)
+ * @param sensor - Sensor index
+ * @param present - 1 to connect
+ * @return void
+ */
+void Sim_SetPresent(uint8_t sensor, uint8_t present);
+
+/**
+ * @brief Corrupt the writes to one register of a sensor
+ * @param sensor - Sensor index
+ * @param reg - Register
+ * @param flip - Bits inverted in every value written (0 = no fault); kept across a reset
+ * @return void
+ */
+void Sim_SetRegisterFault(uint8_t sensor, uint8_t reg, uint8_t flip);
+
+/**
+ * @brief Handles of the virtual sensors (id = mux channel = index)
+ * @return Array of Sim_Init() num_sensors handles
+ */
+const MAX30101_Handle *Sim_Sensors(void);
+
+/**
+ * @brief One SysTick period: Acquisition_Poll(), then virtual time to the next tick
+ * @return Samples pushed to the acquisition ring
+ */
+uint8_t Sim_Tick(void);
+
+/**
+ * @brief Longest Acquisition_Poll() of Sim_Tick()
+ * @return Cycles
+ */
+uint32_t Sim_GetMaxPollCycles(void);
+
+/**
+ * @brief Activity of a virtual sensor, brought up to the current time
+ * @param sensor - Sensor index
+ * @return Statistics
+ */
+const Sim_SensorStats *Sim_GetSensorStats(uint8_t sensor);
+
+/**
+ * @brief Default optical path: SIM_RED/IR_NA_PER_MA with a SIM_PULSE_HZ pulse
+ * @param ctx - Unused
+ * @param sensor - Sensor index (adds a small per-sensor phase)
+ * @param channel - Sim_Channel
+ * @param t_s - Time (s)
+ * @return nA per mA
+ */
+float32_t Sim_DefaultSignal(void *ctx, uint8_t sensor, uint8_t channel, double t_s);
+
+#endif /* SIM_H_ */
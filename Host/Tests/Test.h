@@ -0,0 +1,41 @@
+/**
+ * @file Test.h
+ * @brief Minimal host test checks
+ * @details Each test is one executable registered with CTest: checks print the failing
+ *          expression with its location and count the failure, TEST_EXIT() returns a
+ *          non-zero exit status if any check failed.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <math.h>
+#include <stdio.h>
+
+static int test_failures = 0;   /**< Failed checks in this executable */
+
+/** @brief Check a condition */
+#define TEST_CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+        test_failures++; \
+    } \
+} while (0)
+
+/** @brief Check that two values agree within an absolute tolerance */
+#define TEST_NEAR(a, b, tol) do { \
+    double test_a_ = (double)(a), test_b_ = (double)(b); \
+    if (!(fabs(test_a_ - test_b_) <= (double)(tol))) { \
+        printf("FAIL %s:%d: %s = %.9g, %s = %.9g (tol %g)\n", __FILE__, __LINE__, \
+               #a, test_a_, #b, test_b_, (double)(tol)); \
+        test_failures++; \
+    } \
+} while (0)
+
+/** @brief Exit status of the test executable */
+#define TEST_EXIT() (printf("%s\n", test_failures ? "FAILED" : "PASSED"), test_failures ? 1 : 0)
+
+#endif /* TEST_H_ */
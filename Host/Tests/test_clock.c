@@ -0,0 +1,161 @@
+/**
+ * @file test_clock.c
+ * @brief Clock_I2CTiming() against the RM0316 I2C timing limits, Clock_UsartDivider() baud error
+ * @details For kernel clocks of 8 to 72 MHz and the Standard, Fast and Fast-mode Plus
+ *          rates, the TIMINGR fields are decoded and checked against the I2C-bus limits
+ *          (RM0316 §28.4.9, analog filter on, no digital filter):
+ *          - tLOW, tHIGH ≥ their minimum
+ *          - tSU;DAT: (SCLDEL + 1)·tPRESC ≥ tr + tSU;DAT(min)
+ *          - tHD;DAT: SDADEL·tPRESC ≥ tf − tAF(min) − 3·tI2CCLK and, where the analog filter
+ *            spread leaves room, ≤ tHD;DAT(max) − tr − tAF(max) − 4·tI2CCLK
+ *          - SCL period with the spec rise/fall times not shorter than the target, and no
+ *            longer than the target or the minimum phases require (plus rounding); at
+ *            low kernel clocks the synchronization delay alone keeps Fm+ below 1 MHz
+ *
+ *          Every USART divider must be the nearest one available (½ LSB with oversampling
+ *          by 16, 1 LSB by 8, where BRR[3] stays clear). The boot values are checked on the
+ *          simulator: TIMINGR 0x10C71329 (64 MHz, 400 kHz) and BRR 0x8B (64 MHz, 460800).
+ *          Bus recovery must reload the TIMINGR of the last I2C1_Config(), not recompute it
+ *          from a clock tree that changed since.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <math.h>
+#include "HostI2c.h"
+#include "I2C.h"
+#include "PLL.h"
+#include "Sim.h"
+#include "UART.h"
+#include "Test.h"
+
+#define TAF_MIN_NS      50.0    /**< Analog filter delay, minimum */
+#define TAF_MAX_NS      260.0   /**< Analog filter delay, maximum */
+
+/**
+ * @struct BusMode
+ * @brief I2C-bus specification limits of one mode (ns)
+ */
+typedef struct {
+    uint32_t scl_hz;
+    double t_low, t_high, t_su_dat, t_hd_dat_max, t_r, t_f;
+} BusMode;
+
+static const BusMode modes[] = {
+    {  100000u, 4700.0, 4000.0, 250.0, 3450.0, 1000.0, 300.0 },
+    {  400000u, 1300.0,  600.0, 100.0,  900.0,  300.0, 300.0 },
+    { 1000000u,  500.0,  260.0,  50.0,  450.0,  120.0, 120.0 },
+};
+
+static const uint32_t kernel_hz[] = { 8000000u, 16000000u, 24000000u, 32000000u, 48000000u, 64000000u, 72000000u };
+
+static const uint32_t bauds[] = { 9600u, 19200u, 57600u, 115200u, 230400u, 460800u, 921600u, 2000000u, 4000000u };
+
+/**
+ * @brief Check one TIMINGR value against the bus limits
+ * @param clk - Kernel clock (Hz)
+ * @param m - [in] Mode
+ * @param v - TIMINGR
+ * @return SCL frequency with the spec rise/fall times (Hz)
+ */
+static double CheckTiming(uint32_t clk, const BusMode *m, uint32_t v) {
+    double t_clk = 1e9 / clk;
+    double t_presc = ((v >> 28) + 1u) * t_clk;
+    uint32_t scldel = (v >> 20) & 0xFu, sdadel = (v >> 16) & 0xFu;
+    uint32_t sclh = (v >> 8) & 0xFFu, scll = v & 0xFFu;
+
+    TEST_CHECK((v & 0x0F000000u) == 0);
+    TEST_CHECK((scll + 1u) * t_presc >= m->t_low);
+    TEST_CHECK((sclh + 1u) * t_presc >= m->t_high);
+    TEST_CHECK((scldel + 1u) * t_presc >= m->t_r + m->t_su_dat);
+    TEST_CHECK(sdadel * t_presc >= m->t_f - TAF_MIN_NS - 3.0 * t_clk - 1e-9);
+    double sdadel_max = m->t_hd_dat_max - m->t_r - TAF_MAX_NS - 4.0 * t_clk;
+    if (sdadel_max >= m->t_f - TAF_MIN_NS - 3.0 * t_clk) {
+        TEST_CHECK(sdadel * t_presc <= sdadel_max + 1e-9);
+    }
+    double t_sync = m->t_f + m->t_r + 2.0 * TAF_MIN_NS + 4.0 * t_clk;
+    double t_scl = (scll + 1u + sclh + 1u) * t_presc + t_sync;
+    TEST_CHECK(t_scl >= 1e9 / m->scl_hz - 1e-6);
+    // No slower than the target period or the minimum phases force, within the rounding of both phases
+    double t_need = fmax(1e9 / m->scl_hz, m->t_low + m->t_high + t_sync);
+    TEST_CHECK(t_scl <= t_need + 2.0 * t_presc);
+    return 1e9 / t_scl;
+}
+
+int main(void) {
+    // I2C timing over kernel clocks and modes
+    for (uint32_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        printf("i2c %4u kHz:", (unsigned)(modes[i].scl_hz / 1000u));
+        for (uint32_t k = 0; k < sizeof(kernel_hz) / sizeof(kernel_hz[0]); k++) {
+            uint32_t v = Clock_I2CTiming(kernel_hz[k], modes[i].scl_hz);
+            TEST_CHECK(v != 0u);
+            double f = CheckTiming(kernel_hz[k], &modes[i], v);
+            printf("  %2u MHz %5.1f", (unsigned)(kernel_hz[k] / 1000000u), f / 1000.0);
+        }
+        printf(" kHz\n");
+    }
+    TEST_CHECK(Clock_I2CTiming(64000000u, 400000u) == 0x10C71329u);
+    TEST_CHECK(Clock_I2CTiming(64000000u, 0u) == 0u);
+    TEST_CHECK(Clock_I2CTiming(64000000u, 2000000u) == 0u);
+
+    // USART dividers: nearest available divider, or 0 above f_ck / 8
+    double worst = 0.0;
+    for (uint32_t k = 0; k < sizeof(kernel_hz) / sizeof(kernel_hz[0]); k++) {
+        for (uint32_t b = 0; b < sizeof(bauds) / sizeof(bauds[0]); b++) {
+            uint32_t clk = kernel_hz[k], baud = bauds[b];
+            uint8_t over8 = 0xFF;
+            uint32_t brr = Clock_UsartDivider(clk, baud, &over8);
+            if (baud * 8ull > clk + baud / 2u) {
+                TEST_CHECK(brr == 0u);
+                continue;
+            }
+            TEST_CHECK(brr != 0u && over8 <= 1u);
+            double exact, div;
+            if (over8) {
+                TEST_CHECK((brr & 0x8u) == 0);
+                div = (double)((brr & 0xFFF0u) | ((brr & 0x7u) << 1));
+                exact = 2.0 * clk / baud;
+                TEST_CHECK(fabs(div - exact) <= 1.0);
+                TEST_CHECK(baud * 16ull > clk + baud / 2u);     // OVER8 only where OVER16 cannot reach
+            } else {
+                div = (double)brr;
+                exact = (double)clk / baud;
+                TEST_CHECK(fabs(div - exact) <= 0.5);
+            }
+            double err = exact / div - 1.0;
+            if (clk == 64000000u && baud <= 921600u) {
+                worst = (fabs(err) > fabs(worst)) ? err : worst;
+            }
+        }
+    }
+    uint8_t over8 = 0xFF;
+    uint32_t brr = Clock_UsartDivider(64000000u, 460800u, &over8);
+    printf("usart: 64 MHz 460800 baud BRR 0x%X (%+.2f %%), worst %+.2f %% up to 921600 baud\n",
+           (unsigned)brr, 100.0 * (64000000.0 / brr / 460800.0 - 1.0), 100.0 * worst);
+    TEST_CHECK(brr == 0x8Bu && over8 == 0);
+    TEST_CHECK(fabs(worst) < 0.01);
+
+    // Boot values on the simulator
+    Sim_Init(1);
+    Sim_Boot();
+    UART_Config(460800u);
+    TEST_CHECK(I2C1->TIMINGR == 0x10C71329u);
+    TEST_CHECK(USART2->BRR == 0x8Bu && !(USART2->CR1 & USART_CR1_OVER8));
+
+    // Recovery reloads the configured TIMINGR: halve the PLL behind its back, then fail a transfer
+    uint8_t buf[3];
+    uint32_t cfgr = RCC->CFGR;
+    RCC->CFGR = (cfgr & ~RCC_CFGR_PLLMUL) | ((8u - 2u) << RCC_CFGR_PLLMUL_Pos);
+    HostI2c_InjectFault(HOSTI2C_FAULT_BERR, 3, 0);
+    TEST_CHECK(I2C1_Read(SENSOR_ADDR, FIFO_WRITPTR, buf, sizeof(buf)) == I2C_ERR_BERR);
+    TEST_CHECK(HostI2c_GetStats()->pe_resets >= 1u);
+    TEST_CHECK(I2C1->TIMINGR == 0x10C71329u);
+    // An explicit I2C1_Config() follows the clock change
+    I2C1_Config();
+    TEST_CHECK(I2C1->TIMINGR == Clock_I2CTiming(32000000u, I2C1_SPEED_HZ));
+    RCC->CFGR = cfgr;
+    I2C1_Config();
+    TEST_CHECK(I2C1->TIMINGR == 0x10C71329u);
+    return TEST_EXIT();
+}
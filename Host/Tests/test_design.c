@@ -0,0 +1,220 @@
+/**
+ * @file test_design.c
+ * @brief Design_Filter() cascades against the analytic Butterworth / Chebyshev II responses
+ * @details The magnitude of every generated SOS cascade (single-precision coefficients,
+ *          evaluated in double) is compared on a dense grid with the exact response of the
+ *          bilinear design, Ω = tan(πf/fs) / tan(πf1/fs) for low-pass, its inverse for
+ *          high-pass and (w² − w1·w2) / (w·(w2 − w1)) for band-pass:
+ *          - Butterworth A(Ω) = 10·log10(1 + Ω^2N): passband within DESIGN_PASS_TOL_DB,
+ *            −3.01 dB at the edges, stopband at least the exact attenuation (up to
+ *            DESIGN_FLOOR_DB, the single-precision floor)
+ *          - Chebyshev II A(Ω) = 10·log10(1 + 1 / (ε²·T_N²(1/Ω))), ε² = 1 / (10^(As/10) − 1):
+ *            passband within DESIGN_PASS_TOL_DB and stop_db reached everywhere beyond the
+ *            stopband edges
+ *          - unit gain at the passband reference (DC, Nyquist, band centre)
+ *
+ *          Orders 1 to DESIGN_MAX_ORDER, edges up to 0.4·fs, the two firmware designs
+ *          (order 4, 0.04 Hz, 80 dB at 50 and 12.5 Hz) and invalid specifications. Low-pass
+ *          and band-pass edges start at 0.01·fs: below that, their poles and zeros crowd
+ *          z = 1 so closely that rounding the coefficients to single precision alone moves
+ *          the gain by more than 0.1 % (the exact design rounded to float does no better).
+ *          High-pass edges go down to 0.002·fs, where the gain reference is Nyquist.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <complex.h>
+#include <math.h>
+#include "FilterDesign.h"
+#include "Test.h"
+
+#define DESIGN_GRID         4000u   /**< Frequencies per design (log-spaced up to Nyquist) */
+#define DESIGN_PASS_TOL_DB  0.01    /**< Passband deviation from the exact response */
+#define DESIGN_STOP_TOL_DB  0.1     /**< Stopband shortfall tolerated */
+#define DESIGN_FLOOR_DB     90.0    /**< Attenuation beyond which single precision is not checked */
+
+static uint32_t designs = 0;        /**< Designs checked */
+static double worst_pass = 0.0;     /**< Largest passband deviation (dB) */
+static double worst_stop = 1e9;     /**< Smallest stopband margin over the required attenuation (dB) */
+
+/**
+ * @brief Magnitude of a CMSIS DF2T cascade
+ * @param c - [in] {b0, b1, b2, a1, a2} per section, feedback negated
+ * @param n - Sections
+ * @param f - Normalized frequency (cycles/sample)
+ * @return |H|
+ */
+static double Magnitude(const float32_t *c, uint8_t n, double f) {
+    double complex z1 = cexp(-2.0 * M_PI * I * f);
+    double complex h = 1.0;
+    for (uint8_t s = 0; s < n; s++, c += 5) {
+        double complex num = c[0] + c[1] * z1 + c[2] * z1 * z1;
+        double complex den = 1.0 - c[3] * z1 - c[4] * z1 * z1;
+        h *= num / den;
+    }
+    return cabs(h);
+}
+
+/**
+ * @brief Chebyshev polynomial T_N(x)
+ */
+static double Cheb(uint8_t n, double x) {
+    x = fabs(x);
+    return (x <= 1.0) ? cos(n * acos(x)) : cosh(n * acosh(x));
+}
+
+/**
+ * @brief Prototype frequency of a design frequency
+ * @param spec - [in] Specification
+ * @param fs - Sample rate (Hz)
+ * @param f - Frequency (Hz)
+ * @return |Ω| (1 at the edges)
+ */
+static double Omega(const Design_Spec *spec, double fs, double f) {
+    double w = tan(M_PI * f / fs);
+    double w1 = tan(M_PI * spec->f1_hz / fs);
+    double w2 = tan(M_PI * spec->f2_hz / fs);
+    switch (spec->type) {
+    case DESIGN_LOWPASS:
+        return w / w1;
+    case DESIGN_HIGHPASS:
+        return w1 / w;
+    default:
+        return fabs((w * w - w1 * w2) / (w * (w2 - w1)));
+    }
+}
+
+/**
+ * @brief Exact attenuation of the bilinear design
+ * @param spec - [in] Specification
+ * @param omega - |Ω|
+ * @return Attenuation (dB, ≥ 0)
+ */
+static double Exact(const Design_Spec *spec, double omega) {
+    if (spec->family == DESIGN_BUTTERWORTH) {
+        return 10.0 * log10(1.0 + pow(omega, 2.0 * spec->order));
+    }
+    double eps2 = 1.0 / (pow(10.0, spec->stop_db / 10.0) - 1.0);
+    double t = Cheb(spec->order, 1.0 / omega);
+    return 10.0 * log10(1.0 + 1.0 / (eps2 * t * t));
+}
+
+/**
+ * @brief Design one specification and compare it with the exact response
+ * @param spec - [in] Specification
+ * @param fs - Sample rate (Hz)
+ * @return void
+ */
+static void Check(const Design_Spec *spec, double fs) {
+    float32_t c[5 * DESIGN_MAX_ORDER];
+    uint8_t n = Design_Filter(spec, (float32_t)fs, c, DESIGN_MAX_ORDER);
+    TEST_CHECK(n == Design_Sections(spec));
+    if (n == 0) {
+        return;
+    }
+    designs++;
+    double pass = 0.0, stop = 1e9;
+
+    // Unit gain at the passband reference
+    double f_ref = 0.0;
+    if (spec->type == DESIGN_HIGHPASS) {
+        f_ref = 0.5;
+    } else if (spec->type == DESIGN_BANDPASS) {
+        f_ref = atan(sqrt(tan(M_PI * spec->f1_hz / fs) * tan(M_PI * spec->f2_hz / fs))) / M_PI;
+    }
+    TEST_NEAR(Magnitude(c, n, f_ref), 1.0, 1e-3);
+
+    // Butterworth edges at -3.01 dB
+    if (spec->family == DESIGN_BUTTERWORTH) {
+        TEST_NEAR(-20.0 * log10(Magnitude(c, n, spec->f1_hz / fs)), 10.0 * log10(2.0), DESIGN_PASS_TOL_DB);
+        if (spec->type == DESIGN_BANDPASS) {
+            TEST_NEAR(-20.0 * log10(Magnitude(c, n, spec->f2_hz / fs)), 10.0 * log10(2.0), DESIGN_PASS_TOL_DB);
+        }
+    }
+
+    // Log-spaced grid from 1e-4·fs to just below Nyquist, plus the edges themselves
+    for (uint32_t k = 0; k <= DESIGN_GRID + 2u; k++) {
+        double f;
+        if (k < DESIGN_GRID) {
+            f = 1e-4 * pow(0.4999 / 1e-4, (double)k / (DESIGN_GRID - 1u)) * fs;
+        } else {
+            f = (k == DESIGN_GRID) ? spec->f1_hz : ((spec->type == DESIGN_BANDPASS) ? spec->f2_hz : spec->f1_hz);
+        }
+        double omega = Omega(spec, fs, f);
+        double exact = Exact(spec, omega);
+        double att = -20.0 * log10(Magnitude(c, n, f / fs));
+        if (spec->family == DESIGN_CHEBY2 && omega >= 1.0 - 1e-9) {
+            // Stopband: the specified attenuation everywhere
+            stop = fmin(stop, att - spec->stop_db);
+        } else if (exact <= 3.0103) {
+            pass = fmax(pass, fabs(att - exact));
+        } else {
+            stop = fmin(stop, att - fmin(exact, DESIGN_FLOOR_DB));
+        }
+    }
+    if (pass > DESIGN_PASS_TOL_DB || stop < -DESIGN_STOP_TOL_DB) {
+        printf("design: family %d type %d order %u f1 %g f2 %g fs %g: passband %.3g dB, stopband margin %.3g dB\n",
+               spec->family, spec->type, spec->order, (double)spec->f1_hz, (double)spec->f2_hz, fs, pass, stop);
+    }
+    TEST_CHECK(pass <= DESIGN_PASS_TOL_DB);
+    TEST_CHECK(stop >= -DESIGN_STOP_TOL_DB);
+    worst_pass = fmax(worst_pass, pass);
+    worst_stop = fmin(worst_stop, stop);
+}
+
+int main(void) {
+    static const double rel[] = { 0.002, 0.01, 0.05, 0.1, 0.25, 0.4 };
+    static const double fs[] = { 12.5, 50.0, 400.0 };
+    static const float32_t stop_db[] = { 40.0f, 60.0f, 80.0f };
+
+    for (uint32_t r = 0; r < sizeof(fs) / sizeof(fs[0]); r++) {
+        for (uint8_t order = 1; order <= DESIGN_MAX_ORDER; order++) {
+            for (uint32_t e = 0; e < sizeof(rel) / sizeof(rel[0]); e++) {
+                for (int type = DESIGN_LOWPASS; type <= DESIGN_BANDPASS; type++) {
+                    Design_Spec spec = { DESIGN_BUTTERWORTH, (Design_Type)type, order, (float32_t)(rel[e] * fs[r]),
+                                         (float32_t)(1.5 * rel[e] * fs[r]), 0.0f };
+                    if ((type == DESIGN_BANDPASS && 1.5 * rel[e] >= 0.5) || (type != DESIGN_HIGHPASS && rel[e] < 0.01)) {
+                        continue;
+                    }
+                    Check(&spec, fs[r]);
+                    spec.family = DESIGN_CHEBY2;
+                    spec.stop_db = stop_db[(order + e) % 3u];
+                    Check(&spec, fs[r]);
+                }
+            }
+        }
+    }
+
+    // The firmware high-pass at the full and the reduced adaptive rate
+    const Design_Spec fw = { DESIGN_CHEBY2, DESIGN_HIGHPASS, 4, 0.04f, 0.0f, 80.0f };
+    Check(&fw, 50.0);
+    Check(&fw, 12.5);
+    float32_t c[5 * DESIGN_MAX_ORDER];
+    TEST_CHECK(Design_Filter(&fw, 50.0f, c, DESIGN_MAX_ORDER) == 2u);
+    printf("firmware high-pass at 50 Hz: %.1f dB at 0.02 Hz, %.2f dB at 0.2 Hz, %.4f dB at 1.2 Hz\n",
+           -20.0 * log10(Magnitude(c, 2, 0.02 / 50.0)), -20.0 * log10(Magnitude(c, 2, 0.2 / 50.0)),
+           -20.0 * log10(Magnitude(c, 2, 1.2 / 50.0)));
+    TEST_CHECK(-20.0 * log10(Magnitude(c, 2, 0.02 / 50.0)) >= 80.0 - DESIGN_STOP_TOL_DB);
+    TEST_CHECK(fabs(20.0 * log10(Magnitude(c, 2, 1.2 / 50.0))) < 0.01);
+
+    // Invalid specifications
+    Design_Spec bad = fw;
+    bad.f1_hz = 25.0f;
+    TEST_CHECK(Design_Filter(&bad, 50.0f, c, DESIGN_MAX_ORDER) == 0);
+    bad.f1_hz = 0.0f;
+    TEST_CHECK(Design_Filter(&bad, 50.0f, c, DESIGN_MAX_ORDER) == 0);
+    bad = fw;
+    bad.order = DESIGN_MAX_ORDER + 1u;
+    TEST_CHECK(Design_Filter(&bad, 50.0f, c, DESIGN_MAX_ORDER) == 0);
+    bad = fw;
+    bad.type = DESIGN_BANDPASS;
+    bad.f2_hz = 0.03f;
+    TEST_CHECK(Design_Filter(&bad, 50.0f, c, DESIGN_MAX_ORDER) == 0);
+    bad = fw;
+    TEST_CHECK(Design_Filter(&bad, 50.0f, c, 1) == 0);
+
+    printf("design: %u designs, worst passband deviation %.4f dB, worst stopband margin %+.2f dB\n",
+           (unsigned)designs, worst_pass, worst_stop);
+    return TEST_EXIT();
+}
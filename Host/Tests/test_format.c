@@ -0,0 +1,176 @@
+/**
+ * @file test_format.c
+ * @brief Fmt_Fixed4() against snprintf("%.4f") and throughput comparison
+ * @details Bit-compatibility on:
+ *          - exact ties k/32 (odd k), which round to even on the fourth decimal
+ *          - the neighbours of every decimal rounding boundary of 0..10 (±1 ulp)
+ *          - small negatives that print "-0.0000", zeros and subnormals
+ *          - large magnitudes up to FLT_MAX (the multi-word path above 2^23)
+ *          - a stride over all 2^32 bit patterns and random values
+ *
+ *          NaN is printed "nan" whatever its sign (newlib); glibc prints "-nan" for a
+ *          negative NaN, so only positive NaN is compared.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Format.h"
+#include "Test.h"
+
+#define STRIDE          4099u       /**< Bit-pattern stride over the whole float space (prime) */
+#define RANDOM_VALUES   1000000u
+#define BENCH_VALUES    4096u
+#define BENCH_ROUNDS    200u
+
+static uint32_t checked = 0;    /**< Values compared */
+static uint32_t mismatches = 0; /**< Values that differed */
+
+/**
+ * @brief Compare one value with snprintf
+ * @param x - Value
+ * @return void
+ */
+static void Check(float32_t x) {
+    char ref[64];
+    char out[FMT_FIXED4_MAX_CHARS + 1];
+    int n = snprintf(ref, sizeof(ref), "%.4f", (double)x);
+    char *end = Fmt_Fixed4(out, x);
+    *end = '\0';
+    checked++;
+    if ((int)(end - out) != n || strcmp(out, ref) != 0) {
+        if (mismatches++ < 10) {
+            uint32_t bits;
+            memcpy(&bits, &x, sizeof(bits));
+            printf("mismatch: bits 0x%08x: Fmt_Fixed4 \"%s\", snprintf \"%s\"\n", (unsigned)bits, out, ref);
+        }
+    }
+}
+
+/**
+ * @brief Fmt_Fixed4() as a string
+ * @param x - Value
+ * @return NUL-terminated text (static buffer)
+ */
+static const char *Fixed4(float32_t x) {
+    static char buf[FMT_FIXED4_MAX_CHARS + 1];
+    *Fmt_Fixed4(buf, x) = '\0';
+    return buf;
+}
+
+/**
+ * @brief Compare a bit pattern (positive NaN only)
+ * @param bits - IEEE-754 single
+ * @return void
+ */
+static void CheckBits(uint32_t bits) {
+    float32_t x;
+    memcpy(&x, &bits, sizeof(x));
+    if (isnan(x) && (bits >> 31)) {
+        return;
+    }
+    Check(x);
+}
+
+/**
+ * @brief Seconds of a monotonic clock
+ * @return Time (s)
+ */
+static double Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+int main(void) {
+    // Exact ties: k/32 with odd k has a 5 in the fifth decimal and nothing after it
+    for (uint32_t k = 1; k < 32u * 4096u; k += 2) {
+        Check((float32_t)k / 32.0f);
+        Check(-(float32_t)k / 32.0f);
+    }
+    TEST_CHECK(strcmp(Fixed4(0.03125f), "0.0312") == 0);
+    TEST_CHECK(strcmp(Fixed4(0.09375f), "0.0938") == 0);
+
+    // Neighbours of the decimal rounding boundaries (n + 0.5) / 10^4
+    for (uint32_t n = 0; n < 100000u; n++) {
+        float32_t b = (float32_t)((n + 0.5) / 10000.0);
+        Check(b);
+        Check(nextafterf(b, 0.0f));
+        Check(nextafterf(b, INFINITY));
+        Check(-b);
+    }
+
+    // Zeros, "-0.0000" and subnormals
+    static const float32_t small[] = {
+        0.0f, -0.0f, 1e-5f, -1e-5f, 4.9999e-5f, -4.9999e-5f, 5e-5f, -5e-5f, 5.0001e-5f, -5.0001e-5f,
+        1e-30f, -1e-30f, FLT_MIN, -FLT_MIN, 1e-45f, -1e-45f, FLT_TRUE_MIN, -FLT_TRUE_MIN
+    };
+    for (uint32_t i = 0; i < sizeof(small) / sizeof(small[0]); i++) {
+        Check(small[i]);
+    }
+    TEST_CHECK(strcmp(Fixed4(-1e-5f), "-0.0000") == 0);
+    TEST_CHECK(strcmp(Fixed4(-0.0f), "-0.0000") == 0);
+
+    // Large magnitudes: every power of two from 2^20 up and its neighbours, FLT_MAX, inf
+    for (int e = 20; e < 128; e++) {
+        float32_t v = ldexpf(1.0f, e);
+        Check(v);
+        Check(-v);
+        Check(nextafterf(v, 0.0f));
+        Check(nextafterf(v, INFINITY));
+    }
+    Check(FLT_MAX);
+    Check(-FLT_MAX);
+    Check(INFINITY);
+    Check(-INFINITY);
+    Check(NAN);
+
+    // Whole bit-pattern space at a prime stride, then random bit patterns
+    for (uint64_t bits = 0; bits <= 0xFFFFFFFFull; bits += STRIDE) {
+        CheckBits((uint32_t)bits);
+    }
+    srand(12345);
+    for (uint32_t i = 0; i < RANDOM_VALUES; i++) {
+        CheckBits(((uint32_t)rand() << 16) ^ (uint32_t)rand());
+    }
+    printf("format: %u values compared with snprintf(\"%%.4f\"), %u mismatches\n",
+           (unsigned)checked, (unsigned)mismatches);
+    TEST_CHECK(mismatches == 0);
+
+    // Throughput on values of the data stream (currents of a few hundred to a few thousand nA)
+    static float32_t values[BENCH_VALUES];
+    static char sink[BENCH_VALUES * 16];
+    for (uint32_t i = 0; i < BENCH_VALUES; i++) {
+        values[i] = 500.0f + 3000.0f * (float32_t)rand() / (float32_t)RAND_MAX;
+    }
+    size_t bytes_fmt = 0, bytes_printf = 0;
+    double t0 = Now();
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+        char *p = sink;
+        for (uint32_t i = 0; i < BENCH_VALUES; i++) {
+            p = Fmt_Fixed4(p, values[i]);
+        }
+        bytes_fmt += (size_t)(p - sink);
+    }
+    double t1 = Now();
+    for (uint32_t r = 0; r < BENCH_ROUNDS; r++) {
+        char *p = sink;
+        for (uint32_t i = 0; i < BENCH_VALUES; i++) {
+            p += snprintf(p, 16, "%.4f", (double)values[i]);
+        }
+        bytes_printf += (size_t)(p - sink);
+    }
+    double t2 = Now();
+    double n = (double)BENCH_VALUES * BENCH_ROUNDS;
+    printf("format: Fmt_Fixed4 %.1f ns/value (%.1f M/s), snprintf %.1f ns/value (%.1f M/s), %.1fx\n",
+           1e9 * (t1 - t0) / n, n / (t1 - t0) / 1e6, 1e9 * (t2 - t1) / n, n / (t2 - t1) / 1e6,
+           (t2 - t1) / (t1 - t0));
+    TEST_CHECK(bytes_fmt == bytes_printf);
+    return TEST_EXIT();
+}
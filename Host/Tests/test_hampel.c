@@ -0,0 +1,202 @@
+/**
+ * @file test_hampel.c
+ * @brief Rolling Hampel filter against a naive median/MAD reference, and their cost
+ * @details The reference sorts the centred window, then the absolute deviations, for every
+ *          sample (the hampel_naive benchmark kernel), on the same left-padded stream.
+ *          - Equivalence: random data (a pulse on a random walk, quantized to the ADC step
+ *            so values tie, flat stretches where the MAD is 0, single spikes and spike
+ *            pairs) through every window from 3 to 31, plus even and out-of-range windows,
+ *            at two thresholds, fed in blocks of 1 to 8 samples. Every output and the
+ *            replaced count must be bit-identical
+ *          - Cost: HAMPEL_TEST_BENCH_N samples through both for windows 5, 9, 15 and 31,
+ *            best of three runs (CLOCK_MONOTONIC); ns per sample and the ratio are printed,
+ *            not checked, since the host load varies
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Hampel.h"
+#include "Test.h"
+
+#define HAMPEL_TEST_N           20000u
+#define HAMPEL_TEST_BENCH_N     200000u
+#define HAMPEL_TEST_LSB         0.0625f     /**< ADC step (nA) */
+
+static float32_t input[HAMPEL_TEST_BENCH_N];
+static float32_t fast[HAMPEL_TEST_BENCH_N];
+static float32_t naive[HAMPEL_TEST_BENCH_N];
+
+/**
+ * @brief Uniform random number in [0, 1)
+ */
+static double Uniform(void) {
+    return rand() / ((double)RAND_MAX + 1.0);
+}
+
+/**
+ * @brief Insertion sort (ascending)
+ */
+static void Sort(float32_t *v, uint32_t n) {
+    for (uint32_t i = 1; i < n; i++) {
+        float32_t t = v[i];
+        uint32_t j = i;
+        while (j > 0u && v[j - 1u] > t) {
+            v[j] = v[j - 1u];
+            j--;
+        }
+        v[j] = t;
+    }
+}
+
+/**
+ * @brief Reference: sort the window and the deviations for every sample
+ * @param x - [in] Samples
+ * @param y - [out] Output, delayed by window / 2 like Hampel_Process()
+ * @param n - Number of samples
+ * @param window - Odd window length
+ * @param threshold - Threshold in robust standard deviations
+ * @return Number of samples replaced
+ */
+static uint32_t Naive(const float32_t *x, float32_t *y, uint32_t n, uint8_t window, float32_t threshold) {
+    const uint32_t h = window / 2u;
+    const float32_t limit = threshold * HAMPEL_MAD_SCALE;
+    float32_t win[HAMPEL_MAX_WINDOW], tmp[HAMPEL_MAX_WINDOW];
+    uint32_t replaced = 0;
+    for (uint32_t k = 0; k < window; k++) {
+        win[k] = x[0];      // Left padding: the first sample before the start
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint32_t k = 0; k + 1u < window; k++) {
+            win[k] = win[k + 1u];
+        }
+        win[window - 1u] = x[i];
+        if (i < h) {
+            y[i] = x[0];    // Padding still leaving the window
+            continue;
+        }
+        memcpy(tmp, win, window * sizeof(float32_t));
+        Sort(tmp, window);
+        float32_t med = tmp[h];
+        for (uint32_t k = 0; k < window; k++) {
+            float32_t d = win[k] - med;
+            tmp[k] = (d < 0.0f) ? -d : d;
+        }
+        Sort(tmp, window);
+        float32_t c = win[h];
+        float32_t dev = (c < med) ? med - c : c - med;
+        if (tmp[h] > 0.0f && dev > limit * tmp[h]) {
+            c = med;
+            replaced++;
+        }
+        y[i] = c;
+    }
+    return replaced;
+}
+
+/**
+ * @brief Monotonic time (ns)
+ */
+static double Ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Pulse on a random walk, quantized, with flat stretches and spikes
+ * @param spikes - [out] Spikes injected
+ */
+static void Generate(uint32_t n, uint32_t *spikes) {
+    double walk = 2000.0;
+    *spikes = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        walk += 0.05 * (Uniform() - 0.5);
+        double v = walk + 20.0 * sin(2.0 * M_PI * i / 50.0) + 0.3 * (Uniform() - 0.5);
+        if ((i / 500u) % 20u == 7u) {
+            v = 1500.0;     // Clipped / flat stretch: MAD 0
+        }
+        input[i] = HAMPEL_TEST_LSB * (float32_t)floor(v / HAMPEL_TEST_LSB);
+        if (Uniform() < 0.002) {
+            float32_t spike = (float32_t)((Uniform() < 0.5 ? -1.0 : 1.0) * (50.0 + 500.0 * Uniform()));
+            input[i] += spike;
+            (*spikes)++;
+            if (i + 1u < n && Uniform() < 0.25) {
+                input[++i] = (float32_t)walk + spike;   // A pair
+                (*spikes)++;
+            }
+        }
+    }
+}
+
+int main(void) {
+    static Hampel_Filter hf;
+    uint32_t spikes;
+
+    srand(2026);
+    Generate(HAMPEL_TEST_N, &spikes);
+
+    // Equivalence, streamed in random block sizes
+    static const uint8_t extra[] = { 0, 1, 4, 16, 40 };     // Clamped / rounded up to odd
+    static const float32_t thresholds[] = { 3.0f, 2.0f };
+    uint32_t configs = 0, mismatches = 0;
+    for (uint32_t t = 0; t < 2u; t++) {
+        for (uint32_t w = 0; w < (HAMPEL_MAX_WINDOW - 1u) / 2u + sizeof(extra); w++) {
+            uint8_t req = (w < sizeof(extra)) ? extra[w] : (uint8_t)(HAMPEL_MIN_WINDOW + 2u * (w - sizeof(extra)));
+            Hampel_Init(&hf, req, thresholds[t]);
+            uint8_t window = hf.window;
+            TEST_CHECK((window & 1u) && window >= HAMPEL_MIN_WINDOW && window <= HAMPEL_MAX_WINDOW);
+            memcpy(fast, input, HAMPEL_TEST_N * sizeof(float32_t));
+            uint32_t got = 0;
+            for (uint32_t i = 0; i < HAMPEL_TEST_N;) {
+                uint32_t n = 1u + (uint32_t)rand() % 8u;
+                n = (n > HAMPEL_TEST_N - i) ? HAMPEL_TEST_N - i : n;
+                got += Hampel_Process(&hf, &fast[i], n);
+                i += n;
+            }
+            uint32_t want = Naive(input, naive, HAMPEL_TEST_N, window, thresholds[t]);
+            uint32_t diff = 0;
+            for (uint32_t i = 0; i < HAMPEL_TEST_N; i++) {
+                diff += (memcmp(&fast[i], &naive[i], sizeof(float32_t)) != 0) ? 1u : 0u;
+            }
+            if (diff > 0u || got != want) {
+                printf("hampel: window %u threshold %.0f: %u outputs differ, replaced %u vs %u\n", window,
+                       (double)thresholds[t], (unsigned)diff, (unsigned)got, (unsigned)want);
+            }
+            mismatches += diff + ((got != want) ? 1u : 0u);
+            TEST_CHECK(got == want && got > 0u);
+            configs++;
+        }
+    }
+    printf("hampel: %u configurations x %u samples (%u spikes) identical to the reference\n",
+           (unsigned)configs, (unsigned)HAMPEL_TEST_N, (unsigned)spikes);
+    TEST_CHECK(mismatches == 0);
+
+    // Cost: best of three runs per window
+    Generate(HAMPEL_TEST_BENCH_N, &spikes);
+    static const uint8_t bench_windows[] = { 5, 9, 15, 31 };
+    for (uint32_t w = 0; w < sizeof(bench_windows); w++) {
+        double best_fast = INFINITY, best_naive = INFINITY;
+        for (uint32_t run = 0; run < 3u; run++) {
+            memcpy(fast, input, sizeof(fast));
+            Hampel_Init(&hf, bench_windows[w], 3.0f);
+            double t0 = Ns();
+            for (uint32_t i = 0; i < HAMPEL_TEST_BENCH_N; i += 8u) {
+                Hampel_Process(&hf, &fast[i], 8);
+            }
+            double t1 = Ns();
+            Naive(input, naive, HAMPEL_TEST_BENCH_N, bench_windows[w], 3.0f);
+            double t2 = Ns();
+            best_fast = fmin(best_fast, t1 - t0);
+            best_naive = fmin(best_naive, t2 - t1);
+        }
+        TEST_CHECK(memcmp(fast, naive, sizeof(fast)) == 0);
+        printf("hampel: window %2u: rolling %.1f ns/sample, naive %.1f ns/sample, %.1fx\n", bench_windows[w],
+               best_fast / HAMPEL_TEST_BENCH_N, best_naive / HAMPEL_TEST_BENCH_N, best_naive / best_fast);
+    }
+    return TEST_EXIT();
+}
@@ -0,0 +1,89 @@
+/**
+ * @file test_i2c_faults.c
+ * @brief I2C1 driver fault injection: one case per bus fault, recovery checked on the bus model
+ * @details Each case arms one fault in the I2C1 model, runs a 3-byte I2C1_Read() against a
+ *          virtual MAX30101 and checks:
+ *          - the returned I2C_Status and the matching I2C1_GetErrorCount() increment
+ *          - the recovery path taken: PE software reset, SCL pulses and STOP of the bus
+ *            clear, I2C1_GetBusClearCount()
+ *          - the whole call (recovery included) within I2C_WORST_CASE_US(size + 1)
+ *          - the bus idle afterwards, and a following read returning the right data
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "HostI2c.h"
+#include "I2C.h"
+#include "MAX30101.h"
+#include "Sim.h"
+#include "Test.h"
+
+#define READ_SIZE       3u  /**< FIFO_WRITPTR..FIFO_READPTR, as MAX30101_GetNumAvailableSamples() */
+
+/**
+ * @struct FaultCase
+ * @brief One injected fault and the recovery it must cause
+ */
+typedef struct {
+    const char *name;       /**< Case name */
+    HostI2c_Fault fault;    /**< Injected fault */
+    uint8_t byte;           /**< Byte it hits (0 = address, 1 = register, 2 = read address, 3.. data) */
+    uint8_t param;          /**< SCL pulses until SDA is released (SDA_STUCK) */
+    I2C_Status status;      /**< Expected result */
+    uint32_t pe_resets;     /**< Expected PE software resets */
+    uint32_t bus_clears;    /**< Expected bus clears */
+    uint32_t scl_pulses;    /**< Expected SCL pulses clocked by the bus clear */
+} FaultCase;
+
+static const FaultCase cases[] = {
+    { "nack_address",  HOSTI2C_FAULT_NACK,      0, 0, I2C_ERR_NACK,    0, 0, 0 },
+    { "nack_register", HOSTI2C_FAULT_NACK,      1, 0, I2C_ERR_NACK,    0, 0, 0 },
+    { "berr",          HOSTI2C_FAULT_BERR,      3, 0, I2C_ERR_BERR,    1, 0, 0 },
+    { "arlo",          HOSTI2C_FAULT_ARLO,      1, 0, I2C_ERR_ARLO,    1, 0, 0 },
+    { "byte_timeout",  HOSTI2C_FAULT_STRETCH,   4, 0, I2C_ERR_TIMEOUT, 1, 1, 0 },
+    { "sda_stuck",     HOSTI2C_FAULT_SDA_STUCK, 0, 5, I2C_ERR_TIMEOUT, 1, 1, 5 },
+};
+
+int main(void) {
+    const uint64_t worst = HOST_US_TO_CYCLES(I2C_WORST_CASE_US(READ_SIZE + 1u));
+    uint8_t buf[READ_SIZE];
+    uint8_t mode;
+
+    Sim_Init(1);
+    Sim_Boot();
+    TEST_CHECK(HostI2c_BusIdle());
+
+    for (uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const FaultCase *c = &cases[i];
+        HostI2c_Stats before = *HostI2c_GetStats();
+        uint32_t errors = I2C1_GetErrorCount(c->status);
+        uint32_t clears = I2C1_GetBusClearCount();
+
+        HostI2c_InjectFault(c->fault, c->byte, c->param);
+        uint64_t t0 = Host_Cycles();
+        I2C_Status status = I2C1_Read(SENSOR_ADDR, FIFO_WRITPTR, buf, READ_SIZE);
+        uint64_t run = Host_Cycles() - t0;
+        const HostI2c_Stats *after = HostI2c_GetStats();
+
+        printf("%-14s status %d, %4u us (bound %u us), pe resets %u, bus clears %u, scl pulses %u\n",
+               c->name, (int)status, (unsigned)(run / (HOST_CORE_HZ / 1000000u)),
+               (unsigned)I2C_WORST_CASE_US(READ_SIZE + 1u), (unsigned)(after->pe_resets - before.pe_resets),
+               (unsigned)(I2C1_GetBusClearCount() - clears), (unsigned)(after->scl_pulses - before.scl_pulses));
+        TEST_CHECK(status == c->status);
+        TEST_CHECK(I2C1_GetErrorCount(c->status) == errors + 1u);
+        TEST_CHECK(I2C1_GetBusClearCount() == clears + c->bus_clears);
+        TEST_CHECK(after->pe_resets - before.pe_resets == c->pe_resets);
+        TEST_CHECK(after->scl_pulses - before.scl_pulses == c->scl_pulses);
+        TEST_CHECK(after->gpio_stops - before.gpio_stops == c->bus_clears);
+        TEST_CHECK(run <= worst);
+        TEST_CHECK(HostI2c_BusIdle());
+
+        // The bus is usable again: the profile's mode register reads back
+        mode = 0;
+        TEST_CHECK(I2C1_Read(SENSOR_ADDR, MODE_CONFIG, &mode, 1) == I2C_OK);
+        TEST_CHECK(mode == MAX30101_NIRSLiteProfile.mode);
+        TEST_CHECK(HostI2c_BusIdle());
+    }
+    return TEST_EXIT();
+}
@@ -0,0 +1,128 @@
+/**
+ * @file test_init.c
+ * @brief Sensor configuration: burst writes per register run and read-back verification
+ * @details Runs MAX30101_ApplyConfig() / MAX30101_InitNIRSLite() against virtual sensors
+ *          and checks, from the transfers the sensor saw:
+ *          - the NIRS Lite table goes out as one write per run of consecutive registers
+ *            (3 writes for its 8 registers) and one read-back per verified run (2)
+ *          - a run longer than MAX30101's burst limit is split, a table out of address
+ *            order is not merged
+ *          - a register corrupted on the sensor side is counted as a mismatch, only under
+ *            its verify_mask, and a missing sensor returns I2C_ERR_NACK
+ *          - Sim_Boot() (the main() sequence) registers only the sensors that came up
+ *            intact, and only those stream
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Acquisition.h"
+#include "I2C.h"
+#include "MAX30101.h"
+#include "PLL.h"
+#include "Sim.h"
+#include "Test.h"
+
+#define INIT_TEST_SENSORS   3u
+
+/**
+ * @brief Transfers a sensor saw during one call
+ */
+typedef struct {
+    uint32_t write_bursts;  /**< Write transfers carrying registers */
+    uint32_t reg_writes;    /**< Registers written */
+    uint32_t read_bursts;   /**< Read transfers */
+} Traffic;
+
+/**
+ * @brief Transfers of a sensor since a snapshot of its statistics
+ */
+static Traffic Since(uint8_t sensor, const Sim_SensorStats *before) {
+    const Sim_SensorStats *now = Sim_GetSensorStats(sensor);
+    Traffic t = { now->write_bursts - before->write_bursts, now->reg_writes - before->reg_writes,
+                  now->read_bursts - before->read_bursts };
+    return t;
+}
+
+int main(void) {
+    const MAX30101_Handle *dev;
+    Sim_SensorStats before;
+    Traffic t;
+    uint8_t bad;
+
+    Sim_Init(INIT_TEST_SENSORS);
+    clk_config();
+    I2C1_Config();
+    dev = Sim_Sensors();
+
+    // NIRS Lite: runs 0x08-0x0A, 0x0C-0x0D and 0x04-0x06 (pointers, not verified)
+    before = *Sim_GetSensorStats(0);
+    TEST_CHECK(MAX30101_InitNIRSLite(&dev[0], &bad) == I2C_OK);
+    t = Since(0, &before);
+    printf("init: NIRS Lite %u registers in %u writes, %u read-backs, %u mismatches\n",
+           (unsigned)t.reg_writes, (unsigned)t.write_bursts, (unsigned)t.read_bursts, bad);
+    TEST_CHECK(bad == 0u);
+    TEST_CHECK(t.reg_writes == MAX30101_NIRSLiteConfig.count);
+    TEST_CHECK(t.write_bursts == 3u);
+    TEST_CHECK(t.read_bursts == 2u);
+
+    // Nine consecutive registers: one full burst and a single one; out-of-order entries
+    static const MAX30101_RegEntry long_run[] = {
+        { MLED_CONFG1, 0x21, 0xFF }, { MLED_CONFG2, 0x03, 0xFF }, { 0x13, 0x01, 0x00 }, { 0x14, 0x02, 0x00 },
+        { 0x15, 0x03, 0x00 }, { 0x16, 0x04, 0x00 }, { 0x17, 0x05, 0x00 }, { 0x18, 0x06, 0x00 },
+        { 0x19, 0x07, 0xFF },
+    };
+    static const MAX30101_ConfigTable long_cfg = { long_run, sizeof(long_run) / sizeof(long_run[0]) };
+    before = *Sim_GetSensorStats(0);
+    TEST_CHECK(MAX30101_ApplyConfig(&dev[0], &long_cfg, &bad) == I2C_OK && bad == 0u);
+    t = Since(0, &before);
+    TEST_CHECK(t.reg_writes == 9u && t.write_bursts == 2u && t.read_bursts == 2u);
+
+    static const MAX30101_RegEntry shuffled[] = {
+        { LED2_PAMPLI, 0x40, 0xFF }, { LED1_PAMPLI, 0x30, 0xFF }, { PILOT_PA, 0x10, 0xFF },
+    };
+    static const MAX30101_ConfigTable shuffled_cfg = { shuffled, 3 };
+    before = *Sim_GetSensorStats(0);
+    TEST_CHECK(MAX30101_ApplyConfig(&dev[0], &shuffled_cfg, &bad) == I2C_OK && bad == 0u);
+    t = Since(0, &before);
+    TEST_CHECK(t.reg_writes == 3u && t.write_bursts == 3u && t.read_bursts == 3u);
+
+    // Corrupted registers: two verified ones, then a bit outside SPO2_CONFIG's mask (0x7F)
+    Sim_SetRegisterFault(1, SPO2_CONFIG, 0x04);
+    Sim_SetRegisterFault(1, LED2_PAMPLI, 0x01);
+    TEST_CHECK(MAX30101_InitNIRSLite(&dev[1], &bad) == I2C_OK);
+    TEST_CHECK(bad == 2u);
+    Sim_SetRegisterFault(1, LED2_PAMPLI, 0x00);
+    TEST_CHECK(MAX30101_InitNIRSLite(&dev[1], &bad) == I2C_OK);
+    TEST_CHECK(bad == 1u);
+    Sim_SetRegisterFault(1, SPO2_CONFIG, 0x80);
+    TEST_CHECK(MAX30101_InitNIRSLite(&dev[1], &bad) == I2C_OK);
+    TEST_CHECK(bad == 0u);
+
+    // Missing sensor
+    Sim_SetPresent(2, 0);
+    bad = 0xFF;
+    TEST_CHECK(MAX30101_InitNIRSLite(&dev[2], &bad) == I2C_ERR_NACK);
+
+    // Boot: sensor 1 reads back wrong, sensor 2 is missing; only sensor 0 streams
+    Sim_Init(INIT_TEST_SENSORS);
+    Sim_SetRegisterFault(1, LED1_PAMPLI, 0x02);
+    Sim_SetPresent(2, 0);
+    TEST_CHECK(Sim_Boot() == 1u);
+    uint32_t samples[INIT_TEST_SENSORS] = { 0 };
+    for (uint32_t tick = 0; tick < 2u * SIM_TICK_HZ; tick++) {
+        SampleBlock *block;
+        Sim_Tick();
+        while ((block = Acquisition_Peek()) != NULL) {
+            TEST_CHECK(block->sensor_id < INIT_TEST_SENSORS);
+            if (block->sensor_id < INIT_TEST_SENSORS) {
+                samples[block->sensor_id] += block->count;
+            }
+            Acquisition_Release();
+        }
+    }
+    printf("init: boot with a corrupted and a missing sensor: %u/%u/%u samples streamed\n",
+           (unsigned)samples[0], (unsigned)samples[1], (unsigned)samples[2]);
+    TEST_CHECK(samples[0] + 2u >= 2u * SIM_TICK_HZ && samples[1] == 0u && samples[2] == 0u);
+    return TEST_EXIT();
+}
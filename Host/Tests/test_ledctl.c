@@ -0,0 +1,319 @@
+/**
+ * @file test_ledctl.c
+ * @brief Automatic LED current control: decision rules and closed loop on the simulator
+ * @details Rules, on synthetic blocks of constant currents through LedCtl_Update():
+ *          - hysteresis: channels inside [LEDCTL_LOW_FRAC, LEDCTL_HIGH_FRAC] · FS keep
+ *            their drive
+ *          - a channel out of the band is retargeted to LEDCTL_TARGET_FRAC · FS; a channel
+ *            in the band keeps its drive unless the range changes
+ *          - a clipped channel counts as FS, so its drive is at least halved
+ *          - the smallest range in which the brightest channel needs LEDCTL_MIN_CODE
+ *          - drives clamped to LEDCTL_MIN_CODE and LEDCTL_MAX_CODE
+ *          - blocks that do not show the requested settings yet are not averaged
+ *
+ *          Closed loop: one virtual sensor, Pipeline_ProcessBlock() with led_control and
+ *          Pipeline_GetLedRequest() handed to Acquisition_SetLed() as Task_Process() does,
+ *          from the profile drive (10 mA, 4096 nA range) on a dim, a too dim, a saturating
+ *          and a very bright optical path. Each run must settle within a few windows on the
+ *          expected range with both channels in the 20–80 % band (or on LEDCTL_MAX_CODE),
+ *          stay there, and mark every settings change with exactly one SB_FLAG_GAIN block
+ *          (one "#led" line).
+ *
+ *          Each closed-loop run boots in a child process, so the driver state (mux
+ *          selection cache, acquisition counters) starts from reset as after a power cycle.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Acquisition.h"
+#include "LedControl.h"
+#include "MAX30101.h"
+#include "Pipeline.h"
+#include "Sim.h"
+#include "Test.h"
+
+#define LED_TEST_SECONDS    20u     /**< Closed-loop run length */
+#define LED_TEST_SETTLE_S   6.0     /**< Latest settling time: a few LEDCTL_WINDOW_SAMPLES windows */
+
+/**
+ * @brief Feed one decision window of constant currents
+ * @param lc - [in,out] LED controller
+ * @param red_na - Red current (nA)
+ * @param ir_na - IR current (nA)
+ * @param red_code - Red drive code of the blocks
+ * @param ir_code - IR drive code of the blocks
+ * @param range - ADC range of the blocks
+ * @return 1 if the requested settings changed
+ */
+static uint8_t Feed(LedCtl_Context *lc, float32_t red_na, float32_t ir_na, uint8_t red_code, uint8_t ir_code,
+                    uint8_t range) {
+    static SampleBlock block;
+    uint8_t changed = 0;
+    memset(&block, 0, sizeof(block));
+    block.count = SAMPLE_BLOCK_LEN;
+    block.led[SB_CH_RED] = red_code;
+    block.led[SB_CH_IR] = ir_code;
+    block.adc_range = range;
+    for (uint8_t i = 0; i < SAMPLE_BLOCK_LEN; i++) {
+        block.ch[SB_CH_RED][i] = red_na;
+        block.ch[SB_CH_IR][i] = ir_na;
+    }
+    for (uint32_t n = 0; n < LEDCTL_WINDOW_SAMPLES; n += SAMPLE_BLOCK_LEN) {
+        changed |= LedCtl_Update(lc, &block, 0);
+    }
+    return changed;
+}
+
+/**
+ * @brief Check the requested drive codes and range
+ */
+static void Expect(const LedCtl_Context *lc, uint8_t red_code, uint8_t ir_code, uint8_t range) {
+    TEST_CHECK(lc->code[SB_CH_RED] == red_code);
+    TEST_CHECK(lc->code[SB_CH_IR] == ir_code);
+    TEST_CHECK(lc->range == range);
+}
+
+/**
+ * @brief Decision rules on synthetic windows
+ * @return void
+ */
+static void Test_Rules(void) {
+    LedCtl_Context lc;
+    float32_t fs0 = MAX30101_RANGE_FULLSCALE_NA(0u);
+    float32_t fs1 = MAX30101_RANGE_FULLSCALE_NA(1u);
+    float32_t fs3 = MAX30101_RANGE_FULLSCALE_NA(3u);
+
+    // Hysteresis: both channels just inside the band
+    LedCtl_Init(&lc);
+    TEST_CHECK(Feed(&lc, 0.21f * fs1, 0.79f * fs1, 50, 50, 1) == 0u);
+    Expect(&lc, 50, 50, 1);
+    TEST_CHECK(lc.count == 0u);
+
+    // IR at 10 % of FS: target 0.5 · 2048 nA takes 125 (range 0), Red 25; the range changes
+    // from 1 to 0, so the in-band Red channel is retargeted too
+    TEST_CHECK(Feed(&lc, 0.5f * fs1, 0.1f * fs1, 50, 50, 1) == 1u);
+    Expect(&lc, 25, 125, 0);
+
+    // Waiting: blocks with the previous settings are not averaged, the request stands
+    TEST_CHECK(Feed(&lc, 0.5f * fs1, 0.1f * fs1, 50, 50, 1) == 0u);
+    TEST_CHECK(Feed(&lc, 0.5f * fs1, 0.1f * fs1, 25, 50, 0) == 0u);
+    TEST_CHECK(lc.count == 0u);
+    Expect(&lc, 25, 125, 0);
+    TEST_CHECK(Feed(&lc, 0.5f * fs0, 0.5f * fs0, 25, 125, 0) == 0u);
+    Expect(&lc, 25, 125, 0);
+
+    // Same range: the in-band Red keeps its drive, only IR (10 % of FS) moves; clamped at
+    // LEDCTL_MAX_CODE (it would need 250 · 0.5 / 0.1)
+    TEST_CHECK(Feed(&lc, 0.5f * fs0, 0.1f * fs0, 25, 125, 0) == 1u);
+    Expect(&lc, 25, LEDCTL_MAX_CODE, 0);
+
+    // Clipped IR (peak ≥ LEDCTL_CLIP_FRAC · FS) counts as FS: drive halved, Red kept
+    LedCtl_Init(&lc);
+    TEST_CHECK(Feed(&lc, 0.5f * fs0, 0.99f * fs0, 100, 100, 0) == 1u);
+    Expect(&lc, 100, 50, 0);
+
+    // Smallest range: clipped IR at code 8 would need 4 < LEDCTL_MIN_CODE in range 0, so
+    // range 1 with IR 8 and Red (40 % of FS) retargeted to 20
+    LedCtl_Init(&lc);
+    TEST_CHECK(Feed(&lc, 0.4f * fs0, fs0, 8, 8, 0) == 1u);
+    Expect(&lc, 20, 8, 1);
+
+    // Clamps: no light asks for LEDCTL_MAX_CODE in range 0; a clipped channel at the
+    // minimum drive in the largest range stays there (nothing left to change)
+    LedCtl_Init(&lc);
+    TEST_CHECK(Feed(&lc, 0.0f, 0.0f, 50, 50, 1) == 1u);
+    Expect(&lc, LEDCTL_MAX_CODE, LEDCTL_MAX_CODE, 0);
+    LedCtl_Init(&lc);
+    TEST_CHECK(Feed(&lc, fs3, fs3, LEDCTL_MIN_CODE, LEDCTL_MIN_CODE, LEDCTL_MAX_RANGE) == 0u);
+    Expect(&lc, LEDCTL_MIN_CODE, LEDCTL_MIN_CODE, LEDCTL_MAX_RANGE);
+}
+
+/**
+ * @brief Default optical path scaled by *(const double *)ctx
+ */
+static float32_t ScaledSignal(void *ctx, uint8_t sensor, uint8_t channel, double t_s) {
+    return (float32_t)(*(const double *)ctx * Sim_DefaultSignal(NULL, sensor, channel, t_s));
+}
+
+/**
+ * @struct LoopStats
+ * @brief Measurements of one closed-loop run
+ */
+typedef struct {
+    uint32_t requests;                      /**< Distinct settings requested */
+    uint32_t gain_blocks;                   /**< Blocks flagged SB_FLAG_GAIN ("#led" lines) */
+    uint32_t untagged;                      /**< Settings changes without SB_FLAG_GAIN */
+    double   settled_s;                     /**< Time of the last settings change (s) */
+    uint8_t  first_ir;                      /**< IR drive of the first request */
+    uint8_t  code[SAMPLE_BLOCK_CHANNELS];   /**< Final drive codes */
+    uint8_t  range;                         /**< Final ADC range */
+    double   dc_frac[SAMPLE_BLOCK_CHANNELS]; /**< Mean DC over the last second (fraction of FS) */
+} LoopStats;
+
+/**
+ * @brief Run the closed loop on one optical path
+ * @param scale - Optical path relative to Sim_DefaultSignal()
+ * @param ls - [out] Measurements
+ * @return void
+ */
+static void Run_Loop(double scale, LoopStats *ls) {
+    static Pipeline_Context ctx;
+    static double path;
+    Pipeline_Config cfg;
+    SampleBlock *block;
+    uint8_t req[SAMPLE_BLOCK_CHANNELS] = { 0 };
+    uint8_t req_range = 0xFF;
+    uint8_t led[SAMPLE_BLOCK_CHANNELS] = { 0 };
+    uint8_t range = 0xFF;
+    double sum[SAMPLE_BLOCK_CHANNELS] = { 0 };
+    uint32_t tail = 0;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.filter = PIPELINE_FILTER_DC_BLOCKER;
+    cfg.alpha = 0.995f;
+    cfg.warmup_samples = 600;
+    cfg.led_control = 1;
+    memset(ls, 0, sizeof(*ls));
+    path = scale;
+
+    Sim_Init(1);
+    Sim_SetSignal(ScaledSignal, &path);
+    Sim_Boot();
+    Pipeline_Init(&ctx, &cfg);
+    for (uint32_t tick = 0; tick < LED_TEST_SECONDS * SIM_TICK_HZ; tick++) {
+        double t_s = (double)tick / SIM_TICK_HZ;
+        Sim_Tick();
+        while ((block = Acquisition_Peek()) != NULL) {
+            uint8_t changed = (block->adc_range != range);
+            for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+                changed |= (block->led[c] != led[c]);
+                led[c] = block->led[c];
+            }
+            range = block->adc_range;
+            if (block->flags & SB_FLAG_GAIN) {
+                ls->gain_blocks++;
+                ls->settled_s = t_s;
+            } else if (changed && block->seq != 0u) {
+                ls->untagged++;
+            }
+            if (t_s >= LED_TEST_SECONDS - 1.0) {
+                for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+                    for (uint8_t k = 0; k < block->count; k++) {
+                        sum[c] += block->ch[c][k] / MAX30101_RANGE_FULLSCALE_NA(block->adc_range);
+                    }
+                }
+                tail += block->count;
+            }
+            Pipeline_ProcessBlock(&ctx, block);
+
+            uint8_t codes[SAMPLE_BLOCK_CHANNELS];
+            uint8_t r;
+            if (Pipeline_GetLedRequest(&ctx, codes, &r)) {
+                if (r != req_range || memcmp(codes, req, sizeof(req)) != 0) {
+                    if (req_range != 0xFF) {
+                        ls->requests++;
+                        if (ls->requests == 1u) {
+                            ls->first_ir = codes[SB_CH_IR];
+                        }
+                    }
+                    memcpy(req, codes, sizeof(req));
+                    req_range = r;
+                }
+                Acquisition_SetLed(block->sensor_id, codes, r);
+            }
+            Acquisition_Release();
+        }
+    }
+    memcpy(ls->code, led, sizeof(led));
+    ls->range = range;
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        ls->dc_frac[c] = tail ? sum[c] / tail : 0.0;
+    }
+    TEST_CHECK(Acquisition_GetDropped() == 0);
+    TEST_CHECK(Acquisition_GetErrors(Sim_Sensors()[0].id) == 0);
+}
+
+/**
+ * @brief Run_Loop() in a freshly booted child process
+ * @param scale - Optical path relative to Sim_DefaultSignal()
+ * @param ls - [out] Measurements
+ * @return 1 if the child completed with all its checks passed
+ */
+static uint8_t RunChild(double scale, LoopStats *ls) {
+    int fd[2];
+    int status = 0;
+    memset(ls, 0, sizeof(*ls));
+    if (pipe(fd) != 0) {
+        return 0;
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fd[0]);
+        Run_Loop(scale, ls);
+        ssize_t w = write(fd[1], ls, sizeof(*ls));
+        fflush(stdout);
+        _exit((w == (ssize_t)sizeof(*ls) && test_failures == 0) ? 0 : 1);
+    }
+    close(fd[1]);
+    ssize_t r = (pid > 0) ? read(fd[0], ls, sizeof(*ls)) : -1;
+    close(fd[0]);
+    if (pid > 0) {
+        waitpid(pid, &status, 0);
+    }
+    return (r == (ssize_t)sizeof(*ls) && pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+int main(void) {
+    // Optical paths relative to the default (100 nA/mA IR, 60 nA/mA Red) and the range
+    // each must settle in: dim (4.9 % of FS at the profile drive), too dim to reach the
+    // band at LEDCTL_MAX_CODE, saturating (clipped), very bright (clipped, range 3)
+    static const struct {
+        const char *name;
+        double      scale;
+        uint8_t     range;
+        uint8_t     in_band;
+    } runs[] = {
+        { "dim", 0.2, 0, 1 }, { "too dim", 0.02, 0, 0 }, { "saturating", 10.0, 0, 1 }, { "very bright", 50.0, 3, 1 },
+    };
+    LoopStats ls[4];
+    uint8_t ok = 1;
+
+    // Children inherit the failure count: run them all before checking
+    for (uint32_t i = 0; i < 4u; i++) {
+        ok &= RunChild(runs[i].scale, &ls[i]);
+    }
+    TEST_CHECK(ok);
+    Test_Rules();
+
+    for (uint32_t i = 0; i < 4u; i++) {
+        const LoopStats *s = &ls[i];
+        printf("ledctl: %-11s %u requests, %u #led, settled at %.2f s: Red %.1f mA, IR %.1f mA, range %u nA, DC %.0f/%.0f %% FS\n",
+               runs[i].name, (unsigned)s->requests, (unsigned)s->gain_blocks, s->settled_s,
+               (double)MAX30101_LED_REG_TO_MA(s->code[SB_CH_RED]), (double)MAX30101_LED_REG_TO_MA(s->code[SB_CH_IR]),
+               (unsigned)MAX30101_RANGE_FULLSCALE_NA(s->range), 100.0 * s->dc_frac[SB_CH_RED],
+               100.0 * s->dc_frac[SB_CH_IR]);
+        TEST_CHECK(s->requests > 0u && s->gain_blocks == s->requests && s->untagged == 0u);
+        TEST_CHECK(s->settled_s < LED_TEST_SETTLE_S);
+        TEST_CHECK(s->range == runs[i].range);
+        for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+            TEST_CHECK(s->code[c] >= LEDCTL_MIN_CODE && s->code[c] <= LEDCTL_MAX_CODE);
+            if (runs[i].in_band) {
+                TEST_CHECK(s->dc_frac[c] >= LEDCTL_LOW_FRAC && s->dc_frac[c] <= LEDCTL_HIGH_FRAC);
+            } else {
+                TEST_CHECK(s->code[c] == LEDCTL_MAX_CODE && s->dc_frac[c] < LEDCTL_LOW_FRAC);
+            }
+        }
+    }
+    // Clipped at the profile drive: the first step at least halves the IR drive
+    uint8_t profile_ir = MAX30101_LED_MA_TO_REG(MAX30101_NIRSLiteProfile.led_ir_ma);
+    TEST_CHECK(ls[2].first_ir <= profile_ir / 2u && ls[3].first_ir <= profile_ir / 2u);
+    // Smallest range: one range lower, the brighter IR channel would need less than the minimum
+    double ir_na_per_code = runs[3].scale * SIM_IR_NA_PER_MA * MAX30101_LED_REG_TO_MA(1u);
+    TEST_CHECK(LEDCTL_TARGET_FRAC * MAX30101_RANGE_FULLSCALE_NA(2u) / ir_na_per_code < LEDCTL_MIN_CODE);
+    return TEST_EXIT();
+}
@@ -0,0 +1,152 @@
+/**
+ * @file test_occlusion.c
+ * @brief Occlusion detector on a synthetic protocol with known kinetics
+ * @details HbDiff = ΔHbO2 − ΔHHb (µM) of an arterial occlusion protocol, sampled at 50 Hz
+ *          with a cardiac pulse and noise:
+ *          - rest at OCCL_TEST_BASELINE, then a 17 s dip that recovers quickly (a transient
+ *            shorter than OCCL_MIN_OCCLUSION_SAMPLES, no record)
+ *          - occlusion: a linear fall at OCCL_TEST_SLOPE for OCCL_TEST_OCCLUSION_S
+ *          - reperfusion: exponential recovery with time constant OCCL_TEST_TAU_S toward
+ *            OCCL_TEST_HYPEREMIA above the baseline, then the hyperemia decays with
+ *            OCCL_TEST_DECAY_S
+ *
+ *          The trace is fed once at full rate and once decimated by 4 (the adaptive rate).
+ *          The two Occl_Update() records must match the trace: occlusion duration,
+ *          baseline, minimum and desaturation slope; reperfusion time to half recovery
+ *          (solved from the model), peak and recovery time constant.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "Occlusion.h"
+#include "Test.h"
+
+#define OCCL_TEST_HZ            50.0
+#define OCCL_TEST_SECONDS       480u
+#define OCCL_TEST_BASELINE      2.0     /**< µM */
+#define OCCL_TEST_DIP_S         60.0    /**< Transient dip start (s) */
+#define OCCL_TEST_ONSET_S       150.0   /**< Cuff inflated (s) */
+#define OCCL_TEST_OCCLUSION_S   180.0   /**< Occlusion length (s) */
+#define OCCL_TEST_SLOPE         -0.08   /**< Desaturation (µM/s) */
+#define OCCL_TEST_TAU_S         20.0    /**< Recovery time constant (s) */
+#define OCCL_TEST_HYPEREMIA     4.0     /**< Plateau above the baseline (µM) */
+#define OCCL_TEST_PLATEAU_S     100.0   /**< Release to the start of the hyperemia decay (s) */
+#define OCCL_TEST_DECAY_S       30.0    /**< Hyperemia decay time constant (s) */
+#define OCCL_TEST_BIN_S         (OCCL_BIN_SAMPLES / OCCL_TEST_HZ)
+
+/**
+ * @brief Noise-free HbDiff of the protocol
+ * @param t - Time (s)
+ * @return HbDiff (µM)
+ */
+static double Protocol(double t) {
+    const double B = OCCL_TEST_BASELINE;
+    const double release = OCCL_TEST_ONSET_S + OCCL_TEST_OCCLUSION_S;
+    const double min = B + OCCL_TEST_SLOPE * OCCL_TEST_OCCLUSION_S;
+    const double plateau = B + OCCL_TEST_HYPEREMIA;
+    if (t >= OCCL_TEST_DIP_S && t < OCCL_TEST_DIP_S + 17.0) {
+        // Transient: 15 s down at 0.2 µM/s, 2 s back
+        double u = t - OCCL_TEST_DIP_S;
+        return B - ((u < 15.0) ? 0.2 * u : 1.5 * (17.0 - u));
+    }
+    if (t < OCCL_TEST_ONSET_S) {
+        return B;
+    }
+    if (t < release) {
+        return B + OCCL_TEST_SLOPE * (t - OCCL_TEST_ONSET_S);
+    }
+    double u = t - release;
+    double y = plateau - (plateau - min) * exp(-u / OCCL_TEST_TAU_S);
+    if (u > OCCL_TEST_PLATEAU_S) {
+        y = B + (y - B) * exp(-(u - OCCL_TEST_PLATEAU_S) / OCCL_TEST_DECAY_S);
+    }
+    return y;
+}
+
+/**
+ * @brief Release to half recovery of the model (bisection)
+ */
+static double HalfRecovery(void) {
+    const double release = OCCL_TEST_ONSET_S + OCCL_TEST_OCCLUSION_S;
+    const double min = OCCL_TEST_BASELINE + OCCL_TEST_SLOPE * OCCL_TEST_OCCLUSION_S;
+    const double half = 0.5 * (min + OCCL_TEST_BASELINE);
+    double lo = 0.0, hi = OCCL_TEST_PLATEAU_S;
+    for (uint32_t i = 0; i < 60u; i++) {
+        double mid = 0.5 * (lo + hi);
+        if (Protocol(release + mid) < half) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Feed the protocol and check the records
+ * @param decim - ADC sample periods per sample
+ * @return void
+ */
+static void Run(uint8_t decim) {
+    static Occl_Context oc;
+    Occl_Event ev[4];
+    uint32_t events = 0;
+    float32_t hbo2[8], hhb[8];
+    uint32_t total = (uint32_t)(OCCL_TEST_SECONDS * OCCL_TEST_HZ);
+
+    srand(2026);
+    Occl_Init(&oc);
+    for (uint32_t i = 0; i < total; i += 8u) {
+        uint32_t n = 0;
+        for (uint32_t k = i; k < i + 8u; k += decim) {
+            double t = k / OCCL_TEST_HZ;
+            double y = Protocol(t) + 0.05 * sin(2.0 * M_PI * 1.2 * t) + 0.02 * (2.0 * rand() / RAND_MAX - 1.0);
+            hbo2[n] = (float32_t)(0.6 * y);
+            hhb[n] = (float32_t)(-0.4 * y);
+            n++;
+        }
+        if (Occl_Update(&oc, hbo2, hhb, n, decim) && events < 4u) {
+            ev[events++] = oc.event;
+        }
+    }
+
+    double min = OCCL_TEST_BASELINE + OCCL_TEST_SLOPE * OCCL_TEST_OCCLUSION_S;
+    double t_half = HalfRecovery();
+    double peak = Protocol(OCCL_TEST_ONSET_S + OCCL_TEST_OCCLUSION_S + OCCL_TEST_PLATEAU_S);
+    TEST_CHECK(events == 2u);
+    if (events != 2u) {
+        return;
+    }
+    printf("occlusion (decim %u): %.2f s, baseline %.3f, min %.3f, slope %.4f uM/s "
+           "(expected %.0f s, %.3f, %.3f, %.4f)\n", decim, (double)ev[0].duration_s,
+           (double)ev[0].baseline, (double)ev[0].level, (double)ev[0].slope, OCCL_TEST_OCCLUSION_S,
+           OCCL_TEST_BASELINE, min, OCCL_TEST_SLOPE);
+    printf("reperfusion (decim %u): %.2f s, t_half %.2f s, peak %.3f at %.1f s, tau %.2f s "
+           "(expected t_half %.2f s, peak %.3f, tau %.1f s)\n", decim, (double)ev[1].duration_s,
+           (double)ev[1].t_half_s, (double)ev[1].level, (double)ev[1].t_peak_s, (double)ev[1].tau_s, t_half,
+           peak, OCCL_TEST_TAU_S);
+
+    // Occlusion: times within about a bin, levels within the bin averaging of the slope
+    TEST_CHECK(ev[0].phase == OCCL_PHASE_OCCLUSION);
+    TEST_NEAR(ev[0].duration_s, OCCL_TEST_OCCLUSION_S, 2.0 * OCCL_TEST_BIN_S);
+    TEST_NEAR(ev[0].baseline, OCCL_TEST_BASELINE, 0.05);
+    TEST_NEAR(ev[0].level, min, 0.1);
+    TEST_NEAR(ev[0].slope, OCCL_TEST_SLOPE, 0.02 * fabs(OCCL_TEST_SLOPE));
+
+    // Reperfusion: half recovery within a bin (the release is the lowest bin), τ within 5 %
+    TEST_CHECK(ev[1].phase == OCCL_PHASE_REPERFUSION);
+    TEST_NEAR(ev[1].baseline, OCCL_TEST_BASELINE, 0.05);
+    TEST_NEAR(ev[1].t_half_s, t_half, OCCL_TEST_BIN_S);
+    TEST_NEAR(ev[1].level, peak, 0.05);
+    TEST_CHECK(ev[1].t_peak_s > 4.0 * OCCL_TEST_TAU_S && ev[1].t_peak_s <= OCCL_TEST_PLATEAU_S + 2.0);
+    TEST_NEAR(ev[1].tau_s, OCCL_TEST_TAU_S, 0.05 * OCCL_TEST_TAU_S);
+}
+
+int main(void) {
+    Run(1);
+    Run(4);
+    return TEST_EXIT();
+}
@@ -0,0 +1,217 @@
+/**
+ * @file test_quality.c
+ * @brief Signal-quality engine on synthetic blocks, one scenario per flag
+ * @details Each scenario feeds Quality_BeginBlock() / Quality_EndBlock() with raw rows
+ *          (DC + pulse, nA) and the matching high-passed IR row, as the pipeline does,
+ *          and checks the quality word of every block:
+ *          - a clean pulse: QUALITY_FLAG_PARTIAL for the first QUALITY_WINDOW_BLOCKS − 1
+ *            blocks, then no flag, and the SNR byte equal to the rounded SNR recomputed in
+ *            double over the last 64 samples
+ *          - one flag per scenario: clipping (one Red sample per window at full scale,
+ *            and the threshold following Quality_SetFullScale()), low DC, low perfusion,
+ *            white noise (low SNR), a stuck ADC (flatline)
+ *          - SB_FLAG_GAP and SB_FLAG_GAIN restart the window: the next word is PARTIAL
+ *            and the metrics cover the new block only
+ *          - samples before `first` are not counted
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "Quality.h"
+#include "Test.h"
+
+#define QUAL_TEST_FS_NA     4096.0f     /**< ADC full scale (nA) */
+#define QUAL_TEST_HZ        50.0
+#define QUAL_TEST_WINDOW    (QUALITY_WINDOW_BLOCKS * SAMPLE_BLOCK_LEN)
+#define QUAL_TEST_BLOCKS    40u
+
+/**
+ * @struct Scenario
+ * @brief Synthetic signal of one scenario
+ */
+typedef struct {
+    double dc;          /**< IR DC (nA); Red is 0.6 of it */
+    double pulse;       /**< IR pulse amplitude (nA) */
+    double noise;       /**< White noise amplitude (nA, uniform ±) */
+    uint8_t stuck;      /**< Raw IR repeats one value */
+    uint8_t clip_every; /**< One Red sample at full scale every clip_every samples (0 = never) */
+} Scenario;
+
+static double ac_hist[QUAL_TEST_BLOCKS * SAMPLE_BLOCK_LEN];    /**< High-passed IR fed so far */
+
+/**
+ * @brief Uniform random number in [-1, 1]
+ */
+static double Noise(void) {
+    return 2.0 * rand() / RAND_MAX - 1.0;
+}
+
+/**
+ * @brief Fill block b of a scenario: raw rows in the block, high-passed IR in ac[]
+ */
+static void Make_Block(const Scenario *sc, uint32_t b, SampleBlock *block, float32_t *ac) {
+    block->count = SAMPLE_BLOCK_LEN;
+    block->flags = 0;
+    block->seq = b * SAMPLE_BLOCK_LEN;
+    for (uint8_t i = 0; i < SAMPLE_BLOCK_LEN; i++) {
+        uint32_t n = b * SAMPLE_BLOCK_LEN + i;
+        double a = sc->pulse * sin(2.0 * M_PI * 1.2 * n / QUAL_TEST_HZ) + sc->noise * Noise();
+        block->ch[SB_CH_IR][i] = sc->stuck ? (float32_t)sc->dc : (float32_t)(sc->dc + a);
+        block->ch[SB_CH_RED][i] = (float32_t)(0.6 * sc->dc + 0.6 * a);
+        if (sc->clip_every && n % sc->clip_every == sc->clip_every - 1u) {
+            block->ch[SB_CH_RED][i] = QUAL_TEST_FS_NA;
+        }
+        ac[i] = sc->stuck ? 0.0f : (float32_t)a;
+        ac_hist[n] = ac[i];
+    }
+}
+
+/**
+ * @brief Rounded SNR (dB) of the last window of high-passed samples, in double
+ */
+static int32_t Expected_Snr(uint32_t end) {
+    double ac_ms = 0.0, diff_ms = 0.0;
+    for (uint32_t n = end - QUAL_TEST_WINDOW; n < end; n++) {
+        double prev = (n > 0u) ? ac_hist[n - 1u] : ac_hist[0];
+        ac_ms += ac_hist[n] * ac_hist[n];
+        diff_ms += (ac_hist[n] - prev) * (ac_hist[n] - prev);
+    }
+    double noise = 0.5 * diff_ms / QUAL_TEST_WINDOW;
+    double signal = ac_ms / QUAL_TEST_WINDOW - noise;
+    return (signal > 0.0 && noise > 0.0) ? (int32_t)floor(10.0 * log10(signal / noise) + 0.5) : 0;
+}
+
+/**
+ * @brief Run a scenario and return the steady-state word (last block)
+ * @param sc - [in] Scenario
+ * @param name - Scenario name for the report
+ * @return Quality word of the last block
+ */
+static uint16_t Run(const Scenario *sc, const char *name) {
+    Quality_Context q;
+    SampleBlock block;
+    float32_t ac[SAMPLE_BLOCK_LEN];
+    uint16_t word = 0;
+
+    Quality_Init(&q, QUAL_TEST_FS_NA);
+    for (uint32_t b = 0; b < QUAL_TEST_BLOCKS; b++) {
+        Make_Block(sc, b, &block, ac);
+        Quality_BeginBlock(&q, &block, 0);
+        word = Quality_EndBlock(&q, ac, SAMPLE_BLOCK_LEN);
+        TEST_CHECK(((word & QUALITY_FLAG_PARTIAL) != 0) == (b + 1u < QUALITY_WINDOW_BLOCKS));
+    }
+    const Quality_Metrics *m = Quality_GetMetrics(&q);
+    printf("quality %-9s: word 0x%04x, dc %.1f nA, pi %.4f %%, snr %.1f dB, clip %.3f, flat %.3f\n", name,
+           word, (double)m->dc, (double)m->pi, (double)m->snr_db, (double)m->clip_rate, (double)m->flat_rate);
+    return word;
+}
+
+int main(void) {
+    srand(2026);
+
+    // Clean pulse: no flag, SNR byte from the window
+    const Scenario clean = { 2000.0, 20.0, 0.2, 0, 0 };
+    uint16_t word = Run(&clean, "clean");
+    TEST_CHECK((word & QUALITY_FLAGS_MASK) == 0u);
+    int32_t snr = Expected_Snr(QUAL_TEST_BLOCKS * SAMPLE_BLOCK_LEN);
+    TEST_CHECK(snr > QUALITY_MIN_SNR_DB);
+    TEST_NEAR(word >> QUALITY_SNR_SHIFT, snr, 1);
+
+    // One flag each
+    const Scenario clip = { 2000.0, 20.0, 0.2, 0, 32 };         // 2 / 64 samples > 1 %
+    TEST_CHECK((Run(&clip, "clipping") & QUALITY_FLAGS_MASK) == QUALITY_FLAG_CLIPPING);
+    const Scenario dim = { 50.0, 1.0, 0.01, 0, 0 };
+    TEST_CHECK((Run(&dim, "low_dc") & QUALITY_FLAGS_MASK) == QUALITY_FLAG_LOW_DC);
+    const Scenario flat_pulse = { 2000.0, 0.2, 0.0, 0, 0 };      // PI 0.007 %
+    TEST_CHECK((Run(&flat_pulse, "low_pi") & QUALITY_FLAGS_MASK) == QUALITY_FLAG_LOW_PI);
+    const Scenario noisy = { 2000.0, 0.0, 20.0, 0, 0 };
+    word = Run(&noisy, "low_snr");
+    TEST_CHECK((word & QUALITY_FLAGS_MASK) == QUALITY_FLAG_LOW_SNR);
+    TEST_CHECK((word >> QUALITY_SNR_SHIFT) == 0u);
+    const Scenario stuck = { 2000.0, 0.0, 0.0, 1, 0 };
+    word = Run(&stuck, "flatline");
+    TEST_CHECK(word & QUALITY_FLAG_FLATLINE);
+    TEST_CHECK((word & (QUALITY_FLAG_CLIPPING | QUALITY_FLAG_LOW_DC | QUALITY_FLAG_PARTIAL)) == 0u);
+
+    // Clipping threshold follows the full scale: the same samples clip at half the range
+    {
+        Quality_Context q;
+        SampleBlock block;
+        float32_t ac[SAMPLE_BLOCK_LEN];
+        const Scenario bright = { 3000.0, 20.0, 0.2, 0, 0 };
+        Quality_Init(&q, QUAL_TEST_FS_NA);
+        for (uint32_t b = 0; b < QUALITY_WINDOW_BLOCKS; b++) {
+            Make_Block(&bright, b, &block, ac);
+            Quality_BeginBlock(&q, &block, 0);
+            word = Quality_EndBlock(&q, ac, SAMPLE_BLOCK_LEN);
+        }
+        TEST_CHECK(!(word & QUALITY_FLAG_CLIPPING));
+        Quality_SetFullScale(&q, QUAL_TEST_FS_NA / 2.0f);
+        Make_Block(&bright, QUALITY_WINDOW_BLOCKS, &block, ac);
+        block.flags = SB_FLAG_GAIN;
+        Quality_BeginBlock(&q, &block, 0);
+        word = Quality_EndBlock(&q, ac, SAMPLE_BLOCK_LEN);
+        TEST_CHECK(word & QUALITY_FLAG_CLIPPING);
+    }
+
+    // Window restart on a gap or a gain step: the new block alone decides
+    static const uint8_t restart_flags[] = { SB_FLAG_GAP, SB_FLAG_GAIN };
+    for (uint32_t f = 0; f < 2u; f++) {
+        Quality_Context q;
+        SampleBlock block;
+        float32_t ac[SAMPLE_BLOCK_LEN];
+        Quality_Init(&q, QUAL_TEST_FS_NA);
+        for (uint32_t b = 0; b < 2u * QUALITY_WINDOW_BLOCKS; b++) {
+            Make_Block(&clean, b, &block, ac);
+            Quality_BeginBlock(&q, &block, 0);
+            word = Quality_EndBlock(&q, ac, SAMPLE_BLOCK_LEN);
+        }
+        TEST_CHECK((word & QUALITY_FLAGS_MASK) == 0u);
+        // Without the flag one dim block is averaged away; with it, it is the whole window
+        Make_Block(&dim, 2u * QUALITY_WINDOW_BLOCKS, &block, ac);
+        block.flags = restart_flags[f];
+        Quality_BeginBlock(&q, &block, 0);
+        word = Quality_EndBlock(&q, ac, SAMPLE_BLOCK_LEN);
+        TEST_CHECK(word & QUALITY_FLAG_PARTIAL);
+        TEST_CHECK(word & QUALITY_FLAG_LOW_DC);
+        TEST_NEAR(Quality_GetMetrics(&q)->dc, dim.dc, 2.0);
+        for (uint32_t b = 1; b < QUALITY_WINDOW_BLOCKS; b++) {
+            Make_Block(&dim, 2u * QUALITY_WINDOW_BLOCKS + b, &block, ac);
+            Quality_BeginBlock(&q, &block, 0);
+            word = Quality_EndBlock(&q, ac, SAMPLE_BLOCK_LEN);
+        }
+        TEST_CHECK(!(word & QUALITY_FLAG_PARTIAL));
+
+        Quality_Init(&q, QUAL_TEST_FS_NA);
+        for (uint32_t b = 0; b < 2u * QUALITY_WINDOW_BLOCKS; b++) {
+            Make_Block(&clean, b, &block, ac);
+            Quality_BeginBlock(&q, &block, 0);
+            Quality_EndBlock(&q, ac, SAMPLE_BLOCK_LEN);
+        }
+        Make_Block(&dim, 2u * QUALITY_WINDOW_BLOCKS, &block, ac);
+        Quality_BeginBlock(&q, &block, 0);
+        word = Quality_EndBlock(&q, ac, SAMPLE_BLOCK_LEN);
+        TEST_CHECK(!(word & (QUALITY_FLAG_PARTIAL | QUALITY_FLAG_LOW_DC)));
+    }
+
+    // Samples before first are not counted: a dim warm-up sample does not move the DC
+    {
+        Quality_Context q;
+        SampleBlock block;
+        float32_t ac[SAMPLE_BLOCK_LEN];
+        Quality_Init(&q, QUAL_TEST_FS_NA);
+        Make_Block(&clean, 0, &block, ac);
+        block.ch[SB_CH_IR][0] = 0.0f;
+        Quality_BeginBlock(&q, &block, 1);
+        Quality_EndBlock(&q, &ac[1], SAMPLE_BLOCK_LEN - 1u);
+        double dc = 0.0;
+        for (uint8_t i = 1; i < SAMPLE_BLOCK_LEN; i++) {
+            dc += block.ch[SB_CH_IR][i];
+        }
+        TEST_NEAR(Quality_GetMetrics(&q)->dc, dc / (SAMPLE_BLOCK_LEN - 1u), 1e-3);
+    }
+    return TEST_EXIT();
+}
@@ -0,0 +1,204 @@
+/**
+ * @file test_rate.c
+ * @brief Adaptive output rate on the simulator: switching and measured savings
+ * @details One virtual sensor sees 120 s of a steady pulse (0.2 % depth) with a motion
+ *          episode (3 %, 1 Hz) from 60 to 70 s. The same trace is acquired twice through
+ *          Acquisition_Poll() and Pipeline_ProcessBlock() (DC blocker):
+ *          - fixed: adaptive_decim 0, full rate throughout
+ *          - adaptive: adaptive_decim RATE_TEST_DECIM, the rate request handed to
+ *            Acquisition_SetDecimation() after every block as Task_Process() does
+ *
+ *          Checked and reported per run:
+ *          - switching: reduced rate after the RATE_QUIET_SAMPLES quiet period, full rate
+ *            within a second of the motion onset, reduced again once it is over
+ *          - bandwidth: Acquisition_GetBusBytes(), I2C busy time and processed samples
+ *            (output lines), over the whole trace and over a steady window
+ *          - power: LED charge and ADC conversions of Sim_SensorStats. Averaging on chip
+ *            keeps the LEDs and the ADC at full rate, so these must not change
+ *
+ *          Each run boots in a child process, so the driver state (mux selection cache,
+ *          acquisition counters) starts from reset as after a power cycle.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <math.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Acquisition.h"
+#include "AdaptiveRate.h"
+#include "HostI2c.h"
+#include "Pipeline.h"
+#include "Sim.h"
+#include "Test.h"
+
+#define RATE_TEST_SECONDS   120u
+#define RATE_TEST_DECIM     4u
+#define MOTION_START_S      60.0
+#define MOTION_END_S        70.0
+#define STEADY_FROM_S       30u     /**< Steady window for the rate-reduced figures */
+#define STEADY_TO_S         60u
+
+/**
+ * @struct RunStats
+ * @brief Measurements of one run
+ */
+typedef struct {
+    uint32_t bus_bytes;         /**< Acquisition_GetBusBytes() over the trace */
+    uint32_t steady_bytes;      /**< Acquisition_GetBusBytes() in the steady window */
+    double   busy_ms;           /**< I2C busy time over the trace (ms) */
+    uint32_t samples;           /**< Samples processed (output lines) */
+    uint32_t steady_samples;    /**< Samples processed in the steady window */
+    uint32_t conversions;       /**< ADC conversions */
+    double   led_charge_uc;     /**< LED charge (µC) */
+    uint32_t switches;          /**< Rate changes seen in the block stream ("#rate" lines) */
+    double   reduced_s;         /**< First time at the reduced rate (s) */
+    double   wake_s;            /**< First time at full rate after the motion onset (s) */
+    double   resume_s;          /**< First time at the reduced rate after the motion (s) */
+} RunStats;
+
+/**
+ * @brief Steady pulse with a motion episode
+ */
+static float32_t RateSignal(void *ctx, uint8_t sensor, uint8_t channel, double t_s) {
+    double base = (channel == SIM_CH_IR) ? SIM_IR_NA_PER_MA : SIM_RED_NA_PER_MA;
+    double pulse = 0.002 * sin(2.0 * M_PI * 1.2 * t_s);
+    double motion = (t_s >= MOTION_START_S && t_s < MOTION_END_S) ? 0.03 * sin(2.0 * M_PI * 1.0 * t_s) : 0.0;
+    return (float32_t)(base * (1.0 + pulse + motion));
+}
+
+/**
+ * @brief Acquire and process the trace once
+ * @param adaptive - 1 to follow the rate requests of the pipeline
+ * @param rs - [out] Measurements
+ * @return void
+ */
+static void Run(uint8_t adaptive, RunStats *rs) {
+    static Pipeline_Context ctx;
+    Pipeline_Config cfg;
+    SampleBlock *block;
+    uint8_t decim = 1;
+    uint32_t bytes_from = 0;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.filter = PIPELINE_FILTER_DC_BLOCKER;
+    cfg.alpha = 0.995f;
+    cfg.warmup_samples = 600;
+    cfg.adaptive_decim = adaptive ? RATE_TEST_DECIM : 0u;
+    memset(rs, 0, sizeof(*rs));
+
+    Sim_Init(1);
+    Sim_SetSignal(RateSignal, NULL);
+    Sim_Boot();
+    Pipeline_Init(&ctx, &cfg);
+    for (uint32_t tick = 0; tick < RATE_TEST_SECONDS * SIM_TICK_HZ; tick++) {
+        double t_s = (double)tick / SIM_TICK_HZ;
+        if (tick == STEADY_FROM_S * SIM_TICK_HZ) {
+            bytes_from = Acquisition_GetBusBytes();
+        } else if (tick == STEADY_TO_S * SIM_TICK_HZ) {
+            rs->steady_bytes = Acquisition_GetBusBytes() - bytes_from;
+        }
+        Sim_Tick();
+        while ((block = Acquisition_Peek()) != NULL) {
+            if (block->decimation != decim) {
+                decim = block->decimation;
+                rs->switches++;
+                if (decim > 1u && rs->reduced_s == 0.0) {
+                    rs->reduced_s = t_s;
+                } else if (decim == 1u && t_s >= MOTION_START_S && rs->wake_s == 0.0) {
+                    rs->wake_s = t_s;
+                } else if (decim > 1u && t_s >= MOTION_END_S && rs->resume_s == 0.0) {
+                    rs->resume_s = t_s;
+                }
+            }
+            Pipeline_ProcessBlock(&ctx, block);
+            rs->samples += block->count;
+            if (t_s >= STEADY_FROM_S && t_s < STEADY_TO_S) {
+                rs->steady_samples += block->count;
+            }
+            Acquisition_SetDecimation(block->sensor_id, Pipeline_GetRateRequest(&ctx));
+            Acquisition_Release();
+        }
+    }
+    rs->bus_bytes = Acquisition_GetBusBytes();
+    rs->busy_ms = 1e3 * (double)HostI2c_GetStats()->busy_cycles / HOST_CORE_HZ;
+    rs->conversions = Sim_GetSensorStats(0)->conversions;
+    rs->led_charge_uc = Sim_GetSensorStats(0)->led_charge_uc;
+    TEST_CHECK(Acquisition_GetDropped() == 0);
+    TEST_CHECK(Sim_GetSensorStats(0)->overflows == 0);
+}
+
+/**
+ * @brief Run() in a freshly booted child process
+ * @param adaptive - 1 to follow the rate requests of the pipeline
+ * @param rs - [out] Measurements
+ * @return 1 if the child completed with all its checks passed
+ */
+static uint8_t RunChild(uint8_t adaptive, RunStats *rs) {
+    int fd[2];
+    int status = 0;
+    memset(rs, 0, sizeof(*rs));
+    if (pipe(fd) != 0) {
+        return 0;
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fd[0]);
+        Run(adaptive, rs);
+        ssize_t w = write(fd[1], rs, sizeof(*rs));
+        fflush(stdout);
+        _exit((w == (ssize_t)sizeof(*rs) && test_failures == 0) ? 0 : 1);
+    }
+    close(fd[1]);
+    ssize_t r = (pid > 0) ? read(fd[0], rs, sizeof(*rs)) : -1;
+    close(fd[0]);
+    if (pid > 0) {
+        waitpid(pid, &status, 0);
+    }
+    return (r == (ssize_t)sizeof(*rs) && pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+int main(void) {
+    RunStats fixed, adapt;
+
+    TEST_CHECK(RunChild(0, &fixed));
+    TEST_CHECK(RunChild(1, &adapt));
+    printf("rate: %u s, motion %.0f-%.0f s; reduced at %.2f s, full at %.2f s, reduced again at %.2f s\n",
+           (unsigned)RATE_TEST_SECONDS, MOTION_START_S, MOTION_END_S, adapt.reduced_s, adapt.wake_s, adapt.resume_s);
+    printf("%-8s %10s %12s %10s %12s %12s %14s\n", "run", "bus bytes", "steady B/s", "I2C ms", "samples",
+           "conversions", "LED charge mC");
+    const RunStats *runs[2] = { &fixed, &adapt };
+    for (uint32_t i = 0; i < 2; i++) {
+        printf("%-8s %10u %12.1f %10.1f %12u %12u %14.2f\n", i ? "adaptive" : "fixed", (unsigned)runs[i]->bus_bytes,
+               (double)runs[i]->steady_bytes / (STEADY_TO_S - STEADY_FROM_S), runs[i]->busy_ms,
+               (unsigned)runs[i]->samples, (unsigned)runs[i]->conversions, runs[i]->led_charge_uc / 1e3);
+    }
+    double bus_ratio = (double)adapt.bus_bytes / fixed.bus_bytes;
+    double steady_ratio = (double)adapt.steady_bytes / fixed.steady_bytes;
+    printf("adaptive/fixed: bus bytes %.2f (steady %.2f), I2C time %.2f, samples %.2f (steady %.2f), LED charge %.3f\n",
+           bus_ratio, steady_ratio, adapt.busy_ms / fixed.busy_ms, (double)adapt.samples / fixed.samples,
+           (double)adapt.steady_samples / fixed.steady_samples, adapt.led_charge_uc / fixed.led_charge_uc);
+
+    // Switching: quiet period after the start-up transient of the high-pass, wake on motion,
+    // slow down again after it
+    TEST_CHECK(fixed.switches == 0 && fixed.samples + 2u >= RATE_TEST_SECONDS * SIM_TICK_HZ);
+    TEST_CHECK(adapt.switches == 3u);
+    TEST_CHECK(adapt.reduced_s >= (double)RATE_QUIET_SAMPLES / SIM_TICK_HZ && adapt.reduced_s < 25.0);
+    TEST_CHECK(adapt.wake_s >= MOTION_START_S && adapt.wake_s < MOTION_START_S + 1.0);
+    TEST_CHECK(adapt.resume_s >= MOTION_END_S + (double)RATE_QUIET_SAMPLES / SIM_TICK_HZ
+               && adapt.resume_s < MOTION_END_S + 25.0);
+
+    // Bandwidth: steady phases cost 1 / RATE_TEST_DECIM of the register traffic and samples;
+    // over the trace about half, with the start-up, the motion and both quiet periods at full rate
+    TEST_NEAR((double)adapt.steady_samples / fixed.steady_samples, 1.0 / RATE_TEST_DECIM, 0.01);
+    TEST_CHECK(steady_ratio < 0.3);
+    TEST_CHECK(bus_ratio < 0.6 && adapt.busy_ms < 0.6 * fixed.busy_ms);
+
+    // Power: the LEDs and the ADC keep converting at the full rate
+    TEST_NEAR((double)adapt.conversions / fixed.conversions, 1.0, 1e-3);
+    TEST_NEAR(adapt.led_charge_uc / fixed.led_charge_uc, 1.0, 1e-3);
+    return TEST_EXIT();
+}
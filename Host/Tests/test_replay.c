@@ -0,0 +1,243 @@
+/**
+ * @file test_replay.c
+ * @brief Golden replay of recorded raw Red/IR samples through Pipeline_ProcessBlock()
+ * @details Host/Data/replay_raw.csv holds 60 s of raw currents (nA, 50 Hz) recorded from
+ *          a virtual MAX30101 through the acquisition path (18-bit counts of the 4096 nA
+ *          range, so every value is a multiple of 1/64 nA and the text is exact). The
+ *          trace has a cardiac pulse, respiration, a slow drift and a baseline step.
+ *
+ *          It is replayed in SAMPLE_BLOCK_LEN blocks through the two high-pass variants of
+ *          main.c (FILTER_TYPE):
+ *          - dc_blocker: α = 0.995, 600 warm-up iterations
+ *          - biquad: Design_Filter() of the Chebyshev II spec (order 4, 0.04 Hz, 80 dB) at 50 Hz
+ *
+ *          Every valid output sample must match Host/Data/replay_<variant>.csv within
+ *          REPLAY_TOL_NA, and the throughput of each variant is reported in samples/s.
+ *
+ *          Usage: test_replay [--record | --update]
+ *          - --record: re-record replay_raw.csv from the simulator
+ *          - --update: rewrite the golden files from the current pipeline (after an
+ *            intended change of the filter outputs)
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Acquisition.h"
+#include "FilterDesign.h"
+#include "MAX30101.h"
+#include "Pipeline.h"
+#include "Sim.h"
+#include "Test.h"
+
+#ifndef HOST_DATA_DIR
+#define HOST_DATA_DIR   "Host/Data"
+#endif
+
+#define REPLAY_FS_HZ        50.0
+#define REPLAY_SECONDS      60u
+#define REPLAY_MAX          (REPLAY_SECONDS * 50u)
+#define REPLAY_TOL_NA       1e-3    /**< Output tolerance (nA), 1/16 of the 1/64 nA ADC step */
+#define REPLAY_BENCH_PASSES 200u    /**< Passes over the trace for the throughput figure */
+#define REPLAY_IIR_ORDER    4
+#define REPLAY_IIR_SECTIONS ((REPLAY_IIR_ORDER + 1) / 2)
+
+/**
+ * @struct Variant
+ * @brief One high-pass configuration and its golden file
+ */
+typedef struct {
+    const char *name;
+    Pipeline_Config cfg;
+} Variant;
+
+static float32_t raw[REPLAY_MAX][2];    /**< Recorded Red/IR (nA) */
+static float32_t out[REPLAY_MAX][2];    /**< Pipeline output */
+static uint32_t n_raw = 0;
+
+/**
+ * @brief Signal of the recording: pulse, respiration, drift and a baseline step at 30 s
+ */
+static float32_t RecordSignal(void *ctx, uint8_t sensor, uint8_t channel, double t_s) {
+    double base = (channel == SIM_CH_IR) ? SIM_IR_NA_PER_MA : SIM_RED_NA_PER_MA;
+    double pulse = 0.01 * sin(2.0 * M_PI * 1.2 * t_s) + 0.004 * sin(2.0 * M_PI * 2.4 * t_s + 0.8);
+    double resp = 0.006 * sin(2.0 * M_PI * 0.25 * t_s);
+    double drift = 0.02 * t_s / REPLAY_SECONDS;
+    double step = (t_s >= 30.0) ? -0.03 : 0.0;
+    return (float32_t)(base * (1.0 + pulse + resp + drift + step));
+}
+
+/**
+ * @brief Record REPLAY_SECONDS of raw samples from one virtual sensor
+ * @param path - [in] Output file
+ * @return 0 on success
+ */
+static int Record(const char *path) {
+    SampleBlock *block;
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        return 1;
+    }
+    Sim_Init(1);
+    Sim_SetSignal(RecordSignal, NULL);
+    Sim_Boot();
+    fprintf(f, "# Raw Red/IR currents (nA), 50 Hz, virtual MAX30101 (NIRS Lite profile, 4096 nA range)\n");
+    uint32_t n = 0;
+    while (n < REPLAY_MAX) {
+        Sim_Tick();
+        while ((block = Acquisition_Peek()) != NULL) {
+            for (uint8_t k = 0; k < block->count && n < REPLAY_MAX; k++, n++) {
+                fprintf(f, "%.6f,%.6f\n", (double)block->ch[SB_CH_RED][k], (double)block->ch[SB_CH_IR][k]);
+            }
+            Acquisition_Release();
+        }
+    }
+    fclose(f);
+    printf("replay: recorded %u samples to %s\n", (unsigned)n, path);
+    return 0;
+}
+
+/**
+ * @brief Read a two-column CSV file ('#' lines are comments)
+ * @param path - [in] File
+ * @param rows - [out] Values
+ * @param max - Rows available
+ * @return Rows read
+ */
+static uint32_t ReadCsv(const char *path, float32_t rows[][2], uint32_t max) {
+    char line[128];
+    uint32_t n = 0;
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        printf("replay: cannot open %s\n", path);
+        return 0;
+    }
+    while (n < max && fgets(line, sizeof(line), f) != NULL) {
+        float a, b;
+        if (line[0] != '#' && sscanf(line, "%f,%f", &a, &b) == 2) {
+            rows[n][0] = a;
+            rows[n][1] = b;
+            n++;
+        }
+    }
+    fclose(f);
+    return n;
+}
+
+/**
+ * @brief Run the recorded trace through a fresh pipeline
+ * @param cfg - [in] Configuration
+ * @return Index of the first valid output sample
+ */
+static uint32_t Replay(const Pipeline_Config *cfg) {
+    static Pipeline_Context ctx;
+    SampleBlock b;
+    uint32_t first = 0;
+
+    Pipeline_Init(&ctx, cfg);
+    for (uint32_t i = 0; i < n_raw; i += SAMPLE_BLOCK_LEN) {
+        memset(&b, 0, sizeof(b));
+        b.seq = i;
+        b.count = (uint8_t)((n_raw - i < SAMPLE_BLOCK_LEN) ? n_raw - i : SAMPLE_BLOCK_LEN);
+        b.decimation = 1;
+        b.adc_range = MAX30101_NIRSLiteProfile.adc_range;
+        b.led[SB_CH_RED] = b.led[SB_CH_IR] = MAX30101_LED_MA_TO_REG(MAX30101_NIRSLiteProfile.led_red_ma);
+        for (uint8_t k = 0; k < b.count; k++) {
+            b.ch[SB_CH_RED][k] = raw[i + k][0];
+            b.ch[SB_CH_IR][k] = raw[i + k][1];
+        }
+        Pipeline_ProcessBlock(&ctx, &b);
+        if (i == 0) {
+            first = b.first;
+        }
+        for (uint8_t k = 0; k < b.count; k++) {
+            out[i + k][0] = b.ch[SB_CH_RED][k];
+            out[i + k][1] = b.ch[SB_CH_IR][k];
+        }
+    }
+    return first;
+}
+
+/**
+ * @brief Seconds of a monotonic clock
+ * @return Time (s)
+ */
+static double Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+    static float32_t golden[REPLAY_MAX][2];
+    float32_t iir[5 * REPLAY_IIR_SECTIONS];
+    const Design_Spec spec = { DESIGN_CHEBY2, DESIGN_HIGHPASS, REPLAY_IIR_ORDER, 0.04f, 0.0f, 80.0f };
+    uint8_t update = (argc > 1 && strcmp(argv[1], "--update") == 0);
+    char path[256];
+
+    if (argc > 1 && strcmp(argv[1], "--record") == 0) {
+        return Record(HOST_DATA_DIR "/replay_raw.csv");
+    }
+    TEST_CHECK(Design_Filter(&spec, (float32_t)REPLAY_FS_HZ, iir, REPLAY_IIR_SECTIONS) == REPLAY_IIR_SECTIONS);
+    Variant variants[2];
+    memset(variants, 0, sizeof(variants));
+    variants[0].name = "dc_blocker";
+    variants[0].cfg.filter = PIPELINE_FILTER_DC_BLOCKER;
+    variants[0].cfg.alpha = 0.995f;
+    variants[0].cfg.warmup_samples = 600;
+    variants[1].name = "biquad";
+    variants[1].cfg.filter = PIPELINE_FILTER_BIQUAD;
+    variants[1].cfg.iir_coeffs = iir;
+    variants[1].cfg.iir_sections = REPLAY_IIR_SECTIONS;
+    variants[1].cfg.alpha = 0.995f;
+    variants[1].cfg.warmup_samples = 600;
+
+    n_raw = ReadCsv(HOST_DATA_DIR "/replay_raw.csv", raw, REPLAY_MAX);
+    TEST_CHECK(n_raw == REPLAY_MAX);
+    if (n_raw == 0) {
+        return TEST_EXIT();
+    }
+    for (uint32_t v = 0; v < 2; v++) {
+        const Variant *var = &variants[v];
+        uint32_t first = Replay(&var->cfg);
+        snprintf(path, sizeof(path), "%s/replay_%s.csv", HOST_DATA_DIR, var->name);
+        if (update) {
+            FILE *f = fopen(path, "w");
+            TEST_CHECK(f != NULL);
+            if (f != NULL) {
+                fprintf(f, "# %s high-pass output of replay_raw.csv (nA), from sample %u\n", var->name, (unsigned)first);
+                for (uint32_t i = first; i < n_raw; i++) {
+                    fprintf(f, "%.9g,%.9g\n", (double)out[i][0], (double)out[i][1]);
+                }
+                fclose(f);
+                printf("replay: wrote %s\n", path);
+            }
+            continue;
+        }
+
+        uint32_t n = ReadCsv(path, golden, REPLAY_MAX);
+        double worst = 0.0;
+        TEST_CHECK(first == 1u);
+        TEST_CHECK(n == n_raw - first);
+        for (uint32_t i = 0; i < n && first + i < n_raw; i++) {
+            for (uint8_t c = 0; c < 2; c++) {
+                double d = fabs((double)out[first + i][c] - (double)golden[i][c]);
+                worst = (d > worst) ? d : worst;
+            }
+        }
+
+        double t0 = Now();
+        for (uint32_t p = 0; p < REPLAY_BENCH_PASSES; p++) {
+            Replay(&var->cfg);
+        }
+        double sps = (double)REPLAY_BENCH_PASSES * n_raw / (Now() - t0);
+        printf("%-10s %u samples, max |out - golden| %.3g nA (tol %g nA), %.2f M samples/s\n", var->name,
+               (unsigned)n, worst, REPLAY_TOL_NA, sps / 1e6);
+        TEST_CHECK(worst <= REPLAY_TOL_NA);
+    }
+    return TEST_EXIT();
+}
@@ -0,0 +1,226 @@
+/**
+ * @file test_sched.c
+ * @brief Scheduler with an injected tick and cycle source
+ * @details Task bodies advance the fake counters by a set amount, so run times and
+ *          completion ticks are exact:
+ *          - timer releases at every period, drift-free after a late run
+ *          - priority order between ready tasks, registration order on equal priority
+ *          - coalesced event releases, the deadline measured from the first signal, and
+ *            a signal raised while the task runs
+ *          - deadline misses (late completion, default deadline = period) and overrun
+ *            accounting of skipped timer releases
+ *          - last/max execution cycles, across a wrap of both counters
+ *          - table capacity and unknown IDs
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "Scheduler.h"
+#include "Test.h"
+
+static uint32_t now_ticks;              /**< Fake tick counter */
+static uint32_t now_cycles;             /**< Fake cycle counter */
+static uint32_t run_ticks;              /**< Ticks the next task body takes */
+static uint32_t run_cycles;             /**< Cycles the next task body takes */
+static char trace[64];                  /**< Task letters in run order */
+static uint32_t trace_len;
+static uint8_t resignal_id = SCHED_INVALID_TASK;    /**< Task signalled again from its own body */
+
+static uint32_t Ticks(void) {
+    return now_ticks;
+}
+
+static uint32_t Cycles(void) {
+    return now_cycles;
+}
+
+/**
+ * @brief Common task body: log the task and consume the configured time
+ */
+static void Body(char name) {
+    if (trace_len + 1u < sizeof(trace)) {
+        trace[trace_len++] = name;
+        trace[trace_len] = '\0';
+    }
+    now_ticks += run_ticks;
+    now_cycles += run_cycles;
+    if (resignal_id != SCHED_INVALID_TASK) {
+        Sched_Signal(resignal_id);  // As an ISR would during the run
+        resignal_id = SCHED_INVALID_TASK;
+    }
+}
+
+static void RunA(void) { Body('A'); }
+static void RunB(void) { Body('B'); }
+static void RunC(void) { Body('C'); }
+
+/**
+ * @brief Run every ready task
+ * @return Tasks run
+ */
+static uint32_t Drain(void) {
+    uint32_t n = 0;
+    while (Sched_RunOnce()) {
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Statistics of a task
+ */
+static Sched_Stats Stats(uint8_t id) {
+    Sched_Stats s;
+    memset(&s, 0, sizeof(s));
+    TEST_CHECK(Sched_GetStats(id, &s));
+    return s;
+}
+
+/**
+ * @brief Restart the scheduler at given counter values
+ */
+static void Reset(uint32_t ticks, uint32_t cycles) {
+    now_ticks = ticks;
+    now_cycles = cycles;
+    run_ticks = 0;
+    run_cycles = 0;
+    trace_len = 0;
+    trace[0] = '\0';
+    Sched_Init(Ticks, Cycles);
+}
+
+int main(void) {
+    // Period: released at 5, 10, ... and drift-free after a late run
+    static const Sched_Task timer = { "timer", RunA, 1, 5, 0 };
+    Reset(0, 0);
+    uint8_t t = Sched_AddTask(&timer);
+    uint32_t release_ticks[32], n = 0;
+    for (now_ticks = 0; now_ticks <= 100; now_ticks++) {
+        if (now_ticks == 40) {
+            now_ticks += 2;     // Main loop busy: the release at 40 is served at 42
+        }
+        uint32_t tick = now_ticks;
+        if (Drain() && n < 32) {
+            release_ticks[n++] = tick;
+        }
+    }
+    TEST_CHECK(n == 20u);
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t expect = 5u * (i + 1u);
+        TEST_CHECK(release_ticks[i] == ((expect == 40u) ? 42u : expect));
+    }
+    TEST_CHECK(Stats(t).runs == 20u && Stats(t).deadline_misses == 0);
+
+    // Priority: most urgent first, registration order on equal priority
+    static const Sched_Task ev_low = { "low", RunA, 3, 0, 0 };
+    static const Sched_Task ev_high = { "high", RunB, 0, 0, 0 };
+    static const Sched_Task ev_high2 = { "high2", RunC, 0, 0, 0 };
+    Reset(0, 0);
+    uint8_t low = Sched_AddTask(&ev_low);
+    uint8_t high = Sched_AddTask(&ev_high);
+    uint8_t high2 = Sched_AddTask(&ev_high2);
+    Sched_Signal(low);
+    Sched_Signal(high2);
+    Sched_Signal(high);
+    TEST_CHECK(Drain() == 3u);
+    TEST_CHECK(strcmp(trace, "BCA") == 0);
+    TEST_CHECK(Drain() == 0u);
+
+    // Pending flag: signals coalesce, a signal during the run releases it again
+    static const Sched_Task ev = { "event", RunA, 0, 0, 2 };
+    Reset(100, 0);
+    uint8_t e = Sched_AddTask(&ev);
+    Sched_Signal(e);
+    now_ticks = 101;
+    Sched_Signal(e);
+    Sched_Signal(e);
+    TEST_CHECK(Drain() == 1u);
+    TEST_CHECK(Stats(e).runs == 1u && Stats(e).deadline_misses == 0);
+    // Deadline from the first unserved signal: signalled at 102, run at 105
+    now_ticks = 102;
+    Sched_Signal(e);
+    now_ticks = 104;
+    Sched_Signal(e);
+    now_ticks = 105;
+    TEST_CHECK(Drain() == 1u);
+    TEST_CHECK(Stats(e).deadline_misses == 1u);
+    resignal_id = e;
+    Sched_Signal(e);
+    TEST_CHECK(Drain() == 2u);
+    TEST_CHECK(Stats(e).runs == 4u);
+
+    // Deadline enforcement: completion after deadline_ticks (or period_ticks) is a miss
+    static const Sched_Task dl = { "deadline", RunA, 0, 0, 3 };
+    static const Sched_Task per = { "period", RunB, 1, 4, 0 };
+    Reset(0, 0);
+    uint8_t d = Sched_AddTask(&dl);
+    uint8_t p = Sched_AddTask(&per);
+    run_ticks = 3;
+    Sched_Signal(d);
+    Drain();
+    TEST_CHECK(Stats(d).deadline_misses == 0);      // Completed exactly at the deadline
+    run_ticks = 4;
+    Sched_Signal(d);
+    TEST_CHECK(Sched_RunOnce());
+    TEST_CHECK(Stats(d).deadline_misses == 1u);
+    // The period task was released at 4 and runs after d at 7, completing at 9 (deadline 8)
+    run_ticks = 2;
+    TEST_CHECK(Sched_RunOnce());
+    TEST_CHECK(Stats(p).runs == 1u && Stats(p).deadline_misses == 1u);
+    // Its next release (8) is served at 9, in time
+    run_ticks = 0;
+    TEST_CHECK(Drain() == 1u);
+    TEST_CHECK(Stats(p).runs == 2u && Stats(p).deadline_misses == 1u);
+
+    // Overrun: releases a full period behind are skipped and counted, the run serves the latest
+    Reset(0, 0);
+    p = Sched_AddTask(&per);
+    now_ticks = 4;
+    Drain();
+    now_ticks = 21;             // Releases at 8, 12, 16, 20 pending
+    TEST_CHECK(Drain() == 1u);
+    TEST_CHECK(Stats(p).runs == 2u && Stats(p).deadline_misses == 3u);
+    now_ticks = 23;
+    TEST_CHECK(Drain() == 0u);  // Next release at 24, in phase with the period
+    now_ticks = 24;
+    TEST_CHECK(Drain() == 1u);
+    TEST_CHECK(Stats(p).deadline_misses == 3u);
+
+    // Execution time across a wrap of both counters
+    Reset(0xFFFFFFFEu, 0xFFFFFF00u);
+    p = Sched_AddTask(&per);
+    now_ticks = 0xFFFFFFFEu + 4u;    // Wrapped
+    run_cycles = 1000;
+    TEST_CHECK(Drain() == 1u);
+    run_cycles = 300;
+    now_ticks += 4u;
+    TEST_CHECK(Drain() == 1u);
+    Sched_Stats s = Stats(p);
+    TEST_CHECK(s.runs == 2u && s.deadline_misses == 0);
+    TEST_CHECK(s.last_cycles == 300u && s.max_cycles == 1000u);
+
+    // Without a cycle counter execution time is not measured
+    Sched_Init(Ticks, NULL);
+    e = Sched_AddTask(&ev);
+    run_cycles = 500;
+    Sched_Signal(e);
+    Drain();
+    TEST_CHECK(Stats(e).runs == 1u && Stats(e).last_cycles == 0);
+
+    // Capacity and unknown IDs
+    Reset(0, 0);
+    for (uint32_t i = 0; i < SCHED_MAX_TASKS; i++) {
+        TEST_CHECK(Sched_AddTask(&ev) == i);
+    }
+    TEST_CHECK(Sched_AddTask(&ev) == SCHED_INVALID_TASK);
+    TEST_CHECK(Sched_GetTaskCount() == SCHED_MAX_TASKS);
+    Sched_Signal(SCHED_MAX_TASKS);      // Ignored
+    TEST_CHECK(Drain() == 0u);
+    TEST_CHECK(Sched_GetStats(SCHED_MAX_TASKS, &s) == 0);
+    TEST_CHECK(Sched_GetName(SCHED_MAX_TASKS) == NULL);
+    TEST_CHECK(strcmp(Sched_GetName(0), "event") == 0);
+    return TEST_EXIT();
+}
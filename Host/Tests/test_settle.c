@@ -0,0 +1,304 @@
+/**
+ * @file test_settle.c
+ * @brief Settings changes while streaming: exact block tags and tick-based temperature timing
+ * @details One virtual sensor sees a slow IR ramp (SETTLE_RAMP nA per mA per conversion),
+ *          so consecutive samples of a block differ by a known step: SETTLE_RAMP × the
+ *          decimation, in nA per mA of the tagged LED current. A sample tagged with settings
+ *          it was not taken with breaks that step. Each tick is a little longer than a
+ *          conversion period (SETTLE_DRIFT_US), so the FIFO writes sweep across the drain
+ *          and the settings write of Acquisition_Poll(), and the sensor stores samples in
+ *          between on some of the changes. Checked:
+ *          - decimation: Acquisition_SetDecimation() cycles through 1, 4, 2 and 8 every
+ *            SETTLE_CHANGE_TICKS ticks; every block must be on the ramp with its tag, and
+ *            every change must come with SB_FLAG_GAP (samples discarded by the settle)
+ *          - ADC range and LED current: Acquisition_SetLed() cycles through the four ranges
+ *            and two IR currents; the ramp must continue across every change without a
+ *            step (unless samples were discarded), and every change must come with
+ *            SB_FLAG_GAIN
+ *          - temperature: with a 50-tick period, results must arrive as often at a
+ *            decimation of 4 as at full rate
+ *
+ *          Each run boots in a child process, so the driver state (mux selection cache,
+ *          acquisition counters) starts from reset as after a power cycle.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Acquisition.h"
+#include "HostDevice.h"
+#include "Sim.h"
+#include "Test.h"
+
+#define SETTLE_IR_START         50.0    /**< IR signal at t = 0 (nA per mA) */
+#define SETTLE_RAMP             0.02    /**< IR signal step per conversion (nA per mA): 170 nA per mA after 120 s */
+#define SETTLE_TOL              1e-4    /**< Step tolerance beyond the ADC steps of both samples (nA per mA) */
+#define SETTLE_DRIFT_US         37u     /**< Extra time per tick: the conversion phase sweeps the tick in ~540 ticks */
+#define SETTLE_CHANGE_TICKS     11u     /**< Ticks between setting requests (longer than the slowest drain interval) */
+#define SETTLE_TICKS            6000u   /**< Ticks per run */
+#define SETTLE_TEMP_PERIOD      50u     /**< Temperature period of the timing check (ticks) */
+#define SETTLE_TEMP_TICKS       2000u   /**< Ticks of the timing check */
+
+/**
+ * @brief IR ramp, constant Red
+ */
+static float32_t RampSignal(void *ctx, uint8_t sensor, uint8_t channel, double t_s) {
+    (void)ctx;
+    (void)sensor;
+    if (channel != SIM_CH_IR) {
+        return SIM_RED_NA_PER_MA;
+    }
+    return (float32_t)(SETTLE_IR_START + SETTLE_RAMP * SIM_TICK_HZ * t_s);
+}
+
+/**
+ * @struct RampCheck
+ * @brief Ramp continuity across the block stream of one sensor
+ */
+typedef struct {
+    double   last;          /**< Last IR sample (nA per mA of its tagged current) */
+    double   last_lsb;      /**< ADC step of the last sample (nA per mA) */
+    uint32_t next_seq;      /**< Sequence number expected next */
+    uint8_t  decimation;    /**< Decimation of the last block */
+    uint8_t  range;         /**< ADC range of the last block */
+    uint8_t  led;           /**< IR LED code of the last block */
+    uint8_t  tag;           /**< Flag every change must carry */
+    uint8_t  started;       /**< A block was seen */
+    uint32_t samples;       /**< Samples checked */
+    uint32_t off_ramp;      /**< Steps off the ramp */
+    uint32_t changes;       /**< Blocks whose tags differ from the previous block */
+    uint32_t untagged;      /**< Changes without SB_FLAG_GAP */
+    uint32_t gaps;          /**< Blocks with SB_FLAG_GAP */
+    uint32_t skipped;       /**< Samples the sequence numbers skip */
+} RampCheck;
+
+/**
+ * @struct RunStats
+ * @brief Results of one run
+ */
+typedef struct {
+    RampCheck ramp;         /**< Ramp check of the stream */
+    uint32_t  temps;        /**< Temperature results */
+} RunStats;
+
+/**
+ * @brief Check one block against the ramp
+ * @param rc - [in,out] Check state
+ * @param block - [in] Block
+ * @return void
+ */
+static void Ramp_Block(RampCheck *rc, const SampleBlock *block) {
+    double ma = MAX30101_LED_REG_TO_MA(block->led[SB_CH_IR]);
+    double lsb = MAX30101_RANGE_FULLSCALE_NA(block->adc_range) / (1u << MAX30101_ADC_BITS) / ma;
+    double step = SETTLE_RAMP * block->decimation;
+    uint8_t gap = (block->flags & SB_FLAG_GAP) != 0u;
+    uint8_t changed = rc->started && (block->decimation != rc->decimation || block->adc_range != rc->range ||
+                                      block->led[SB_CH_IR] != rc->led);
+    // Across a gap or a decimation change the distance is unknown; otherwise it is one step
+    uint8_t joined = rc->started && !gap && block->decimation == rc->decimation;
+
+    if (gap) {
+        rc->gaps++;
+        rc->skipped += block->seq - rc->next_seq;
+    } else if (rc->started) {
+        TEST_CHECK(block->seq == rc->next_seq);
+    }
+    if (changed) {
+        rc->changes++;
+        rc->untagged += !(block->flags & rc->tag);
+    }
+    for (uint8_t k = 0; k < block->count; k++) {
+        double v = block->ch[SB_CH_IR][k] / ma;
+        // Each sample is truncated to its ADC step: the difference is within both steps
+        if ((k > 0 || joined) && fabs(v - rc->last - step) > rc->last_lsb + lsb + SETTLE_TOL) {
+            if (rc->off_ramp < 5u) {
+                printf("settle: seq %u tick %u: step %.4f nA/mA, expected %.4f (decimation %u, range %u, LED %.1f mA)\n",
+                       (unsigned)(block->seq + k), (unsigned)block->tick, v - rc->last, step,
+                       block->decimation, block->adc_range, ma);
+            }
+            rc->off_ramp++;
+        }
+        rc->last = v;
+        rc->last_lsb = lsb;
+    }
+    rc->samples += block->count;
+    rc->next_seq = block->seq + block->count;
+    rc->decimation = block->decimation;
+    rc->range = block->adc_range;
+    rc->led = block->led[SB_CH_IR];
+    rc->started = 1;
+}
+
+/**
+ * @brief Run the stream with periodic decimation requests
+ * @param arg - Unused
+ * @param rs - [out] Results
+ * @return void
+ */
+static void Run_Decimation(uint8_t arg, RunStats *rs) {
+    static const uint8_t decims[] = { 1, 4, 2, 8 };
+    RampCheck *rc = &rs->ramp;
+    uint8_t id;
+    SampleBlock *block;
+
+    (void)arg;
+    rc->tag = SB_FLAG_GAP;
+    Sim_Init(1);
+    id = Sim_Sensors()[0].id;
+    Sim_SetSignal(RampSignal, NULL);
+    Sim_Boot();
+    Acquisition_SetTemperaturePeriod(0);
+    for (uint32_t tick = 0; tick < SETTLE_TICKS; tick++) {
+        if (tick % SETTLE_CHANGE_TICKS == 0u) {
+            Acquisition_SetDecimation(id, decims[(tick / SETTLE_CHANGE_TICKS) % 4u]);
+        }
+        Sim_Tick();
+        Host_Advance(HOST_US_TO_CYCLES(SETTLE_DRIFT_US));
+        while ((block = Acquisition_Peek()) != NULL) {
+            Ramp_Block(rc, block);
+            Acquisition_Release();
+        }
+    }
+    TEST_CHECK(Acquisition_GetDropped() == 0);
+    TEST_CHECK(Acquisition_GetErrors(id) == 0);
+}
+
+/**
+ * @brief Run the stream with periodic LED current and ADC range requests
+ * @param arg - Unused
+ * @param rs - [out] Results
+ * @return void
+ */
+static void Run_Led(uint8_t arg, RunStats *rs) {
+    // Red, IR code (0.2 mA steps) and range; the ramp stays below 2048 nA at 10 mA
+    static const uint8_t settings[][3] = {
+        { 50, 50, MAX30101_ADC_RGE_2048NA }, { 50, 50, MAX30101_ADC_RGE_8192NA },
+        { 50, 40, MAX30101_ADC_RGE_16384NA }, { 50, 40, MAX30101_ADC_RGE_4096NA },
+    };
+    RampCheck *rc = &rs->ramp;
+    uint8_t id;
+    SampleBlock *block;
+
+    (void)arg;
+    rc->tag = SB_FLAG_GAIN;
+    Sim_Init(1);
+    id = Sim_Sensors()[0].id;
+    Sim_SetSignal(RampSignal, NULL);
+    Sim_Boot();
+    Acquisition_SetTemperaturePeriod(0);
+    for (uint32_t tick = 0; tick < SETTLE_TICKS; tick++) {
+        if (tick % SETTLE_CHANGE_TICKS == 0u) {
+            const uint8_t *set = settings[(tick / SETTLE_CHANGE_TICKS) % 4u];
+            Acquisition_SetLed(id, set, set[2]);
+        }
+        Sim_Tick();
+        Host_Advance(HOST_US_TO_CYCLES(SETTLE_DRIFT_US));
+        while ((block = Acquisition_Peek()) != NULL) {
+            Ramp_Block(rc, block);
+            Acquisition_Release();
+        }
+    }
+    TEST_CHECK(Acquisition_GetDropped() == 0);
+    TEST_CHECK(Acquisition_GetErrors(id) == 0);
+}
+
+/**
+ * @brief Temperature results over SETTLE_TEMP_TICKS ticks at one decimation
+ * @param decimation - On-chip averaging
+ * @param rs - [out] Results
+ * @return void
+ */
+static void Run_Temperature(uint8_t decimation, RunStats *rs) {
+    uint8_t id;
+    float32_t deg_c;
+
+    Sim_Init(1);
+    id = Sim_Sensors()[0].id;
+    Sim_Boot();
+    Acquisition_SetTemperaturePeriod(SETTLE_TEMP_PERIOD);
+    Acquisition_SetDecimation(id, decimation);
+    for (uint32_t tick = 0; tick < SETTLE_TEMP_TICKS; tick++) {
+        Sim_Tick();
+        while (Acquisition_Peek() != NULL) {
+            Acquisition_Release();
+        }
+        if (Acquisition_GetTemperature(id, &deg_c)) {
+            TEST_NEAR(deg_c, SIM_DIE_TEMP_C, 0.0625);
+            rs->temps++;
+        }
+    }
+}
+
+/**
+ * @brief Run a scenario in a freshly booted child process
+ * @param run - Scenario
+ * @param arg - Scenario argument
+ * @param rs - [out] Results
+ * @return 1 if the child completed with all its checks passed
+ */
+static uint8_t RunChild(void (*run)(uint8_t arg, RunStats *rs), uint8_t arg, RunStats *rs) {
+    int fd[2];
+    int status = 0;
+    memset(rs, 0, sizeof(*rs));
+    if (pipe(fd) != 0) {
+        return 0;
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fd[0]);
+        run(arg, rs);
+        ssize_t w = write(fd[1], rs, sizeof(*rs));
+        fflush(stdout);
+        _exit((w == (ssize_t)sizeof(*rs) && test_failures == 0) ? 0 : 1);
+    }
+    close(fd[1]);
+    ssize_t r = (pid > 0) ? read(fd[0], rs, sizeof(*rs)) : -1;
+    close(fd[0]);
+    if (pid > 0) {
+        waitpid(pid, &status, 0);
+    }
+    return (r == (ssize_t)sizeof(*rs) && pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+/**
+ * @brief Report and check the ramp of a run
+ * @param name - Scenario name
+ * @param rc - [in] Ramp check
+ * @return void
+ */
+static void Ramp_Report(const char *name, const RampCheck *rc) {
+    printf("settle: %s: %u samples, %u changes (%u flagged, %u samples discarded), %u off the ramp\n",
+           name, (unsigned)rc->samples, (unsigned)rc->changes, (unsigned)(rc->changes - rc->untagged),
+           (unsigned)rc->skipped, (unsigned)rc->off_ramp);
+    TEST_CHECK(rc->off_ramp == 0u);
+    TEST_CHECK(rc->untagged == 0u);
+    // A request superseded before its first kept sample (the slow rates) shows no block
+    TEST_CHECK(rc->changes >= SETTLE_TICKS / SETTLE_CHANGE_TICKS / 2u);
+}
+
+int main(void) {
+    RunStats decim, led, full, reduced;
+
+    // Children inherit the failure count: run them all before checking
+    uint8_t ok = RunChild(Run_Decimation, 0, &decim);
+    ok &= RunChild(Run_Led, 0, &led);
+    ok &= RunChild(Run_Temperature, 1, &full);
+    ok &= RunChild(Run_Temperature, 4, &reduced);
+    TEST_CHECK(ok);
+    Ramp_Report("decimation", &decim.ramp);
+    Ramp_Report("range/LED", &led.ramp);
+    TEST_CHECK(led.ramp.gaps > 0u);
+
+    // Period and conversion wait count ticks: each cycle is the period plus the conversion
+    // wait, rounded up to the sensor's drains (every tick, or every 4th)
+    printf("settle: temperature every %u ticks: %u results at full rate, %u at 1/4 over %u ticks\n",
+           (unsigned)SETTLE_TEMP_PERIOD, (unsigned)full.temps, (unsigned)reduced.temps, (unsigned)SETTLE_TEMP_TICKS);
+    TEST_CHECK(full.temps >= SETTLE_TEMP_TICKS / (SETTLE_TEMP_PERIOD + ACQ_TEMP_CONV_TICKS + 2u));
+    TEST_CHECK(reduced.temps >= SETTLE_TEMP_TICKS / (SETTLE_TEMP_PERIOD + ACQ_TEMP_CONV_TICKS + 8u));
+    TEST_CHECK(full.temps <= SETTLE_TEMP_TICKS / SETTLE_TEMP_PERIOD && reduced.temps <= full.temps);
+    return TEST_EXIT();
+}
@@ -0,0 +1,86 @@
+/**
+ * @file test_sim.c
+ * @brief Simulator check: four virtual sensors drained by Acquisition_Poll() for 10 s
+ * @details Checks that every sensor delivers a gap-free sample stream with the expected
+ *          photocurrents, that no sensor FIFO overflows, that each poll stays inside
+ *          ACQ_TICK_BUDGET_US and that the die temperature side channel delivers.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Acquisition.h"
+#include "HostI2c.h"
+#include "Sim.h"
+#include "Test.h"
+
+#define SIM_SENSORS     4
+#define SIM_SECONDS     10
+
+int main(void) {
+    uint32_t next_seq[SIM_SENSORS] = { 0 };
+    uint32_t samples[SIM_SENSORS] = { 0 };
+    double sum[SIM_SENSORS][2] = { { 0 } };
+    float32_t lo[SIM_SENSORS][2], hi[SIM_SENSORS][2];
+    uint8_t temp_seen[SIM_SENSORS] = { 0 };
+    SampleBlock *block;
+
+    for (int i = 0; i < SIM_SENSORS; i++) {
+        lo[i][0] = lo[i][1] = 1e9f;
+        hi[i][0] = hi[i][1] = -1e9f;
+    }
+    Sim_Init(SIM_SENSORS);
+    Sim_Boot();
+    for (uint32_t tick = 0; tick < SIM_SECONDS * SIM_TICK_HZ; tick++) {
+        Sim_Tick();
+        while ((block = Acquisition_Peek()) != NULL) {
+            uint8_t id = block->sensor_id;
+            TEST_CHECK(id < SIM_SENSORS);
+            TEST_CHECK(block->seq == next_seq[id]);
+            TEST_CHECK(!(block->flags & SB_FLAG_GAP));
+            next_seq[id] = block->seq + block->count;
+            for (uint8_t k = 0; k < block->count; k++) {
+                for (int c = 0; c < 2; c++) {
+                    float32_t v = block->ch[c == 0 ? SB_CH_RED : SB_CH_IR][k];
+                    sum[id][c] += v;
+                    lo[id][c] = (v < lo[id][c]) ? v : lo[id][c];
+                    hi[id][c] = (v > hi[id][c]) ? v : hi[id][c];
+                }
+            }
+            samples[id] += block->count;
+            Acquisition_Release();
+        }
+        for (uint8_t i = 0; i < SIM_SENSORS; i++) {
+            float32_t deg_c;
+            if (Acquisition_GetTemperature(i, &deg_c)) {
+                TEST_NEAR(deg_c, SIM_DIE_TEMP_C, 1e-3);
+                temp_seen[i] = 1;
+            }
+        }
+    }
+
+    uint32_t poll_us = Sim_GetMaxPollCycles() / (HOST_CORE_HZ / 1000000u);
+    printf("sim: %d sensors, %d s, max poll %u us, bus busy %.1f %%\n", SIM_SENSORS, SIM_SECONDS,
+           (unsigned)poll_us, 100.0 * (double)HostI2c_GetStats()->busy_cycles / (double)Host_Cycles());
+    TEST_CHECK(poll_us <= ACQ_TICK_BUDGET_US);
+    TEST_CHECK(Acquisition_GetDropped() == 0);
+    TEST_CHECK(Acquisition_GetFifoOverflows() == 0);
+    for (uint8_t i = 0; i < SIM_SENSORS; i++) {
+        const Sim_SensorStats *st = Sim_GetSensorStats(i);
+        double led_ma = MAX30101_NIRSLiteProfile.led_red_ma;
+        printf("sensor %u: %u samples, red %.1f nA, ir %.1f nA\n", i, (unsigned)samples[i],
+               sum[i][0] / samples[i], sum[i][1] / samples[i]);
+        TEST_CHECK(Acquisition_GetErrors(i) == 0);
+        TEST_CHECK(st->overflows == 0);
+        // At most the samples of the last tick are still in the sensor FIFO
+        TEST_CHECK(samples[i] + 2u >= st->samples && samples[i] <= st->samples);
+        TEST_CHECK(samples[i] + 2u >= SIM_SECONDS * SIM_TICK_HZ);
+        TEST_NEAR(sum[i][0] / samples[i], SIM_RED_NA_PER_MA * led_ma, 0.01 * SIM_RED_NA_PER_MA * led_ma);
+        TEST_NEAR(sum[i][1] / samples[i], SIM_IR_NA_PER_MA * led_ma, 0.01 * SIM_IR_NA_PER_MA * led_ma);
+        TEST_CHECK(hi[i][1] <= SIM_IR_NA_PER_MA * led_ma * (1.0f + SIM_PULSE_DEPTH) + 0.1f);
+        TEST_CHECK(lo[i][1] >= SIM_IR_NA_PER_MA * led_ma * (1.0f - SIM_PULSE_DEPTH) - 0.1f);
+        TEST_CHECK(hi[i][1] - lo[i][1] > SIM_IR_NA_PER_MA * led_ma * SIM_PULSE_DEPTH);
+        TEST_CHECK(temp_seen[i]);
+    }
+    return TEST_EXIT();
+}
@@ -0,0 +1,153 @@
+/**
+ * @file test_stats.c
+ * @brief Sliding-window statistics against a naive recompute over a long run
+ * @details Four channels with large DC levels (2000 nA to 1.5e5 nA, one negative), each
+ *          with a slow drift, a pulse, noise and occasional steps, are pushed 200000 frames
+ *          into windows of several capacities. At checkpoints (every frame at the start,
+ *          then a spread of positions around the history wrap) Stats_Get() is compared with
+ *          mean, sample variance, min/max and least-squares slope recomputed in double over
+ *          the test's own copy of the window:
+ *          - min and max exactly
+ *          - mean within STATS_TOL_MEAN of the DC level (float resolution) plus the spread
+ *          - variance within STATS_TOL_VAR relative, slope within STATS_TOL_SLOPE of the
+ *            slope scale of the window (standard deviation per window length)
+ *
+ *          A constant run at the largest DC must give zero variance and slope. The worst
+ *          normalized errors are printed.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "Stats.h"
+#include "Test.h"
+
+#define STATS_FRAMES        200000u
+#define STATS_CHANNELS      4u
+#define STATS_MAX_CAP       1000u
+#define STATS_TOL_MEAN      1e-6    /**< Of the DC level */
+#define STATS_TOL_VAR       1e-3    /**< Relative */
+#define STATS_TOL_SLOPE     1e-3    /**< Of std / capacity */
+
+static const double dc[STATS_CHANNELS] = { 2000.0, 48000.0, -3000.0, 150000.0 };
+static const double amp[STATS_CHANNELS] = { 4.0, 30.0, 0.5, 120.0 };
+
+static float32_t hist[STATS_STORAGE_LEN(STATS_MAX_CAP, STATS_CHANNELS)];
+static uint16_t min_q[STATS_STORAGE_LEN(STATS_MAX_CAP, STATS_CHANNELS)];
+static uint16_t max_q[STATS_STORAGE_LEN(STATS_MAX_CAP, STATS_CHANNELS)];
+static float32_t frames[STATS_FRAMES][STATS_CHANNELS];
+
+static double worst_mean = 0.0, worst_var = 0.0, worst_slope = 0.0;
+static uint32_t checks = 0;
+
+/**
+ * @brief Uniform random number in [-1, 1]
+ */
+static double Noise(void) {
+    return 2.0 * rand() / RAND_MAX - 1.0;
+}
+
+/**
+ * @brief Compare the window with the naive statistics of frames [end − n, end)
+ */
+static void Compare(const Stats_Window *sw, uint32_t end) {
+    uint32_t n = sw->count;
+    TEST_CHECK(n == ((end < sw->capacity) ? end : sw->capacity));
+    for (uint8_t c = 0; c < STATS_CHANNELS; c++) {
+        double sum = 0.0, lo = INFINITY, hi = -INFINITY;
+        for (uint32_t k = 0; k < n; k++) {
+            double x = frames[end - n + k][c];
+            sum += x;
+            lo = fmin(lo, x);
+            hi = fmax(hi, x);
+        }
+        double mean = sum / n, m2 = 0.0, kd = 0.0;
+        for (uint32_t k = 0; k < n; k++) {
+            double e = frames[end - n + k][c] - mean;
+            m2 += e * e;
+            kd += (k - 0.5 * (n - 1.0)) * e;
+        }
+        double var = (n > 1u) ? m2 / (n - 1.0) : 0.0;
+        double slope = (n > 1u) ? kd / (n * ((double)n * n - 1.0) / 12.0) : 0.0;
+        double std = sqrt(var);
+
+        Stats_Result r;
+        Stats_Get(sw, c, &r);
+        double e_mean = fabs(r.mean - mean) / (STATS_TOL_MEAN * fabs(dc[c]) + 1e-4 * std);
+        double e_var = fabs(r.var - var) / (STATS_TOL_VAR * var + 1e-12);
+        double e_slope = (n > 1u) ? fabs(r.slope - slope) / (STATS_TOL_SLOPE * std / n + 1e-12) : 0.0;
+        TEST_CHECK(r.min == lo && r.max == hi);
+        TEST_CHECK(e_mean <= 1.0);
+        TEST_CHECK(e_var <= 1.0);
+        TEST_CHECK(e_slope <= 1.0);
+        if (e_mean > 1.0 || e_var > 1.0 || e_slope > 1.0) {
+            printf("stats: capacity %u frame %u channel %u: mean %.6f/%.6f var %.6g/%.6g slope %.6g/%.6g\n",
+                   (unsigned)sw->capacity, (unsigned)end, c, (double)r.mean, mean, (double)r.var, var,
+                   (double)r.slope, slope);
+        }
+        worst_mean = fmax(worst_mean, e_mean);
+        worst_var = fmax(worst_var, e_var);
+        worst_slope = fmax(worst_slope, e_slope);
+        checks++;
+    }
+}
+
+int main(void) {
+    static const uint16_t caps[] = { 2, 7, 64, 375, STATS_MAX_CAP };
+    Stats_Window sw;
+
+    // Drift, 1.2 Hz pulse, noise and a step every 7919 frames, at 50 Hz
+    srand(2026);
+    double step[STATS_CHANNELS] = { 0 };
+    for (uint32_t i = 0; i < STATS_FRAMES; i++) {
+        double t = i / 50.0;
+        for (uint8_t c = 0; c < STATS_CHANNELS; c++) {
+            if (i % 7919u == 7918u) {
+                step[c] = 20.0 * amp[c] * Noise();
+            }
+            frames[i][c] = (float32_t)(dc[c] + step[c] + amp[c] * (5.0 * sin(2.0 * M_PI * t / 600.0)
+                                       + sin(2.0 * M_PI * 1.2 * t + c) + 0.3 * Noise()));
+        }
+    }
+
+    for (uint32_t w = 0; w < sizeof(caps) / sizeof(caps[0]); w++) {
+        uint16_t cap = caps[w];
+        Stats_Init(&sw, STATS_CHANNELS, cap, hist, min_q, max_q);
+        for (uint32_t i = 0; i < STATS_FRAMES; i++) {
+            Stats_Push(&sw, frames[i]);
+            uint32_t end = i + 1u;
+            uint32_t phase = end % cap;
+            if (end <= 2u * cap || phase <= 1u || phase == cap / 2u || phase + 1u == cap || end % 997u == 0) {
+                Compare(&sw, end);
+            }
+        }
+        // Stats_PushRows() continues the same window
+        const float32_t *rows[STATS_CHANNELS];
+        float32_t cols[STATS_CHANNELS][8];
+        for (uint8_t c = 0; c < STATS_CHANNELS; c++) {
+            for (uint32_t k = 0; k < 8u; k++) {
+                cols[c][k] = frames[k][c];
+            }
+            rows[c] = cols[c];
+        }
+        Stats_Reset(&sw);
+        Stats_PushRows(&sw, rows, 8);
+        Compare(&sw, 8u);
+    }
+
+    // A constant level at the largest DC: no spread, no trend
+    Stats_Init(&sw, 1, 375, hist, min_q, max_q);
+    const float32_t level = (float32_t)dc[3];
+    for (uint32_t i = 0; i < 3000u; i++) {
+        Stats_Push(&sw, &level);
+    }
+    Stats_Result r;
+    Stats_Get(&sw, 0, &r);
+    TEST_CHECK(r.mean == level && r.var == 0.0f && r.slope == 0.0f && r.min == level && r.max == level);
+
+    printf("stats: %u channel checks over capacities 2..%u, worst error / tolerance: mean %.3f, var %.3f, slope %.3f\n",
+           (unsigned)checks, (unsigned)STATS_MAX_CAP, worst_mean, worst_var, worst_slope);
+    return TEST_EXIT();
+}
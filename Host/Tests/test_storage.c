@@ -0,0 +1,309 @@
+/**
+ * @file test_storage.c
+ * @brief Session recorder on the file-backed storage backend, and the flash deadline
+ * @details On a file with the geometry of the flash log (FLASH_LOG_PAGES × FLASH_PAGE_BYTES):
+ *          - session 1 logs two sensors until the page ring has wrapped several times;
+ *            every retained sample decodes to the value pushed, page seqs are consecutive
+ *            in ring order and the erase counts of all pages differ by at most one
+ *          - a reboot (file closed with a partly written page, reopened) continues on the
+ *            page after the newest one with the next seq and a session record, and
+ *            session 2 starts its sample indices at 0
+ *          - Recorder_Dump() sends the header line, every valid page oldest first and
+ *            the end line
+ *          - Recorder_Erase() leaves one page with a seq above every earlier one
+ *
+ *          The Flash_Backend erase of a controller that stays busy returns
+ *          STORAGE_ERR_TIMEOUT after FLASH_ERASE_TIMEOUT_US.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "Flash.h"
+#include "HostStorage.h"
+#include "HostUart.h"
+#include "Recorder.h"
+#include "Sim.h"
+#include "UART.h"
+#include "Test.h"
+
+#define STORAGE_PATH    "test_storage.bin"
+#define SENSORS         2u
+#define SESSION1_N      12000u  /**< Samples per sensor in session 1 (several ring wraps) */
+#define SESSION2_N      300u    /**< Samples per sensor in session 2 (not flushed before the dump) */
+#define PAGE_BYTES      FLASH_PAGE_BYTES
+#define PAGES           FLASH_LOG_PAGES
+#define DUMP_MAX        (PAGES * PAGE_BYTES + 64u)
+
+/**
+ * @struct Session
+ * @brief Samples pushed in one session, as ADC counts
+ */
+typedef struct {
+    uint32_t id;                        /**< Session record value (seq of its first page) */
+    uint32_t n;                         /**< Samples per sensor */
+    int32_t  counts[SENSORS][2][SESSION1_N];
+} Session;
+
+/**
+ * @struct LogCheck
+ * @brief Result of decoding the whole log
+ */
+typedef struct {
+    uint32_t pages;                     /**< Valid pages */
+    uint32_t newest;                    /**< Page with the highest seq */
+    uint32_t max_seq;                   /**< Highest seq */
+    uint32_t sessions;                  /**< Session records */
+    uint32_t samples;                   /**< Samples decoded */
+    uint32_t mismatches;                /**< Samples that differ from the pushed value */
+    uint32_t next[2][SENSORS];          /**< Index after the last decoded sample, per session */
+    uint8_t  consecutive;               /**< Page seqs increase by one in ring order */
+} LogCheck;
+
+static Session sessions[2];
+static uint8_t dump[DUMP_MAX];
+static uint32_t dump_len = 0;
+
+/**
+ * @brief Collect USART2 output
+ */
+static void Capture(void *ctx, uint8_t byte) {
+    if (dump_len < DUMP_MAX) {
+        dump[dump_len++] = byte;
+    }
+}
+
+static uint32_t GetU32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Decode a zigzag varint
+ * @param p - [in,out] Read pointer
+ * @return Value
+ */
+static int32_t GetVarint(const uint8_t **p) {
+    uint32_t z = 0;
+    for (uint8_t shift = 0; ; shift += 7) {
+        uint8_t b = *(*p)++;
+        z |= (uint32_t)(b & 0x7Fu) << shift;
+        if (!(b & 0x80u)) {
+            break;
+        }
+    }
+    return (int32_t)(z >> 1) ^ -(int32_t)(z & 1u);
+}
+
+/**
+ * @brief Push one session's samples: a random walk with steps of all varint lengths
+ * @param s - [in,out] Session (id set, counts filled)
+ * @param n - Samples per sensor
+ * @return void
+ */
+static void PushSession(Session *s, uint32_t n) {
+    s->n = n;
+    for (uint32_t k = 0; k < n; k++) {
+        for (uint8_t id = 0; id < SENSORS; id++) {
+            for (uint8_t c = 0; c < 2; c++) {
+                int32_t prev = (k == 0) ? 40000 * (c + 1) : s->counts[id][c][k - 1];
+                int32_t step = (rand() % 64 == 0) ? (rand() % 20001) - 10000 : (rand() % 129) - 64;
+                int32_t v = prev + step;
+                s->counts[id][c][k] = (v < 0) ? -v : v;
+            }
+            Recorder_Push(id, (float32_t)s->counts[id][0][k] / RECORDER_COUNTS_PER_NA,
+                          (float32_t)s->counts[id][1][k] / RECORDER_COUNTS_PER_NA);
+        }
+    }
+}
+
+/**
+ * @brief Newest page and its seq from the page headers
+ * @param b - [in] Backend
+ * @param seq - [out] Highest seq (0 if the log is empty)
+ * @return Page index
+ */
+static uint16_t Newest(const Storage_Backend *b, uint32_t *seq) {
+    uint8_t hdr[8];
+    uint16_t newest = 0;
+    *seq = 0;
+    for (uint16_t p = 0; p < b->num_pages; p++) {
+        b->read((uint32_t)p * b->page_size, hdr, sizeof(hdr));
+        if (GetU32(hdr) == RECORDER_PAGE_MAGIC && GetU32(&hdr[4]) > *seq) {
+            *seq = GetU32(&hdr[4]);
+            newest = p;
+        }
+    }
+    return newest;
+}
+
+/**
+ * @brief Decode every valid page, oldest first, and compare with the pushed samples
+ * @param b - [in] Backend
+ * @param nsessions - Sessions pushed so far
+ * @param out - [out] Result
+ * @return void
+ */
+static void DecodeLog(const Storage_Backend *b, uint8_t nsessions, LogCheck *out) {
+    static uint8_t page[PAGE_BYTES];
+    uint32_t prev_seq = 0;
+
+    memset(out, 0, sizeof(*out));
+    out->consecutive = 1;
+    out->newest = Newest(b, &out->max_seq);
+    for (uint16_t n = 1; n <= b->num_pages; n++) {
+        uint16_t p = (uint16_t)((out->newest + n) % b->num_pages);
+        b->read((uint32_t)p * b->page_size, page, (uint16_t)b->page_size);
+        if (GetU32(page) != RECORDER_PAGE_MAGIC) {
+            continue;
+        }
+        uint32_t seq = GetU32(&page[4]);
+        if (out->pages++ && seq != prev_seq + 1u) {
+            out->consecutive = 0;
+        }
+        prev_seq = seq;
+        // A page belongs to the newest session that started at or before it
+        uint8_t si = 0;
+        for (uint8_t i = 0; i < nsessions; i++) {
+            if (sessions[i].id <= seq) {
+                si = i;
+            }
+        }
+        for (uint32_t off = 8; off + 2u <= b->page_size; ) {
+            uint16_t len = (uint16_t)(page[off] | (page[off + 1] << 8));
+            if (len == 0xFFFFu) {
+                break;
+            }
+            const uint8_t *r = &page[off + 2];
+            if (r[0] == RECORDER_REC_SESSION) {
+                out->sessions++;
+                TEST_CHECK(GetU32(&r[2]) == seq);
+            } else if (r[0] == RECORDER_REC_SAMPLES) {
+                uint8_t id = r[1], count = r[2];
+                uint32_t index = GetU32(&r[4]);
+                const uint8_t *v = &r[8];
+                int32_t red = 0, ir = 0;
+                TEST_CHECK(id < SENSORS);
+                for (uint8_t k = 0; k < count && id < SENSORS; k++, index++) {
+                    red += GetVarint(&v);
+                    ir += GetVarint(&v);
+                    const Session *s = &sessions[si];
+                    if (index >= s->n || s->counts[id][0][index] != red || s->counts[id][1][index] != ir) {
+                        out->mismatches++;
+                    }
+                    out->samples++;
+                }
+                // Records of one sensor follow each other without a gap
+                if (id < SENSORS) {
+                    TEST_CHECK(out->next[si][id] == 0 || out->next[si][id] == index - count);
+                    out->next[si][id] = index;
+                }
+                TEST_CHECK((uint32_t)(v - r) <= len);
+            } else {
+                TEST_CHECK(0);
+                break;
+            }
+            off += 2u + len + (len & 1u);
+        }
+    }
+}
+
+int main(void) {
+    LogCheck log;
+    uint32_t seq;
+
+    remove(STORAGE_PATH);
+    const Storage_Backend *b = HostStorage_Open(STORAGE_PATH, PAGE_BYTES, PAGES);
+    TEST_CHECK(b != NULL);
+    if (b == NULL) {
+        return TEST_EXIT();
+    }
+    Sim_Init(1);
+    Sim_Boot();
+    UART_Config(460800u);
+    HostUart_SetTxSink(Capture, NULL);
+    srand(2026);
+
+    // Session 1 on an erased medium: wraps the ring
+    TEST_CHECK(Recorder_Init(b) == STORAGE_OK);
+    Newest(b, &sessions[0].id);
+    TEST_CHECK(sessions[0].id == 1u);
+    PushSession(&sessions[0], SESSION1_N);
+    TEST_CHECK(Recorder_Flush() == STORAGE_OK);
+    DecodeLog(b, 1, &log);
+    uint32_t lo = UINT32_MAX, hi = 0;
+    for (uint16_t p = 0; p < PAGES; p++) {
+        uint32_t e = HostStorage_GetEraseCount(p);
+        lo = (e < lo) ? e : lo;
+        hi = (e > hi) ? e : hi;
+    }
+    printf("session 1: %u pages written, %u samples retained of %u, page erases %u..%u\n",
+           (unsigned)log.max_seq, (unsigned)log.samples, (unsigned)(SESSION1_N * SENSORS), (unsigned)lo, (unsigned)hi);
+    TEST_CHECK(log.max_seq > 2u * PAGES);
+    TEST_CHECK(log.pages == PAGES);
+    TEST_CHECK(log.consecutive);
+    TEST_CHECK(log.mismatches == 0);
+    TEST_CHECK(log.samples > 0 && log.samples < SESSION1_N * SENSORS);
+    TEST_CHECK(log.next[0][0] == SESSION1_N && log.next[0][1] == SESSION1_N);
+    TEST_CHECK(hi - lo <= 1u);
+
+    // Reboot with a partly written page: logging continues on the page after the newest
+    for (uint32_t k = 0; k < 5; k++) {
+        Recorder_Push(0, 1.0f, 2.0f);   // Lost: never flushed
+    }
+    uint16_t newest = Newest(b, &seq);
+    HostStorage_Close();
+    b = HostStorage_Open(STORAGE_PATH, PAGE_BYTES, PAGES);
+    TEST_CHECK(Recorder_Init(b) == STORAGE_OK);
+    uint16_t resumed = Newest(b, &sessions[1].id);
+    printf("reboot: newest page %u (seq %u), resumed on page %u (seq %u)\n",
+           (unsigned)newest, (unsigned)seq, (unsigned)resumed, (unsigned)sessions[1].id);
+    TEST_CHECK(resumed == (newest + 1u) % PAGES);
+    TEST_CHECK(sessions[1].id == seq + 1u);
+    PushSession(&sessions[1], SESSION2_N);
+
+    // Dump: flushes session 2, then every valid page oldest first
+    dump_len = 0;
+    Recorder_Dump();
+    DecodeLog(b, 2, &log);
+    TEST_CHECK(log.consecutive);
+    TEST_CHECK(log.mismatches == 0);
+    TEST_CHECK(log.sessions >= 1u);
+    TEST_CHECK(log.next[1][0] == SESSION2_N && log.next[1][1] == SESSION2_N);
+    static const char head[] = "#dump,8,2048\r\n";
+    static const char tail[] = "#dump,end\r\n";
+    uint32_t body = PAGES * PAGE_BYTES;
+    TEST_CHECK(dump_len == strlen(head) + body + strlen(tail));
+    TEST_CHECK(memcmp(dump, head, strlen(head)) == 0);
+    TEST_CHECK(memcmp(&dump[strlen(head) + body], tail, strlen(tail)) == 0);
+    uint32_t dump_mismatch = 0;
+    for (uint16_t n = 1; n <= PAGES; n++) {
+        static uint8_t page[PAGE_BYTES];
+        b->read((uint32_t)((log.newest + n) % PAGES) * PAGE_BYTES, page, PAGE_BYTES);
+        dump_mismatch += memcmp(&dump[strlen(head) + (n - 1u) * PAGE_BYTES], page, PAGE_BYTES) != 0;
+    }
+    TEST_CHECK(dump_mismatch == 0);
+    printf("dump: %u bytes, %u pages\n", (unsigned)dump_len, (unsigned)log.pages);
+
+    // Erase: one page left, seq keeps counting
+    uint32_t before = log.max_seq;
+    TEST_CHECK(Recorder_Erase() == STORAGE_OK);
+    DecodeLog(b, 2, &log);
+    TEST_CHECK(log.pages == 1u && log.max_seq > before);
+    TEST_CHECK(log.sessions == 1u && log.samples == 0);
+    HostStorage_Close();
+    remove(STORAGE_PATH);
+
+    // Flash controller stuck busy: the erase gives up at its deadline
+    Host_FLASH.SR = FLASH_SR_BSY;
+    uint64_t t0 = Host_Cycles();
+    Storage_Status status = Flash_Backend.erase(0);
+    uint64_t us = (Host_Cycles() - t0) / (HOST_CORE_HZ / 1000000u);
+    printf("flash busy: status %d after %u us (deadline %u us)\n", (int)status, (unsigned)us,
+           (unsigned)FLASH_ERASE_TIMEOUT_US);
+    TEST_CHECK(status == STORAGE_ERR_TIMEOUT);
+    TEST_CHECK(us >= FLASH_ERASE_TIMEOUT_US && us <= FLASH_ERASE_TIMEOUT_US + 10u);
+    TEST_CHECK(!(Host_FLASH.CR & FLASH_CR_PER) && (Host_FLASH.CR & FLASH_CR_LOCK));
+    return TEST_EXIT();
+}
@@ -0,0 +1,178 @@
+/**
+ * @file test_telemetry.c
+ * @brief "#tlm" frames through Tlm_Format() and back through the host decoder
+ * @details The encoder is the one Output_Telemetry() calls, so the layout checked here is
+ *          the layout on the wire:
+ *          - Round trip: edge frames (zeros, UINT32_MAX, 0 % and 100 %, negative zero,
+ *            inf and nan, the largest float) and TLM_TEST_FRAMES random ones. Each line
+ *            must start with "#tlm,", end in "\r\n", hold nine commas and fit in
+ *            TLM_LINE_MAX_CHARS; integers must come back exactly and decimals as the
+ *            "%.4f" text of the value (so within 0.5e-4 for small values)
+ *          - Field order: a frame with a distinct value per field, read back by position
+ *          - Rejection: every strict prefix of a valid line, every single-byte
+ *            corruption to a separator or letter, and hand-made malformed lines
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Telemetry.h"
+#include "TelemetryDecode.h"
+#include "Test.h"
+
+#define TLM_TEST_FRAMES     20000u
+
+/**
+ * @brief Random 32-bit value, spread over all magnitudes
+ */
+static uint32_t Random_Uint(void) {
+    uint32_t v = ((uint32_t)rand() << 16) ^ (uint32_t)rand() ^ ((uint32_t)rand() << 31);
+    return v >> ((uint32_t)rand() % 32u);
+}
+
+/**
+ * @brief Random float, spread over all magnitudes and both signs
+ */
+static float32_t Random_Float(void) {
+    double m = rand() / (double)RAND_MAX;
+    double v = ldexp(m, rand() % 80 - 20);
+    return (float32_t)((rand() & 1) ? -v : v);
+}
+
+/**
+ * @brief Decimal field equal to the "%.4f" text of the encoded value
+ */
+static uint8_t Same_Fixed4(float32_t got, float32_t sent) {
+    char text[64];
+    if (isnan(sent)) {
+        return (uint8_t)isnan(got);
+    }
+    snprintf(text, sizeof(text), "%.4f", (double)sent);
+    float32_t want = (float32_t)strtod(text, NULL);
+    return (uint8_t)(memcmp(&got, &want, sizeof(got)) == 0 || got == want);
+}
+
+/**
+ * @brief Encode, check the line shape, decode and compare
+ * @return Encoded length
+ */
+static uint32_t Round_Trip(const Tlm_Frame *sent, char *line) {
+    Tlm_Frame got;
+    uint32_t len = (uint32_t)(Tlm_Format(line, sent) - line);
+    uint32_t commas = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        commas += (line[i] == ',') ? 1u : 0u;
+    }
+    TEST_CHECK(len <= TLM_LINE_MAX_CHARS);
+    TEST_CHECK(memcmp(line, TLM_PREFIX, sizeof(TLM_PREFIX) - 1u) == 0);
+    TEST_CHECK(line[len - 2u] == '\r' && line[len - 1u] == '\n');
+    TEST_CHECK(commas == TLM_FIELDS);
+    TEST_CHECK(Tlm_Parse(line, len, &got));
+    TEST_CHECK(Tlm_Parse(line, len - 2u, &got));    // Without the line ending
+    TEST_CHECK(got.t_us == sent->t_us && got.tx_pending == sent->tx_pending && got.tx_peak == sent->tx_peak &&
+               got.ring_peak == sent->ring_peak && got.dropped == sent->dropped && got.fifo_ovf == sent->fifo_ovf);
+    TEST_CHECK(Same_Fixed4(got.idle_pct, sent->idle_pct) && Same_Fixed4(got.i2c_pct, sent->i2c_pct) &&
+               Same_Fixed4(got.latency_us, sent->latency_us) && Same_Fixed4(got.isr_max_us, sent->isr_max_us));
+    if (fabsf(sent->idle_pct) <= 100.0f) {
+        TEST_NEAR(got.idle_pct, sent->idle_pct, 0.5e-4 + 100.0 * FLT_EPSILON);
+    }
+    return len;
+}
+
+int main(void) {
+    char line[TLM_LINE_MAX_CHARS + 8];
+    Tlm_Frame f, got;
+    uint32_t longest = 0;
+
+    // Edge frames
+    static const Tlm_Frame edges[] = {
+        { 0, 0.0f, 0.0f, 0, 0, 0, 0, 0, 0.0f, 0.0f },
+        { UINT32_MAX, 100.0f, 100.0f, UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX, 1e6f, 1e6f },
+        { 1, 99.99995f, 0.00005f, 1, 10, 100, 1000, 10000, 0.125f, 3.0e-5f },
+        { 4000000000u, -0.0f, -1e-9f, 9, 99, 999, 9999, 99999, INFINITY, -INFINITY },
+        { 123, NAN, 50.0f, 7, 8, 9, 10, 11, FLT_MAX, -FLT_MAX },
+    };
+    for (uint32_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+        uint32_t len = Round_Trip(&edges[i], line);
+        longest = (len > longest) ? len : longest;
+    }
+
+    // Random frames
+    srand(2026);
+    for (uint32_t i = 0; i < TLM_TEST_FRAMES; i++) {
+        f.t_us = Random_Uint();
+        f.idle_pct = 100.0f * (float32_t)rand() / (float32_t)RAND_MAX;
+        f.i2c_pct = Random_Float();
+        f.tx_pending = Random_Uint();
+        f.tx_peak = Random_Uint();
+        f.ring_peak = Random_Uint();
+        f.dropped = Random_Uint();
+        f.fifo_ovf = Random_Uint();
+        f.latency_us = Random_Float();
+        f.isr_max_us = Random_Float();
+        uint32_t len = Round_Trip(&f, line);
+        longest = (len > longest) ? len : longest;
+    }
+
+    // Field order: a distinct value per field
+    f = (Tlm_Frame){ 1, 2.0f, 3.0f, 4, 5, 6, 7, 8, 9.0f, 10.0f };
+    uint32_t len = (uint32_t)(Tlm_Format(line, &f) - line);
+    line[len] = '\0';
+    TEST_CHECK(strcmp(line, "#tlm,1,2.0000,3.0000,4,5,6,7,8,9.0000,10.0000\r\n") == 0);
+    TEST_CHECK(Tlm_Parse(line, len, &got));
+    TEST_CHECK(got.t_us == 1u && got.idle_pct == 2.0f && got.i2c_pct == 3.0f && got.tx_pending == 4u &&
+               got.tx_peak == 5u && got.ring_peak == 6u && got.dropped == 7u && got.fifo_ovf == 8u &&
+               got.latency_us == 9.0f && got.isr_max_us == 10.0f);
+
+    // Truncated lines and single-byte corruptions
+    uint32_t rejected = 0, trials = 0;
+    for (uint32_t n = 0; n < len - 2u; n++) {
+        TEST_CHECK(!Tlm_Parse(line, n, &got));
+    }
+    for (uint32_t i = 0; i < len - 2u; i++) {
+        static const char bad[] = { ',', 'x', '\r', ' ' };
+        for (uint32_t b = 0; b < sizeof(bad); b++) {
+            char saved = line[i];
+            if (saved == bad[b]) {
+                continue;
+            }
+            line[i] = bad[b];
+            rejected += Tlm_Parse(line, len, &got) ? 0u : 1u;
+            trials++;
+            line[i] = saved;
+        }
+    }
+    TEST_CHECK(rejected == trials);
+
+    static const char *const malformed[] = {
+        "#tlm,1,2.0000,3.0000,4,5,6,7,8,9.0000\r\n",                    // 9 fields
+        "#tlm,1,2.0000,3.0000,4,5,6,7,8,9.0000,10.0000,11\r\n",         // 11 fields
+        "#tlm,4294967296,2.0000,3.0000,4,5,6,7,8,9.0000,10.0000\r\n",   // Over 32 bits
+        "#tlm,-1,2.0000,3.0000,4,5,6,7,8,9.0000,10.0000\r\n",           // Signed integer
+        "#tlm,01,2.0000,3.0000,4,5,6,7,8,9.0000,10.0000\r\n",           // Leading zero
+        "#tlm,1,2.000,3.0000,4,5,6,7,8,9.0000,10.0000\r\n",             // Three decimals
+        "#tlm,1,2,3.0000,4,5,6,7,8,9.0000,10.0000\r\n",                 // No decimals
+        "#tlm,1,.0000,3.0000,4,5,6,7,8,9.0000,10.0000\r\n",             // No integer digit
+        "#tlm,1,2.0000,3.0000,4.0000,5,6,7,8,9.0000,10.0000\r\n",       // Decimal in an integer field
+        "#tlm,1,2.0000,3.0000,,5,6,7,8,9.0000,10.0000\r\n",             // Empty field
+        "#tlm,1,2.0000,-nan,4,5,6,7,8,9.0000,10.0000\r\n",              // Signed NaN
+        "#tlx,1,2.0000,3.0000,4,5,6,7,8,9.0000,10.0000\r\n",            // Tag
+        "#tlm,1,2.0000,3.0000,4,5,6,7,8,9.0000,10.0000\n\r\n",          // Stray line feed
+    };
+    for (uint32_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++) {
+        uint8_t ok = Tlm_Parse(malformed[i], (uint32_t)strlen(malformed[i]), &got);
+        if (ok) {
+            printf("telemetry: accepted malformed line %u\n", (unsigned)i);
+        }
+        TEST_CHECK(!ok);
+    }
+
+    printf("telemetry: %u frames round-tripped (longest %u of %u chars), %u corruptions rejected\n",
+           (unsigned)(TLM_TEST_FRAMES + sizeof(edges) / sizeof(edges[0])), (unsigned)longest,
+           (unsigned)TLM_LINE_MAX_CHARS, (unsigned)rejected);
+    return TEST_EXIT();
+}
@@ -0,0 +1,204 @@
+/**
+ * @file test_timesync.c
+ * @brief TimeSync host library on virtual clocks of known offset and drift
+ * @details Two boards boot at different host times and run 80 min, past the 71.6 min
+ *          wrap of the 32-bit device µs. Each board has its own oscillator error (SysTick,
+ *          device time) and its sensor another one (sample clock). The host time is the
+ *          true time, at a Unix-epoch µs scale. Per board the test generates what TIME_SYNC
+ *          sends, from the same rules as main.c:
+ *          - "#sync": every SYNC_PERIOD_TICKS drains, the newest sample number with the
+ *            device time (tick + 1) · 20000 µs of the drain that read it
+ *          - "#pong": one ping per second, with random exponential line delays, 5 % of
+ *            them delayed by a further 20 ms, and up to 100 ms of command-task delay
+ *            between t2 and t3
+ *
+ *          Checked: drift and offset of the clock fit, host time of every sample against
+ *          its true time, and the resampling of both boards' streams of one signal onto a
+ *          common grid against the signal itself. The timeline without synchronization
+ *          (nominal 50 Hz from the first sample) is printed for comparison.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "TimeSync.h"
+#include "Test.h"
+
+#define TS_BOARDS           2
+#define TS_SECONDS          4800u           /**< 80 min, past the 32-bit µs wrap */
+#define TS_PERIOD_US        20000.0         /**< Nominal sample and SysTick period */
+#define TS_SYNC_TICKS       50u             /**< SYNC_PERIOD_TICKS */
+#define TS_SAMPLES          (TS_SECONDS * 50u)
+#define TS_HOST_EPOCH_US    1.7e15          /**< Host clock origin (Unix µs) */
+#define TS_GRID_HZ          50.0
+
+/**
+ * @struct VirtualBoard
+ * @brief True timing of one board
+ */
+typedef struct {
+    double boot_us;         /**< Host time of SysTick_Config() (device time 0) */
+    double board_ppm;       /**< SysTick oscillator error */
+    double sensor_ppm;      /**< Sensor sample clock error */
+    double first_us;        /**< Host time of sample 0 */
+} VirtualBoard;
+
+static const VirtualBoard boards[TS_BOARDS] = {
+    { TS_HOST_EPOCH_US + 1.5e6,  40.0, -60.0, TS_HOST_EPOCH_US + 1.5e6 + 7300.0 },
+    { TS_HOST_EPOCH_US + 7.3e6, -25.0,  80.0, TS_HOST_EPOCH_US + 7.3e6 + 15100.0 },
+};
+
+static TSync_Board clock_fit[TS_BOARDS];
+static TSync_Stream stream[TS_BOARDS];
+static double t_true[TS_BOARDS][TS_SAMPLES];   /**< True sample times */
+static double t_sync[TS_BOARDS][TS_SAMPLES];   /**< Sample times from the fits */
+static double t_naive[TS_BOARDS][TS_SAMPLES];  /**< Nominal 50 Hz from the first sample */
+static float32_t x[TS_BOARDS][TS_SAMPLES];     /**< Samples of the common signal */
+static float32_t grid[3][TS_SECONDS * 50u];    /**< Resampled A, B and A without sync */
+
+/**
+ * @brief Uniform random number in (0, 1)
+ */
+static double Uniform(void) {
+    return ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+}
+
+/**
+ * @brief One-way line delay: 150 µs plus an exponential queueing delay, sometimes 20 ms more
+ */
+static double LineDelay(void) {
+    double d = 150.0 - 400.0 * log(Uniform());
+    return (Uniform() < 0.05) ? d + 20000.0 : d;
+}
+
+/**
+ * @brief Signal seen by every sensor
+ */
+static double Signal(double host_us) {
+    double t = (host_us - TS_HOST_EPOCH_US) * 1e-6;
+    return sin(2.0 * M_PI * 1.1 * t) + 0.3 * sin(2.0 * M_PI * 0.23 * t);
+}
+
+/**
+ * @brief Device time (µs, unwrapped) of a host time
+ */
+static double DeviceTime(const VirtualBoard *vb, double host_us) {
+    return (host_us - vb->boot_us) * (1.0 + vb->board_ppm * 1e-6);
+}
+
+/**
+ * @brief Generate the "#pong" and "#sync" lines of one board in arrival order
+ */
+static void RunBoard(uint8_t i) {
+    const VirtualBoard *vb = &boards[i];
+    double sample_us = TS_PERIOD_US / (1.0 + vb->sensor_ppm * 1e-6);
+    double tick_us = TS_PERIOD_US / (1.0 + vb->board_ppm * 1e-6);
+    double ping_us = vb->boot_us + 0.5e6;
+    uint32_t newest = 0;
+
+    TSync_BoardInit(&clock_fit[i]);
+    TSync_StreamInit(&stream[i]);
+    for (uint32_t k = 0; k < TS_SAMPLES; k++) {
+        t_true[i][k] = vb->first_us + k * sample_us;
+        t_naive[i][k] = vb->first_us + k * TS_PERIOD_US;
+        x[i][k] = (float32_t)Signal(t_true[i][k]);
+    }
+    for (uint32_t tick = 0; tick < TS_SECONDS * 50u; tick++) {
+        double drain_us = vb->boot_us + (tick + 1u) * tick_us;
+        // Pings that complete before this drain
+        while (ping_us < drain_us) {
+            double rx = ping_us + LineDelay();
+            double tx = rx + 100000.0 * Uniform();
+            double t4 = tx + LineDelay();
+            TSync_AddPing(&clock_fit[i], ping_us, (uint32_t)(uint64_t)DeviceTime(vb, rx),
+                          (uint32_t)(uint64_t)DeviceTime(vb, tx), t4);
+            ping_us += 1e6 + 1000.0 * Uniform();
+        }
+        while (newest + 1u < TS_SAMPLES && t_true[i][newest + 1u] <= drain_us) {
+            newest++;
+        }
+        if (tick % TS_SYNC_TICKS == 0 && t_true[i][0] <= drain_us) {
+            TSync_AddSync(&clock_fit[i], &stream[i], newest, (uint32_t)((uint64_t)(tick + 1u) * 20000u));
+        }
+    }
+    TEST_CHECK(TSync_FitClock(&clock_fit[i]));
+    TEST_CHECK(TSync_FitStream(&stream[i]));
+}
+
+int main(void) {
+    // Unwrap across 2^32 and back
+    TSync_Board u;
+    TSync_BoardInit(&u);
+    TEST_CHECK(TSync_Unwrap(&u, 0xFFFFFF00u) == 0xFFFFFF00ll);
+    TEST_CHECK(TSync_Unwrap(&u, 0x00000100u) == 0x100000100ll);
+    TEST_CHECK(TSync_Unwrap(&u, 0xFFFFFFF0u) == 0xFFFFFFF0ll);
+
+    // Resampling edges: outside the span, a single sample, exact sample times
+    const double ts[3] = { 10.0, 20.0, 40.0 };
+    const float32_t xs[3] = { 1.0f, 3.0f, -1.0f };
+    float32_t ys[7];
+    TEST_CHECK(TSync_Resample(ts, xs, 3, 5.0, 7.0, ys, 7) == 5u);
+    TEST_CHECK(isnan(ys[0]) && isnan(ys[6]));
+    TEST_NEAR(ys[1], 1.4, 1e-6);
+    TEST_NEAR(ys[2], 2.8, 1e-6);
+    TEST_NEAR(ys[3], 1.8, 1e-6);
+    TEST_NEAR(ys[4], 0.4, 1e-6);
+    TEST_NEAR(ys[5], -1.0, 1e-6);
+    TEST_CHECK(TSync_Resample(ts, xs, 1, 10.0, 1.0, ys, 2) == 1u && ys[0] == 1.0f && isnan(ys[1]));
+
+    srand(2026);
+    for (uint8_t i = 0; i < TS_BOARDS; i++) {
+        const VirtualBoard *vb = &boards[i];
+        RunBoard(i);
+
+        // Clock: slope 1 / (1 + ppm), host time of device time across the session
+        double b_true = 1.0 / (1.0 + vb->board_ppm * 1e-6);
+        double drift_err = (clock_fit[i].clock.slope - b_true) * 1e6;
+        double off_err = 0.0;
+        for (double h = vb->boot_us + 1e6; h < vb->boot_us + TS_SECONDS * 1e6; h += 10e6) {
+            off_err = fmax(off_err, fabs(TSync_HostTime(&clock_fit[i], DeviceTime(vb, h)) - h));
+        }
+        // Samples: host time of every sample number
+        double err = 0.0, naive = 0.0;
+        for (uint32_t k = 0; k < TS_SAMPLES; k++) {
+            t_sync[i][k] = TSync_SampleTime(&clock_fit[i], &stream[i], k);
+            err = fmax(err, fabs(t_sync[i][k] - t_true[i][k]));
+            naive = fmax(naive, fabs(t_naive[i][k] - t_true[i][k]));
+        }
+        printf("board %u: board %+.0f ppm, sensor %+.0f ppm; fitted drift error %+.4f ppm, "
+               "clock error %.1f us, sample time error %.1f us (%.1f ms unsynchronized)\n", i,
+               vb->board_ppm, vb->sensor_ppm, drift_err, off_err, err, naive / 1e3);
+        TEST_CHECK(clock_fit[i].clock.count >= TS_SECONDS / TSYNC_PING_GROUP - 1u);
+        TEST_CHECK(fabs(drift_err) < 0.05);
+        TEST_CHECK(off_err < 100.0);
+        TEST_CHECK(err < 300.0);
+    }
+
+    // Both streams and the unsynchronized A on one grid, over the span both boards cover
+    double t0 = fmax(t_sync[0][0], t_sync[1][0]);
+    double t1 = fmin(t_sync[0][TS_SAMPLES - 1u], t_sync[1][TS_SAMPLES - 1u]);
+    double dt = 1e6 / TS_GRID_HZ;
+    uint32_t m = (uint32_t)((t1 - t0) / dt);
+    TEST_CHECK(TSync_Resample(t_sync[0], x[0], TS_SAMPLES, t0, dt, grid[0], m) == m);
+    TEST_CHECK(TSync_Resample(t_sync[1], x[1], TS_SAMPLES, t0, dt, grid[1], m) == m);
+    TSync_Resample(t_naive[0], x[0], TS_SAMPLES, t0, dt, grid[2], m);
+    double e_sig = 0.0, e_ab = 0.0, e_naive = 0.0;
+    for (uint32_t j = 0; j < m; j++) {
+        double s = Signal(t0 + dt * j);
+        e_sig = fmax(e_sig, fmax(fabs(grid[0][j] - s), fabs(grid[1][j] - s)));
+        e_ab = fmax(e_ab, fabs(grid[0][j] - grid[1][j]));
+        if (!isnan(grid[2][j])) {
+            e_naive = fmax(e_naive, fabs(grid[2][j] - s));
+        }
+    }
+    printf("resampled to %.0f Hz: %u points, max |board - signal| %.4f, max |A - B| %.4f (%.3f unsynchronized)\n",
+           TS_GRID_HZ, (unsigned)m, e_sig, e_ab, e_naive);
+    // Linear interpolation of the 1.1 Hz component over 20 ms alone costs up to 0.0025
+    TEST_CHECK(e_sig < 0.005);
+    TEST_CHECK(e_ab < 0.005);
+    TEST_CHECK(e_naive > 0.5);
+    return TEST_EXIT();
+}
@@ -0,0 +1,273 @@
+/**
+ * @file test_uart.c
+ * @brief USART2 circular-DMA reception against a reference model, with bursty traffic
+ * @details A random stream of messages (1 to 300 bytes, each closed by an idle line)
+ *          arrives in chunks through the DMA model. The handlers run in random
+ *          interleavings, the way the target can take them:
+ *          - DMA1 channel 6 (HT/TC) right away or up to 96 bytes later, and before or
+ *            after the IDLE interrupt of a message that ends meanwhile
+ *          - USART2 IDLE at any time after the last byte of the message, before the
+ *            next one starts
+ *          - the main loop peeks and releases at random points, with slow phases that
+ *            fill the USART2_RX_MSG_SLOTS descriptor ring and let the DMA overwrite
+ *            unread messages, and bytes arriving between a peek and its release
+ *
+ *          A model of the descriptor ring predicts every outcome: which message each peek
+ *          returns, its split at the USART2_RX_DMA_SIZE buffer wrap, its content and IDLE
+ *          stamp, whether the release finds it intact, and the dropped count (ring full,
+ *          longer than the buffer, overwritten before or during the view). The run must
+ *          have covered each of these cases.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "HostDevice.h"
+#include "HostUart.h"
+#include "Sim.h"
+#include "UART.h"
+#include "Test.h"
+
+void DMA1_Channel6_IRQHandler(void);
+void USART2_IRQHandler(void);
+
+#define UART_TEST_STEPS     400000u
+#define UART_TEST_LATENCY   96u     /**< Most bytes a pending DMA interrupt waits */
+#define UART_TEST_MAX_LEN   300u
+
+/**
+ * @struct ModelSlot
+ * @brief Expected descriptor of one accepted message
+ */
+typedef struct {
+    uint32_t id;        /**< Message number */
+    uint32_t start;     /**< Stream offset of its first byte */
+    uint16_t len;       /**< Length */
+    uint32_t before;    /**< DWT->CYCCNT just before the IDLE handler */
+    uint32_t after;     /**< DWT->CYCCNT just after it */
+} ModelSlot;
+
+static ModelSlot ring[USART2_RX_MSG_SLOTS];     /**< Accepted, not yet released */
+static uint32_t ring_tail = 0, ring_count = 0;
+static uint32_t rx_total = 0;           /**< Bytes fed to the DMA */
+static uint32_t dropped = 0;            /**< Expected USART2_GetRxDropped() */
+static uint32_t sent = 0, delivered = 0;
+
+// Message being received
+static uint32_t msg_id = 0;
+static uint16_t msg_len = 0, msg_pos = 0;
+static uint8_t idle_pending = 0;        /**< Line idle, IDLE handler not run yet */
+static uint32_t dma_wait = 0;           /**< Bytes since the DMA flag was raised, 0 if none */
+static uint8_t viewing = 0;             /**< Between a peek and its release */
+
+// Coverage
+static uint32_t n_ht = 0, n_tc = 0, n_idle_dma_first = 0, n_idle_dma_late = 0;
+static uint32_t n_wrap = 0, n_ring_full = 0, n_too_long = 0, n_lost_peek = 0, n_lost_view = 0;
+
+/**
+ * @brief Byte j of message id
+ */
+static uint8_t Pattern(uint32_t id, uint16_t j) {
+    return (uint8_t)(id * 131u + j * 29u + 7u);
+}
+
+/**
+ * @brief Uniform integer in [lo, hi]
+ */
+static uint32_t Rand(uint32_t lo, uint32_t hi) {
+    return lo + (uint32_t)rand() % (hi - lo + 1u);
+}
+
+/**
+ * @brief Start the next message
+ */
+static void NextMessage(void) {
+    uint32_t r = Rand(0, 99);
+    msg_id = sent++;
+    msg_len = (uint16_t)((r < 2) ? Rand(USART2_RX_DMA_SIZE + 1u, UART_TEST_MAX_LEN)
+                         : (r < 12) ? Rand(65, USART2_RX_DMA_SIZE) : Rand(1, 64));
+    msg_pos = 0;
+}
+
+/**
+ * @brief Run the DMA handler for a pending HT/TC
+ */
+static void DmaIrq(void) {
+    uint32_t isr = DMA1->ISR;
+    n_ht += (isr & DMA_ISR_HTIF6) ? 1u : 0u;
+    n_tc += (isr & DMA_ISR_TCIF6) ? 1u : 0u;
+    DMA1_Channel6_IRQHandler();
+    dma_wait = 0;
+}
+
+/**
+ * @brief Feed a chunk of the current message
+ */
+static void Receive(void) {
+    uint8_t chunk[64];
+    uint16_t n = (uint16_t)Rand(1, sizeof(chunk));
+    if (n > msg_len - msg_pos) {
+        n = (uint16_t)(msg_len - msg_pos);
+    }
+    for (uint16_t j = 0; j < n; j++) {
+        chunk[j] = Pattern(msg_id, (uint16_t)(msg_pos + j));
+    }
+    for (uint16_t j = 0; j < n; j++) {
+        // Same-priority handlers: a pending DMA interrupt is taken before it falls 128 bytes behind
+        if (dma_wait >= UART_TEST_LATENCY) {
+            DmaIrq();
+        }
+        TEST_CHECK(HostUart_Receive(&chunk[j], 1) == 1u);
+        if (dma_wait > 0u) {
+            dma_wait++;
+        } else if (DMA1->ISR & DMA_ISR_GIF6) {
+            dma_wait = 1;
+        }
+    }
+    rx_total += n;
+    msg_pos = (uint16_t)(msg_pos + n);
+    if (msg_pos == msg_len) {
+        HostUart_LineIdle();
+        idle_pending = 1;
+    }
+}
+
+/**
+ * @brief Run the IDLE handler and update the model as the driver should
+ */
+static void IdleIrq(void) {
+    if (dma_wait > 0u) {
+        n_idle_dma_late++;
+    }
+    uint32_t before = (uint32_t)Host_Cycles();
+    USART2_IRQHandler();
+    uint32_t after = (uint32_t)Host_Cycles();
+    idle_pending = 0;
+    if (ring_count == USART2_RX_MSG_SLOTS - 1u) {
+        dropped++;
+        n_ring_full++;
+    } else if (msg_len > USART2_RX_DMA_SIZE) {
+        dropped++;
+        n_too_long++;
+    } else {
+        ModelSlot *s = &ring[(ring_tail + ring_count++) % USART2_RX_MSG_SLOTS];
+        s->id = msg_id;
+        s->start = rx_total - msg_len;
+        s->len = msg_len;
+        s->before = before;
+        s->after = after;
+    }
+    NextMessage();
+}
+
+/**
+ * @brief Main loop: peek, or release the viewed message
+ */
+static void Consume(void) {
+    USART2_Message m;
+    if (viewing) {
+        uint8_t intact = (rx_total - ring[ring_tail].start <= USART2_RX_DMA_SIZE);
+        TEST_CHECK(USART2_ReleaseMessage() == intact);
+        if (intact) {
+            delivered++;
+        } else {
+            dropped++;
+            n_lost_view++;
+        }
+        ring_tail = (ring_tail + 1u) % USART2_RX_MSG_SLOTS;
+        ring_count--;
+        viewing = 0;
+        TEST_CHECK(USART2_GetRxDropped() == dropped);
+        return;
+    }
+    while (ring_count > 0u && rx_total - ring[ring_tail].start > USART2_RX_DMA_SIZE) {
+        ring_tail = (ring_tail + 1u) % USART2_RX_MSG_SLOTS;
+        ring_count--;
+        dropped++;
+        n_lost_peek++;
+    }
+    uint8_t got = USART2_PeekMessage(&m);
+    TEST_CHECK(USART2_GetRxDropped() == dropped);
+    TEST_CHECK(got == (ring_count > 0u));
+    if (!got || ring_count == 0u) {
+        return;
+    }
+    const ModelSlot *s = &ring[ring_tail];
+    uint16_t first = (uint16_t)(USART2_RX_DMA_SIZE - s->start % USART2_RX_DMA_SIZE);
+    if (s->len > first) {
+        TEST_CHECK(m.len == first && m.wrap != NULL && m.wrap_len == s->len - first);
+        n_wrap++;
+    } else {
+        TEST_CHECK(m.len == s->len && m.wrap == NULL && m.wrap_len == 0);
+    }
+    uint16_t bad = 0;
+    for (uint16_t j = 0; j < m.len + m.wrap_len; j++) {
+        bad += (USART2_MessageByte(&m, j) != Pattern(s->id, j)) ? 1u : 0u;
+    }
+    TEST_CHECK(bad == 0);
+    TEST_CHECK(m.cycles - s->before <= s->after - s->before);
+    viewing = 1;
+}
+
+int main(void) {
+    Sim_Init(1);
+    Sim_Boot();
+    UART_Config(460800u);
+    srand(2026);
+    NextMessage();
+
+    uint8_t slow = 0;
+    for (uint32_t step = 0; step < UART_TEST_STEPS; step++) {
+        // Phases of a busy main loop (descriptor ring fills, bytes get overwritten)
+        if (step % 2000u == 0) {
+            slow = (Rand(0, 3) == 0);
+        }
+        uint32_t r = Rand(0, 99);
+        if (r < 45) {
+            if (!idle_pending) {
+                Receive();
+            }
+        } else if (r < 60) {
+            if (dma_wait > 0u) {
+                if (idle_pending) {
+                    n_idle_dma_first++;
+                }
+                DmaIrq();
+            }
+        } else if (r < 75) {
+            if (idle_pending) {
+                IdleIrq();
+            }
+        } else if (!slow || r < 77) {
+            Consume();
+        }
+    }
+    // Flush: close the open message, then read everything
+    while (msg_pos < msg_len) {
+        Receive();
+    }
+    if (dma_wait > 0u) {
+        DmaIrq();
+    }
+    IdleIrq();
+    sent--;     // NextMessage() opened one that never arrives
+    while (viewing || ring_count > 0u) {
+        Consume();
+    }
+    USART2_Message m;
+    TEST_CHECK(USART2_PeekMessage(&m) == 0);
+
+    printf("uart: %u messages, %u bytes: %u delivered, %u dropped (ring full %u, longer than buffer %u, "
+           "overwritten before peek %u, during view %u)\n", (unsigned)sent, (unsigned)rx_total,
+           (unsigned)delivered, (unsigned)dropped, (unsigned)n_ring_full, (unsigned)n_too_long,
+           (unsigned)n_lost_peek, (unsigned)n_lost_view);
+    printf("uart: %u HT, %u TC, DMA before IDLE %u, after IDLE %u, wrapped views %u\n", (unsigned)n_ht,
+           (unsigned)n_tc, (unsigned)n_idle_dma_first, (unsigned)n_idle_dma_late, (unsigned)n_wrap);
+    TEST_CHECK(delivered + dropped == sent);
+    TEST_CHECK(USART2_GetRxDropped() == dropped);
+    TEST_CHECK(n_ht > 0 && n_tc > 0 && n_idle_dma_first > 0 && n_idle_dma_late > 0 && n_wrap > 0);
+    TEST_CHECK(n_ring_full > 0 && n_too_long > 0 && n_lost_peek > 0 && n_lost_view > 0);
+    return TEST_EXIT();
+}
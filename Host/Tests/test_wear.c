@@ -0,0 +1,138 @@
+/**
+ * @file test_wear.c
+ * @brief Off-body suspension and return to skin on the simulator
+ * @details One virtual sensor on the skin (default pulse) loses its optical path from
+ *          WEAR_CUT_S to WEAR_BACK_S: only ambient light, WEAR_AMBIENT of the signal, well
+ *          under WEAR_OFF_NA_PER_MA and under the proximity threshold at the pilot current.
+ *          Blocks go through Pipeline_ProcessBlock() (wear_detect, DC blocker) and the
+ *          off-body flag is handed to Acquisition_Suspend() as Task_Process() does. Checked:
+ *          - one off-body block ("#wear,…,0"), WEAR_OFF_SAMPLES sample periods after the cut
+ *          - while suspended: no samples stored by the sensor, one INTR_STATUS1 read every
+ *            ACQ_PROX_POLL_TICKS ticks and nothing else on the bus
+ *          - when the light returns: one proximity wake-up, one SB_FLAG_RESUME block
+ *            ("#wear,…,1") within a status poll period, sequence numbers continuing, raw
+ *            currents at the on-skin level with the profile drive from the first sample,
+ *            and a high-passed output that starts like after boot (filter warm-up on the
+ *            first sample) instead of ringing from the ambient level (no transient)
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <math.h>
+#include <string.h>
+#include "Acquisition.h"
+#include "Pipeline.h"
+#include "Sim.h"
+#include "Test.h"
+#include "Wear.h"
+
+#define WEAR_TEST_SECONDS   30u
+#define WEAR_CUT_S          10.0    /**< Optical path lost */
+#define WEAR_BACK_S         20.0    /**< Optical path back */
+#define WEAR_AMBIENT        0.02    /**< Signal fraction left while off the skin */
+#define WEAR_QUIET_FROM_S   14.0    /**< Window for the suspended bus traffic */
+#define WEAR_QUIET_TO_S     19.0
+#define WEAR_START_S        5.0     /**< Output window after boot and after the resume */
+
+/**
+ * @brief Default optical path, cut to the ambient level between WEAR_CUT_S and WEAR_BACK_S
+ */
+static float32_t WearSignal(void *ctx, uint8_t sensor, uint8_t channel, double t_s) {
+    double path = (t_s >= WEAR_CUT_S && t_s < WEAR_BACK_S) ? WEAR_AMBIENT : 1.0;
+    return (float32_t)(path * Sim_DefaultSignal(ctx, sensor, channel, t_s));
+}
+
+int main(void) {
+    static Pipeline_Context ctx;
+    Pipeline_Config cfg;
+    SampleBlock *block;
+    uint8_t id;
+    uint32_t off_events = 0, resumes = 0, next_seq = 0;
+    double off_s = 0.0, resume_s = 0.0;
+    double boot_max = 0.0, resume_max = 0.0;
+    uint32_t reads_from = 0, bytes_from = 0, samples_from = 0;
+    uint32_t quiet_reads = 0, quiet_bytes = 0, quiet_samples = 0;
+    double ir_na = SIM_IR_NA_PER_MA * MAX30101_NIRSLiteProfile.led_ir_ma;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.filter = PIPELINE_FILTER_DC_BLOCKER;
+    cfg.alpha = 0.995f;
+    cfg.warmup_samples = 600;
+    cfg.wear_detect = 1;
+
+    Sim_Init(1);
+    id = Sim_Sensors()[0].id;
+    Sim_SetSignal(WearSignal, NULL);
+    Sim_Boot();
+    Acquisition_SetTemperaturePeriod(0);
+    Pipeline_Init(&ctx, &cfg);
+    for (uint32_t tick = 0; tick < WEAR_TEST_SECONDS * SIM_TICK_HZ; tick++) {
+        double t_s = (double)tick / SIM_TICK_HZ;
+        if (tick == (uint32_t)(WEAR_QUIET_FROM_S * SIM_TICK_HZ)) {
+            reads_from = Sim_GetSensorStats(0)->read_bursts;
+            bytes_from = Acquisition_GetBusBytes();
+            samples_from = Sim_GetSensorStats(0)->samples;
+        } else if (tick == (uint32_t)(WEAR_QUIET_TO_S * SIM_TICK_HZ)) {
+            quiet_reads = Sim_GetSensorStats(0)->read_bursts - reads_from;
+            quiet_bytes = Acquisition_GetBusBytes() - bytes_from;
+            quiet_samples = Sim_GetSensorStats(0)->samples - samples_from;
+        }
+        Sim_Tick();
+        while ((block = Acquisition_Peek()) != NULL) {
+            TEST_CHECK(block->seq == next_seq && !(block->flags & SB_FLAG_GAP));
+            next_seq = block->seq + block->count;
+            if (block->flags & SB_FLAG_RESUME) {
+                resumes++;
+                resume_s = t_s;
+                // Profile drive and the on-skin level from the first sample on
+                TEST_CHECK(block->led[SB_CH_IR] == MAX30101_LED_MA_TO_REG(MAX30101_NIRSLiteProfile.led_ir_ma));
+                TEST_CHECK(block->adc_range == MAX30101_NIRSLiteProfile.adc_range);
+                for (uint8_t k = 0; k < block->count; k++) {
+                    TEST_NEAR(block->ch[SB_CH_IR][k], ir_na, 2.0 * SIM_PULSE_DEPTH * ir_na);
+                }
+            }
+            Pipeline_ProcessBlock(&ctx, block);
+            for (uint8_t k = block->first; k < block->count; k++) {
+                double y = fabs(block->ch[SB_CH_IR][k]);
+                if (t_s < WEAR_START_S) {
+                    boot_max = (y > boot_max) ? y : boot_max;
+                } else if (resumes > 0u && t_s < resume_s + WEAR_START_S) {
+                    resume_max = (y > resume_max) ? y : resume_max;
+                }
+            }
+            if (block->flags & SB_FLAG_OFF_BODY) {
+                off_events++;
+                off_s = t_s;
+                Acquisition_Suspend(block->sensor_id);
+            }
+            Acquisition_Release();
+        }
+    }
+
+    const Sim_SensorStats *st = Sim_GetSensorStats(0);
+    double quiet_s = WEAR_QUIET_TO_S - WEAR_QUIET_FROM_S;
+    printf("wear: off-body at %.2f s (cut %.1f s), resumed at %.2f s (light back %.1f s), %u wake-ups\n",
+           off_s, WEAR_CUT_S, resume_s, WEAR_BACK_S, (unsigned)st->prox_wakeups);
+    printf("wear: suspended: %.1f status reads/s, %.1f bus B/s, %u samples stored\n",
+           quiet_reads / quiet_s, quiet_bytes / quiet_s, (unsigned)quiet_samples);
+    printf("wear: IR output max over %.0f s: %.2f nA after boot, %.2f nA after the resume (step %.0f nA)\n",
+           WEAR_START_S, boot_max, resume_max, (1.0 - WEAR_AMBIENT) * ir_na);
+
+    // One off-body event, WEAR_OFF_SAMPLES periods after the cut (plus the block it ends in)
+    TEST_CHECK(off_events == 1u);
+    TEST_CHECK(off_s >= WEAR_CUT_S + (double)WEAR_OFF_SAMPLES / SIM_TICK_HZ - 0.02
+               && off_s < WEAR_CUT_S + (double)WEAR_OFF_SAMPLES / SIM_TICK_HZ + 0.2);
+    // Suspended: the status poll alone, at 1 / ACQ_PROX_POLL_TICKS of the tick rate
+    TEST_NEAR(quiet_reads, quiet_s * SIM_TICK_HZ / ACQ_PROX_POLL_TICKS, 1.0);
+    TEST_CHECK(quiet_bytes == quiet_reads);
+    TEST_CHECK(quiet_samples == 0u);
+    // Back on the skin within one status poll period, once
+    TEST_CHECK(st->prox_wakeups == 1u && resumes == 1u);
+    TEST_CHECK(resume_s >= WEAR_BACK_S && resume_s < WEAR_BACK_S + (double)ACQ_PROX_POLL_TICKS / SIM_TICK_HZ + 0.1);
+    // No transient: the restarted high-pass settles as after boot, far from the ambient-to-skin step
+    TEST_CHECK(boot_max > 0.0 && resume_max <= 1.1 * boot_max);
+    TEST_CHECK(resume_max < 0.1 * (1.0 - WEAR_AMBIENT) * ir_na);
+    TEST_CHECK(Acquisition_GetErrors(id) == 0 && Acquisition_GetDropped() == 0);
+    return TEST_EXIT();
+}
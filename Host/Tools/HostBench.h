@@ -0,0 +1,34 @@
+/**
+ * @file HostBench.h
+ * @brief Host time source for the DSP micro-benchmark suite (Bench.c)
+ * @details Forced into Bench.c with -include by the bench target: BENCH_CYCLES() reads
+ *          CLOCK_MONOTONIC in nanoseconds (truncated to 32 bits, wrap-safe for the
+ *          sub-second measurements) and BENCH_CORE_HZ is 1 GHz, so the
+ *          <cycles_per_sample> field of the "#bench" lines is in ns per sample and
+ *          <samples_per_s> is the host throughput.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Bench_Run
+ */
+
+#ifndef HOST_BENCH_H_
+#define HOST_BENCH_H_
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @brief Monotonic time in nanoseconds, modulo 2^32
+ * @return Time (ns)
+ */
+static inline uint32_t HostBench_Ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+#define BENCH_CYCLES()  HostBench_Ns()      /**< Host time source */
+#define BENCH_CORE_HZ   1000000000u         /**< Ticks per second of BENCH_CYCLES() */
+
+#endif /* HOST_BENCH_H_ */
@@ -0,0 +1,126 @@
+/**
+ * @file TelemetryDecode.c
+ * @brief Host decoder for the "#tlm" runtime telemetry frame
+ * @details Fields are parsed in the order Tlm_Format() writes them. Decimals go through
+ *          strtod() of the validated text, so the result is the nearest double to what the
+ *          device printed, rounded to float32_t.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "TelemetryDecode.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Parse an unsigned decimal integer field
+ * @param s - [in] Field
+ * @param n - Field length
+ * @param v - [out] Value
+ * @return 1 if valid, 0 otherwise
+ */
+static uint8_t Parse_Uint(const char *s, uint32_t n, uint32_t *v) {
+    uint64_t x = 0;
+    if (n == 0u || n > FMT_UINT_MAX_CHARS || (n > 1u && s[0] == '0')) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (s[i] < '0' || s[i] > '9') {
+            return 0;
+        }
+        x = x * 10u + (uint64_t)(s[i] - '0');
+    }
+    if (x > UINT32_MAX) {
+        return 0;
+    }
+    *v = (uint32_t)x;
+    return 1;
+}
+
+/**
+ * @brief Parse a Fmt_Fixed4() field
+ * @param s - [in] Field
+ * @param n - Field length
+ * @param v - [out] Value
+ * @return 1 if valid, 0 otherwise
+ */
+static uint8_t Parse_Fixed4(const char *s, uint32_t n, float32_t *v) {
+    char buf[FMT_FIXED4_MAX_CHARS + 1];
+    uint32_t i = (n > 0u && s[0] == '-') ? 1u : 0u;
+    if (n - i == 3u && memcmp(&s[i], "inf", 3) == 0) {
+        *v = i ? -INFINITY : INFINITY;
+        return 1;
+    }
+    if (n == 3u && memcmp(s, "nan", 3) == 0) {
+        *v = NAN;
+        return 1;
+    }
+    if (n > FMT_FIXED4_MAX_CHARS || n < i + 6u || s[n - 5u] != '.') {
+        return 0;       // At least one integer digit, '.', four decimals
+    }
+    for (uint32_t k = i; k < n; k++) {
+        if (k != n - 5u && (s[k] < '0' || s[k] > '9')) {
+            return 0;
+        }
+    }
+    memcpy(buf, s, n);
+    buf[n] = '\0';
+    *v = (float32_t)strtod(buf, NULL);
+    return 1;
+}
+
+/**
+ * @brief Decode one "#tlm" line
+ * @param line - [in] Line, starting at the tag
+ * @param len - Characters in the line (with or without the "\r\n")
+ * @param f - [out] Frame, written only on success
+ * @return 1 if the line is a well-formed frame, 0 otherwise
+ */
+uint8_t Tlm_Parse(const char *line, uint32_t len, Tlm_Frame *f) {
+    const uint32_t tag = sizeof(TLM_PREFIX) - 1u;
+    const char *field[TLM_FIELDS];
+    uint32_t width[TLM_FIELDS];
+    Tlm_Frame out;
+
+    if (len >= 2u && line[len - 2u] == '\r' && line[len - 1u] == '\n') {
+        len -= 2u;
+    }
+    if (len < tag || memcmp(line, TLM_PREFIX, tag) != 0) {
+        return 0;
+    }
+    // Split: exactly TLM_FIELDS fields, no stray CR/LF inside
+    uint32_t count = 0, start = tag;
+    for (uint32_t i = tag; i <= len; i++) {
+        if (i < len && (line[i] == '\r' || line[i] == '\n')) {
+            return 0;
+        }
+        if (i == len || line[i] == ',') {
+            if (count == TLM_FIELDS) {
+                return 0;
+            }
+            field[count] = &line[start];
+            width[count] = i - start;
+            count++;
+            start = i + 1u;
+        }
+    }
+    if (count != TLM_FIELDS) {
+        return 0;
+    }
+    if (!Parse_Uint(field[0], width[0], &out.t_us) ||
+        !Parse_Fixed4(field[1], width[1], &out.idle_pct) ||
+        !Parse_Fixed4(field[2], width[2], &out.i2c_pct) ||
+        !Parse_Uint(field[3], width[3], &out.tx_pending) ||
+        !Parse_Uint(field[4], width[4], &out.tx_peak) ||
+        !Parse_Uint(field[5], width[5], &out.ring_peak) ||
+        !Parse_Uint(field[6], width[6], &out.dropped) ||
+        !Parse_Uint(field[7], width[7], &out.fifo_ovf) ||
+        !Parse_Fixed4(field[8], width[8], &out.latency_us) ||
+        !Parse_Fixed4(field[9], width[9], &out.isr_max_us)) {
+        return 0;
+    }
+    *f = out;
+    return 1;
+}
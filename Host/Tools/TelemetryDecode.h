@@ -0,0 +1,30 @@
+/**
+ * @file TelemetryDecode.h
+ * @brief Host decoder for the "#tlm" runtime telemetry frame
+ * @details Strict inverse of Tlm_Format() (Project/Telemetry.h): the "#tlm," tag, exactly
+ *          TLM_FIELDS comma-separated fields and an optional "\r\n". Integer fields take
+ *          digits only and must fit in 32 bits; decimal fields take an optional '-', digits,
+ *          '.' and exactly four decimals, or "inf", "-inf" and "nan". Anything else rejects
+ *          the whole line, so a frame cut by a lost byte is never half-decoded.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Tlm_Format
+ */
+
+#ifndef TELEMETRYDECODE_H_
+#define TELEMETRYDECODE_H_
+
+#include <stdint.h>
+#include "Telemetry.h"
+
+/**
+ * @brief Decode one "#tlm" line
+ * @param line - [in] Line, starting at the tag
+ * @param len - Characters in the line (with or without the "\r\n")
+ * @param f - [out] Frame, written only on success
+ * @return 1 if the line is a well-formed frame, 0 otherwise
+ */
+uint8_t Tlm_Parse(const char *line, uint32_t len, Tlm_Frame *f);
+
+#endif /* TELEMETRYDECODE_H_ */
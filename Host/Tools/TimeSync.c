@@ -0,0 +1,228 @@
+/**
+ * @file TimeSync.c
+ * @brief Host time synchronization implementation
+ * @details Least-squares lines over rings of points, in double precision and relative to
+ *          the first point so µs timestamps of a long session keep their resolution.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "TimeSync.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * @brief Empty a line
+ */
+static void TSync_LineInit(TSync_Line *l) {
+    memset(l, 0, sizeof(*l));
+    l->slope = 1.0;
+}
+
+/**
+ * @brief Append a point, dropping the oldest one when full
+ */
+static void TSync_LinePush(TSync_Line *l, double x, double y) {
+    if (l->count == 0) {
+        l->x0 = x;
+    }
+    l->points[l->next].x = x;
+    l->points[l->next].y = y;
+    l->next = (l->next + 1u) % TSYNC_MAX_POINTS;
+    if (l->count < TSYNC_MAX_POINTS) {
+        l->count++;
+    }
+}
+
+/**
+ * @brief Least-squares line through the kept points
+ * @return 1 on success, 0 with fewer than two distinct abscissae
+ */
+static uint8_t TSync_LineFit(TSync_Line *l) {
+    double sx = 0.0, sy = 0.0;
+    if (l->count < 2u) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < l->count; i++) {
+        sx += l->points[i].x - l->x0;
+        sy += l->points[i].y;
+    }
+    double mx = sx / l->count, my = sy / l->count;
+    double sxx = 0.0, sxy = 0.0;
+    for (uint32_t i = 0; i < l->count; i++) {
+        double dx = l->points[i].x - l->x0 - mx;
+        sxx += dx * dx;
+        sxy += dx * (l->points[i].y - my);
+    }
+    if (sxx <= 0.0) {
+        return 0;
+    }
+    l->slope = sxy / sxx;
+    l->y0 = my - l->slope * mx;
+    return 1;
+}
+
+/**
+ * @brief Start a board with no pings
+ * @param b - [out] Board
+ * @return void
+ */
+void TSync_BoardInit(TSync_Board *b) {
+    b->last_us = 0;
+    b->started = 0;
+    TSync_LineInit(&b->clock);
+    b->group = 0;
+    b->best_rtt = INFINITY;
+}
+
+/**
+ * @brief Unwrap a 32-bit device time
+ * @param b - [in,out] Board
+ * @param us - Device time (µs, modulo 2^32)
+ * @return Unwrapped device time (µs)
+ */
+int64_t TSync_Unwrap(TSync_Board *b, uint32_t us) {
+    if (!b->started) {
+        b->started = 1;
+        b->last_us = us;
+    } else {
+        // Signed distance to the previous value, modulo 2^32
+        b->last_us += (int32_t)(us - (uint32_t)b->last_us);
+    }
+    return b->last_us;
+}
+
+/**
+ * @brief Add one ping exchange
+ * @param b - [in,out] Board
+ * @param t1_us - Host send time (µs)
+ * @param rx_us - Device arrival time t2
+ * @param tx_us - Device reply time t3
+ * @param t4_us - Host arrival time of the reply (µs)
+ * @return void
+ */
+void TSync_AddPing(TSync_Board *b, double t1_us, uint32_t rx_us, uint32_t tx_us, double t4_us) {
+    double t2 = (double)TSync_Unwrap(b, rx_us);
+    double t3 = (double)TSync_Unwrap(b, tx_us);
+    double rtt = (t4_us - t1_us) - (t3 - t2);
+    if (rtt < b->best_rtt) {
+        b->best_rtt = rtt;
+        b->best.x = 0.5 * (t2 + t3);
+        b->best.y = 0.5 * (t1_us + t4_us);
+    }
+    if (++b->group >= TSYNC_PING_GROUP) {
+        TSync_LinePush(&b->clock, b->best.x, b->best.y);
+        b->group = 0;
+        b->best_rtt = INFINITY;
+    }
+}
+
+/**
+ * @brief Fit host time over device time through the kept pings
+ * @param b - [in,out] Board
+ * @return 1 on success
+ */
+uint8_t TSync_FitClock(TSync_Board *b) {
+    return TSync_LineFit(&b->clock);
+}
+
+/**
+ * @brief Host time of a device time
+ * @param b - [in] Board
+ * @param device_us - Unwrapped device time (µs)
+ * @return Host time (µs)
+ */
+double TSync_HostTime(const TSync_Board *b, double device_us) {
+    return b->clock.y0 + b->clock.slope * (device_us - b->clock.x0);
+}
+
+/**
+ * @brief Start a stream segment
+ * @param s - [out] Stream
+ * @return void
+ */
+void TSync_StreamInit(TSync_Stream *s) {
+    TSync_LineInit(&s->seq);
+}
+
+/**
+ * @brief Add one "#sync" frame
+ * @param b - [in,out] Board
+ * @param s - [in,out] Stream
+ * @param seq - Sample number
+ * @param t_us - Device time of the drain (µs, modulo 2^32)
+ * @return void
+ */
+void TSync_AddSync(TSync_Board *b, TSync_Stream *s, uint32_t seq, uint32_t t_us) {
+    TSync_LinePush(&s->seq, (double)seq, (double)TSync_Unwrap(b, t_us));
+}
+
+/**
+ * @brief Fit device time over sample number
+ * @details Slope by least squares, intercept from the smallest drain lag: the line is
+ *          moved down until it touches the lowest frame.
+ * @param s - [in,out] Stream
+ * @return 1 on success
+ */
+uint8_t TSync_FitStream(TSync_Stream *s) {
+    TSync_Line *l = &s->seq;
+    if (!TSync_LineFit(l)) {
+        return 0;
+    }
+    double lag = INFINITY;
+    for (uint32_t i = 0; i < l->count; i++) {
+        double r = l->points[i].y - (l->y0 + l->slope * (l->points[i].x - l->x0));
+        lag = (r < lag) ? r : lag;
+    }
+    l->y0 += lag;
+    return 1;
+}
+
+/**
+ * @brief Host time of a sample
+ * @param b - [in] Board
+ * @param s - [in] Stream
+ * @param seq - Sample number
+ * @return Host time (µs)
+ */
+double TSync_SampleTime(const TSync_Board *b, const TSync_Stream *s, uint32_t seq) {
+    const TSync_Line *l = &s->seq;
+    return TSync_HostTime(b, l->y0 + l->slope * ((double)seq - l->x0));
+}
+
+/**
+ * @brief Linear interpolation onto a uniform grid
+ * @param t_us - [in] Sample times (increasing)
+ * @param x - [in] Samples
+ * @param n - Number of samples
+ * @param t0_us - First grid time
+ * @param dt_us - Grid step
+ * @param y - [out] Grid values (NAN outside the sampled span)
+ * @param m - Grid points
+ * @return Grid points inside the sampled span
+ */
+uint32_t TSync_Resample(const double *t_us, const float32_t *x, uint32_t n, double t0_us, double dt_us,
+                        float32_t *y, uint32_t m) {
+    uint32_t inside = 0;
+    uint32_t k = 0;
+    for (uint32_t j = 0; j < m; j++) {
+        double t = t0_us + dt_us * (double)j;
+        if (n == 0 || t < t_us[0] || t > t_us[n - 1u]) {
+            y[j] = NAN;
+            continue;
+        }
+        inside++;
+        if (n == 1u) {
+            y[j] = x[0];
+            continue;
+        }
+        while (k + 2u < n && t_us[k + 1u] < t) {
+            k++;
+        }
+        double span = t_us[k + 1u] - t_us[k];
+        double w = (span > 0.0) ? (t - t_us[k]) / span : 0.0;
+        y[j] = (float32_t)((1.0 - w) * x[k] + w * x[k + 1u]);
+    }
+    return inside;
+}
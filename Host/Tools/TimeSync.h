@@ -0,0 +1,178 @@
+/**
+ * @file TimeSync.h
+ * @brief Host side of TIME_SYNC: device clock estimation and resampling onto one timeline
+ * @details Turns the "#pong" replies and "#sync" frames of one board into host times
+ *          for every sample, so the streams of several boards can be resampled onto a
+ *          common grid:
+ *
+ *          ping (t1, t2, t3, t4) → host = a + b · device → device = c + d · seq → host
+ *
+ * ### Clock (one per board)
+ *  - Each ping gives the midpoint pair ((t2 + t3) / 2, (t1 + t4) / 2) and the round trip
+ *    (t4 − t1) − (t3 − t2). Of every TSYNC_PING_GROUP pings only the one with the
+ *    shortest round trip is kept; queueing only lengthens a trip, so it carries the
+ *    least asymmetric delay
+ *  - host = a + b · device is a least-squares line through the kept points: a is the
+ *    offset, b − 1 the drift of the board oscillator (≈ −ppm · 1e-6)
+ *
+ * ### Stream (one per sensor and output rate)
+ *  - A "#sync" frame pairs a sample number with the device time of the FIFO drain that
+ *    read it; the drain comes 0 to one sample period after the sample
+ *  - device = c + d · seq takes d from a least-squares line and c from the lower envelope
+ *    (the smallest drain lag seen), since the lag sweeps its whole range as the sensor
+ *    and SysTick oscillators beat against each other
+ *  - A "#rate" line starts a new segment: use a new stream from its <seq> on
+ *
+ * ### Device Time
+ *  "#pong" and "#sync" carry 32-bit µs that wrap after 71.6 min. Every value of a board
+ *  goes through one TSync_Board unwrapper in arrival order, so pings and frames share
+ *  one epoch.
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Output_Pong, Output_Sync
+ */
+
+#ifndef TIMESYNC_H_
+#define TIMESYNC_H_
+
+#include <stdint.h>
+#include "arm_math_types.h"
+
+#define     TSYNC_MAX_POINTS    4096u   /**< Points kept per fit (the oldest are dropped) */
+#define     TSYNC_PING_GROUP    8u      /**< Pings per kept clock point (shortest round trip wins) */
+
+/**
+ * @struct TSync_Point
+ * @brief One point of a line fit
+ */
+typedef struct {
+    double x;   /**< Abscissa (device µs or sample number) */
+    double y;   /**< Ordinate (host µs or device µs) */
+} TSync_Point;
+
+/**
+ * @struct TSync_Line
+ * @brief Points and fitted line y = y0 + slope · (x − x0)
+ */
+typedef struct {
+    TSync_Point points[TSYNC_MAX_POINTS];   /**< Ring of points */
+    uint32_t    count;                      /**< Points kept */
+    uint32_t    next;                       /**< Next ring slot */
+    double      x0;                         /**< Reference abscissa (first point), keeps the fit well conditioned */
+    double      y0;                         /**< Fitted ordinate at x0 */
+    double      slope;                      /**< Fitted slope */
+} TSync_Line;
+
+/**
+ * @struct TSync_Board
+ * @brief Clock model of one board
+ */
+typedef struct {
+    int64_t    last_us;     /**< Last unwrapped device time */
+    uint8_t    started;     /**< 1 once a device time was seen */
+    TSync_Line clock;       /**< Kept ping points, host µs over device µs */
+    TSync_Point best;       /**< Shortest round trip of the current ping group */
+    double     best_rtt;    /**< Its round trip (µs) */
+    uint32_t   group;       /**< Pings in the current group */
+} TSync_Board;
+
+/**
+ * @struct TSync_Stream
+ * @brief Sample timing of one sensor at one output rate
+ */
+typedef struct {
+    TSync_Line seq;         /**< Sync frames, device µs over sample number */
+} TSync_Stream;
+
+/**
+ * @brief Start a board with no pings
+ * @param b - [out] Board
+ * @return void
+ */
+void TSync_BoardInit(TSync_Board *b);
+
+/**
+ * @brief Unwrap a 32-bit device time
+ * @details Values must arrive within ±2^31 µs (35 min) of the previous one.
+ * @param b - [in,out] Board
+ * @param us - Device time from "#pong" or "#sync" (µs, modulo 2^32)
+ * @return Device time since the first value's epoch (µs)
+ */
+int64_t TSync_Unwrap(TSync_Board *b, uint32_t us);
+
+/**
+ * @brief Add one ping exchange
+ * @param b - [in,out] Board
+ * @param t1_us - Host time the 'T' was sent (µs)
+ * @param rx_us - "#pong" <rx_us> (t2)
+ * @param tx_us - "#pong" <tx_us> (t3)
+ * @param t4_us - Host time the "#pong" line arrived (µs)
+ * @return void
+ */
+void TSync_AddPing(TSync_Board *b, double t1_us, uint32_t rx_us, uint32_t tx_us, double t4_us);
+
+/**
+ * @brief Fit host time over device time through the kept pings
+ * @param b - [in,out] Board
+ * @return 1 on success, 0 with fewer than two kept points
+ */
+uint8_t TSync_FitClock(TSync_Board *b);
+
+/**
+ * @brief Host time of a device time (after TSync_FitClock())
+ * @param b - [in] Board
+ * @param device_us - Unwrapped device time (µs)
+ * @return Host time (µs)
+ */
+double TSync_HostTime(const TSync_Board *b, double device_us);
+
+/**
+ * @brief Start a stream segment
+ * @param s - [out] Stream
+ * @return void
+ */
+void TSync_StreamInit(TSync_Stream *s);
+
+/**
+ * @brief Add one "#sync,<id>,<seq>,<t_us>" frame
+ * @param b - [in,out] Board (unwraps t_us)
+ * @param s - [in,out] Stream of the sensor
+ * @param seq - Sample number
+ * @param t_us - Device time of the drain (µs, modulo 2^32)
+ * @return void
+ */
+void TSync_AddSync(TSync_Board *b, TSync_Stream *s, uint32_t seq, uint32_t t_us);
+
+/**
+ * @brief Fit device time over sample number
+ * @param s - [in,out] Stream
+ * @return 1 on success, 0 with fewer than two frames
+ */
+uint8_t TSync_FitStream(TSync_Stream *s);
+
+/**
+ * @brief Host time of a sample (after TSync_FitClock() and TSync_FitStream())
+ * @param b - [in] Board
+ * @param s - [in] Stream of the sensor
+ * @param seq - Sample number
+ * @return Host time (µs)
+ */
+double TSync_SampleTime(const TSync_Board *b, const TSync_Stream *s, uint32_t seq);
+
+/**
+ * @brief Linear interpolation of a sample stream onto a uniform grid
+ * @param t_us - [in] Host times of the samples (increasing)
+ * @param x - [in] Samples
+ * @param n - Number of samples
+ * @param t0_us - First grid time
+ * @param dt_us - Grid step
+ * @param y - [out] Grid values, NAN outside [t_us[0], t_us[n-1]]
+ * @param m - Grid points
+ * @return Grid points inside the sampled span
+ */
+uint32_t TSync_Resample(const double *t_us, const float32_t *x, uint32_t n, double t0_us, double dt_us,
+                        float32_t *y, uint32_t m);
+
+#endif /* TIMESYNC_H_ */
@@ -0,0 +1,47 @@
+/**
+ * @file bench.c
+ * @brief DSP micro-benchmark suite on the host
+ * @details Runs Bench_Run() unmodified, built with the HostBench.h time source, with the
+ *          boot-time IIR design of main.c (Chebyshev II high-pass at the sensor output
+ *          rate). USART2 output goes to stdout, so the "#bench" lines have the target
+ *          format and the same scripts can diff host and target results.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include <stdio.h>
+#include "Bench.h"
+#include "FilterDesign.h"
+#include "HostDevice.h"
+#include "HostUart.h"
+#include "MAX30101.h"
+#include "PLL.h"
+#include "UART.h"
+
+#define BENCH_IIR_ORDER     4       /**< main.c IIR_ORDER */
+#define BENCH_IIR_SECTIONS  ((BENCH_IIR_ORDER + 1) / 2)
+
+/**
+ * @brief Write transmitted bytes to stdout
+ */
+static void Stdout(void *ctx, uint8_t byte) {
+    putchar(byte);
+}
+
+int main(void) {
+    static const Design_Spec spec = { DESIGN_CHEBY2, DESIGN_HIGHPASS, BENCH_IIR_ORDER, 0.04f, 0.0f, 80.0f };
+    float32_t coeffs[5 * BENCH_IIR_SECTIONS];
+
+    Host_Reset();
+    clk_config();
+    UART_Config(460800u);
+    HostUart_SetTxSink(Stdout, NULL);
+    if (Design_Filter(&spec, MAX30101_OutputRateHz(&MAX30101_NIRSLiteProfile), coeffs, BENCH_IIR_SECTIONS) == 0u) {
+        fprintf(stderr, "bench: IIR design failed\n");
+        return 1;
+    }
+    Bench_Run(coeffs, BENCH_IIR_SECTIONS);
+    USART2_Flush();
+    return 0;
+}
@@ -0,0 +1,647 @@
+/**
+ * @file Acquisition.c
+ * @brief Multi-sensor MAX30101 acquisition scheduler implementation
+ * @details Round-robin burst drain of sensor FIFOs into a SampleBlock ring.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Acquisition.h"
+#include "MAX30101.h"
+#include "I2C.h"
+#include "stm32f303x8.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#if SAMPLE_BLOCK_CHANNELS != 2
+#error "Acquisition reads the FIFO in SpO2 mode (Red/IR); a multi-LED build needs a 3-channel burst read"
+#endif
+
+static const MAX30101_Handle *acq_sensors;  /**< Registered sensor handles */
+static uint8_t acq_num_sensors = 0;         /**< Number of registered sensors */
+static uint8_t acq_rr_start = 0;            /**< Sensor polled first on the next tick */
+
+static SampleBlock acq_ring[ACQ_RING_BLOCKS];    /**< Block ring (ISR producer, main consumer) */
+static SampleBlock acq_discard;                  /**< Burst target while the ring is full */
+static volatile uint16_t acq_head = 0;           /**< Next write index (ISR only) */
+static volatile uint16_t acq_tail = 0;           /**< Next read index (main loop only) */
+static volatile uint32_t acq_dropped = 0;        /**< Samples lost to ring overflow */
+static uint32_t acq_errors[ACQ_MAX_SENSORS];     /**< Failed I2C transactions per sensor slot */
+static uint32_t acq_seq[ACQ_MAX_SENSORS];        /**< Next sample sequence number per sensor slot */
+static uint8_t  acq_gap[ACQ_MAX_SENSORS];        /**< Samples of this sensor were dropped since its last block */
+static uint32_t acq_tick = 0;                    /**< Acquisition_Poll() calls since Acquisition_Init() */
+static volatile uint32_t acq_bus_bytes = 0;      /**< Sensor register bytes transferred */
+static volatile uint32_t acq_fifo_overflows = 0; /**< FIFO level queries that found a sensor FIFO overflowed */
+static volatile uint16_t acq_ring_peak = 0;      /**< Most blocks queued at once */
+
+static uint8_t  acq_avg[ACQ_MAX_SENSORS];               /**< Applied SMP_AVE setting (log2 of the decimation) */
+static volatile uint8_t acq_avg_req[ACQ_MAX_SENSORS];   /**< Requested SMP_AVE setting (main loop) */
+static uint8_t  acq_poll_wait[ACQ_MAX_SENSORS];         /**< Ticks to skip before the next FIFO level query */
+static uint8_t  acq_skip[ACQ_MAX_SENSORS];              /**< Samples to read and discard before the next block (ACQ_SKIP_ALL: the whole next drain) */
+
+#define     ACQ_SKIP_ALL        0xFFu   /**< acq_skip value when the samples behind a settings write could not be counted */
+/** Worst case of Acquisition_Settle(): one FIFO pointer burst (the mux already routes to the sensor) */
+#define     ACQ_SETTLE_US       I2C_WORST_CASE_US(4)
+
+/** LED codes and ADC range packed in one word, so a request is written atomically */
+#define     ACQ_LED_PACK(red, ir, range)    ((uint32_t)(red) | ((uint32_t)(ir) << 8) | ((uint32_t)(range) << 16))
+static uint32_t acq_led[ACQ_MAX_SENSORS];               /**< Applied LED codes and ADC range (ACQ_LED_PACK) */
+static volatile uint32_t acq_led_req[ACQ_MAX_SENSORS];  /**< Requested LED codes and ADC range (main loop) */
+static uint8_t  acq_gain[ACQ_MAX_SENSORS];              /**< Settings changed since the sensor's last block */
+
+static volatile uint8_t acq_suspend_req[ACQ_MAX_SENSORS];   /**< Suspension requested (main loop), cleared when applied */
+static uint8_t  acq_suspended[ACQ_MAX_SENSORS];             /**< Sensor in proximity mode */
+static uint8_t  acq_resumed[ACQ_MAX_SENSORS];               /**< Woke up since the sensor's last block */
+
+/** Worst case of MAX30101_EnterProximity(): status read, three register writes, three bursts */
+#define     ACQ_PROX_ENTER_US   (4 * I2C_WORST_CASE_US(2) + I2C_WORST_CASE_US(3) + 2 * I2C_WORST_CASE_US(4))
+
+static uint16_t acq_temp_period = ACQ_TEMP_PERIOD_TICKS;   /**< Ticks between temperature conversions (0 = off) */
+static uint32_t acq_temp_due[ACQ_MAX_SENSORS];             /**< acq_tick of the next step: conversion trigger (idle) or first result poll (converting) */
+static uint8_t  acq_temp_pending[ACQ_MAX_SENSORS];         /**< Conversion in progress */
+static float32_t acq_temp_value[ACQ_MAX_SENSORS];          /**< Latest die temperature (°C) */
+static volatile uint8_t acq_temp_new[ACQ_MAX_SENSORS];     /**< Set by ISR on a new result, cleared by main loop */
+
+/**
+ * @brief Register the sensors drained by the scheduler
+ * @param sensors - [in] Array of initialized sensor handles
+ * @param num_sensors - [in] Number of sensors, clamped to ACQ_MAX_SENSORS
+ * @return void
+ */
+void Acquisition_Init(const MAX30101_Handle *sensors, uint8_t num_sensors) {
+    acq_sensors = sensors;
+    acq_num_sensors = (num_sensors > ACQ_MAX_SENSORS) ? ACQ_MAX_SENSORS : num_sensors;
+    acq_rr_start = 0;
+    acq_head = 0;
+    acq_tail = 0;
+    acq_dropped = 0;
+    acq_tick = 0;
+    acq_bus_bytes = 0;
+    acq_fifo_overflows = 0;
+    acq_ring_peak = 0;
+    for (uint8_t i = 0; i < ACQ_MAX_SENSORS; i++) {
+        acq_avg[i] = (uint8_t)MAX30101_NIRSLiteProfile.sample_avg;
+        acq_avg_req[i] = acq_avg[i];
+        acq_led[i] = ACQ_LED_PACK(MAX30101_LED_MA_TO_REG(MAX30101_NIRSLiteProfile.led_red_ma),
+                                  MAX30101_LED_MA_TO_REG(MAX30101_NIRSLiteProfile.led_ir_ma),
+                                  MAX30101_NIRSLiteProfile.adc_range);
+        acq_led_req[i] = acq_led[i];
+        acq_gain[i] = 0;
+        acq_suspend_req[i] = 0;
+        acq_suspended[i] = 0;
+        acq_resumed[i] = 0;
+        acq_poll_wait[i] = 0;
+        acq_skip[i] = 0;
+        acq_errors[i] = 0;
+        acq_seq[i] = 0;
+        acq_gap[i] = 0;
+        // Stagger the first conversion of each sensor across ticks
+        acq_temp_due[i] = ACQ_TEMP_CONV_TICKS + 1u + i;
+        acq_temp_pending[i] = 0;
+        acq_temp_new[i] = 0;
+    }
+}
+
+/**
+ * @brief Check whether a transaction of the given worst case fits in the tick budget
+ * @param start - DWT->CYCCNT at the start of Acquisition_Poll()
+ * @param worst_us - Worst-case duration of the next transaction(s) in µs
+ * @return 1 if it fits, 0 otherwise
+ */
+static inline uint8_t Acquisition_Fits(uint32_t start, uint32_t worst_us) {
+    uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+    return (DWT->CYCCNT - start) + worst_us * cycles_per_us <= ACQ_TICK_BUDGET_US * cycles_per_us;
+}
+
+/**
+ * @brief Read one FIFO burst of a sensor into the next free block
+ * @details The burst is unpacked directly into the head block's channel arrays and
+ *          published by advancing the head index. With the ring full the burst goes to a
+ *          scratch block and is counted as dropped; samples still to be skipped after a
+ *          settings write (at most n) go there too, without counting. Either way the next
+ *          block of the sensor carries SB_FLAG_GAP.
+ * @param idx - Sensor slot
+ * @param n - Number of samples (1..SAMPLE_BLOCK_LEN)
+ * @return I2C_OK, or the I2C error of the FIFO read
+ */
+static I2C_Status Acquisition_ReadBlock(uint8_t idx, uint8_t n) {
+    const MAX30101_Handle *dev = &acq_sensors[idx];
+    uint16_t head = acq_head;
+    uint16_t next = (head + 1u) & (ACQ_RING_BLOCKS - 1u);
+    uint8_t full = (next == acq_tail);
+    uint8_t skip = (acq_skip[idx] > 0u);
+    SampleBlock *blk = (full || skip) ? &acq_discard : &acq_ring[head];
+
+    I2C_Status status = MAX30101_ReadBurstCurrentSoA(dev, blk->ch[SB_CH_RED], blk->ch[SB_CH_IR], n);
+    if (status != I2C_OK) {
+        return status;
+    }
+    acq_bus_bytes += (uint32_t)n * MAX30101_BYTES_PER_SAMPLE;
+    uint32_t led = acq_led[idx];
+    uint8_t range = (uint8_t)(led >> 16);
+    if (range != (uint8_t)MAX30101_ADC_RGE_4096NA) {
+        // The burst reader converts with the 4096 nA LSB
+        float32_t scale = MAX30101_RANGE_FULLSCALE_NA(range) / MAX30101_CURRENT_FULLSCALE;
+        for (uint8_t i = 0; i < n; i++) {
+            blk->ch[SB_CH_RED][i] *= scale;
+            blk->ch[SB_CH_IR][i] *= scale;
+        }
+    }
+    blk->seq = acq_seq[idx];
+    acq_seq[idx] += n;
+    if (skip) {
+        acq_skip[idx] -= n;
+        acq_gap[idx] = 1;
+        return I2C_OK;
+    }
+    if (full) {
+        acq_dropped += n;
+        acq_gap[idx] = 1;
+        return I2C_OK;
+    }
+    blk->tick = acq_tick;
+    blk->count = n;
+    blk->first = 0;
+    blk->sensor_id = dev->id;
+    blk->flags = acq_gap[idx] ? SB_FLAG_GAP : 0u;
+    blk->decimation = (uint8_t)(1u << acq_avg[idx]);
+    blk->led[SB_CH_RED] = (uint8_t)led;
+    blk->led[SB_CH_IR] = (uint8_t)(led >> 8);
+    blk->adc_range = range;
+    if (acq_gain[idx]) {
+        blk->flags |= SB_FLAG_GAIN;
+    }
+    if (acq_resumed[idx]) {
+        blk->flags |= SB_FLAG_RESUME;
+    }
+    acq_gap[idx] = 0;
+    acq_gain[idx] = 0;
+    acq_resumed[idx] = 0;
+    __DMB(); // Block contents must be visible before the new head index
+    acq_head = next;
+    uint16_t depth = (uint16_t)((next - acq_tail) & (ACQ_RING_BLOCKS - 1u));
+    if (depth > acq_ring_peak) {
+        acq_ring_peak = depth;
+    }
+    return I2C_OK;
+}
+
+/**
+ * @brief Advance the die temperature state machine of one sensor
+ * @details Called right after the sensor's FIFO drain, while the mux still routes to it:
+ *          - converting and old enough: poll the result (one 3-byte burst read)
+ *          - idle and due: trigger a conversion (one register write)
+ *          Each transaction is only issued if it fits in the tick budget; otherwise the
+ *          step is retried on the sensor's next turn. Due times are in acquisition ticks,
+ *          so the period does not stretch while averaging skips FIFO polls (the step just
+ *          waits for the sensor's next drain, at most 2^avg − 1 ticks).
+ * @param idx - Sensor slot
+ * @param start - DWT->CYCCNT at the start of Acquisition_Poll()
+ * @return void
+ */
+static void Acquisition_Temperature(uint8_t idx, uint32_t start) {
+    const MAX30101_Handle *dev = &acq_sensors[idx];
+    uint8_t due = ((int32_t)(acq_tick - acq_temp_due[idx]) >= 0);
+    if (acq_temp_pending[idx]) {
+        uint8_t ready = 0;
+        float32_t deg_c;
+        if (!due) {
+            return;
+        }
+        if (!Acquisition_Fits(start, I2C_WORST_CASE_US(4))) {
+            return;
+        }
+        if (MAX30101_PollTemperature(dev, &ready, &deg_c) != I2C_OK) {
+            acq_errors[idx]++;
+            return;
+        }
+        acq_bus_bytes += 3u;
+        if (ready) {
+            acq_temp_value[idx] = deg_c;
+            acq_temp_new[idx] = 1;
+            acq_temp_pending[idx] = 0;
+            acq_temp_due[idx] = acq_tick + acq_temp_period;
+        }
+        return;
+    }
+    if (acq_temp_period == 0 || !due) {
+        return;
+    }
+    if (!Acquisition_Fits(start, I2C_WORST_CASE_US(2))) {
+        return;
+    }
+    if (MAX30101_StartTemperature(dev) != I2C_OK) {
+        acq_errors[idx]++;
+    } else {
+        acq_bus_bytes += 1u;
+        acq_temp_pending[idx] = 1;
+        acq_temp_due[idx] = acq_tick + ACQ_TEMP_CONV_TICKS + 1u;
+    }
+}
+
+/**
+ * @brief Discard the samples that straddle a settings write
+ * @details The drain before the write emptied the FIFO as of its level query, but the
+ *          sensor may store samples in the milliseconds until the write: they were taken
+ *          with the previous settings. A level query right after the write counts them
+ *          (and the few taken after it); they are read into the scratch block at the next
+ *          drain and dropped, together with the averaged sample in progress at the write
+ *          when either setting averages, since that one mixes both. The next block starts
+ *          with the first sample taken entirely with the new settings and carries
+ *          SB_FLAG_GAP: its seq skips the discarded samples. If the level cannot be read,
+ *          the whole next drain is discarded.
+ * @param idx - Sensor slot
+ * @param averaging - The previous or the new averaging setting is above 1
+ * @return void
+ */
+static void Acquisition_Settle(uint8_t idx, uint8_t averaging) {
+    uint8_t available = 0;
+    if (MAX30101_GetNumAvailableSamples(&acq_sensors[idx], &available) != I2C_OK) {
+        acq_errors[idx]++;
+        acq_skip[idx] = ACQ_SKIP_ALL;
+        return;
+    }
+    acq_bus_bytes += 3u;
+    acq_skip[idx] = (uint8_t)(available + (averaging ? 1u : 0u));
+}
+
+/**
+ * @brief Apply a pending on-chip averaging change of one sensor
+ * @details Called right after a complete FIFO drain; Acquisition_Settle() then discards
+ *          what the sensor stored meanwhile, so every block's decimation is exact.
+ * @param idx - Sensor slot
+ * @param start - DWT->CYCCNT at the start of Acquisition_Poll()
+ * @return 1 if the setting was written
+ */
+static uint8_t Acquisition_Averaging(uint8_t idx, uint32_t start) {
+    uint8_t req = acq_avg_req[idx];
+    if (req == acq_avg[idx] || !Acquisition_Fits(start, I2C_WORST_CASE_US(2) + ACQ_SETTLE_US)) {
+        return 0;
+    }
+    if (MAX30101_SetSampleAverage(&acq_sensors[idx], (MAX30101_SampleAvg)req) != I2C_OK) {
+        acq_errors[idx]++;
+        return 0;
+    }
+    acq_bus_bytes += 1u;
+    acq_avg[idx] = req;
+    return 1;
+}
+
+/**
+ * @brief Apply pending LED current and ADC range changes of one sensor
+ * @details Called right after a complete FIFO drain, like Acquisition_Averaging(); the
+ *          next block of the sensor is flagged SB_FLAG_GAIN. The LED pair and the range
+ *          are separate writes: whatever was written is tracked, the rest retried on the
+ *          next drain.
+ * @param idx - Sensor slot
+ * @param start - DWT->CYCCNT at the start of Acquisition_Poll()
+ * @return 1 if a setting was written
+ */
+static uint8_t Acquisition_Led(uint8_t idx, uint32_t start) {
+    uint32_t req = acq_led_req[idx];
+    uint32_t led = acq_led[idx];
+    uint8_t wrote = 0;
+    if ((req & 0xFFFFu) != (led & 0xFFFFu) && Acquisition_Fits(start, I2C_WORST_CASE_US(3) + ACQ_SETTLE_US)) {
+        if (MAX30101_SetLedAmplitudes(&acq_sensors[idx], (uint8_t)req, (uint8_t)(req >> 8)) != I2C_OK) {
+            acq_errors[idx]++;
+            return 0;
+        }
+        acq_bus_bytes += 2u;
+        led = (led & ~0xFFFFu) | (req & 0xFFFFu);
+        acq_gain[idx] = 1;
+        wrote = 1;
+    }
+    if ((req >> 16) != (led >> 16) && Acquisition_Fits(start, I2C_WORST_CASE_US(2) + ACQ_SETTLE_US)) {
+        if (MAX30101_SetAdcRange(&acq_sensors[idx], (MAX30101_AdcRange)(req >> 16)) != I2C_OK) {
+            acq_errors[idx]++;
+        } else {
+            acq_bus_bytes += 1u;
+            led = (led & 0xFFFFu) | (req & ~0xFFFFu);
+            acq_gain[idx] = 1;
+            wrote = 1;
+        }
+    }
+    acq_led[idx] = led;
+    return wrote;
+}
+
+/**
+ * @brief Return the settings bookkeeping of one sensor to the profile
+ * @details The sensor itself was set back by MAX30101_EnterProximity(); requests still
+ *          pending from before the suspension are discarded.
+ * @param idx - Sensor slot
+ * @return void
+ */
+static void Acquisition_ProfileSettings(uint8_t idx) {
+    acq_avg[idx] = (uint8_t)MAX30101_NIRSLiteProfile.sample_avg;
+    acq_avg_req[idx] = acq_avg[idx];
+    acq_led[idx] = ACQ_LED_PACK(MAX30101_LED_MA_TO_REG(MAX30101_NIRSLiteProfile.led_red_ma),
+                                MAX30101_LED_MA_TO_REG(MAX30101_NIRSLiteProfile.led_ir_ma),
+                                MAX30101_NIRSLiteProfile.adc_range);
+    acq_led_req[idx] = acq_led[idx];
+    acq_gain[idx] = 0;
+    acq_skip[idx] = 0;
+}
+
+/**
+ * @brief Apply a pending suspension of one sensor
+ * @details Called right after a complete FIFO drain, so no sample of the sensor is lost
+ *          before proximity mode. A conversion in progress is abandoned.
+ * @param idx - Sensor slot
+ * @param start - DWT->CYCCNT at the start of Acquisition_Poll()
+ * @return 1 if the sensor is now suspended
+ */
+static uint8_t Acquisition_EnterProximity(uint8_t idx, uint32_t start) {
+    if (!acq_suspend_req[idx] || !Acquisition_Fits(start, ACQ_PROX_ENTER_US)) {
+        return 0;
+    }
+    if (MAX30101_EnterProximity(&acq_sensors[idx], MAX30101_LED_MA_TO_REG(ACQ_PROX_PILOT_MA),
+                                MAX30101_PROX_NA_TO_REG(ACQ_PROX_THRESH_NA, MAX30101_NIRSLiteProfile.adc_range)) != I2C_OK) {
+        acq_errors[idx]++;
+        return 0;
+    }
+    acq_bus_bytes += 12u;
+    acq_suspend_req[idx] = 0;
+    acq_suspended[idx] = 1;
+    acq_temp_pending[idx] = 0;
+    acq_poll_wait[idx] = ACQ_PROX_POLL_TICKS - 1u;
+    Acquisition_ProfileSettings(idx);
+    return 1;
+}
+
+/**
+ * @brief Poll a suspended sensor for skin contact
+ * @details One INTR_STATUS1 read; on PROX_INT the sensor is already sampling with the
+ *          profile, so it only needs the interrupt disabled and its FIFO polled again.
+ *          A failed disable is counted but does not hold the resume back (the interrupt
+ *          pin is unused).
+ * @param idx - Sensor slot
+ * @param start - DWT->CYCCNT at the start of Acquisition_Poll()
+ * @return void
+ */
+static void Acquisition_Proximity(uint8_t idx, uint32_t start) {
+    const MAX30101_Handle *dev = &acq_sensors[idx];
+    uint8_t status = 0;
+    // Mux deselect + select + status read + interrupt disable
+    if (!Acquisition_Fits(start, 2 * I2C_WORST_CASE_US(1) + 2 * I2C_WORST_CASE_US(2))) {
+        return;
+    }
+    if (MAX30101_ReadInterruptStatus1(dev, &status) != I2C_OK) {
+        acq_errors[idx]++;
+        return;
+    }
+    acq_bus_bytes += 1u;
+    acq_poll_wait[idx] = ACQ_PROX_POLL_TICKS - 1u;
+    if (!(status & MAX30101_INT_PROX)) {
+        return;
+    }
+    if (MAX30101_LeaveProximity(dev) != I2C_OK) {
+        acq_errors[idx]++;
+    } else {
+        acq_bus_bytes += 1u;
+    }
+    Acquisition_ProfileSettings(idx);   // Requests written during the suspension are stale
+    acq_suspended[idx] = 0;
+    acq_resumed[idx] = 1;
+    acq_poll_wait[idx] = 0;
+    acq_temp_due[idx] = acq_tick + acq_temp_period;
+}
+
+/**
+ * @brief Drain sensor FIFOs within the per-tick sample budget
+ * @details For each sensor, starting at the rotating round-robin index:
+ *          1. Query the FIFO level (mux select + one 3-byte pointer burst)
+ *          2. Read up to ACQ_BURST_SAMPLES samples per transaction, each into its own
+ *             SampleBlock, until the sensor's FIFO is empty or the sample budget is exhausted
+ *
+ *          Before each step the worst-case transaction time is checked against what is
+ *          left of ACQ_TICK_BUDGET_US; a burst that does not fit is shortened, and the
+ *          poll ends early when not even one sample fits. A failed transaction ends the
+ *          sensor's turn for this tick. After a successful drain the sensor's die
+ *          temperature state machine gets one step, unless a pending suspension puts it
+ *          in proximity mode instead; a suspended sensor only gets its proximity poll.
+ *
+ * @return Number of samples pushed to the ring during this call
+ * @note ISR context (SysTick_Handler)
+ */
+uint8_t Acquisition_Poll(void) {
+    uint32_t start = DWT->CYCCNT;
+    uint8_t budget = ACQ_MAX_SAMPLES_PER_TICK;
+    uint8_t idx = acq_rr_start;
+
+    for (uint8_t k = 0; k < acq_num_sensors && budget > 0; k++) {
+        const MAX30101_Handle *dev = &acq_sensors[idx];
+        uint8_t available = 0;
+        if (acq_poll_wait[idx] > 0) {
+            // Averaging sensor: one new sample every 2^avg ticks, skip the empty polls
+            // (suspended sensor: proximity status every ACQ_PROX_POLL_TICKS ticks)
+            acq_poll_wait[idx]--;
+            if (++idx >= acq_num_sensors) idx = 0;
+            continue;
+        }
+        if (acq_suspended[idx]) {
+            Acquisition_Proximity(idx, start);
+            if (++idx >= acq_num_sensors) idx = 0;
+            continue;
+        }
+        // Mux deselect + select + pointer read
+        if (!Acquisition_Fits(start, 2 * I2C_WORST_CASE_US(1) + I2C_WORST_CASE_US(4))) {
+            break;
+        }
+        if (MAX30101_GetNumAvailableSamples(dev, &available) != I2C_OK) {
+            acq_errors[idx]++;
+            if (++idx >= acq_num_sensors) idx = 0;
+            continue;
+        }
+        acq_bus_bytes += 3u;
+        if (available >= MAX30101_FIFO_DEPTH) {
+            acq_fifo_overflows++;   // Full with a non-zero overflow counter: samples were lost in the sensor
+        }
+        if (acq_skip[idx] == ACQ_SKIP_ALL) {
+            acq_skip[idx] = available;
+        }
+        acq_poll_wait[idx] = (uint8_t)((1u << acq_avg[idx]) - 1u);
+        while (available > 0 && budget > 0) {
+            uint8_t n = available;
+            if (n > ACQ_BURST_SAMPLES) n = ACQ_BURST_SAMPLES;
+            if (n > budget) n = budget;
+            if (acq_skip[idx] > 0u && n > acq_skip[idx]) n = acq_skip[idx];
+            // Shorten the burst until its worst case fits in the remaining tick time
+            while (n > 0 && !Acquisition_Fits(start, I2C_WORST_CASE_US(1 + n * MAX30101_BYTES_PER_SAMPLE))) {
+                n--;
+            }
+            if (n == 0) {
+                budget = 0;
+                break;
+            }
+            if (Acquisition_ReadBlock(idx, n) != I2C_OK) {
+                acq_errors[idx]++;
+                break;
+            }
+            available -= n;
+            budget -= n;
+        }
+        if (available == 0 && !Acquisition_EnterProximity(idx, start)) {
+            uint8_t avg = acq_avg[idx];
+            uint8_t wrote = Acquisition_Averaging(idx, start);
+            wrote |= Acquisition_Led(idx, start);
+            if (wrote) {
+                Acquisition_Settle(idx, (uint8_t)(avg | acq_avg[idx]));
+            }
+            Acquisition_Temperature(idx, start);
+        }
+        if (++idx >= acq_num_sensors) idx = 0;
+    }
+    // Rotate the starting sensor so a budget-limited sensor goes first next tick
+    if (acq_num_sensors > 0 && ++acq_rr_start >= acq_num_sensors) {
+        acq_rr_start = 0;
+    }
+    acq_tick++;
+    return (uint8_t)(ACQ_MAX_SAMPLES_PER_TICK - budget);
+}
+
+/**
+ * @brief Get the oldest block of the ring without removing it
+ * @return Oldest block, or NULL if the ring is empty
+ */
+SampleBlock *Acquisition_Peek(void) {
+    uint16_t tail = acq_tail;
+    if (tail == acq_head) {
+        return NULL;
+    }
+    __DMB(); // Read the block only after observing the head index that published it
+    return &acq_ring[tail];
+}
+
+/**
+ * @brief Hand the oldest block back to the producer
+ * @return void
+ */
+void Acquisition_Release(void) {
+    uint16_t tail = acq_tail;
+    if (tail == acq_head) {
+        return;
+    }
+    __DMB(); // Finish using the slot before handing it back to the producer
+    acq_tail = (tail + 1u) & (ACQ_RING_BLOCKS - 1u);
+}
+
+/**
+ * @brief Number of samples dropped because the ring was full
+ * @return Dropped sample count since Acquisition_Init()
+ */
+uint32_t Acquisition_GetDropped(void) {
+    return acq_dropped;
+}
+
+/**
+ * @brief Number of sensor register bytes transferred
+ * @return Byte count since Acquisition_Init()
+ */
+uint32_t Acquisition_GetBusBytes(void) {
+    return acq_bus_bytes;
+}
+
+/**
+ * @brief Number of FIFO level queries that found a sensor FIFO overflowed
+ * @return Overflow count since Acquisition_Init()
+ */
+uint32_t Acquisition_GetFifoOverflows(void) {
+    return acq_fifo_overflows;
+}
+
+/**
+ * @brief Most blocks queued in the ring at once
+ * @return High-water mark since Acquisition_Init()
+ */
+uint16_t Acquisition_GetRingHighWater(void) {
+    return acq_ring_peak;
+}
+
+/**
+ * @brief Request a FIFO output decimation (on-chip averaging) for a sensor
+ * @param sensor_id - Sensor ID
+ * @param decimation - ADC samples averaged per FIFO sample (power of two, 1..32)
+ * @return void
+ */
+void Acquisition_SetDecimation(uint8_t sensor_id, uint8_t decimation) {
+    uint8_t avg = 0;
+    while (avg < (uint8_t)MAX30101_SMP_AVE_32 && (2u << avg) <= decimation) {
+        avg++;
+    }
+    for (uint8_t i = 0; i < acq_num_sensors; i++) {
+        if (acq_sensors[i].id == sensor_id) {
+            acq_avg_req[i] = avg;
+        }
+    }
+}
+
+/**
+ * @brief Request LED drive currents and an ADC range for a sensor
+ * @param sensor_id - Sensor ID
+ * @param codes - [in] LED drive register code per optical channel
+ * @param range - MAX30101_AdcRange
+ * @return void
+ */
+void Acquisition_SetLed(uint8_t sensor_id, const uint8_t *codes, uint8_t range) {
+    uint32_t req = ACQ_LED_PACK(codes[SB_CH_RED], codes[SB_CH_IR], range & 0x03u);
+    for (uint8_t i = 0; i < acq_num_sensors; i++) {
+        if (acq_sensors[i].id == sensor_id) {
+            acq_led_req[i] = req;
+        }
+    }
+}
+
+/**
+ * @brief Request an off-body suspension (proximity mode) for a sensor
+ * @param sensor_id - Sensor ID
+ * @return void
+ */
+void Acquisition_Suspend(uint8_t sensor_id) {
+    for (uint8_t i = 0; i < acq_num_sensors; i++) {
+        if (acq_sensors[i].id == sensor_id) {
+            acq_suspend_req[i] = 1;
+        }
+    }
+}
+
+/**
+ * @brief Number of failed I2C transactions for a sensor
+ * @param sensor_id - Sensor ID
+ * @return Error count since Acquisition_Init() (0 for unknown IDs)
+ */
+uint32_t Acquisition_GetErrors(uint8_t sensor_id) {
+    for (uint8_t i = 0; i < acq_num_sensors; i++) {
+        if (acq_sensors[i].id == sensor_id) {
+            return acq_errors[i];
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Set the die temperature sampling period
+ * @param period_ticks - Ticks between conversions (0 disables)
+ * @return void
+ */
+void Acquisition_SetTemperaturePeriod(uint16_t period_ticks) {
+    acq_temp_period = period_ticks;
+}
+
+/**
+ * @brief Get the latest die temperature of a sensor if it is new
+ * @param sensor_id - Sensor ID
+ * @param deg_c - [out] Die temperature in °C
+ * @return 1 if a result arrived since the previous call, 0 otherwise
+ */
+uint8_t Acquisition_GetTemperature(uint8_t sensor_id, float32_t *deg_c) {
+    for (uint8_t i = 0; i < acq_num_sensors; i++) {
+        if (acq_sensors[i].id == sensor_id && acq_temp_new[i]) {
+            *deg_c = acq_temp_value[i];
+            acq_temp_new[i] = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,213 @@
+/**
+ * @file Acquisition.h
+ * @brief Multi-sensor MAX30101 acquisition scheduler
+ * @details Round-robin FIFO drain for several MAX30101 sensors sharing I2C1 through a mux.
+ *
+ * ### Scheduling
+ *  - Called once per SysTick tick (ISR context)
+ *  - Each sensor is polled for its FIFO level and drained in bursts of up to
+ *    ACQ_BURST_SAMPLES samples per I2C transaction
+ *  - At most ACQ_MAX_SAMPLES_PER_TICK samples are read per tick; samples left behind
+ *    stay in the sensor FIFO for the next tick
+ *  - The sensor polled first rotates every tick so no sensor is starved by the budget
+ *
+ * ### Latency Guarantee
+ *  - A transaction is only started if its worst case (I2C_WORST_CASE_US: deadline plus
+ *    error recovery) fits in what is left of ACQ_TICK_BUDGET_US; bursts are shortened
+ *    or deferred otherwise. Acquisition_Poll() therefore never exceeds ACQ_TICK_BUDGET_US,
+ *    even with a faulty sensor or a stuck bus
+ *  - A sensor whose transaction fails is skipped for the rest of the tick and its
+ *    error counter is incremented
+ *
+ * ### Die Temperature Side Channel
+ *  - Every ACQ_TEMP_PERIOD_TICKS ticks (runtime adjustable) a conversion is triggered
+ *    with a single register write right after the sensor's FIFO drain
+ *  - From ACQ_TEMP_CONV_TICKS ticks later, each drain of that sensor opportunistically
+ *    reads the result (one 3-byte burst) until the conversion has finished
+ *  - Both periods count acquisition ticks, whatever the sensor's averaging
+ *  - Nothing ever waits for the conversion; temperature transactions are subject to
+ *    the same tick budget as FIFO reads and are simply postponed when it is exhausted
+ *
+ * ### On-Chip Averaging
+ *  - Acquisition_SetDecimation() requests a FIFO averaging factor (SMP_AVE) for a
+ *    sensor; it is written right after the sensor's next complete FIFO drain, so the
+ *    change falls between two blocks
+ *  - Right after the write the FIFO level is read again: samples stored between the
+ *    drain and the write, and the averaged sample in progress, are discarded at the
+ *    next drain, so each block's decimation field is exact. That block carries
+ *    SB_FLAG_GAP (its seq skips the discarded samples)
+ *  - While averaging by D the sensor produces one sample every D ticks, so its FIFO
+ *    level is only queried every D ticks
+ *  - Acquisition_GetBusBytes() counts the sensor register bytes moved, to compare the
+ *    bus load of the rates
+ *
+ * ### LED Current and ADC Range
+ *  - Acquisition_SetLed() requests LED drive codes and an ADC range; like the averaging,
+ *    they are written right after the sensor's next complete FIFO drain, and the samples
+ *    stored meanwhile are discarded the same way (SB_FLAG_GAP if there were any)
+ *  - Every block carries the LED codes and range it was sampled with; the first block
+ *    after a change is flagged SB_FLAG_GAIN
+ *  - Currents are scaled to the active range, so nA values are comparable across ranges
+ *
+ * ### Off-Body Suspension
+ *  - Acquisition_Suspend() (after the pipeline detected off-body) puts the sensor in the
+ *    MAX30101 proximity mode right after its next complete FIFO drain: profile averaging,
+ *    range and LED currents are restored, only the IR pilot LED (ACQ_PROX_PILOT_MA) pulses
+ *    and nothing is stored in the FIFO
+ *  - While suspended the sensor costs one 1-byte INTR_STATUS1 read every
+ *    ACQ_PROX_POLL_TICKS ticks instead of a FIFO poll per tick; no temperature conversions
+ *  - When the IR current exceeds ACQ_PROX_THRESH_NA the sensor resumes the profile mode by
+ *    itself; the next poll sees PROX_INT, the bookkeeping (averaging, LED codes, range and
+ *    their requests) returns to the profile and the first block is flagged SB_FLAG_RESUME
+ *
+ * ### Output
+ *  - Each FIFO burst is unpacked straight into the channel arrays of the next free
+ *    SampleBlock of a single-producer / single-consumer block ring, tagged with the
+ *    sensor ID, a per-sensor sequence number and the acquisition tick
+ *  - The consumer processes the oldest block in place (Acquisition_Peek) and hands the
+ *    slot back (Acquisition_Release); samples are never copied
+ *  - On ring overflow the burst is still read (to keep the sensor FIFO drained) but
+ *    dropped and counted; the next block of that sensor carries SB_FLAG_GAP
+ *  - The ring high-water mark and the sensor FIFO overflows are counted as well, to size
+ *    the ring and the tick budget from the field
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see MAX30101_Handle, MAX30101_ReadBurstCurrentData
+ */
+
+#ifndef ACQUISITION_H_
+#define ACQUISITION_H_
+
+#include <stdint.h>
+#include "MAX30101.h"
+#include "SampleBlock.h"
+
+#define     ACQ_MAX_SENSORS             4   /**< Maximum number of sensors handled by the scheduler */
+#define     ACQ_BURST_SAMPLES           SAMPLE_BLOCK_LEN /**< Maximum samples read per I2C FIFO burst (one block) */
+#define     ACQ_MAX_SAMPLES_PER_TICK    16  /**< Sample budget per tick across all sensors (~135 µs of bus time per sample at 400 kHz) */
+#define     ACQ_RING_BLOCKS             16  /**< Block ring capacity (power of two); ~0.3 s of backlog at one block per tick */
+#define     ACQ_TICK_BUDGET_US          8000 /**< Hard upper bound on Acquisition_Poll() time per tick (40% of the 20 ms tick) */
+#define     ACQ_TEMP_PERIOD_TICKS       250 /**< Default die temperature period in ticks (5 s at 50 Hz), 0 disables */
+#define     ACQ_TEMP_CONV_TICKS         2   /**< Ticks to wait before the first result poll (≥ 29 ms conversion) */
+#define     ACQ_PROX_POLL_TICKS         25  /**< Ticks between proximity status polls of a suspended sensor (0.5 s) */
+#define     ACQ_PROX_PILOT_MA           5.0f    /**< IR pilot LED current while suspended (mA) */
+#define     ACQ_PROX_THRESH_NA          100.0f  /**< IR current that wakes a suspended sensor (nA; 20 nA/mA at the pilot, twice WEAR_OFF_NA_PER_MA) */
+
+/**
+ * @brief Register the sensors drained by the scheduler
+ * @details Sensors must already be initialized (MAX30101_InitNIRSLite).
+ *          The handle array must stay valid for the lifetime of the scheduler.
+ * @param sensors - [in] Array of sensor handles
+ * @param num_sensors - [in] Number of sensors (1 to ACQ_MAX_SENSORS)
+ * @return void
+ */
+void Acquisition_Init(const MAX30101_Handle *sensors, uint8_t num_sensors);
+
+/**
+ * @brief Drain sensor FIFOs within the per-tick sample budget
+ * @details Intended to be called from SysTick_Handler once per tick.
+ * @return Number of samples pushed to the ring during this call
+ */
+uint8_t Acquisition_Poll(void);
+
+/**
+ * @brief Get the oldest block of the ring without removing it
+ * @details The block may be modified in place until Acquisition_Release().
+ * @return Oldest block, or NULL if the ring is empty
+ * @note Main-loop context only (single consumer)
+ */
+SampleBlock *Acquisition_Peek(void);
+
+/**
+ * @brief Hand the block returned by Acquisition_Peek() back to the producer
+ * @return void
+ * @note Main-loop context only; the block must not be used afterwards
+ */
+void Acquisition_Release(void);
+
+/**
+ * @brief Number of samples dropped because the ring was full
+ * @return Dropped sample count since Acquisition_Init()
+ */
+uint32_t Acquisition_GetDropped(void);
+
+/**
+ * @brief Number of sensor register bytes transferred (FIFO data, pointers, temperature, configuration)
+ * @return Byte count since Acquisition_Init()
+ */
+uint32_t Acquisition_GetBusBytes(void);
+
+/**
+ * @brief Number of FIFO level queries that found a sensor FIFO overflowed
+ * @details The MAX30101 FIFO holds 32 samples; a query that finds it full (pointers
+ *          equal, overflow counter non-zero) means samples were overwritten in the
+ *          sensor before the drain caught up.
+ * @return Overflow count since Acquisition_Init(), all sensors
+ */
+uint32_t Acquisition_GetFifoOverflows(void);
+
+/**
+ * @brief Most blocks queued in the ring at once
+ * @details Sampled by the producer after each published block; ACQ_RING_BLOCKS - 1
+ *          means the ring has been full (see Acquisition_GetDropped()).
+ * @return High-water mark since Acquisition_Init()
+ */
+uint16_t Acquisition_GetRingHighWater(void);
+
+/**
+ * @brief Request a FIFO output decimation (on-chip averaging) for a sensor
+ * @details Applied by Acquisition_Poll() after the sensor's next complete FIFO drain.
+ * @param sensor_id - Sensor ID
+ * @param decimation - ADC samples averaged per FIFO sample (power of two, 1..32; rounded down)
+ * @return void
+ * @note Main-loop context
+ */
+void Acquisition_SetDecimation(uint8_t sensor_id, uint8_t decimation);
+
+/**
+ * @brief Request LED drive currents and an ADC range for a sensor
+ * @details Applied by Acquisition_Poll() after the sensor's next complete FIFO drain.
+ * @param sensor_id - Sensor ID
+ * @param codes - [in] LED drive register code per optical channel (0.2 mA steps)
+ * @param range - MAX30101_AdcRange
+ * @return void
+ * @note Main-loop context
+ */
+void Acquisition_SetLed(uint8_t sensor_id, const uint8_t *codes, uint8_t range);
+
+/**
+ * @brief Request an off-body suspension (proximity mode) for a sensor
+ * @details Applied by Acquisition_Poll() after the sensor's next complete FIFO drain; the
+ *          sensor resumes by itself on skin contact (first block flagged SB_FLAG_RESUME).
+ * @param sensor_id - Sensor ID
+ * @return void
+ * @note Main-loop context
+ */
+void Acquisition_Suspend(uint8_t sensor_id);
+
+/**
+ * @brief Number of failed I2C transactions for a sensor
+ * @param sensor_id - Sensor ID
+ * @return Error count since Acquisition_Init() (0 for unknown IDs)
+ */
+uint32_t Acquisition_GetErrors(uint8_t sensor_id);
+
+/**
+ * @brief Set the die temperature sampling period
+ * @param period_ticks - Ticks between conversions per sensor (0 disables temperature sampling)
+ * @return void
+ */
+void Acquisition_SetTemperaturePeriod(uint16_t period_ticks);
+
+/**
+ * @brief Get the latest die temperature of a sensor if it is new
+ * @param sensor_id - Sensor ID
+ * @param deg_c - [out] Die temperature in °C
+ * @return 1 if a result arrived since the previous call, 0 otherwise
+ * @note Main-loop context; consumes the "new" flag
+ */
+uint8_t Acquisition_GetTemperature(uint8_t sensor_id, float32_t *deg_c);
+
+#endif /* ACQUISITION_H_ */
@@ -0,0 +1,69 @@
+/**
+ * @file AdaptiveRate.c
+ * @brief Activity-adaptive output rate implementation
+ * @details Smoothed relative AC activity with a quiet timer and an immediate wake-up.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "AdaptiveRate.h"
+#include <math.h>
+#include <stdint.h>
+
+/**
+ * @brief Initialize a rate controller at full rate
+ * @param rc - [out] Rate controller
+ * @param low_decim - Decimation of the reduced rate
+ * @return void
+ */
+void Rate_Init(Rate_Context *rc, uint8_t low_decim) {
+    rc->ms = 0.0f;
+    rc->quiet = 0;
+    rc->low_decim = low_decim;
+    rc->request = 1;
+}
+
+/**
+ * @brief Update the activity with a block of high-passed samples
+ * @param rc - [in,out] Rate controller
+ * @param ac - [in] High-passed IR samples (nA)
+ * @param dc - IR baseline (nA)
+ * @param n - Number of samples
+ * @param decim - Decimation the samples were taken with
+ * @return Requested decimation
+ */
+uint8_t Rate_Update(Rate_Context *rc, const float32_t *ac, float32_t dc, uint32_t n, uint8_t decim) {
+    if (dc <= 0.0f) {
+        // No usable baseline (off-skin, start-up): stay at full rate
+        rc->quiet = 0;
+        rc->request = 1;
+        return rc->request;
+    }
+    const float32_t wake_ms = RATE_WAKE_PCT * RATE_WAKE_PCT;
+    const float32_t quiet_ms = RATE_QUIET_PCT * RATE_QUIET_PCT;
+    // Same time constant at every rate: one reduced-rate sample spans decim periods
+    float32_t alpha = (decim > 1u) ? powf(RATE_ACTIVITY_ALPHA, (float32_t)decim) : RATE_ACTIVITY_ALPHA;
+    float32_t scale = 100.0f / dc;
+    float32_t ms = rc->ms;
+
+    for (uint32_t i = 0; i < n; i++) {
+        float32_t r = ac[i] * scale;
+        float32_t r2 = r * r;
+        ms = alpha * ms + (1.0f - alpha) * r2;
+        if (r2 > wake_ms || ms > wake_ms) {
+            rc->quiet = 0;
+            rc->request = 1;
+        } else if (ms < quiet_ms) {
+            if (rc->quiet < RATE_QUIET_SAMPLES) {
+                rc->quiet += decim;
+            } else {
+                rc->request = rc->low_decim;
+            }
+        } else {
+            rc->quiet = 0;
+        }
+    }
+    rc->ms = ms;
+    return rc->request;
+}
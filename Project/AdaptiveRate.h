@@ -0,0 +1,64 @@
+/**
+ * @file AdaptiveRate.h
+ * @brief Activity-adaptive output rate: on-chip averaging during steady state
+ * @details Decides, per sensor, between full rate and a reduced rate in which the
+ *          MAX30101 averages low_decim ADC samples per FIFO sample (SMP_AVE). The
+ *          ADC keeps sampling at the configured rate, so the reduced rate loses no
+ *          light, only bandwidth beyond the reduced Nyquist frequency; I2C traffic,
+ *          processing and link load drop by the decimation factor.
+ *
+ * ### Activity
+ *  Relative AC level of the high-passed IR channel, 100 · |ac| / dc (%), smoothed as an
+ *  exponential mean square (RATE_ACTIVITY_ALPHA per full-rate sample period):
+ *  - **Slow down** after RATE_QUIET_SAMPLES full-rate sample periods with the smoothed
+ *    activity below RATE_QUIET_PCT
+ *  - **Snap back** as soon as one sample or the smoothed activity exceeds RATE_WAKE_PCT
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Pipeline_ProcessBlock, Acquisition_SetDecimation
+ */
+
+#ifndef ADAPTIVERATE_H_
+#define ADAPTIVERATE_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+
+#define     RATE_QUIET_PCT          0.5f    /**< Smoothed activity (%) below which the signal is steady */
+#define     RATE_WAKE_PCT           1.0f    /**< Sample or smoothed activity (%) that restores full rate */
+#define     RATE_QUIET_SAMPLES      500u    /**< Steady full-rate sample periods before slowing down (10 s at 50 Hz) */
+#define     RATE_ACTIVITY_ALPHA     0.95f   /**< Activity mean-square smoothing per full-rate sample (τ ≈ 0.4 s at 50 Hz) */
+
+/**
+ * @struct Rate_Context
+ * @brief Rate controller state (one per sensor)
+ */
+typedef struct {
+    float32_t ms;           /**< Smoothed activity mean square (%²) */
+    uint32_t  quiet;        /**< Full-rate sample periods of steady signal */
+    uint8_t   low_decim;    /**< Decimation of the reduced rate */
+    uint8_t   request;      /**< Requested decimation (1 or low_decim) */
+} Rate_Context;
+
+/**
+ * @brief Initialize a rate controller at full rate
+ * @param rc - [out] Rate controller
+ * @param low_decim - Decimation of the reduced rate (power of two, 2..32)
+ * @return void
+ */
+void Rate_Init(Rate_Context *rc, uint8_t low_decim);
+
+/**
+ * @brief Update the activity with a block of high-passed samples
+ * @param rc - [in,out] Rate controller
+ * @param ac - [in] High-passed IR samples (nA)
+ * @param dc - IR baseline (nA)
+ * @param n - Number of samples
+ * @param decim - Decimation the samples were taken with
+ * @return Requested decimation (1 = full rate)
+ */
+uint8_t Rate_Update(Rate_Context *rc, const float32_t *ac, float32_t dc, uint32_t n, uint8_t decim);
+
+#endif /* ADAPTIVERATE_H_ */
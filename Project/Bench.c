@@ -0,0 +1,394 @@
+/**
+ * @file Bench.c
+ * @brief DSP micro-benchmark suite implementation
+ * @details Kernel table, shared synthetic input buffers and the DWT-based timing loop.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Bench.h"
+#include "MAX30101.h"
+#include "MotionCancel.h"
+#include "Hemoglobin.h"
+#include "Format.h"
+#include "Stats.h"
+#include "Hampel.h"
+#include "UART.h"
+#include "stm32f303x8.h"
+#include "system_stm32f3xx.h"
+#include "arm_math.h"
+#include <stdint.h>
+
+#ifndef BENCH_CYCLES
+#define BENCH_CYCLES()  (DWT->CYCCNT)       /**< Cycle counter */
+#endif
+#ifndef BENCH_CORE_HZ
+#define BENCH_CORE_HZ   SystemCoreClock     /**< Cycle counter frequency */
+#endif
+
+#define BENCH_IIR_MAX_SECTIONS  4           /**< Largest cascade accepted by Bench_Run() */
+#define BENCH_STATS_WINDOW      50u         /**< Sliding-window length (1 s at 50 Hz) */
+#define BENCH_HAMPEL_WINDOW     15u         /**< Spike filter window (samples) */
+
+/* Shared synthetic data, generated once by Bench_Prepare() */
+static MAX30101_Sample bench_raw[BENCH_MAX_BLOCK];      /**< FIFO-format bytes */
+static MAX30101_DataSample bench_counts[BENCH_MAX_BLOCK]; /**< 18-bit counts */
+static float32_t bench_in[BENCH_MAX_BLOCK];             /**< Red current (nA) */
+static float32_t bench_in2[BENCH_MAX_BLOCK];            /**< IR current (nA) */
+static float32_t bench_out[BENCH_MAX_BLOCK];            /**< Kernel output */
+static float32_t bench_out2[BENCH_MAX_BLOCK];           /**< Second kernel output */
+static uint32_t bench_red_u32[BENCH_MAX_BLOCK];         /**< SoA Red counts */
+static uint32_t bench_ir_u32[BENCH_MAX_BLOCK];          /**< SoA IR counts */
+static volatile uint32_t bench_sink;                    /**< Keeps results observable */
+
+/* Kernel state */
+static float32_t bench_w;
+static float32_t bench_lp;
+static arm_biquad_cascade_df2T_instance_f32 bench_iir;
+static float32_t bench_iir_state[2 * BENCH_IIR_MAX_SECTIONS];
+static Motion_Canceller bench_mc;
+static Hb_Context bench_hb;
+static Stats_Window bench_stats;
+static float32_t bench_stats_hist[STATS_STORAGE_LEN(BENCH_STATS_WINDOW, 2)];
+static uint16_t bench_stats_min[STATS_STORAGE_LEN(BENCH_STATS_WINDOW, 2)];
+static uint16_t bench_stats_max[STATS_STORAGE_LEN(BENCH_STATS_WINDOW, 2)];
+static Hampel_Filter bench_hampel;
+static float32_t bench_hampel_win[BENCH_HAMPEL_WINDOW];   /**< Naive Hampel: last samples, oldest first */
+
+/**
+ * @brief Empty kernel, measures the timing loop overhead
+ */
+static void Bench_Empty(uint32_t n) {
+    bench_sink = n;
+}
+
+/**
+ * @brief MAX30101_FirstOrderDC_Blocker, one call per sample
+ */
+static void Bench_DCBlocker(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        bench_out[i] = MAX30101_FirstOrderDC_Blocker(bench_in[i], &bench_w, 0.995f);
+    }
+}
+
+/**
+ * @brief Biquad cascade (main.c iirCoeffs), one call per block
+ */
+static void Bench_IIR(uint32_t n) {
+    arm_biquad_cascade_df2T_f32(&bench_iir, bench_in, bench_out, n);
+}
+
+/**
+ * @brief DC blocker plus its baseline in one pass (Pipeline_HighPass with baseline_output)
+ */
+static void Bench_DCBaseline(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        bench_out2[i] = (1.0f - 0.995f) * bench_w;
+        bench_out[i] = MAX30101_FirstOrderDC_Blocker(bench_in[i], &bench_w, 0.995f);
+    }
+}
+
+/**
+ * @brief DC blocker plus a separate one-pole low-pass baseline filter (reference for dc_baseline)
+ */
+static void Bench_DCBaseline2Pass(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        bench_out[i] = MAX30101_FirstOrderDC_Blocker(bench_in[i], &bench_w, 0.995f);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        bench_lp += (1.0f - 0.995f) * (bench_in[i] - bench_lp);
+        bench_out2[i] = bench_lp;
+    }
+}
+
+/**
+ * @brief Biquad cascade plus its complementary baseline (Pipeline_HighPass with baseline_output)
+ */
+static void Bench_IIRBaseline(uint32_t n) {
+    arm_biquad_cascade_df2T_f32(&bench_iir, bench_in, bench_out, n);
+    for (uint32_t i = 0; i < n; i++) {
+        bench_out2[i] = bench_in[i] - bench_out[i];
+    }
+}
+
+/**
+ * @brief Biquad cascade plus a separate one-pole low-pass baseline filter (reference for iir_baseline)
+ */
+static void Bench_IIRBaseline2Pass(uint32_t n) {
+    arm_biquad_cascade_df2T_f32(&bench_iir, bench_in, bench_out, n);
+    for (uint32_t i = 0; i < n; i++) {
+        bench_lp += (1.0f - 0.995f) * (bench_in[i] - bench_lp);
+        bench_out2[i] = bench_lp;
+    }
+}
+
+/**
+ * @brief MAX30101_ConvertSampleToUint32 (3-byte unpack, both channels)
+ */
+static void Bench_Unpack(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        MAX30101_ConvertSampleToUint32(&bench_raw[i], &bench_counts[i]);
+    }
+}
+
+/**
+ * @brief MAX30101_ConvertUint32ToCurrent (counts to nA, both channels)
+ */
+static void Bench_ToCurrent(uint32_t n) {
+    MAX30101_CurrentSample s;
+    for (uint32_t i = 0; i < n; i++) {
+        MAX30101_ConvertUint32ToCurrent(&bench_counts[i], &s);
+        bench_out[i] = s.red;
+    }
+}
+
+/**
+ * @brief MAX30101_UnpackBurstCounts (FIFO burst to SoA counts), one call per block
+ */
+static void Bench_UnpackBurst(uint32_t n) {
+    MAX30101_UnpackBurstCounts((const uint8_t *)bench_raw, bench_red_u32, bench_ir_u32, n);
+}
+
+/**
+ * @brief MAX30101_UnpackBurstCurrent (FIFO burst to SoA nA), one call per block
+ */
+static void Bench_UnpackBurstCurrent(uint32_t n) {
+    MAX30101_UnpackBurstCurrent((const uint8_t *)bench_raw, bench_out, bench_out2, 1, n);
+}
+
+/**
+ * @brief Fmt_Fixed4 text encoding ("%.4f" equivalent), one value per sample
+ */
+static void Bench_Fixed4(uint32_t n) {
+    char text[FMT_FIXED4_MAX_CHARS];
+    for (uint32_t i = 0; i < n; i++) {
+        bench_sink = (uint32_t)(Fmt_Fixed4(text, bench_in[i]) - text);
+    }
+}
+
+/**
+ * @brief Motion_Cancel (NLMS, MOTION_NUM_TAPS taps), in chunks of MOTION_MAX_BLOCK
+ */
+static void Bench_NLMS(uint32_t n) {
+    for (uint32_t i = 0; i < n; i += MOTION_MAX_BLOCK) {
+        uint32_t len = (n - i < MOTION_MAX_BLOCK) ? (n - i) : MOTION_MAX_BLOCK;
+        Motion_Cancel(&bench_mc, &bench_in[i], &bench_in2[i], &bench_out[i], len);
+    }
+}
+
+/**
+ * @brief Hb_Compute (two log10f and a 2×2 product) per sample
+ */
+static void Bench_MBLL(uint32_t n) {
+    Hb_Sample hb;
+    for (uint32_t i = 0; i < n; i++) {
+        Hb_Compute(&bench_hb, bench_in[i], bench_in2[i], &hb);
+        bench_out[i] = hb.hbo2;
+    }
+}
+
+/**
+ * @brief Stats_PushRows over Red/IR plus one Stats_Get per channel and block
+ */
+static void Bench_Stats(uint32_t n) {
+    const float32_t *rows[2] = { bench_in, bench_in2 };
+    Stats_Result r;
+    Stats_PushRows(&bench_stats, rows, n);
+    Stats_Get(&bench_stats, 0, &r);
+    bench_out[0] = r.slope;
+    Stats_Get(&bench_stats, 1, &r);
+    bench_out[1] = r.slope;
+}
+
+/**
+ * @brief Hampel_Process (rolling sorted window, MAD by merge selection)
+ */
+static void Bench_Hampel(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        bench_out[i] = bench_in[i];
+    }
+    bench_sink = Hampel_Process(&bench_hampel, bench_out, n);
+}
+
+/**
+ * @brief Insertion sort of a short array
+ */
+static void Bench_InsertionSort(float32_t *v, uint32_t len) {
+    for (uint32_t i = 1; i < len; i++) {
+        float32_t t = v[i];
+        uint32_t j = i;
+        while (j > 0u && v[j - 1u] > t) {
+            v[j] = v[j - 1u];
+            j--;
+        }
+        v[j] = t;
+    }
+}
+
+/**
+ * @brief Hampel filter sorting the window twice per sample (reference for hampel)
+ */
+static void Bench_HampelNaive(uint32_t n) {
+    const uint32_t h = BENCH_HAMPEL_WINDOW / 2u;
+    float32_t tmp[BENCH_HAMPEL_WINDOW];
+    uint32_t replaced = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint32_t k = 0; k + 1u < BENCH_HAMPEL_WINDOW; k++) {
+            bench_hampel_win[k] = bench_hampel_win[k + 1u];
+        }
+        bench_hampel_win[BENCH_HAMPEL_WINDOW - 1u] = bench_in[i];
+        for (uint32_t k = 0; k < BENCH_HAMPEL_WINDOW; k++) {
+            tmp[k] = bench_hampel_win[k];
+        }
+        Bench_InsertionSort(tmp, BENCH_HAMPEL_WINDOW);
+        float32_t med = tmp[h];
+        for (uint32_t k = 0; k < BENCH_HAMPEL_WINDOW; k++) {
+            float32_t d = bench_hampel_win[k] - med;
+            tmp[k] = (d < 0.0f) ? -d : d;
+        }
+        Bench_InsertionSort(tmp, BENCH_HAMPEL_WINDOW);
+        float32_t c = bench_hampel_win[h];
+        float32_t dev = (c < med) ? med - c : c - med;
+        if (tmp[h] > 0.0f && dev > 3.0f * HAMPEL_MAD_SCALE * tmp[h]) {
+            c = med;
+            replaced++;
+        }
+        bench_out[i] = c;
+    }
+    bench_sink = replaced;
+}
+
+/** Registered kernels, in report order */
+static const Bench_Case bench_cases[] = {
+    { "dc_blocker",  Bench_DCBlocker },
+    { "iir_biquad",  Bench_IIR },
+    { "dc_baseline", Bench_DCBaseline },
+    { "dc_base_2pass", Bench_DCBaseline2Pass },
+    { "iir_baseline", Bench_IIRBaseline },
+    { "iir_base_2pass", Bench_IIRBaseline2Pass },
+    { "unpack_u32",  Bench_Unpack },
+    { "to_current",  Bench_ToCurrent },
+    { "unpack_burst", Bench_UnpackBurst },
+    { "unpack_burst_na", Bench_UnpackBurstCurrent },
+    { "fmt_fixed4",  Bench_Fixed4 },
+    { "nlms",        Bench_NLMS },
+    { "mbll",        Bench_MBLL },
+    { "stats_window", Bench_Stats },
+    { "hampel",      Bench_Hampel },
+    { "hampel_naive", Bench_HampelNaive },
+};
+
+static const uint8_t bench_blocks[] = { 1, 4, 8, 16, BENCH_MAX_BLOCK }; /**< Block sizes */
+
+/**
+ * @brief Fill the shared buffers with a deterministic PPG-like signal
+ * @details DC of ~2000 nA plus a triangle "pulse" and LCG noise, encoded back into the
+ *          MAX30101 FIFO byte format for the unpack kernels.
+ * @return void
+ */
+static void Bench_Prepare(void) {
+    uint32_t lcg = 12345u;
+    for (uint32_t i = 0; i < BENCH_MAX_BLOCK; i++) {
+        lcg = lcg * 1664525u + 1013904223u;
+        uint32_t tri = (i & 15u) < 8u ? (i & 15u) : 16u - (i & 15u);
+        uint32_t red = 128000u + tri * 400u + (lcg >> 24);
+        uint32_t ir  = 160000u + tri * 300u + ((lcg >> 16) & 0xFFu);
+        bench_raw[i].red[0] = (uint8_t)(red >> 16);
+        bench_raw[i].red[1] = (uint8_t)(red >> 8);
+        bench_raw[i].red[2] = (uint8_t)red;
+        bench_raw[i].ir[0]  = (uint8_t)(ir >> 16);
+        bench_raw[i].ir[1]  = (uint8_t)(ir >> 8);
+        bench_raw[i].ir[2]  = (uint8_t)ir;
+        bench_in[i]  = (float32_t)red * (1.0f / 64.0f);
+        bench_in2[i] = (float32_t)ir * (1.0f / 64.0f);
+        MAX30101_ConvertSampleToUint32(&bench_raw[i], &bench_counts[i]);
+    }
+}
+
+/**
+ * @brief Time one kernel at one block size
+ * @param run - Kernel
+ * @param block - Block size
+ * @return Total cycles for ceil(BENCH_MIN_SAMPLES / block) calls
+ */
+static uint32_t Bench_Time(Bench_Kernel run, uint32_t block) {
+    uint32_t reps = (BENCH_MIN_SAMPLES + block - 1u) / block;
+    run(block);             // Untimed warm-up call
+    USART2_Flush();         // No TX interrupts while timing
+    __disable_irq();
+    uint32_t start = BENCH_CYCLES();
+    for (uint32_t r = 0; r < reps; r++) {
+        run(block);
+    }
+    uint32_t cycles = BENCH_CYCLES() - start;
+    __enable_irq();
+    return cycles;
+}
+
+/**
+ * @brief Emit one "#bench,<kernel>,<block>,<cycles_per_sample>,<samples_per_s>" line
+ */
+static void Bench_Report(const char *name, uint32_t block, float32_t cycles_per_sample) {
+    char line[FMT_UINT_MAX_CHARS * 2 + FMT_FIXED4_MAX_CHARS + 4];
+    uint32_t sps = (cycles_per_sample > 0.0f) ? (uint32_t)((float32_t)BENCH_CORE_HZ / cycles_per_sample) : 0u;
+    char *p = Fmt_Uint(line, block);
+    *p++ = ',';
+    p = Fmt_Fixed4(p, cycles_per_sample);
+    *p++ = ',';
+    p = Fmt_Uint(p, sps);
+    *p++ = '\r';
+    *p++ = '\n';
+    USART2_putString("#bench,");
+    USART2_putString(name);
+    USART2_putString(",");
+    USART2_Write(line, (uint16_t)(p - line));
+}
+
+/**
+ * @brief Run every registered kernel at every block size
+ * @param iir_coeffs - [in] Biquad cascade coefficients
+ * @param iir_sections - Number of biquad sections (up to 4)
+ * @return void
+ */
+void Bench_Run(const float32_t *iir_coeffs, uint8_t iir_sections) {
+    char line[FMT_UINT_MAX_CHARS + 2];
+
+    // Cycle counter (also enabled by I2C1_Config)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    if (iir_sections > BENCH_IIR_MAX_SECTIONS) {
+        iir_sections = BENCH_IIR_MAX_SECTIONS;
+    }
+    Bench_Prepare();
+    bench_w = 0.0f;
+    bench_lp = bench_in[0];
+    arm_biquad_cascade_df2T_init_f32(&bench_iir, iir_sections, iir_coeffs, bench_iir_state);
+    Motion_Init(&bench_mc, MOTION_MU);
+    Hb_Init(&bench_hb, HB_DEFAULT_DISTANCE_CM, HB_DEFAULT_DPF, 0);
+    Hb_SetBaseline(&bench_hb, bench_in[0], bench_in2[0]);
+    Stats_Init(&bench_stats, 2, BENCH_STATS_WINDOW, bench_stats_hist, bench_stats_min, bench_stats_max);
+    Hampel_Init(&bench_hampel, BENCH_HAMPEL_WINDOW, 3.0f);
+    for (uint32_t k = 0; k < BENCH_HAMPEL_WINDOW; k++) {
+        bench_hampel_win[k] = bench_in[0];
+    }
+
+    char *p = Fmt_Uint(line, BENCH_CORE_HZ);
+    *p++ = '\r';
+    *p++ = '\n';
+    USART2_putString("#bench,begin,");
+    USART2_Write(line, (uint16_t)(p - line));
+
+    for (uint8_t b = 0; b < sizeof(bench_blocks); b++) {
+        uint32_t block = bench_blocks[b];
+        uint32_t samples = ((BENCH_MIN_SAMPLES + block - 1u) / block) * block;
+        uint32_t overhead = Bench_Time(Bench_Empty, block);
+        for (uint8_t k = 0; k < sizeof(bench_cases) / sizeof(bench_cases[0]); k++) {
+            uint32_t cycles = Bench_Time(bench_cases[k].run, block);
+            cycles = (cycles > overhead) ? cycles - overhead : 0u;
+            Bench_Report(bench_cases[k].name, block, (float32_t)cycles / (float32_t)samples);
+        }
+    }
+    USART2_putString("#bench,end\r\n");
+}
@@ -0,0 +1,65 @@
+/**
+ * @file Bench.h
+ * @brief DSP micro-benchmark suite for the processing kernels
+ * @details Times each registered kernel with the DWT cycle counter at several block sizes
+ *          and reports cycles per sample and throughput as machine-readable side-channel
+ *          lines, so results can be diffed between commits.
+ *
+ * ### Method
+ *  - Each kernel runs once untimed (cache/flash prefetch and state warm-up), then
+ *    repeatedly until at least BENCH_MIN_SAMPLES samples have been processed
+ *  - The UART TX ring is flushed and interrupts are masked while a kernel is timed
+ *  - The loop overhead of an empty kernel is measured at the same block size and subtracted
+ *
+ * ### Output (USART2)
+ *  ```
+ *  #bench,begin,<core_hz>
+ *  #bench,<kernel>,<block>,<cycles_per_sample>,<samples_per_s>
+ *  ...
+ *  #bench,end
+ *  ```
+ *
+ * ### Host Builds
+ *  BENCH_CYCLES() and BENCH_CORE_HZ may be predefined (e.g. with a TSC/clock_gettime
+ *  source) to run the same suite off target.
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Bench_Run
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+#include "arm_math_types.h"
+
+#define     BENCH_MAX_BLOCK         32      /**< Largest block size (one full MAX30101 FIFO) */
+#define     BENCH_MIN_SAMPLES       2048    /**< Samples processed per measurement */
+
+/**
+ * @brief Benchmark kernel: process one block of block_size samples from the shared buffers
+ */
+typedef void (*Bench_Kernel)(uint32_t block_size);
+
+/**
+ * @struct Bench_Case
+ * @brief Named kernel in the benchmark table
+ */
+typedef struct {
+    const char  *name;      /**< Kernel name (first CSV field) */
+    Bench_Kernel run;       /**< Kernel entry */
+} Bench_Case;
+
+/**
+ * @brief Run every registered kernel at block sizes 1, 4, 8, 16 and 32
+ * @details Blocks for the duration of the suite (well under a second at 64 MHz).
+ *          Intended to be called once at boot, before SysTick_Config().
+ * @param iir_coeffs - [in] Biquad cascade coefficients used by the IIR kernel
+ * @param iir_sections - Number of biquad sections
+ * @return void
+ */
+void Bench_Run(const float32_t *iir_coeffs, uint8_t iir_sections);
+
+#endif /* BENCH_H_ */
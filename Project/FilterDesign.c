@@ -0,0 +1,403 @@
+/**
+ * @file FilterDesign.c
+ * @brief Runtime IIR design implementation
+ * @details Zero/pole/gain design with a minimal complex type, then section pairing.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "FilterDesign.h"
+#include <math.h>
+#include <stdint.h>
+
+#define     DESIGN_PI       3.14159265358979f
+#define     DESIGN_IM_TOL   1e-6f   /**< |Im| below which a root is treated as real */
+
+#define     DESIGN_ROOT_ANY         0   /**< Design_TakeNearest(): real roots and pair representatives */
+#define     DESIGN_ROOT_REAL        1   /**< Design_TakeNearest(): real roots only */
+#define     DESIGN_ROOT_COMPLEX     2   /**< Design_TakeNearest(): pair representatives only */
+
+/**
+ * @struct Design_Complex
+ * @brief Complex number (single precision)
+ */
+typedef struct {
+    float32_t re;
+    float32_t im;
+} Design_Complex;
+
+/**
+ * @struct Design_Zpk
+ * @brief Zeros and poles of a filter (the gain is set per section afterwards)
+ */
+typedef struct {
+    Design_Complex z[DESIGN_MAX_POLES];
+    Design_Complex p[DESIGN_MAX_POLES];
+    uint8_t nz;
+    uint8_t np;
+} Design_Zpk;
+
+static inline Design_Complex Design_C(float32_t re, float32_t im) {
+    Design_Complex c = { re, im };
+    return c;
+}
+
+static inline Design_Complex Design_Add(Design_Complex a, Design_Complex b) {
+    return Design_C(a.re + b.re, a.im + b.im);
+}
+
+static inline Design_Complex Design_Sub(Design_Complex a, Design_Complex b) {
+    return Design_C(a.re - b.re, a.im - b.im);
+}
+
+static inline Design_Complex Design_Mul(Design_Complex a, Design_Complex b) {
+    return Design_C(a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re);
+}
+
+static inline Design_Complex Design_Scale(Design_Complex a, float32_t s) {
+    return Design_C(a.re * s, a.im * s);
+}
+
+static inline Design_Complex Design_Div(Design_Complex a, Design_Complex b) {
+    float32_t d = b.re * b.re + b.im * b.im;
+    return Design_C((a.re * b.re + a.im * b.im) / d, (a.im * b.re - a.re * b.im) / d);
+}
+
+static inline float32_t Design_Abs(Design_Complex a) {
+    return hypotf(a.re, a.im);
+}
+
+/**
+ * @brief Principal square root
+ * @details Only the larger part comes from sqrt((|a| ± re) / 2); the other is im / (2·larger),
+ *          since |a| - |re| cancels when the argument is close to the real axis (band-pass
+ *          roots near ±j·w0).
+ */
+static Design_Complex Design_Sqrt(Design_Complex a) {
+    float32_t r = Design_Abs(a);
+    if (r == 0.0f) {
+        return Design_C(0.0f, 0.0f);
+    }
+    if (a.re >= 0.0f) {
+        float32_t re = sqrtf(0.5f * (r + a.re));
+        return Design_C(re, 0.5f * a.im / re);
+    }
+    float32_t im = sqrtf(0.5f * (r - a.re));
+    return Design_C(0.5f * fabsf(a.im) / im, (a.im < 0.0f) ? -im : im);
+}
+
+/**
+ * @brief Analog low-pass prototype with unit edge frequency
+ * @details Butterworth: poles on the unit circle, no zeros. Chebyshev II: poles of the
+ *          inverse Chebyshev, zeros on the imaginary axis, stopband edge at 1 rad/s.
+ * @param spec - [in] Specification
+ * @param f - [out] Prototype
+ * @return void
+ */
+static void Design_Prototype(const Design_Spec *spec, Design_Zpk *f) {
+    uint8_t n = spec->order;
+    f->nz = 0;
+    f->np = n;
+    if (spec->family == DESIGN_BUTTERWORTH) {
+        for (uint8_t i = 0; i < n; i++) {
+            float32_t theta = DESIGN_PI * (float32_t)(2 * i - n + 1) / (float32_t)(2 * n);
+            f->p[i] = Design_C(-cosf(theta), -sinf(theta));
+        }
+        return;
+    }
+
+    float32_t eps = 1.0f / sqrtf(powf(10.0f, 0.1f * spec->stop_db) - 1.0f);
+    float32_t mu = asinhf(1.0f / eps) / (float32_t)n;
+    for (uint8_t i = 0; i < n; i++) {
+        int32_t m = 2 * (int32_t)i - (int32_t)n + 1;
+        float32_t theta = DESIGN_PI * (float32_t)m / (float32_t)(2 * n);
+        // Chebyshev I poles of the inverse filter, then inverted
+        Design_Complex q = Design_C(-sinhf(mu) * cosf(theta), -coshf(mu) * sinf(theta));
+        f->p[i] = Design_Div(Design_C(1.0f, 0.0f), q);
+        if (m != 0) {
+            // Zeros at ±j / sin(θ); the middle one (odd order) is at infinity
+            f->z[f->nz++] = Design_C(0.0f, 1.0f / sinf(theta));
+        }
+    }
+}
+
+/**
+ * @brief Low-pass prototype to the requested response at analog edges
+ * @param f - [in,out] Filter
+ * @param type - Response type
+ * @param w1 - Edge (rad/s), lower edge for band-pass
+ * @param w2 - Upper edge (rad/s, band-pass only)
+ * @return void
+ */
+static void Design_Transform(Design_Zpk *f, Design_Type type, float32_t w1, float32_t w2) {
+    uint8_t degree = (uint8_t)(f->np - f->nz);
+    if (type == DESIGN_LOWPASS) {
+        for (uint8_t i = 0; i < f->nz; i++) f->z[i] = Design_Scale(f->z[i], w1);
+        for (uint8_t i = 0; i < f->np; i++) f->p[i] = Design_Scale(f->p[i], w1);
+    } else if (type == DESIGN_HIGHPASS) {
+        for (uint8_t i = 0; i < f->nz; i++) f->z[i] = Design_Div(Design_C(w1, 0.0f), f->z[i]);
+        for (uint8_t i = 0; i < f->np; i++) f->p[i] = Design_Div(Design_C(w1, 0.0f), f->p[i]);
+        for (uint8_t i = 0; i < degree; i++) {
+            f->z[f->nz++] = Design_C(0.0f, 0.0f);   // Zeros at infinity move to DC
+        }
+    } else {
+        float32_t bw = w2 - w1;
+        float32_t w0sq = w1 * w2;
+        Design_Complex w0c = Design_C(w0sq, 0.0f);
+        uint8_t nz = f->nz, np = f->np;
+        // Each root r becomes the two roots of s² - r·bw·s + w0² = 0
+        for (uint8_t i = 0; i < nz; i++) {
+            Design_Complex r = Design_Scale(f->z[i], 0.5f * bw);
+            Design_Complex d = Design_Sqrt(Design_Sub(Design_Mul(r, r), w0c));
+            f->z[i] = Design_Add(r, d);
+            f->z[nz + i] = Design_Sub(r, d);
+        }
+        for (uint8_t i = 0; i < np; i++) {
+            Design_Complex r = Design_Scale(f->p[i], 0.5f * bw);
+            Design_Complex d = Design_Sqrt(Design_Sub(Design_Mul(r, r), w0c));
+            f->p[i] = Design_Add(r, d);
+            f->p[np + i] = Design_Sub(r, d);
+        }
+        f->nz = (uint8_t)(2 * nz);
+        f->np = (uint8_t)(2 * np);
+        for (uint8_t i = 0; i < degree; i++) {
+            f->z[f->nz++] = Design_C(0.0f, 0.0f);
+        }
+    }
+}
+
+/**
+ * @brief Bilinear transform s = fs2·(z - 1)/(z + 1)
+ * @details Remaining zeros at infinity move to Nyquist (z = -1).
+ * @param f - [in,out] Filter
+ * @param fs2 - 2·fs
+ * @return void
+ */
+static void Design_Bilinear(Design_Zpk *f, float32_t fs2) {
+    Design_Complex c = Design_C(fs2, 0.0f);
+    for (uint8_t i = 0; i < f->nz; i++) {
+        f->z[i] = Design_Div(Design_Add(c, f->z[i]), Design_Sub(c, f->z[i]));
+    }
+    for (uint8_t i = 0; i < f->np; i++) {
+        f->p[i] = Design_Div(Design_Add(c, f->p[i]), Design_Sub(c, f->p[i]));
+    }
+    while (f->nz < f->np) {
+        f->z[f->nz++] = Design_C(-1.0f, 0.0f);
+    }
+}
+
+/**
+ * @brief Remove and return the root closest to a target
+ * @param roots - [in,out] Roots
+ * @param n - [in,out] Number of roots
+ * @param target - Target
+ * @param mode - DESIGN_ROOT_ANY, DESIGN_ROOT_REAL or DESIGN_ROOT_COMPLEX (upper half-plane representative)
+ * @param out - [out] Removed root
+ * @return 1 if found
+ */
+static uint8_t Design_TakeNearest(Design_Complex *roots, uint8_t *n, Design_Complex target, uint8_t mode,
+                                  Design_Complex *out) {
+    uint8_t best = 0xFF;
+    float32_t best_d = 0.0f;
+    for (uint8_t i = 0; i < *n; i++) {
+        uint8_t real = fabsf(roots[i].im) <= DESIGN_IM_TOL;
+        if (mode == DESIGN_ROOT_REAL && !real) continue;
+        if (mode == DESIGN_ROOT_COMPLEX && real) continue;
+        if (roots[i].im < -DESIGN_IM_TOL) continue;   // One representative per pair
+        float32_t d = Design_Abs(Design_Sub(roots[i], target));
+        if (best == 0xFF || d < best_d) {
+            best = i;
+            best_d = d;
+        }
+    }
+    if (best == 0xFF) {
+        return 0;
+    }
+    *out = roots[best];
+    roots[best] = roots[--(*n)];
+    return 1;
+}
+
+/**
+ * @brief Remove the conjugate of a complex root
+ */
+static void Design_TakeConjugate(Design_Complex *roots, uint8_t *n, Design_Complex r) {
+    for (uint8_t i = 0; i < *n; i++) {
+        Design_Complex d = Design_Sub(roots[i], Design_C(r.re, -r.im));
+        if (roots[i].im < -DESIGN_IM_TOL && Design_Abs(d) <= 1e-3f * (1.0f + Design_Abs(r))) {
+            roots[i] = roots[--(*n)];
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Number of real roots
+ */
+static uint8_t Design_CountReal(const Design_Complex *roots, uint8_t n) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        count += (fabsf(roots[i].im) <= DESIGN_IM_TOL);
+    }
+    return count;
+}
+
+/**
+ * @brief Response of a section at z from its roots
+ * @details (z - z1)(z - z2) / ((z - p1)(z - p2)), which equals the expanded
+ *          (1 + b1·z^-1 + b2·z^-2) / (1 + a1·z^-1 + a2·z^-2) but keeps its precision when
+ *          the roots are close to z (the expanded sums cancel there in single precision).
+ *          An absent root of a first-order section is 0 in both lists.
+ */
+static Design_Complex Design_Response(Design_Complex z1, Design_Complex z2, Design_Complex p1, Design_Complex p2,
+                                      Design_Complex z) {
+    Design_Complex num = Design_Mul(Design_Sub(z, z1), Design_Sub(z, z2));
+    Design_Complex den = Design_Mul(Design_Sub(z, p1), Design_Sub(z, p2));
+    return Design_Div(num, den);
+}
+
+/**
+ * @brief Number of second-order sections of a specification
+ * @param spec - [in] Specification
+ * @return Sections
+ */
+uint8_t Design_Sections(const Design_Spec *spec) {
+    return (spec->type == DESIGN_BANDPASS) ? spec->order : (uint8_t)((spec->order + 1u) / 2u);
+}
+
+/**
+ * @brief Design a biquad cascade
+ * @param spec - [in] Specification
+ * @param fs_hz - Sample rate (Hz)
+ * @param coeffs - [out] 5 coefficients per section
+ * @param max_sections - Capacity of coeffs in sections
+ * @return Number of sections, or 0 for an invalid specification
+ */
+uint8_t Design_Filter(const Design_Spec *spec, float32_t fs_hz, float32_t *coeffs, uint8_t max_sections) {
+    float32_t nyq = 0.5f * fs_hz;
+    uint8_t sections = Design_Sections(spec);
+    if (spec->order == 0u || spec->order > DESIGN_MAX_ORDER || sections > max_sections ||
+        !(spec->f1_hz > 0.0f && spec->f1_hz < nyq) ||
+        (spec->type == DESIGN_BANDPASS && !(spec->f2_hz > spec->f1_hz && spec->f2_hz < nyq)) ||
+        (spec->family == DESIGN_CHEBY2 && !(spec->stop_db > 0.0f))) {
+        return 0;
+    }
+
+    Design_Zpk f;
+    float32_t fs2 = 2.0f * fs_hz;
+    // Pre-warp the edges so they land exactly after the bilinear transform
+    float32_t w1 = fs2 * tanf(DESIGN_PI * spec->f1_hz / fs_hz);
+    float32_t w2 = (spec->type == DESIGN_BANDPASS) ? fs2 * tanf(DESIGN_PI * spec->f2_hz / fs_hz) : w1;
+    Design_Prototype(spec, &f);
+    Design_Transform(&f, spec->type, w1, w2);
+    Design_Bilinear(&f, fs2);
+
+    // Passband reference point on the unit circle
+    Design_Complex ref;
+    if (spec->type == DESIGN_LOWPASS) {
+        ref = Design_C(1.0f, 0.0f);
+    } else if (spec->type == DESIGN_HIGHPASS) {
+        ref = Design_C(-1.0f, 0.0f);
+    } else {
+        float32_t wc = 2.0f * atanf(sqrtf(w1 * w2) / fs2);
+        ref = Design_C(cosf(wc), sinf(wc));
+    }
+
+    // Pair poles into sections, closest to the unit circle first (filled from the back)
+    Design_Complex total = Design_C(1.0f, 0.0f);
+    for (int8_t s = (int8_t)(sections - 1); s >= 0; s--) {
+        uint8_t best = 0;
+        float32_t best_d = 2.0f;
+        for (uint8_t i = 0; i < f.np; i++) {
+            if (f.p[i].im < -DESIGN_IM_TOL) continue;
+            float32_t d = 1.0f - Design_Abs(f.p[i]);
+            if (d < best_d) {
+                best = i;
+                best_d = d;
+            }
+        }
+        Design_Complex p1 = f.p[best], p2 = Design_C(0.0f, 0.0f);
+        Design_Complex z1 = Design_C(0.0f, 0.0f), z2 = Design_C(0.0f, 0.0f);
+        uint8_t second_order = 1;
+        f.p[best] = f.p[--f.np];
+        if (fabsf(p1.im) > DESIGN_IM_TOL) {
+            Design_TakeConjugate(f.p, &f.np, p1);
+            p2 = Design_C(p1.re, -p1.im);
+        } else if (!Design_TakeNearest(f.p, &f.np, p1, DESIGN_ROOT_REAL, &p2)) {
+            second_order = 0;   // Odd order: single real pole
+        }
+
+        if (!second_order) {
+            Design_TakeNearest(f.z, &f.nz, p1, DESIGN_ROOT_REAL, &z1);
+        } else {
+            // Nearest zeros: a conjugate pair or two real zeros, keeping one real zero
+            // for a single real pole that is still to come
+            uint8_t reals = Design_CountReal(f.z, f.nz);
+            uint8_t reserve = (uint8_t)(f.np & 1u);
+            uint8_t mode = (reals >= 2u + reserve) ? DESIGN_ROOT_ANY : DESIGN_ROOT_COMPLEX;
+            if (reals == f.nz) {
+                mode = DESIGN_ROOT_REAL;
+            }
+            Design_TakeNearest(f.z, &f.nz, p1, mode, &z1);
+            if (fabsf(z1.im) > DESIGN_IM_TOL) {
+                Design_TakeConjugate(f.z, &f.nz, z1);
+                z2 = Design_C(z1.re, -z1.im);
+            } else {
+                Design_TakeNearest(f.z, &f.nz, p2, DESIGN_ROOT_REAL, &z2);
+            }
+        }
+
+        // (1 - r1·z^-1)(1 - r2·z^-1) = 1 - (r1 + r2)·z^-1 + r1·r2·z^-2
+        float32_t b1 = -(z1.re + z2.re);
+        float32_t b2 = Design_Mul(z1, z2).re;
+        float32_t a1 = -(p1.re + p2.re);
+        float32_t a2 = Design_Mul(p1, p2).re;
+        Design_Complex h = Design_Response(z1, z2, p1, p2, ref);
+        float32_t g = 1.0f / Design_Abs(h);
+        total = Design_Mul(total, Design_Scale(h, g));
+
+        float32_t *c = &coeffs[5 * s];
+        c[0] = g;
+        c[1] = g * b1;
+        c[2] = g * b2;
+        c[3] = -a1;
+        c[4] = -a2;
+    }
+    if (total.re < 0.0f) {
+        // Unit magnitude at the reference but inverted: fix the sign on the first section
+        coeffs[0] = -coeffs[0];
+        coeffs[1] = -coeffs[1];
+        coeffs[2] = -coeffs[2];
+    }
+    return sections;
+}
+
+/**
+ * @brief Design a cascade and (re)initialize a CMSIS DF2T instance with it
+ * @param S - [out] CMSIS instance
+ * @param spec - [in] Specification
+ * @param fs_hz - Sample rate (Hz)
+ * @param coeffs - [out] Coefficient storage
+ * @param state - [out] State storage
+ * @param max_sections - Capacity in sections
+ * @return Number of sections, or 0
+ */
+uint8_t Design_Cascade(arm_biquad_cascade_df2T_instance_f32 *S, const Design_Spec *spec, float32_t fs_hz,
+                       float32_t *coeffs, float32_t *state, uint8_t max_sections) {
+    uint8_t sections = Design_Filter(spec, fs_hz, coeffs, max_sections);
+    if (sections != 0u) {
+        arm_biquad_cascade_df2T_init_f32(S, sections, coeffs, state);
+    }
+    return sections;
+}
+
+/**
+ * @brief First-order DC blocker pole for a cutoff
+ * @param fc_hz - Cutoff (Hz)
+ * @param fs_hz - Sample rate (Hz)
+ * @return Pole α
+ */
+float32_t Design_DCBlockerAlpha(float32_t fc_hz, float32_t fs_hz) {
+    return expf(-2.0f * DESIGN_PI * fc_hz / fs_hz);
+}
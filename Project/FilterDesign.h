@@ -0,0 +1,113 @@
+/**
+ * @file FilterDesign.h
+ * @brief Runtime IIR design: Butterworth / Chebyshev II biquad cascades for CMSIS-DSP
+ * @details Computes second-order sections for the sample rate and edge frequencies
+ *          known at configuration time, so a change of sensor rate or cutoff needs no
+ *          offline redesign and no rebuild:
+ *
+ *          analog prototype (zeros, poles, gain) → LP/HP/BP frequency transform at the
+ *          pre-warped edges → bilinear transform → pole/zero pairing into sections
+ *
+ * ### Conventions
+ *  - Coefficients are {b0, b1, b2, a1, a2} per section with the feedback terms negated,
+ *    as expected by arm_biquad_cascade_df2T_f32 (y = b0·x + … + a1·y[n-1] + a2·y[n-2])
+ *  - Butterworth edges are the -3 dB frequencies; Chebyshev II edges are the stopband
+ *    edges, where the attenuation first reaches stop_db (as MATLAB/SciPy cheby2)
+ *  - Sections are ordered with the poles closest to the unit circle last, each pole
+ *    pair takes the nearest zeros; every section is scaled to unit gain at the passband
+ *    reference (DC, Nyquist or the band centre), the first one also carries the sign
+ *  - Band-pass filters have twice the prototype order (order sections)
+ *
+ * ### Cost
+ *  Single precision, a few thousand cycles per design; intended for configuration time,
+ *  not per sample.
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Design_Filter, Design_Cascade
+ */
+
+#ifndef FILTERDESIGN_H_
+#define FILTERDESIGN_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+
+#define     DESIGN_MAX_ORDER        8   /**< Largest prototype order */
+#define     DESIGN_MAX_POLES        (2 * DESIGN_MAX_ORDER) /**< Poles after a band-pass transform */
+
+/**
+ * @enum Design_Family
+ * @brief Analog prototype
+ */
+typedef enum {
+    DESIGN_BUTTERWORTH = 0,     /**< Maximally flat passband */
+    DESIGN_CHEBY2               /**< Flat passband, equiripple stopband (stop_db) */
+} Design_Family;
+
+/**
+ * @enum Design_Type
+ * @brief Frequency response type
+ */
+typedef enum {
+    DESIGN_LOWPASS = 0,         /**< Edge f1 */
+    DESIGN_HIGHPASS,            /**< Edge f1 */
+    DESIGN_BANDPASS             /**< Edges f1 < f2 */
+} Design_Type;
+
+/**
+ * @struct Design_Spec
+ * @brief Filter specification
+ */
+typedef struct {
+    Design_Family family;       /**< Prototype */
+    Design_Type   type;         /**< Response type */
+    uint8_t       order;        /**< Prototype order (1..DESIGN_MAX_ORDER) */
+    float32_t     f1_hz;        /**< Edge frequency (lower edge for band-pass) */
+    float32_t     f2_hz;        /**< Upper edge for band-pass (ignored otherwise) */
+    float32_t     stop_db;      /**< Chebyshev II stopband attenuation (dB, > 0) */
+} Design_Spec;
+
+/**
+ * @brief Number of second-order sections of a specification
+ * @param spec - [in] Specification
+ * @return Sections (ceil(order / 2), or order for band-pass)
+ */
+uint8_t Design_Sections(const Design_Spec *spec);
+
+/**
+ * @brief Design a biquad cascade
+ * @param spec - [in] Specification
+ * @param fs_hz - Sample rate (Hz)
+ * @param coeffs - [out] 5 coefficients per section (CMSIS DF2T layout)
+ * @param max_sections - Capacity of coeffs in sections
+ * @return Number of sections, or 0 for an invalid specification (edges outside
+ *         (0, fs/2), order out of range, too many sections)
+ */
+uint8_t Design_Filter(const Design_Spec *spec, float32_t fs_hz, float32_t *coeffs, uint8_t max_sections);
+
+/**
+ * @brief Design a cascade and (re)initialize a CMSIS DF2T instance with it
+ * @details The state is cleared by the CMSIS init.
+ * @param S - [out] CMSIS instance
+ * @param spec - [in] Specification
+ * @param fs_hz - Sample rate (Hz)
+ * @param coeffs - [out] Coefficient storage (must stay valid while S is used)
+ * @param state - [out] State storage, 2 floats per section
+ * @param max_sections - Capacity of coeffs and state in sections
+ * @return Number of sections, or 0 (instance untouched) for an invalid specification
+ */
+uint8_t Design_Cascade(arm_biquad_cascade_df2T_instance_f32 *S, const Design_Spec *spec, float32_t fs_hz,
+                       float32_t *coeffs, float32_t *state, uint8_t max_sections);
+
+/**
+ * @brief First-order DC blocker pole for a -3 dB cutoff
+ * @details α = exp(-2π·fc / fs), the pole of H(z) = (1 - z^-1) / (1 - α·z^-1).
+ * @param fc_hz - Cutoff (Hz)
+ * @param fs_hz - Sample rate (Hz)
+ * @return Pole α
+ */
+float32_t Design_DCBlockerAlpha(float32_t fc_hz, float32_t fs_hz);
+
+#endif /* FILTERDESIGN_H_ */
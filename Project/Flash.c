@@ -0,0 +1,144 @@
+/**
+ * @file Flash.c
+ * @brief STM32F303 internal flash storage backend implementation
+ * @details Page erase, half-word programming with read-back verify, and memory-mapped
+ *          reads for the log area at FLASH_LOG_BASE.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Flash.h"
+#include "Storage.h"
+#include "stm32f303x8.h"
+#include <stdint.h>
+#include <string.h>
+
+#define FLASH_LOG_BYTES     (FLASH_PAGE_BYTES * FLASH_LOG_PAGES)
+
+/**
+ * @brief Unlock the flash control register
+ * @details Also starts the DWT cycle counter used for the operation deadlines.
+ * @return void
+ */
+static void Flash_Unlock(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    if (FLASH->CR & FLASH_CR_LOCK) {
+        FLASH->KEYR = FLASH_KEYR_KEY1;
+        FLASH->KEYR = FLASH_KEYR_KEY2;
+    }
+}
+
+/**
+ * @brief Relock the flash control register
+ * @return void
+ */
+static void Flash_Lock(void) {
+    FLASH->CR |= FLASH_CR_LOCK;
+}
+
+/**
+ * @brief Wait for the end of the current flash operation and collect its status
+ * @details Clears EOP/PGERR/WRPERR (write-1-to-clear). The deadline is measured with
+ *          wrap-safe unsigned arithmetic on DWT->CYCCNT.
+ * @param fail - Status to report on a programming error
+ * @param timeout_us - Deadline from the call (µs)
+ * @return STORAGE_OK, fail, STORAGE_ERR_WRPROT or STORAGE_ERR_TIMEOUT
+ */
+static Storage_Status Flash_Wait(Storage_Status fail, uint32_t timeout_us) {
+    uint32_t start = DWT->CYCCNT;
+    uint32_t budget = timeout_us * (SystemCoreClock / 1000000u);
+    while (FLASH->SR & FLASH_SR_BSY) {
+        if ((DWT->CYCCNT - start) > budget) {
+            return STORAGE_ERR_TIMEOUT;
+        }
+    }
+    uint32_t sr = FLASH->SR;
+    FLASH->SR = FLASH_SR_EOP | FLASH_SR_PGERR | FLASH_SR_WRPERR;
+    if (sr & FLASH_SR_WRPERR) {
+        return STORAGE_ERR_WRPROT;
+    }
+    if (sr & FLASH_SR_PGERR) {
+        return fail;
+    }
+    return STORAGE_OK;
+}
+
+/**
+ * @brief Erase one log page
+ * @param page - Page index (0 to FLASH_LOG_PAGES - 1)
+ * @return Storage_Status
+ */
+static Storage_Status Flash_Erase(uint16_t page) {
+    if (page >= FLASH_LOG_PAGES) {
+        return STORAGE_ERR_RANGE;
+    }
+    Flash_Unlock();
+    FLASH->CR |= FLASH_CR_PER;
+    FLASH->AR = FLASH_LOG_BASE + (uint32_t)page * FLASH_PAGE_BYTES;
+    FLASH->CR |= FLASH_CR_STRT;
+    Storage_Status status = Flash_Wait(STORAGE_ERR_ERASE, FLASH_ERASE_TIMEOUT_US);
+    FLASH->CR &= ~FLASH_CR_PER;
+    Flash_Lock();
+    return status;
+}
+
+/**
+ * @brief Program bytes into the log area, one half-word at a time
+ * @details Each half-word is read back; a mismatch (e.g. programming over
+ *          non-erased bits) aborts with STORAGE_ERR_PROGRAM.
+ * @param offset - Byte offset in the log area (even)
+ * @param data - [in] Bytes to program
+ * @param len - Number of bytes (even)
+ * @return Storage_Status
+ */
+static Storage_Status Flash_Program(uint32_t offset, const uint8_t *data, uint16_t len) {
+    if ((offset | len) & 1u || offset + len > FLASH_LOG_BYTES) {
+        return STORAGE_ERR_RANGE;
+    }
+    Storage_Status status = STORAGE_OK;
+    volatile uint16_t *dst = (volatile uint16_t *)(uintptr_t)(FLASH_LOG_BASE + offset);
+
+    Flash_Unlock();
+    FLASH->CR |= FLASH_CR_PG;
+    for (uint16_t i = 0; i < len; i += 2) {
+        uint16_t hw = (uint16_t)(data[i] | ((uint16_t)data[i + 1] << 8));
+        *dst = hw;
+        status = Flash_Wait(STORAGE_ERR_PROGRAM, FLASH_PROGRAM_TIMEOUT_US);
+        if (status == STORAGE_OK && *dst != hw) {
+            status = STORAGE_ERR_PROGRAM;
+        }
+        if (status != STORAGE_OK) {
+            break;
+        }
+        dst++;
+    }
+    FLASH->CR &= ~FLASH_CR_PG;
+    Flash_Lock();
+    return status;
+}
+
+/**
+ * @brief Read bytes from the memory-mapped log area
+ * @param offset - Byte offset in the log area
+ * @param data - [out] Destination
+ * @param len - Number of bytes
+ * @return Storage_Status
+ */
+static Storage_Status Flash_Read(uint32_t offset, uint8_t *data, uint16_t len) {
+    if (offset + len > FLASH_LOG_BYTES) {
+        return STORAGE_ERR_RANGE;
+    }
+    memcpy(data, (const void *)(uintptr_t)(FLASH_LOG_BASE + offset), len);
+    return STORAGE_OK;
+}
+
+/** Internal flash log area backend */
+const Storage_Backend Flash_Backend = {
+    FLASH_PAGE_BYTES,
+    FLASH_LOG_PAGES,
+    Flash_Erase,
+    Flash_Program,
+    Flash_Read,
+};
@@ -0,0 +1,41 @@
+/**
+ * @file Flash.h
+ * @brief STM32F303 internal flash storage backend
+ * @details Implements Storage_Backend on the last FLASH_LOG_PAGES pages of the 64 KB
+ *          internal flash. With the recorder enabled, the linker ROM region (__ROM0_SIZE
+ *          in regions_STM32F303K8Tx.h) ends at FLASH_LOG_BASE so code never lands there.
+ *
+ * ### Timing
+ *  - Page erase: 20–40 ms; half-word program: ~50 µs
+ *  - The flash is single-bank: instruction fetch (and therefore interrupts) stalls while
+ *    an erase or program is in progress. The MAX30101 FIFO (640 ms at 50 Hz) absorbs the
+ *    delay and the acquisition scheduler drains the backlog on the following ticks.
+ *  - Each operation has a DWT cycle-count deadline (FLASH_ERASE_TIMEOUT_US,
+ *    FLASH_PROGRAM_TIMEOUT_US); a controller that stays busy past it returns
+ *    STORAGE_ERR_TIMEOUT instead of hanging the main loop
+ *
+ * ### Linker Region
+ *  - The log pages are only reserved when the project defines RECORDER_ENABLE=1
+ *    (Project.cproject.yml): __ROM0_SIZE is then 48 KB, otherwise the whole 64 KB
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Storage_Backend
+ */
+
+#ifndef FLASH_H_
+#define FLASH_H_
+
+#include <stdint.h>
+#include "Storage.h"
+
+#define     FLASH_PAGE_BYTES    2048u           /**< STM32F303x8 flash page size */
+#define     FLASH_LOG_BASE      0x0800C000u     /**< First log page (after 48 KB of code) */
+#define     FLASH_LOG_PAGES     8u              /**< Log pages (16 KB, to the end of flash) */
+#define     FLASH_ERASE_TIMEOUT_US      50000u  /**< Page erase deadline (tERASE max 40 ms) */
+#define     FLASH_PROGRAM_TIMEOUT_US    100u    /**< Half-word program deadline (tPROG max 70 µs) */
+
+extern const Storage_Backend Flash_Backend; /**< Internal flash log area */
+
+#endif /* FLASH_H_ */
@@ -0,0 +1,204 @@
+/**
+ * @file Format.c
+ * @brief Allocation-free numeric text encoder implementation
+ * @details Exact fixed-point "%.4f" encoding and CSV/TSV/JSONL line emission into the TX ring.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Format.h"
+#include "UART.h"
+#include "arm_math_types.h"
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define FMT_SCALE   10000u  /**< 10^4: four decimals */
+
+/**
+ * @brief Encode the integer man × 2^exp (exp ≥ 0, < 2^128) in decimal
+ * @details Multi-word path for |x| ≥ 2^23: the value is split into 9-digit chunks by
+ *          repeated long division of a 4 × 32-bit number by 10^9.
+ * @param p - [out] Destination
+ * @param man - 24-bit mantissa
+ * @param exp - Binary exponent (0 to 104)
+ * @return Pointer one past the last character written
+ */
+static char *Fmt_BigInt(char *p, uint32_t man, uint32_t exp) {
+    uint32_t limb[4] = {0, 0, 0, 0};
+    uint32_t chunk[5];
+    uint8_t num_chunks = 0;
+    uint32_t word = exp >> 5;
+    uint32_t bit = exp & 31u;
+
+    limb[word] = man << bit;
+    if (bit != 0 && word < 3) {
+        limb[word + 1] = man >> (32u - bit);
+    }
+    do {
+        uint64_t rem = 0;
+        uint8_t nonzero = 0;
+        for (int8_t i = 3; i >= 0; i--) {
+            uint64_t cur = (rem << 32) | limb[i];
+            limb[i] = (uint32_t)(cur / 1000000000u);
+            rem = cur % 1000000000u;
+            nonzero |= (limb[i] != 0);
+        }
+        chunk[num_chunks++] = (uint32_t)rem;
+        if (!nonzero) {
+            break;
+        }
+    } while (num_chunks < 5);
+
+    p = Fmt_Uint(p, chunk[--num_chunks]);
+    while (num_chunks--) {
+        uint32_t v = chunk[num_chunks];
+        for (int8_t i = 8; i >= 0; i--) {
+            p[i] = (char)('0' + v % 10u);
+            v /= 10u;
+        }
+        p += 9;
+    }
+    return p;
+}
+
+/**
+ * @brief Encode an unsigned integer in decimal
+ * @param p - [out] Destination
+ * @param v - Value
+ * @return Pointer one past the last character written
+ */
+char *Fmt_Uint(char *p, uint32_t v) {
+    char tmp[FMT_UINT_MAX_CHARS];
+    uint8_t n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10u);
+        v /= 10u;
+    } while (v);
+    while (n) {
+        *p++ = tmp[--n];
+    }
+    return p;
+}
+
+/**
+ * @brief Encode a float with exactly four decimals
+ * @details For x = man × 2^exp with exp < 0, q = round(man × 10^4 / 2^-exp) is computed
+ *          exactly in 64 bits (man × 10^4 < 2^38) with ties to even, then printed as
+ *          q / 10^4 "." q % 10^4. Larger magnitudes are exact integers (Fmt_BigInt).
+ * @param p - [out] Destination
+ * @param x - Value
+ * @return Pointer one past the last character written
+ */
+char *Fmt_Fixed4(char *p, float32_t x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    uint32_t exp_field = (bits >> 23) & 0xFFu;
+    uint32_t man = bits & 0x7FFFFFu;
+
+    if (exp_field == 0xFFu && man != 0) {   // newlib prints NaN without sign
+        memcpy(p, "nan", 3);
+        return p + 3;
+    }
+    if (bits >> 31) {
+        *p++ = '-';
+    }
+    if (exp_field == 0xFFu) {
+        memcpy(p, "inf", 3);
+        return p + 3;
+    }
+
+    int32_t exp;
+    if (exp_field == 0) {       // Zero and subnormals
+        exp = -149;
+    } else {
+        man |= 0x800000u;
+        exp = (int32_t)exp_field - 150;
+    }
+
+    uint32_t frac = 0;
+    if (exp >= 0) {
+        p = Fmt_BigInt(p, man, (uint32_t)exp);
+    } else {
+        uint32_t shift = (uint32_t)(-exp);
+        uint64_t scaled = (uint64_t)man * FMT_SCALE;
+        uint64_t q = 0;
+        if (shift < 64) {       // Otherwise scaled < 2^38 < half an LSB: rounds to 0
+            uint64_t rem = scaled & ((1ull << shift) - 1u);
+            uint64_t half = 1ull << (shift - 1u);
+            q = scaled >> shift;
+            if (rem > half || (rem == half && (q & 1u))) {
+                q++;
+            }
+        }
+        uint32_t ip = (uint32_t)(q / FMT_SCALE);
+        frac = (uint32_t)(q - (uint64_t)ip * FMT_SCALE);
+        p = Fmt_Uint(p, ip);
+    }
+    p[0] = '.';
+    p[4] = (char)('0' + frac % 10u); frac /= 10u;
+    p[3] = (char)('0' + frac % 10u); frac /= 10u;
+    p[2] = (char)('0' + frac % 10u); frac /= 10u;
+    p[1] = (char)('0' + frac);
+    return p + 5;
+}
+
+/**
+ * @brief Emit the valid samples of a block as text lines into the USART2 TX ring
+ * @details Each field is encoded into a small stack buffer and appended to the ring,
+ *          so lines of any width are emitted without a line buffer.
+ * @param format - Line format
+ * @param names - [in] Field names (JSONL only)
+ * @param rows - [in] Block row of each field
+ * @param num_fields - Fields per line
+ * @param block - [in] Processed block (channel rows read in place)
+ * @param with_id - 1 to prefix each line with the sensor ID
+ * @return void
+ */
+void Fmt_WriteBlock(Fmt_Format format, const char *const *names, const uint8_t *rows,
+                    uint8_t num_fields, const SampleBlock *block, uint8_t with_id) {
+    char field[FMT_FIXED4_MAX_CHARS + 4];
+    char sep = (format == FMT_TSV) ? '\t' : ',';
+
+    for (uint8_t r = block->first; r < block->count; r++) {
+        char *p = field;
+        if (format == FMT_JSONL) {
+            *p++ = '{';
+        }
+        if (with_id) {
+            if (format == FMT_JSONL) {
+                memcpy(p, "\"id\":", 5);
+                p += 5;
+            }
+            p = Fmt_Uint(p, block->sensor_id);
+            *p++ = sep;
+        }
+        USART2_Write(field, (uint16_t)(p - field));
+
+        for (uint8_t f = 0; f < num_fields; f++) {
+            float32_t v = block->ch[rows[f]][r];
+            p = field;
+            if (format == FMT_JSONL) {
+                USART2_putString("\"");
+                USART2_putString(names[f]);
+                USART2_putString("\":");
+                if (!isfinite(v)) {     // JSON has no inf/nan literals
+                    memcpy(p, "null", 4);
+                    p += 4;
+                } else {
+                    p = Fmt_Fixed4(p, v);
+                }
+            } else {
+                p = Fmt_Fixed4(p, v);
+            }
+            if (f + 1u < num_fields) {
+                *p++ = sep;
+            } else if (format == FMT_JSONL) {
+                *p++ = '}';
+            }
+            USART2_Write(field, (uint16_t)(p - field));
+        }
+        USART2_Write("\r\n", 2);
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * @file Format.h
+ * @brief Allocation-free numeric text encoder for the UART data stream
+ * @details Integer-only replacement for sprintf("%.4f") and the CSV line assembly in main.c.
+ *
+ * ### Number Encoding
+ *  - Fmt_Fixed4() decodes the IEEE-754 single directly (sign, exponent, 24-bit mantissa)
+ *    and scales the exact value by 10^4 in 64-bit integer arithmetic
+ *  - Rounding is to nearest with ties to even on the exact binary value, i.e. the same
+ *    digits as newlib/glibc printf("%.4f", (double)x), including "-0.0000" for small
+ *    negative values, "inf"/"-inf" and "nan"
+ *  - Values ≥ 2^23 (exact integers) take a slower multi-word path; everything in the
+ *    nA / µM range of this project takes the fast path (one 64-bit shift and divide)
+ *
+ * ### Line Encoding
+ *  - Fmt_WriteBlock() emits one line per sample of a SampleBlock directly into the USART2
+ *    TX ring, field by field, reading the channel rows in place; there is no intermediate
+ *    line buffer
+ *  - CSV:   `[id,]v0,v1,...\r\n`
+ *  - TSV:   `[id\t]v0\tv1\t...\r\n`
+ *  - JSONL: `{["id":id,]"name0":v0,"name1":v1,...}\r\n` (non-finite values as null)
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see USART2_Write
+ */
+
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+#include <stdint.h>
+#include "arm_math_types.h"
+#include "SampleBlock.h"
+
+#define     FMT_FIXED4_MAX_CHARS    46  /**< Longest Fmt_Fixed4() output: sign, 39 integer digits, ".dddd" */
+#define     FMT_UINT_MAX_CHARS      10  /**< Longest Fmt_Uint() output */
+
+/**
+ * @enum Fmt_Format
+ * @brief Line format of the data stream
+ */
+typedef enum {
+    FMT_CSV = 0,    /**< Comma-separated values */
+    FMT_TSV,        /**< Tab-separated values */
+    FMT_JSONL       /**< One JSON object per line */
+} Fmt_Format;
+
+/**
+ * @brief Encode a float with exactly four decimals
+ * @param p - [out] Destination (at least FMT_FIXED4_MAX_CHARS bytes, not NUL-terminated)
+ * @param x - Value
+ * @return Pointer one past the last character written
+ * @note Output is identical to printf("%.4f", x)
+ */
+char *Fmt_Fixed4(char *p, float32_t x);
+
+/**
+ * @brief Encode an unsigned integer in decimal
+ * @param p - [out] Destination (at least FMT_UINT_MAX_CHARS bytes, not NUL-terminated)
+ * @param v - Value
+ * @return Pointer one past the last character written
+ */
+char *Fmt_Uint(char *p, uint32_t v);
+
+/**
+ * @brief Emit the valid samples of a block as text lines into the USART2 TX ring
+ * @details One line per sample from block->first to block->count - 1; field f of a line
+ *          is block->ch[rows[f]][sample].
+ * @param format - Line format
+ * @param names - [in] Field names (JSONL keys; unused for CSV/TSV, may be NULL then)
+ * @param rows - [in] Block row of each field (SB_CH_*)
+ * @param num_fields - Fields per line
+ * @param block - [in] Processed block
+ * @param with_id - 1 to prefix each line with block->sensor_id (first column / "id" key)
+ * @return void
+ * @note Main-loop context (blocks while the TX ring is full)
+ */
+void Fmt_WriteBlock(Fmt_Format format, const char *const *names, const uint8_t *rows,
+                    uint8_t num_fields, const SampleBlock *block, uint8_t with_id);
+
+#endif /* FORMAT_H_ */
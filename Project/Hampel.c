@@ -0,0 +1,165 @@
+/**
+ * @file Hampel.c
+ * @brief Streaming Hampel spike filter implementation
+ * @details Sorted rolling window with a single shift per sample and MAD by merge selection.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Hampel.h"
+#include <stdint.h>
+
+/**
+ * @brief Initialize a spike filter with an empty window
+ * @param hf - [out] Filter
+ * @param window - Window length
+ * @param threshold - Rejection threshold in robust standard deviations
+ * @return void
+ */
+void Hampel_Init(Hampel_Filter *hf, uint8_t window, float32_t threshold) {
+    if (window < HAMPEL_MIN_WINDOW) window = HAMPEL_MIN_WINDOW;
+    if (window > HAMPEL_MAX_WINDOW) window = HAMPEL_MAX_WINDOW;
+    hf->window = (uint8_t)(window | 1u);
+    if (hf->window > HAMPEL_MAX_WINDOW) hf->window -= 2u;
+    hf->limit = threshold * HAMPEL_MAD_SCALE;
+    hf->count = 0;
+    hf->head = 0;
+}
+
+/**
+ * @brief First position in sorted[0..len) whose value is not below v
+ * @param s - [in] Sorted values
+ * @param len - Number of values
+ * @param v - Value
+ * @return Position (len if every value is below v)
+ */
+static uint8_t Hampel_LowerBound(const float32_t *s, uint8_t len, float32_t v) {
+    uint8_t lo = 0;
+    uint8_t hi = len;
+    while (lo < hi) {
+        uint8_t mid = (uint8_t)((lo + hi) >> 1);
+        if (s[mid] < v) {
+            lo = (uint8_t)(mid + 1u);
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Add a sample to the window, dropping the oldest once it is full
+ * @param hf - [in,out] Filter
+ * @param x - Sample
+ * @return void
+ */
+static void Hampel_Slide(Hampel_Filter *hf, float32_t x) {
+    float32_t *s = hf->sorted;
+    if (hf->count < hf->window) {
+        uint8_t j = Hampel_LowerBound(s, hf->count, x);
+        for (uint8_t k = hf->count; k > j; k--) {
+            s[k] = s[k - 1u];
+        }
+        s[j] = x;
+        hf->ring[hf->count] = x;
+        hf->count++;
+        return;
+    }
+
+    // Outgoing value at i; the incoming one goes where it keeps the order once i is gone
+    float32_t old = hf->ring[hf->head];
+    uint8_t i = Hampel_LowerBound(s, hf->window, old);
+    uint8_t j = Hampel_LowerBound(s, hf->window, x);
+    if (j > i) {
+        j--;
+        for (uint8_t k = i; k < j; k++) {
+            s[k] = s[k + 1u];
+        }
+    } else {
+        for (uint8_t k = i; k > j; k--) {
+            s[k] = s[k - 1u];
+        }
+    }
+    s[j] = x;
+    hf->ring[hf->head] = x;
+    hf->head = (uint8_t)((hf->head + 1u < hf->window) ? hf->head + 1u : 0u);
+}
+
+/**
+ * @brief Median absolute deviation of the full sorted window
+ * @details The deviations left of the median grow leftward and those right of it grow
+ *          rightward; merging the two runs from the median outward, the window/2-th
+ *          step gives the median deviation (step 0 is the median itself).
+ * @param s - [in] Sorted window
+ * @param window - Window length (odd)
+ * @return MAD
+ */
+static float32_t Hampel_Mad(const float32_t *s, uint8_t window) {
+    uint8_t h = (uint8_t)(window >> 1);
+    float32_t med = s[h];
+    uint8_t l = h;              // Next left candidate is s[l - 1]
+    uint8_t r = (uint8_t)(h + 1u);
+    float32_t mad = 0.0f;
+    for (uint8_t step = 0; step < h; step++) {
+        float32_t dr = (r < window) ? s[r] - med : 0.0f;
+        if (l > 0u && (r >= window || med - s[l - 1u] <= dr)) {
+            mad = med - s[l - 1u];
+            l--;
+        } else {
+            mad = dr;
+            r++;
+        }
+    }
+    return mad;
+}
+
+/**
+ * @brief Filter samples in place
+ * @param hf - [in,out] Filter
+ * @param x - [in,out] Samples
+ * @param n - Number of samples
+ * @return Number of samples replaced
+ */
+uint32_t Hampel_Process(Hampel_Filter *hf, float32_t *x, uint32_t n) {
+    const uint8_t h = (uint8_t)(hf->window >> 1);
+    uint32_t replaced = 0;
+    if (n > 0u && hf->count == 0u) {
+        for (uint8_t k = 0; k < h; k++) {
+            Hampel_Slide(hf, x[0]);     // Left padding: the first sample before the start
+        }
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        Hampel_Slide(hf, x[i]);
+        if (hf->count < hf->window) {
+            x[i] = hf->ring[0];         // Still emitting the padding
+            continue;
+        }
+        uint8_t pos = (uint8_t)(hf->head + h);
+        if (pos >= hf->window) pos = (uint8_t)(pos - hf->window);
+        float32_t c = hf->ring[pos];
+        float32_t med = hf->sorted[h];
+        float32_t dev = c - med;
+        if (dev < 0.0f) dev = -dev;
+        float32_t mad = Hampel_Mad(hf->sorted, hf->window);
+        if (mad > 0.0f && dev > hf->limit * mad) {
+            c = med;
+            replaced++;
+        }
+        x[i] = c;
+    }
+    return replaced;
+}
+
+/**
+ * @brief Scale the window
+ * @param hf - [in,out] Filter
+ * @param g - Gain
+ * @return void
+ */
+void Hampel_Scale(Hampel_Filter *hf, float32_t g) {
+    for (uint8_t k = 0; k < hf->count; k++) {
+        hf->ring[k] *= g;
+        hf->sorted[k] *= g;
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ * @file Hampel.h
+ * @brief Streaming Hampel (median/MAD) spike filter on a rolling sorted window
+ * @details Replaces single-sample glitches (I2C read errors, ambient light flashes) before
+ *          they reach the high-pass filter, where a step of one sample rings through the
+ *          low-cutoff cascade for seconds.
+ *
+ * ### Decision
+ *  Each sample x is compared with the median m and the median absolute deviation MAD of
+ *  the window centred on it (window / 2 samples on each side):
+ *
+ *          |x − m| > threshold · 1.4826 · MAD   →   x is replaced by m
+ *
+ *  (1.4826 · MAD estimates the standard deviation of Gaussian noise.) The window must be
+ *  centred: against a trailing window every sample on a pulse upstroke looks like an
+ *  outlier. The output is therefore delayed by window / 2 samples, the same on every
+ *  channel, like the group delay of a linear-phase filter. The window starts padded with
+ *  window / 2 copies of the first sample, which are also the first outputs. Raw samples
+ *  (not the replacements) stay in the window, and nothing is replaced while MAD is 0
+ *  (flat or clipped signal: no scale to judge against).
+ *
+ * ### Rolling Median
+ *  The window is kept twice: in arrival order (to know the outgoing sample) and sorted.
+ *  Per sample the outgoing value is found by binary search and the incoming one slides
+ *  into place, moving only the entries between the two positions. The deviations from
+ *  the median are two sorted runs (left and right of the median), so the MAD is the
+ *  (window / 2)-th step of their merge: no sort, O(window) per sample with small
+ *  constants, against O(window²) for an insertion sort per sample.
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Hampel_Process
+ */
+
+#ifndef HAMPEL_H_
+#define HAMPEL_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+
+#define     HAMPEL_MAX_WINDOW       31      /**< Largest window (samples, odd); 8 bytes of RAM per sample and channel */
+#define     HAMPEL_MIN_WINDOW       3       /**< Smallest window (samples) */
+#define     HAMPEL_MAD_SCALE        1.4826f /**< MAD to standard deviation for Gaussian noise */
+
+/**
+ * @struct Hampel_Filter
+ * @brief Spike filter state (one per channel)
+ */
+typedef struct {
+    float32_t ring[HAMPEL_MAX_WINDOW];      /**< Window in arrival order (also the delay line) */
+    float32_t sorted[HAMPEL_MAX_WINDOW];    /**< Window in ascending order */
+    float32_t limit;                        /**< threshold · HAMPEL_MAD_SCALE */
+    uint8_t   window;                       /**< Window length (odd) */
+    uint8_t   count;                        /**< Samples in the window */
+    uint8_t   head;                         /**< Ring position of the oldest sample */
+} Hampel_Filter;
+
+/**
+ * @brief Initialize a spike filter with an empty window
+ * @param hf - [out] Filter
+ * @param window - Window length, rounded up to odd and clamped to
+ *                 HAMPEL_MIN_WINDOW..HAMPEL_MAX_WINDOW
+ * @param threshold - Rejection threshold in robust standard deviations (typically 3)
+ * @return void
+ */
+void Hampel_Init(Hampel_Filter *hf, uint8_t window, float32_t threshold);
+
+/**
+ * @brief Filter samples in place
+ * @param hf - [in,out] Filter
+ * @param x - [in,out] Samples; on return the samples window / 2 earlier, spikes replaced
+ *            by the window median
+ * @param n - Number of samples
+ * @return Number of samples replaced
+ */
+uint32_t Hampel_Process(Hampel_Filter *hf, float32_t *x, uint32_t n);
+
+/**
+ * @brief Scale the window (gain step of the channel)
+ * @param hf - [in,out] Filter
+ * @param g - Gain (> 0, keeps the order)
+ * @return void
+ */
+void Hampel_Scale(Hampel_Filter *hf, float32_t g);
+
+#endif /* HAMPEL_H_ */
@@ -0,0 +1,109 @@
+/**
+ * @file Hemoglobin.c
+ * @brief Modified Beer-Lambert law hemoglobin computation implementation
+ * @details Red/IR attenuation changes to ΔHbO2/ΔHHb with optional LED wavelength
+ *          compensation from the MAX30101 die temperature.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Hemoglobin.h"
+#include "arm_math_types.h"
+#include <math.h>
+#include <stdint.h>
+
+/**
+ * @brief Rebuild the inverse extinction matrix for the context temperature
+ * @details With temperature compensation each LED wavelength is shifted by
+ *          (T - HB_REF_TEMP_DEGC) × nm/°C and the coefficients are evaluated as
+ *          ε(λ0 + Δλ) ≈ ε(λ0) + Δλ · dε/dλ. The matrix
+ *
+ *          | εHbO2(red)  εHHb(red) |
+ *          | εHbO2(ir)   εHHb(ir)  |
+ *
+ *          is inverted and scaled by 1e6 / (d · DPF) so Hb_Compute() yields µM directly.
+ * @param ctx - [in,out] Context
+ * @return void
+ */
+static void Hb_UpdateMatrix(Hb_Context *ctx) {
+    float32_t dl_red = 0.0f;
+    float32_t dl_ir  = 0.0f;
+    if (ctx->temp_comp) {
+        dl_red = (ctx->temp_degc - HB_REF_TEMP_DEGC) * HB_RED_NM_PER_DEGC;
+        dl_ir  = (ctx->temp_degc - HB_REF_TEMP_DEGC) * HB_IR_NM_PER_DEGC;
+    }
+    float32_t a = HB_EPS_HBO2_RED + dl_red * HB_DEPS_HBO2_RED;
+    float32_t b = HB_EPS_HHB_RED  + dl_red * HB_DEPS_HHB_RED;
+    float32_t c = HB_EPS_HBO2_IR  + dl_ir  * HB_DEPS_HBO2_IR;
+    float32_t d = HB_EPS_HHB_IR   + dl_ir  * HB_DEPS_HHB_IR;
+    float32_t scale = 1.0e6f / ((a * d - b * c) * ctx->path_cm);
+
+    ctx->inv[0] =  d * scale;
+    ctx->inv[1] = -b * scale;
+    ctx->inv[2] = -c * scale;
+    ctx->inv[3] =  a * scale;
+}
+
+/**
+ * @brief Initialize an MBLL context
+ * @param ctx - [out] Context
+ * @param distance_cm - Source-detector separation (cm)
+ * @param dpf - Differential pathlength factor
+ * @param temp_comp - 1 to enable temperature compensation
+ * @return void
+ */
+void Hb_Init(Hb_Context *ctx, float32_t distance_cm, float32_t dpf, uint8_t temp_comp) {
+    ctx->path_cm = distance_cm * dpf;
+    ctx->temp_degc = HB_REF_TEMP_DEGC;
+    ctx->temp_comp = temp_comp;
+    ctx->red0 = 1.0f;
+    ctx->ir0 = 1.0f;
+    Hb_UpdateMatrix(ctx);
+}
+
+/**
+ * @brief Set the baseline intensities I0
+ * @param ctx - [in,out] Context
+ * @param red0 - Red baseline current (nA)
+ * @param ir0 - IR baseline current (nA)
+ * @return void
+ */
+void Hb_SetBaseline(Hb_Context *ctx, float32_t red0, float32_t ir0) {
+    ctx->red0 = red0;
+    ctx->ir0 = ir0;
+}
+
+/**
+ * @brief Update the die temperature used for wavelength compensation
+ * @param ctx - [in,out] Context
+ * @param temp_degc - Die temperature (°C)
+ * @return void
+ */
+void Hb_SetTemperature(Hb_Context *ctx, float32_t temp_degc) {
+    ctx->temp_degc = temp_degc;
+    if (ctx->temp_comp) {
+        Hb_UpdateMatrix(ctx);
+    }
+}
+
+/**
+ * @brief Compute ΔHbO2 / ΔHHb for one Red/IR sample
+ * @details ΔA = log10(I0 / I) per wavelength, then [ΔHbO2, ΔHHb] = inv · [ΔA_red, ΔA_ir].
+ * @param ctx - [in] Context
+ * @param red - Red current (nA)
+ * @param ir - IR current (nA)
+ * @param out - [out] Concentration changes (µM)
+ * @return void
+ */
+void Hb_Compute(const Hb_Context *ctx, float32_t red, float32_t ir, Hb_Sample *out) {
+    if (red <= 0.0f || ir <= 0.0f) {
+        out->hbo2 = 0.0f;
+        out->hhb = 0.0f;
+        return;
+    }
+    float32_t da_red = log10f(ctx->red0 / red);
+    float32_t da_ir  = log10f(ctx->ir0 / ir);
+    out->hbo2 = ctx->inv[0] * da_red + ctx->inv[1] * da_ir;
+    out->hhb  = ctx->inv[2] * da_red + ctx->inv[3] * da_ir;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file Hemoglobin.h
+ * @brief Modified Beer-Lambert law (MBLL) hemoglobin concentration changes from Red/IR
+ * @details Converts the raw Red (660 nm) and IR (880 nm) photodiode currents into changes
+ *          of oxy- and deoxy-hemoglobin concentration relative to a baseline:
+ *
+ *          ΔA(λ) = log10(I0(λ) / I(λ)) = (εHbO2(λ)·ΔHbO2 + εHHb(λ)·ΔHHb) · d · DPF
+ *
+ *          The 2×2 extinction system is inverted once (at init and on temperature updates),
+ *          so each sample costs two log10 and a 2×2 multiply.
+ *
+ * ### Temperature Compensation (optional)
+ *  - LED peak wavelength drifts with die temperature (HB_RED_NM_PER_DEGC, HB_IR_NM_PER_DEGC)
+ *  - Extinction coefficients are linearly re-evaluated at the shifted wavelength around
+ *    the nominal value, using the local slopes of the Prahl tables
+ *  - Fed by the MAX30101 die temperature side channel (Acquisition_GetTemperature)
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Hb_Compute, Hb_SetTemperature
+ */
+
+#ifndef HEMOGLOBIN_H_
+#define HEMOGLOBIN_H_
+
+#include <stdint.h>
+#include "arm_math_types.h"
+
+/* Molar extinction coefficients (cm^-1/M, log10 base, S. Prahl tabulation) */
+#define     HB_EPS_HBO2_RED     319.6f      /**< HbO2 at 660 nm */
+#define     HB_EPS_HHB_RED      3226.56f    /**< HHb at 660 nm */
+#define     HB_EPS_HBO2_IR      1154.0f     /**< HbO2 at 880 nm */
+#define     HB_EPS_HHB_IR       726.44f     /**< HHb at 880 nm */
+/* Local slopes dε/dλ (cm^-1/M per nm) around the nominal wavelengths */
+#define     HB_DEPS_HBO2_RED    (-3.70f)    /**< HbO2 slope at 660 nm (650-670 nm) */
+#define     HB_DEPS_HHB_RED     (-47.75f)   /**< HHb slope at 660 nm (650-670 nm) */
+#define     HB_DEPS_HBO2_IR     2.50f       /**< HbO2 slope at 880 nm (870-890 nm) */
+#define     HB_DEPS_HHB_IR      1.89f       /**< HHb slope at 880 nm (870-890 nm) */
+/* LED wavelength temperature coefficients */
+#define     HB_RED_NM_PER_DEGC  0.13f       /**< Red LED peak shift (nm/°C) */
+#define     HB_IR_NM_PER_DEGC   0.28f       /**< IR LED peak shift (nm/°C) */
+#define     HB_REF_TEMP_DEGC    25.0f       /**< Temperature at which the nominal wavelengths apply */
+
+#define     HB_DEFAULT_DISTANCE_CM  0.3f    /**< Default source-detector separation (cm) */
+#define     HB_DEFAULT_DPF          4.0f    /**< Default differential pathlength factor (skeletal muscle) */
+
+/**
+ * @struct Hb_Context
+ * @brief MBLL state for one sensor
+ */
+typedef struct {
+    float32_t inv[4];           /**< Inverse extinction matrix scaled by 1e6 / (d · DPF), row-major */
+    float32_t red0;             /**< Red baseline current I0 (nA) */
+    float32_t ir0;              /**< IR baseline current I0 (nA) */
+    float32_t path_cm;          /**< Effective path length d · DPF (cm) */
+    float32_t temp_degc;        /**< Die temperature used for the current coefficients */
+    uint8_t   temp_comp;        /**< 1 = compensate LED wavelength drift with temperature */
+} Hb_Context;
+
+/**
+ * @struct Hb_Sample
+ * @brief Hemoglobin concentration changes relative to baseline
+ */
+typedef struct {
+    float32_t hbo2;             /**< ΔHbO2 (µM) */
+    float32_t hhb;              /**< ΔHHb (µM) */
+} Hb_Sample;
+
+/**
+ * @brief Initialize an MBLL context
+ * @param ctx - [out] Context
+ * @param distance_cm - Source-detector separation (cm)
+ * @param dpf - Differential pathlength factor
+ * @param temp_comp - 1 to enable temperature compensation of the extinction coefficients
+ * @return void
+ * @note The baseline must be set with Hb_SetBaseline() before Hb_Compute()
+ */
+void Hb_Init(Hb_Context *ctx, float32_t distance_cm, float32_t dpf, uint8_t temp_comp);
+
+/**
+ * @brief Set the baseline intensities I0
+ * @param ctx - [in,out] Context
+ * @param red0 - Red baseline current (nA, > 0)
+ * @param ir0 - IR baseline current (nA, > 0)
+ * @return void
+ */
+void Hb_SetBaseline(Hb_Context *ctx, float32_t red0, float32_t ir0);
+
+/**
+ * @brief Update the die temperature used for wavelength compensation
+ * @details Recomputes the inverse extinction matrix when compensation is enabled.
+ *          Intended for the slow temperature side channel, not per sample.
+ * @param ctx - [in,out] Context
+ * @param temp_degc - MAX30101 die temperature (°C)
+ * @return void
+ */
+void Hb_SetTemperature(Hb_Context *ctx, float32_t temp_degc);
+
+/**
+ * @brief Compute ΔHbO2 / ΔHHb for one Red/IR sample
+ * @param ctx - [in] Context
+ * @param red - Red current (nA)
+ * @param ir - IR current (nA)
+ * @param out - [out] Concentration changes (µM); zero if a current is not positive
+ * @return void
+ */
+void Hb_Compute(const Hb_Context *ctx, float32_t red, float32_t ir, Hb_Sample *out);
+
+#endif /* HEMOGLOBIN_H_ */
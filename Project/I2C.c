@@ -1,36 +1,48 @@
 /**
  * @file I2C.c
  * @brief I2C1 Master communication driver implementation for STM32F303K8
- * @details Low-level I2C driver for sensor communication at 400 kHz using open-drain GPIO.
+ * @details Low-level I2C driver for sensor communication at I2C1_SPEED_HZ (400 kHz) using open-drain GPIO.
  * @author Julio Fajardo, PhD
  * @date 2026-03-26
  * @version 2.0
  */
 
 #include "I2C.h"
+#include "PLL.h"
 #include "stm32f303x8.h"
 
+#define I2C_PIN_SCL     6   /**< PB6 = I2C1_SCL */
+#define I2C_PIN_SDA     7   /**< PB7 = I2C1_SDA */
+
+static volatile uint32_t i2c_error_count[I2C_STATUS_COUNT]; /**< Per-status error counters (index I2C_OK unused) */
+static volatile uint32_t i2c_bus_clears = 0;                /**< Number of SCL-toggle bus clears performed */
+static volatile uint32_t i2c_busy_cycles = 0;               /**< Cycles spent in transactions, recovery included */
+static uint32_t i2c_timingr = 0;                            /**< TIMINGR computed by I2C1_Config(), reloaded by recovery */
+
+static void I2C1_Init(uint8_t retime);
+static void I2C1_Recover(I2C_Status status);
+
 /**
- * @brief Initialize I2C1 peripheral and GPIO pins for 400 kHz master-mode operation
+ * @brief Initialize I2C1 peripheral and GPIO pins for master-mode operation at I2C1_SPEED_HZ
  * @details Complete I2C1 setup sequence:
  *          1. Clock enables (I2C1, GPIOB)
  *          2. GPIO configuration (open-drain, alternate function AF4)
  *          3. I2C peripheral reset
- *          4. Timing register configuration for 400 kHz
+ *          4. Kernel clock = SYSCLK, TIMINGR computed for I2C1_SPEED_HZ (Fm+ drive on PB6/PB7 above 400 kHz)
  *          5. Enable I2C1
+ *          6. Enable the DWT cycle counter used for transaction deadlines
  *
  * ### GPIO Configuration (PB6 = SCL, PB7 = SDA)
  *  - MODER: [13:12]=10 (Alternate Function for PB6), [15:14]=10 (Alternate Function for PB7)
  *  - OTYPER: [7]=1 (Open-drain for PB7), [6]=1 (Open-drain for PB6)
  *  - AFR[0]: [31:28]=0100 (AF4 for PB7), [27:24]=0100 (AF4 for PB6)
  *
- * ### I2C TIMINGR = 0x00C50F26 (for APB1 = 32 MHz, target 400 kHz)
- *  - PRESC[3:0] = 0 (Prescaler = 1)
- *  - SCLDEL[3:0] = 1010 (Setup delay ≈ 640 ns)
- *  - SDADEL[3:0] = 0101 (Hold delay ≈ 320 ns)
- *  - SCLH[7:0] = 00001111 (SCL high ≈ 1.5 µs)
- *  - SCLL[7:0] = 00100110 (SCL low ≈ 1.0 µs)
- *  - Calculated frequency: ~400 kHz (I2C Fast-mode)
+ * ### I2C TIMINGR (Clock_I2CTiming, I2C1 kernel clock = SYSCLK = 64 MHz, target 400 kHz)
+ *  - 0x10C71329: PRESC = 1 (31.25 ns), SCLDEL = 12, SDADEL = 7, SCLH = 19, SCLL = 41
+ *  - SCL low 1.31 µs, high 0.63 µs, ≈ 370 kHz with the spec rise/fall times
+ *  - Recomputed from the active clock tree on every call, so a different PLL setting
+ *    or I2C1_SPEED_HZ needs no hand-made constant. Bus recovery re-initializes the
+ *    peripheral with the value kept from the last call, without recomputing it
  *
  * @param None
  * @return void
@@ -45,7 +57,7 @@
  *  - I2C clock MUST be enabled before TIMINGR modification
  *  - GPIO pins must be configured as open-drain (not push-pull)
  *  - Reset sequence (RSTR flag) clears any prior error states
- *  - TIMINGR is APB1-frequency-sensitive; changing APB1 requires recalculation
+ *  - TIMINGR depends on the I2C1 kernel clock; it is recomputed here, call again after a clock change
  *
  * @side_effects
  *  - PB6 and PB7 become I2C1 pins (unavailable for GPIO)
@@ -54,13 +66,24 @@
  *
  * @warning
  *  - Call once at system startup, BEFORE any I2C_Write/Read operations
- *  - Do not change TIMINGR if APB1 frequency changes dynamically
+ *  - Fast-mode Plus exceeds the MAX30101 rating (400 kHz); use it only with Fm+ devices
  *  - External pull-up resistors (~4.7 kΩ) required on SCL/SDA lines
  *
  * @see I2C1_Write, I2C1_Read
  */
 
 void I2C1_Config(void) {
+    I2C1_Init(1);
+}
+
+/**
+ * @brief Configure the I2C1 pins and peripheral (body of I2C1_Config())
+ * @param retime - 1 to compute TIMINGR from the active clock tree, 0 to reload the
+ *                 value of the last computation (bus recovery: no clock tree read and
+ *                 no timing search in the error path)
+ * @return void
+ */
+static void I2C1_Init(uint8_t retime) {
     // Enable I2C1 clock
     RCC->APB1ENR |= RCC_APB1ENR_I2C1EN;
     // Enable GPIOB clock
@@ -80,11 +103,87 @@ void I2C1_Config(void) {
     RCC->APB1RSTR &= ~RCC_APB1RSTR_I2C1RST;
     // Disable I2C1 to configure it
     I2C1->CR1 &= ~I2C_CR1_PE;
-    // TIMINGR register for 400 kHz with APB1 = 32 MHz
-    // (PRESC=0, SCLDEL=12, SDADEL=5, SCLH=15, SCLL=38)
-    I2C1->TIMINGR = 0x00C50F26;
+    // I2C1 kernel clock = SYSCLK (finer timing, and fast enough for Fast-mode Plus)
+    RCC->CFGR3 |= RCC_CFGR3_I2C1SW;
+    #if I2C1_SPEED_HZ > 400000u
+        // Fast-mode Plus: 20 mA drive on PB6/PB7
+        RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
+        SYSCFG->CFGR1 |= SYSCFG_CFGR1_I2C_PB6_FMP | SYSCFG_CFGR1_I2C_PB7_FMP;
+    #endif
+    // TIMINGR from the active clock tree (0x10C71329 at 64 MHz, 400 kHz)
+    if (retime) {
+        Clock_Tree tree;
+        Clock_GetTree(&tree);
+        i2c_timingr = Clock_I2CTiming(tree.i2c1_ck, I2C1_SPEED_HZ);
+    }
+    I2C1->TIMINGR = i2c_timingr;
     // Enable I2C1
     I2C1->CR1 |= I2C_CR1_PE;
+    // Enable DWT cycle counter (time base for transaction deadlines)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Convert microseconds to core clock cycles
+ * @param us - Time in microseconds
+ * @return Equivalent number of DWT->CYCCNT cycles at SystemCoreClock
+ */
+static inline uint32_t I2C1_UsToCycles(uint32_t us) {
+    return us * (SystemCoreClock / 1000000u);
+}
+
+/**
+ * @brief Busy-wait for a short delay using the DWT cycle counter
+ * @param us - Delay in microseconds
+ * @return void
+ */
+static void I2C1_DelayUs(uint32_t us) {
+    uint32_t start = DWT->CYCCNT;
+    uint32_t cycles = I2C1_UsToCycles(us);
+    while ((DWT->CYCCNT - start) < cycles);
+}
+
+/**
+ * @brief Wait for an ISR flag until the transaction deadline
+ * @details Polls I2C1->ISR and returns as soon as one of:
+ *          - the requested flag is set → I2C_OK
+ *          - NACKF, BERR or ARLO is set → matching error status
+ *          - the deadline (start + budget cycles) expires → I2C_ERR_TIMEOUT
+ *
+ *          The deadline is measured with wrap-safe unsigned arithmetic on DWT->CYCCNT,
+ *          so the wait is bounded regardless of bus state.
+ *
+ * @param flag - ISR flag mask to wait for (e.g. I2C_ISR_TXIS)
+ * @param set - 1 to wait for the flag to be set, 0 to wait for it to clear (BUSY)
+ * @param start - DWT->CYCCNT value at transaction start
+ * @param budget - Transaction budget in cycles
+ * @return I2C_Status
+ */
+static I2C_Status I2C1_WaitFlag(uint32_t flag, uint8_t set, uint32_t start, uint32_t budget) {
+    for (;;) {
+        uint32_t isr = I2C1->ISR;
+        if (isr & I2C_ISR_NACKF) return I2C_ERR_NACK;
+        if (isr & I2C_ISR_BERR)  return I2C_ERR_BERR;
+        if (isr & I2C_ISR_ARLO)  return I2C_ERR_ARLO;
+        if (((isr & flag) != 0) == (set != 0)) return I2C_OK;
+        if ((DWT->CYCCNT - start) > budget) return I2C_ERR_TIMEOUT;
+    }
+}
+
+/**
+ * @brief Finish a transaction: record and recover from any error, account its bus time
+ * @param status - Transaction result
+ * @param start - DWT->CYCCNT value at transaction start
+ * @return The same status, for tail calls
+ */
+static I2C_Status I2C1_Finish(I2C_Status status, uint32_t start) {
+    if (status != I2C_OK) {
+        i2c_error_count[status]++;
+        I2C1_Recover(status);
+    }
+    i2c_busy_cycles += DWT->CYCCNT - start;
+    return status;
 }
 
 
@@ -95,63 +194,182 @@ void I2C1_Config(void) {
  *          2. Configure CR2: 2 bytes, AUTOEND, START condition
  *          3. Send register address (TXDR)
  *          4. Send data byte (TXDR)
- *          5. Wait for TXE (transmitter empty); AUTOEND triggers STOP
+ *          5. Wait for STOPF (AUTOEND generates STOP after the last byte)
+ *
+ *          Every wait is bounded by the transaction deadline
+ *          I2C_TIMEOUT_BASE_US + 2 × I2C_TIMEOUT_BYTE_US.
  *
  * ### Transaction Sequence
  *  ```
  *  START [slave_addr(W)] ACK [register_addr] ACK [data_byte] ACK STOP
  *  ```
  *  - START: Generated by CR2.START
- *  - slave_addr: Shifted left 1 bit by hardware; (slave<<1) or slave|0
+ *  - slave_addr: 8-bit form written as is into CR2.SADD[7:1]; hardware appends R/W as bit 0
  *  - AUTOEND: Automatically generates STOP after NBYTES bytes sent
  *
- * @param slave - 7-bit I2C slave address (e.g., 0x5D for MAX30101)
- *                Format: [D6:D0] (do NOT pre-shift)
+ * @param slave - I2C slave address in 8-bit form (e.g., 0xAE for MAX30101)
+ *                Format: [A6:A0 0] (7-bit address pre-shifted left by 1)
  * @param addr - Register address (0x00-0xFF) in slave device
  * @param data - Single data byte to write (0x00-0xFF)
- * @return void
- * @retval N/A (blocking until complete or bus error)
+ * @return I2C_Status
+ * @retval I2C_OK Transaction completed
+ * @retval I2C_ERR_NACK Slave did not acknowledge address or data
+ * @retval I2C_ERR_BERR / I2C_ERR_ARLO Bus error or arbitration lost
+ * @retval I2C_ERR_TIMEOUT Deadline expired (bus stuck or slave stretching SCL)
  *
  * @timing
  *  - Bus arbitration: 1-2 µs
  *  - Byte transmission (2×): ~10 µs each = 20 µs
  *  - ACK/STOP wait: ~10 µs
  *  - **Total latency**: ~30-50 µs (typical)
- *  - Maximum timeout (bus error): ~1 sec (hardware dependent)
+ *  - **Worst case**: transaction deadline + I2C_RECOVERY_MAX_US
  *
  * @flags_monitored
  *  - BUSY: Wait until clear (bus available)
  *  - TXIS: Transmit interrupt status, fires per byte ready to send
- *  - TXE: Transmitter empty, fires after last byte enqueued
- *  - AUTOEND: Firmware-set flag; hardware auto-clears and generates STOP
+ *  - STOPF: STOP generated after the last byte (AUTOEND)
+ *  - NACKF, BERR, ARLO: Abort with the matching status
  *
  * @error_conditions
- *  - **NAK received**: Bus hangs in BUSY state; requires I2C reset (see datasheet)
- *  - **Slave not present**: Timeout; TXE may never set
- *  - **SDA stuck low**: Requires manual GPIO toggle to recover
+ *  - **NAK received**: Hardware generates STOP; flags cleared, I2C_ERR_NACK returned
+ *  - **BERR/ARLO/timeout**: Peripheral reset; SCL-toggle bus clear if SDA is stuck low
  *
  * @usage_example
  *  ```
  *  // Write LED power control register to MAX30101
- *  I2C1_Write(0x5D, LED1_PAMPLI, 0x3F);  // slave=0x5D, addr=0x0C, data=0x3F
+ *  if (I2C1_Write(0xAE, LED1_PAMPLI, 0x3F) != I2C_OK) { ... }
  *  ```
  *
  * @see I2C1_Read, I2C specification (NXP UM10204)
  */
-void I2C1_Write(uint8_t slave, uint8_t addr, uint8_t data){
+I2C_Status I2C1_Write(uint8_t slave, uint8_t addr, uint8_t data){
+    uint32_t start = DWT->CYCCNT;
+    uint32_t budget = I2C1_UsToCycles(I2C_TIMEOUT_BASE_US + 2 * I2C_TIMEOUT_BYTE_US);
+    I2C_Status status;
+
     // Wait for bus to be available
-    while(I2C1->ISR & I2C_ISR_BUSY);
+    status = I2C1_WaitFlag(I2C_ISR_BUSY, 0, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
+    // Clear any pending STOPF flag
+    I2C1->ICR = I2C_ICR_STOPCF;
     // Set up transfer: slave address, 2 bytes, AUTOEND, START
     I2C1->CR2 = 0x00;
     I2C1->CR2 = I2C_CR2_AUTOEND | (2<<16) | (slave) | I2C_CR2_START;
     // Send register address
-    while(!(I2C1->ISR & I2C_ISR_TXIS));
+    status = I2C1_WaitFlag(I2C_ISR_TXIS, 1, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
     I2C1->TXDR = addr;
     // Send data byte
-    while(!(I2C1->ISR & I2C_ISR_TXIS));
+    status = I2C1_WaitFlag(I2C_ISR_TXIS, 1, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
     I2C1->TXDR = data;
-    // Wait for transmission complete
-    while(!(I2C1->ISR & I2C_ISR_TXE));
+    // Wait for STOP condition (AUTOEND generates this after the data byte is acknowledged)
+    status = I2C1_WaitFlag(I2C_ISR_STOPF, 1, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
+    I2C1->ICR = I2C_ICR_STOPCF;
+    return I2C1_Finish(I2C_OK, start);
+}
+
+/**
+ * @brief Master write consecutive registers to I2C slave (auto-increment burst)
+ * @details Single transaction with automatic STOP condition:
+ *          1. Wait for bus available (ISR.BUSY clear)
+ *          2. Configure CR2: size + 1 bytes, AUTOEND, START condition
+ *          3. Send register address, then each data byte on TXIS
+ *          4. Wait for STOPF
+ *
+ *          Replaces size separate I2C1_Write() calls (each with its own START,
+ *          address and STOP) for register blocks such as MAX30101 0x08-0x0A.
+ *          Bounded by I2C_TIMEOUT_BASE_US + (size + 1) × I2C_TIMEOUT_BYTE_US.
+ *
+ * ### Transaction Sequence
+ *  ```
+ *  START [slave_addr(W)] ACK [register_addr] ACK [data_0] ACK ... [data_N-1] ACK STOP
+ *  ```
+ *
+ * @param slave - I2C slave address (same format as I2C1_Write)
+ * @param addr - First register address
+ * @param data - [in] Data bytes for addr, addr + 1, ...
+ * @param size - Number of data bytes (1-254)
+ * @return I2C_Status (see I2C1_Write)
+ *
+ * @timing
+ *  - **Total latency**: ~30 µs + 22.5 µs per byte (typical, 400 kHz)
+ *
+ * @see I2C1_Write
+ */
+I2C_Status I2C1_WriteBurst(uint8_t slave, uint8_t addr, const uint8_t *data, uint8_t size){
+    uint32_t start = DWT->CYCCNT;
+    uint32_t budget = I2C1_UsToCycles(I2C_TIMEOUT_BASE_US + ((uint32_t)size + 1) * I2C_TIMEOUT_BYTE_US);
+    I2C_Status status;
+
+    // Wait for bus to be available
+    status = I2C1_WaitFlag(I2C_ISR_BUSY, 0, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
+    // Clear any pending STOPF flag
+    I2C1->ICR = I2C_ICR_STOPCF;
+    // Set up transfer: slave address, size + 1 bytes, AUTOEND, START
+    I2C1->CR2 = 0x00;
+    I2C1->CR2 = I2C_CR2_AUTOEND | (((uint32_t)size + 1) << 16) | (slave) | I2C_CR2_START;
+    // Send register address
+    status = I2C1_WaitFlag(I2C_ISR_TXIS, 1, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
+    I2C1->TXDR = addr;
+    // Send data bytes (slave auto-increments the register address)
+    for (uint8_t i = 0; i < size; i++) {
+        status = I2C1_WaitFlag(I2C_ISR_TXIS, 1, start, budget);
+        if (status != I2C_OK) return I2C1_Finish(status, start);
+        I2C1->TXDR = data[i];
+    }
+    // Wait for STOP condition
+    status = I2C1_WaitFlag(I2C_ISR_STOPF, 1, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
+    I2C1->ICR = I2C_ICR_STOPCF;
+    return I2C1_Finish(I2C_OK, start);
+}
+
+/**
+ * @brief Master write single control byte to I2C slave
+ * @details Performs a 1-byte write transaction with automatic STOP condition.
+ *          Used to select the downstream channel of an I2C mux (control register only).
+ *          Bounded by I2C_TIMEOUT_BASE_US + I2C_TIMEOUT_BYTE_US.
+ *
+ * ### Transaction Sequence
+ *  ```
+ *  START [slave_addr(W)] ACK [data_byte] ACK STOP
+ *  ```
+ *
+ * @param slave - I2C slave address (same format as I2C1_Write)
+ * @param data - Control byte to write (for TCA9548A: bit n enables channel n)
+ * @return I2C_Status (see I2C1_Write)
+ *
+ * @timing
+ *  - **Total latency**: ~25-35 µs (typical)
+ *
+ * @see I2C1_Write
+ */
+I2C_Status I2C1_WriteByte(uint8_t slave, uint8_t data){
+    uint32_t start = DWT->CYCCNT;
+    uint32_t budget = I2C1_UsToCycles(I2C_TIMEOUT_BASE_US + I2C_TIMEOUT_BYTE_US);
+    I2C_Status status;
+
+    // Wait for bus to be available
+    status = I2C1_WaitFlag(I2C_ISR_BUSY, 0, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
+    // Clear any pending STOPF flag
+    I2C1->ICR = I2C_ICR_STOPCF;
+    // Set up transfer: slave address, 1 byte, AUTOEND, START
+    I2C1->CR2 = 0x00;
+    I2C1->CR2 = I2C_CR2_AUTOEND | (1<<16) | (slave) | I2C_CR2_START;
+    // Send control byte
+    status = I2C1_WaitFlag(I2C_ISR_TXIS, 1, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
+    I2C1->TXDR = data;
+    // Wait for STOP condition
+    status = I2C1_WaitFlag(I2C_ISR_STOPF, 1, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
+    I2C1->ICR = I2C_ICR_STOPCF;
+    return I2C1_Finish(I2C_OK, start);
 }
 
 /**
@@ -166,6 +384,9 @@ void I2C1_Write(uint8_t slave, uint8_t addr, uint8_t data){
  *            2. Read each byte from RXDR (data available via RXNE flag)
  *            3. Wait for STOPF (AUTOEND triggers STOP)
  *
+ *          Every wait is bounded by the transaction deadline
+ *          I2C_TIMEOUT_BASE_US + (size + 1) × I2C_TIMEOUT_BYTE_US.
+ *
  * ### Transaction Sequence
  *  ```
  *  START [slave_addr(W)] ACK [register_addr] ACK
@@ -174,15 +395,14 @@ void I2C1_Write(uint8_t slave, uint8_t addr, uint8_t data){
  *  - Repeated START: Avoids releasing bus; allows atomic address+read
  *  - RD_WRN: Set for read phase; hardware handles address bit automatically
  *
- * @param slave - 7-bit I2C slave address (e.g., 0x5D for MAX30101)
- *                Format: [D6:D0] (do NOT pre-shift)
+ * @param slave - I2C slave address in 8-bit form (e.g., 0xAE for MAX30101)
+ *                Format: [A6:A0 0] (7-bit address pre-shifted left by 1)
  * @param addr - Register address in slave device to read from (e.g., 0x07 for MAX30101 FIFO)
  * @param data - [out] Pointer to buffer for received bytes
  *               Must be allocated by caller with capacity ≥ size bytes
  * @param size - [in] Number of bytes to read from slave (1-255)
  *               Typical values: 1 (single register), 6 (MAX30101 FIFO sample)
- * @return void
- * @retval N/A (blocking until complete or error)
+ * @return I2C_Status (see I2C1_Write); data[] contents are undefined on error
  *
  * @timing
  *  - Write address phase: ~15-20 µs
@@ -190,6 +410,7 @@ void I2C1_Write(uint8_t slave, uint8_t addr, uint8_t data){
  *  - Read phase (per byte): ~10-15 µs
  *  - **Total latency**: 100+ 30×size µs (typical)
  *  - Example: Read 6 bytes ≈ 180-200 µs
+ *  - **Worst case**: transaction deadline + I2C_RECOVERY_MAX_US
  *  - Dominates any sensor timing; I2C is bottleneck at 50 Hz sampling
  *
  * @flags_monitored
@@ -198,12 +419,12 @@ void I2C1_Write(uint8_t slave, uint8_t addr, uint8_t data){
  *  - TC (not TXE!): Critical; signals address byte sent, allowing repeated START
  *  - RXNE: Data byte available in RXDR
  *  - STOPF: AUTOEND triggered; read phase complete
+ *  - NACKF, BERR, ARLO: Abort with the matching status
  *
  * @error_conditions
- *  - **Register address invalid**: Slave NAKs; BUSY remains set
- *  - **No slave at address**: BUSY hangs indefinitely (no timeout)
+ *  - **Register address invalid / no slave**: NACK; STOP generated, I2C_ERR_NACK returned
+ *  - **Slave not responding / SDA stuck**: I2C_ERR_TIMEOUT, bus clear and re-init
  *  - **Buffer overflow**: Caller must ensure data[] size ≥ size parameter
- *  - **Timeout on RXNE**: Slave not responding; function blocks forever
  *
  * @performance_note
  *  - Current usage: 1 sample (6 bytes) per ISR tick ≈ 180-200 µs per 20 ms window
@@ -212,17 +433,21 @@ void I2C1_Write(uint8_t slave, uint8_t addr, uint8_t data){
  *
  * @usage_example
  *  ```
- *  // Read 6 bytes from MAX30101 FIFO (one sample, 3 channels × 2 bytes)
+ *  // Read 6 bytes from MAX30101 FIFO (one sample, 2 channels × 3 bytes)
  *  uint8_t fifo_data[6];
- *  I2C1_Read(0x5D, 0x07, fifo_data, 6);
- *  // fifo_data[0] = red[MSB], fifo_data[1] = red[LSB], ...
+ *  if (I2C1_Read(0xAE, 0x07, fifo_data, 6) == I2C_OK) { ... }
  *  ```
  *
  * @see I2C1_Write, I2C specification (repeated START section)
  */
-void I2C1_Read(uint8_t slave, uint8_t addr, uint8_t *data, uint8_t size){
+I2C_Status I2C1_Read(uint8_t slave, uint8_t addr, uint8_t *data, uint8_t size){
+    uint32_t start = DWT->CYCCNT;
+    uint32_t budget = I2C1_UsToCycles(I2C_TIMEOUT_BASE_US + ((uint32_t)size + 1) * I2C_TIMEOUT_BYTE_US);
+    I2C_Status status;
+
     // Wait for bus to be available
-    while(I2C1->ISR & I2C_ISR_BUSY);
+    status = I2C1_WaitFlag(I2C_ISR_BUSY, 0, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
     
     // Clear any pending STOPF flag
     I2C1->ICR = I2C_ICR_STOPCF;
@@ -231,26 +456,121 @@ void I2C1_Read(uint8_t slave, uint8_t addr, uint8_t *data, uint8_t size){
     I2C1->CR2 = (1<<16) | (slave) | I2C_CR2_START;
     
     // Send register address byte
-    while(!(I2C1->ISR & I2C_ISR_TXIS));
+    status = I2C1_WaitFlag(I2C_ISR_TXIS, 1, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
     I2C1->TXDR = addr;
     
     // Wait for transfer complete (TC flag - this allows repeated START)
-    while(!(I2C1->ISR & I2C_ISR_TC));
+    status = I2C1_WaitFlag(I2C_ISR_TC, 1, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
     
     // Phase 2: Repeated START with read phase (AUTOEND, RD_WRN=1)
     // Generate repeated START and read with automatic STOP
-    I2C1->CR2 = I2C_CR2_AUTOEND | I2C_CR2_RD_WRN | (size<<16) | (slave) | I2C_CR2_START;
+    I2C1->CR2 = I2C_CR2_AUTOEND | I2C_CR2_RD_WRN | ((uint32_t)size<<16) | (slave) | I2C_CR2_START;
     
     // Read each byte
     for(uint8_t i = 0; i < size; i++){
         // Wait for data ready (RXNE flag)
-        while(!(I2C1->ISR & I2C_ISR_RXNE));
+        status = I2C1_WaitFlag(I2C_ISR_RXNE, 1, start, budget);
+        if (status != I2C_OK) return I2C1_Finish(status, start);
         data[i] = I2C1->RXDR;
     }
     
     // Wait for stop condition (AUTOEND generates this)
-    while(!(I2C1->ISR & I2C_ISR_STOPF));
+    status = I2C1_WaitFlag(I2C_ISR_STOPF, 1, start, budget);
+    if (status != I2C_OK) return I2C1_Finish(status, start);
     
     // Clear STOPF flag
     I2C1->ICR = I2C_ICR_STOPCF;
+    return I2C1_Finish(I2C_OK, start);
+}
+
+/**
+ * @brief Release a stuck bus by clocking SCL manually (bus clear, UM10204 §3.1.16)
+ * @details A slave interrupted mid-byte may hold SDA low indefinitely. PB6/PB7 are
+ *          switched to open-drain GPIO outputs, SCL is toggled up to 9 times at ~100 kHz
+ *          until the slave releases SDA, then a STOP condition is generated (SDA rises
+ *          while SCL is high) and the pins are returned to AF4.
+ * @return void
+ * @timing ≤ ~120 µs (9 clocks × 10 µs + STOP)
+ */
+static void I2C1_BusClear(void) {
+    // Both lines released (high) as open-drain GPIO outputs
+    GPIOB->BSRR = (1u << I2C_PIN_SCL) | (1u << I2C_PIN_SDA);
+    GPIOB->MODER &= ~((3u << (2 * I2C_PIN_SCL)) | (3u << (2 * I2C_PIN_SDA)));
+    GPIOB->MODER |= (1u << (2 * I2C_PIN_SCL)) | (1u << (2 * I2C_PIN_SDA));
+
+    for (uint8_t i = 0; i < 9 && !(GPIOB->IDR & (1u << I2C_PIN_SDA)); i++) {
+        GPIOB->BRR = (1u << I2C_PIN_SCL);   // SCL low
+        I2C1_DelayUs(5);
+        GPIOB->BSRR = (1u << I2C_PIN_SCL);  // SCL high (released)
+        I2C1_DelayUs(5);
+    }
+    // STOP condition: SDA low → high while SCL is high
+    GPIOB->BRR = (1u << I2C_PIN_SDA);
+    I2C1_DelayUs(5);
+    GPIOB->BSRR = (1u << I2C_PIN_SDA);
+    I2C1_DelayUs(5);
+
+    // Return PB6/PB7 to alternate function (AF4 selection in AFR[0] is untouched)
+    GPIOB->MODER &= ~((3u << (2 * I2C_PIN_SCL)) | (3u << (2 * I2C_PIN_SDA)));
+    GPIOB->MODER |= (2u << (2 * I2C_PIN_SCL)) | (2u << (2 * I2C_PIN_SDA));
+}
+
+/**
+ * @brief Bring the bus and I2C1 back to idle after a failed transaction
+ * @details
+ *  - **NACK**: In master mode the hardware issues STOP right after the NACK; the
+ *    STOP is awaited (bounded) and the flags are cleared.
+ *  - **BERR / ARLO / timeout**: The peripheral state machine is reset by toggling PE;
+ *    if SDA is held low a bus clear is performed and I2C1 is fully re-initialized.
+ * @param status - Failure that ended the transaction
+ * @return void
+ * @timing ≤ I2C_RECOVERY_MAX_US
+ */
+static void I2C1_Recover(I2C_Status status) {
+    if (status == I2C_ERR_NACK) {
+        uint32_t start = DWT->CYCCNT;
+        uint32_t budget = I2C1_UsToCycles(I2C_TIMEOUT_BYTE_US);
+        // Poll STOPF itself: I2C1_WaitFlag() would return at once on the pending NACKF
+        while (!(I2C1->ISR & I2C_ISR_STOPF) && (DWT->CYCCNT - start) <= budget);
+        I2C1->ICR = I2C_ICR_NACKCF | I2C_ICR_STOPCF;
+        if (!(I2C1->ISR & I2C_ISR_BUSY)) {
+            return;
+        }
+    }
+    // Software reset: PE low for ≥ 3 APB clocks clears the state machine and flags
+    I2C1->CR1 &= ~I2C_CR1_PE;
+    I2C1->ICR = I2C_ICR_NACKCF | I2C_ICR_STOPCF | I2C_ICR_BERRCF | I2C_ICR_ARLOCF | I2C_ICR_OVRCF;
+    // SDA held low by a slave: clock it free, then re-initialize the peripheral
+    if (!(GPIOB->IDR & (1u << I2C_PIN_SDA)) || status == I2C_ERR_TIMEOUT) {
+        I2C1_BusClear();
+        i2c_bus_clears++;
+    }
+    I2C1_Init(0);
+}
+
+/**
+ * @brief Number of failed transactions with the given status
+ * @param status - I2C_ERR_* status (I2C_OK always returns 0)
+ * @return Counter value since reset
+ */
+uint32_t I2C1_GetErrorCount(I2C_Status status) {
+    return (status > I2C_OK && status < I2C_STATUS_COUNT) ? i2c_error_count[status] : 0;
+}
+
+/**
+ * @brief Number of SCL-toggle bus clears performed during recovery
+ * @return Counter value since reset
+ */
+uint32_t I2C1_GetBusClearCount(void) {
+    return i2c_bus_clears;
+}
+
+/**
+ * @brief Cycles spent in transactions
+ * @return Counter value since reset (wraps at 2^32)
+ */
+uint32_t I2C1_GetBusyCycles(void) {
+    return i2c_busy_cycles;
 }
@@ -4,13 +4,14 @@
  * @details Low-level I2C driver for sensor communication using open-drain configuration.
  *
  * ### Hardware Configuration
- *  - **Peripheral**: I2C1 (APB1 @ 32 MHz)
+ *  - **Peripheral**: I2C1 (kernel clock SYSCLK @ 64 MHz)
  *  - **Pins**: PB6 (SCL), PB7 (SDA) - open-drain outputs
- *  - **Speed**: 400 kHz (Fast-mode compliant)
- *  - **Addressing**: 7-bit slave addressing (MSB first)
+ *  - **Speed**: I2C1_SPEED_HZ, 400 kHz (Fast-mode compliant); TIMINGR computed by Clock_I2CTiming()
+ *  - **Addressing**: 7-bit slave addressing (MSB first); addresses are passed in 8-bit form
+ *    (7-bit address << 1, e.g. 0xAE for the MAX30101) and written directly into CR2.SADD[7:1]
  *  - **Protocol**: Master-only; repeated START supported for register read
  *
- * ### Timing (400 kHz mode, APB1 = 32 MHz)
+ * ### Timing (400 kHz mode, I2C1 kernel clock = SYSCLK = 64 MHz)
  *  - SCL period: 2.5 µs
  *  - SCL high time: ~1.5 µs
  *  - SCL low time: ~1.0 µs
@@ -19,18 +20,28 @@
  * ### Driver Characteristics
  *  - **Write latency**: ~30-50 µs per byte (2 bytes minimum per transaction)
  *  - **Read latency**: ~100 µs overhead + ~30 µs/byte (repeated START; e.g. 6 bytes ≈ 280 µs)
- *  - **Blocking**: Yes (waits for bus/flags; no interrupts or DMA)
+ *  - **Blocking**: Yes (waits for bus/flags; no interrupts or DMA), bounded by a per-transaction deadline
  *  - **Thread-safe**: No (not safe for concurrent I2C accesses)
  *
+ * ### Error Handling
+ *  - Each transaction has a deadline of I2C_TIMEOUT_BASE_US + I2C_TIMEOUT_BYTE_US per byte,
+ *    measured with the DWT cycle counter (usable from SysTick_Handler)
+ *  - NACK, bus error (BERR), arbitration loss (ARLO) and timeout are reported as I2C_Status
+ *  - On BERR/ARLO/timeout the peripheral is reset; if SDA is stuck low, SCL is toggled
+ *    (bus clear) and I2C1 is re-initialized. Recovery takes at most I2C_RECOVERY_MAX_US
+ *  - Worst-case latency of any call: deadline + I2C_RECOVERY_MAX_US
+ *  - I2C1_GetBusyCycles() accumulates the time spent in transactions (bus load)
+ *
  * ### Supported Transactions
  *  1. **Write**: Master writes register address + 1 data byte (MAX30101 registers)
- *  2. **Read**: Master writes address, repeated START, reads N bytes (FIFO streaming)
+ *  2. **Burst write**: Master writes register address + N data bytes (auto-increment)
+ *  3. **Read**: Master writes address, repeated START, reads N bytes (FIFO streaming)
  *
  * @author Julio Fajardo
  * @date 2026-03-26
  * @version 2.0
- * @note For STM32F303K8 only. TIMINGR value 0x00C50F26 is specific to APB1 = 32 MHz
- * @todo Add error handling (NAK detection, bus timeout)
+ * @note For STM32F303K8 only. TIMINGR is computed by Clock_I2CTiming() from the active
+ *       I2C1 kernel clock (SYSCLK) and I2C1_SPEED_HZ
  * @todo Implement DMA for high-speed FIFO reads
  */
 
@@ -39,10 +50,33 @@
 
 #include <stdint.h>
 
+#define     I2C1_SPEED_HZ           400000u /**< SCL frequency: 100000 (Sm), 400000 (Fm) or 1000000 (Fm+; the MAX30101 is specified to 400 kHz) */
+#define     I2C_TIMEOUT_BASE_US     200     /**< Deadline per transaction: fixed part (bus wait, START, address) */
+#define     I2C_TIMEOUT_BYTE_US     (20000000u / I2C1_SPEED_HZ) /**< Deadline per transaction: per byte, ~2.2× the 9 SCL periods (50 µs at 400 kHz) */
+#define     I2C_RECOVERY_MAX_US     300     /**< Upper bound for error recovery (bus clear + re-init) */
+
+/** Worst-case duration of a transaction transferring n bytes (register address included), in µs */
+#define     I2C_WORST_CASE_US(n)    (I2C_TIMEOUT_BASE_US + (n) * I2C_TIMEOUT_BYTE_US + I2C_RECOVERY_MAX_US)
+
+/**
+ * @brief Result of an I2C1 transaction
+ */
+typedef enum {
+    I2C_OK = 0,         /**< Transaction completed */
+    I2C_ERR_NACK,       /**< Address or data byte not acknowledged */
+    I2C_ERR_BERR,       /**< Misplaced START/STOP detected (bus error) */
+    I2C_ERR_ARLO,       /**< Arbitration lost */
+    I2C_ERR_TIMEOUT,    /**< Transaction deadline expired */
+    I2C_STATUS_COUNT    /**< Number of status codes */
+} I2C_Status;
+
 /**
  * @brief Initialize I2C1 peripheral and GPIO pins
- * @details One-time configuration of I2C1 for master-mode 400 kHz operation.
+ * @details One-time configuration of I2C1 for master-mode operation at I2C1_SPEED_HZ.
  *          Must be called before any I2C1_Write() or I2C1_Read().
+ *          Also enables the DWT cycle counter used for transaction deadlines.
+ *          TIMINGR is computed here and kept: bus recovery re-initializes the peripheral
+ *          with the kept value. Call again after a clock change.
  */
 void I2C1_Config(void);
 
@@ -50,13 +84,37 @@ void I2C1_Config(void);
  * @brief Write single register to I2C slave device
  * @details Master writes 2-byte transaction: [register_addr] [data_byte]
  *          Uses AUTOEND flag for automatic STOP condition.
- * @param slave - 7-bit I2C slave address (e.g., 0x5D for MAX30101)
+ * @param slave - I2C slave address in 8-bit form (7-bit address << 1, e.g., 0xAE for MAX30101)
  * @param addr - Register address (0x00-0xFF)
  * @param data - Data byte to write
- * @return void
- * @note Blocking; typical latency 30-50 µs
+ * @return I2C_OK, or the error that aborted the transaction
+ * @note Blocking; typical latency 30-50 µs, worst case I2C_WORST_CASE_US(2)
+ */
+I2C_Status I2C1_Write(uint8_t slave, uint8_t addr, uint8_t data);
+
+/**
+ * @brief Write consecutive registers of an I2C slave device in one transaction
+ * @details Master writes (size + 1)-byte transaction: [register_addr] [data_0] ... [data_N-1]
+ *          The slave auto-increments its register pointer after each byte.
+ * @param slave - I2C slave address (8-bit form, as in I2C1_Write)
+ * @param addr - First register address
+ * @param data - [in] Bytes to write to addr, addr + 1, ...
+ * @param size - Number of data bytes (1-254)
+ * @return I2C_OK, or the error that aborted the transaction
+ * @note Blocking; typical latency 30 µs + 22.5 µs per byte, worst case I2C_WORST_CASE_US(size + 1)
+ */
+I2C_Status I2C1_WriteBurst(uint8_t slave, uint8_t addr, const uint8_t *data, uint8_t size);
+
+/**
+ * @brief Write a single byte to I2C slave device (no register address)
+ * @details Master writes 1-byte transaction: [data_byte]
+ *          Used for devices with a single control register, e.g. TCA9548A I2C mux.
+ * @param slave - I2C slave address (8-bit form, as in I2C1_Write)
+ * @param data - Data byte to write
+ * @return I2C_OK, or the error that aborted the transaction
+ * @note Blocking; typical latency 25-35 µs, worst case I2C_WORST_CASE_US(1)
  */
-void I2C1_Write(uint8_t slave, uint8_t addr, uint8_t data);
+I2C_Status I2C1_WriteByte(uint8_t slave, uint8_t data);
 
 /**
  * @brief Read multiple bytes from I2C slave register (repeated START)
@@ -64,14 +122,36 @@ void I2C1_Write(uint8_t slave, uint8_t addr, uint8_t data);
  *          - Write: [slave_addr + W] [register_addr]
  *          - Repeated START: [slave_addr + R]
  *          - Read: [data_0] [data_1] ... [data_N]
- * @param slave - 7-bit I2C slave address
+ * @param slave - I2C slave address (8-bit form, as in I2C1_Write)
  * @param addr - Register address to read from
  * @param data - [out] Pointer to buffer for received bytes
  * @param size - [in] Number of bytes to read (typically 1-6 for MAX30101)
- * @return void
- * @note Blocking; latency ≈ (100 µs overhead) + (30 µs × size)
+ * @return I2C_OK, or the error that aborted the transaction (data[] undefined)
+ * @note Blocking; latency ≈ (100 µs overhead) + (30 µs × size), worst case I2C_WORST_CASE_US(size + 1)
  * @warning Buffer overflow if size exceeds allocated data[] array
  */
-void I2C1_Read(uint8_t slave, uint8_t addr, uint8_t *data, uint8_t size);
+I2C_Status I2C1_Read(uint8_t slave, uint8_t addr, uint8_t *data, uint8_t size);
+
+/**
+ * @brief Number of failed transactions with the given status
+ * @param status - I2C_ERR_* status
+ * @return Counter value since reset
+ */
+uint32_t I2C1_GetErrorCount(I2C_Status status);
+
+/**
+ * @brief Number of SCL-toggle bus clears performed during error recovery
+ * @return Counter value since reset
+ */
+uint32_t I2C1_GetBusClearCount(void);
+
+/**
+ * @brief Cycles spent in transactions (bus time, error recovery included)
+ * @details Counted with DWT->CYCCNT from the start of each call to its return; it wraps
+ *          after 2^32 cycles (67 s at 64 MHz), so read it as a difference over shorter
+ *          intervals.
+ * @return Counter value since reset
+ */
+uint32_t I2C1_GetBusyCycles(void);
 
 #endif /* I2C_H_ */    
\ No newline at end of file
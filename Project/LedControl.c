@@ -0,0 +1,138 @@
+/**
+ * @file LedControl.c
+ * @brief Automatic LED current control implementation
+ * @details Windowed DC per channel, hysteresis band, proportional drive step and range choice.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "LedControl.h"
+#include "MAX30101.h"
+#include <stdint.h>
+
+/**
+ * @brief Start a new averaging window
+ * @param lc - [in,out] LED controller
+ * @return void
+ */
+static void LedCtl_Restart(LedCtl_Context *lc) {
+    lc->count = 0;
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        lc->sum[c] = 0.0f;
+        lc->peak[c] = 0.0f;
+    }
+}
+
+/**
+ * @brief Initialize an LED controller
+ * @param lc - [out] LED controller
+ * @return void
+ */
+void LedCtl_Init(LedCtl_Context *lc) {
+    lc->valid = 0;
+    lc->range = 0;
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        lc->code[c] = 0;
+    }
+    LedCtl_Restart(lc);
+}
+
+/**
+ * @brief New drive codes and range for the window just completed
+ * @param lc - [in,out] LED controller
+ * @return 1 if the requested settings changed
+ */
+static uint8_t LedCtl_Decide(LedCtl_Context *lc) {
+    float32_t fs = MAX30101_RANGE_FULLSCALE_NA(lc->range);
+    float32_t need[SAMPLE_BLOCK_CHANNELS];
+    float32_t least = 0.0f;
+    uint8_t in_band = 1;
+    uint8_t out[SAMPLE_BLOCK_CHANNELS];
+
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        float32_t dc = lc->sum[c] / (float32_t)lc->count;
+        out[c] = 0;
+        if (lc->peak[c] >= LEDCTL_CLIP_FRAC * fs) {
+            dc = fs;
+            out[c] = 1;
+        } else if (dc < LEDCTL_LOW_FRAC * fs || dc > LEDCTL_HIGH_FRAC * fs) {
+            out[c] = 1;
+        }
+        in_band &= (uint8_t)!out[c];
+        if (dc < 1.0f) {
+            dc = 1.0f;  // No light at all: ask for the most drive
+        }
+        // Drive that puts this channel on target in the smallest range
+        uint8_t code = (lc->code[c] != 0u) ? lc->code[c] : 1u;
+        need[c] = (float32_t)code * LEDCTL_TARGET_FRAC * MAX30101_RANGE_FULLSCALE_NA(0u) / dc;
+        if (c == 0u || need[c] < least) {
+            least = need[c];
+        }
+    }
+    LedCtl_Restart(lc);
+    if (in_band) {
+        return 0;
+    }
+
+    // Smallest range in which the brightest channel still needs at least the minimum drive
+    uint8_t range = 0;
+    while (range < LEDCTL_MAX_RANGE && least * (float32_t)(1u << range) < (float32_t)LEDCTL_MIN_CODE) {
+        range++;
+    }
+    uint8_t changed = (range != lc->range);
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        if (!changed && !out[c]) {
+            continue;   // In band and same range: keep the drive
+        }
+        float32_t q = need[c] * (float32_t)(1u << range);
+        if (q < (float32_t)LEDCTL_MIN_CODE) q = (float32_t)LEDCTL_MIN_CODE;
+        if (q > (float32_t)LEDCTL_MAX_CODE) q = (float32_t)LEDCTL_MAX_CODE;
+        uint8_t code = (uint8_t)(q + 0.5f);
+        changed |= (code != lc->code[c]);
+        lc->code[c] = code;
+    }
+    lc->range = range;
+    return changed;
+}
+
+/**
+ * @brief Add a block of raw currents and decide when the window is complete
+ * @param lc - [in,out] LED controller
+ * @param block - [in] Block with raw currents (nA)
+ * @param first - First sample to include
+ * @return 1 if the requested settings changed
+ */
+uint8_t LedCtl_Update(LedCtl_Context *lc, const SampleBlock *block, uint8_t first) {
+    if (!lc->valid) {
+        for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+            lc->code[c] = block->led[c];
+        }
+        lc->range = block->adc_range;
+        lc->valid = 1;
+    }
+    // Wait until the last request is in effect
+    if (block->adc_range != lc->range) {
+        return 0;
+    }
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        if (block->led[c] != lc->code[c]) {
+            return 0;
+        }
+    }
+
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        const float32_t *x = block->ch[c];
+        for (uint8_t i = first; i < block->count; i++) {
+            lc->sum[c] += x[i];
+            if (x[i] > lc->peak[c]) {
+                lc->peak[c] = x[i];
+            }
+        }
+    }
+    lc->count += (uint16_t)(block->count - first);
+    if (lc->count < LEDCTL_WINDOW_SAMPLES) {
+        return 0;
+    }
+    return LedCtl_Decide(lc);
+}
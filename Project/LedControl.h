@@ -0,0 +1,83 @@
+/**
+ * @file LedControl.h
+ * @brief Automatic LED current control: ADC in range at minimum LED power
+ * @details Closed loop, per sensor, from the raw Red/IR currents to the LED drive codes
+ *          (LED1_PA/LED2_PA) and the ADC range. Skin tone and adipose thickness change
+ *          the detected light by more than an order of magnitude; a fixed drive either
+ *          saturates the ADC or sits near its noise floor, and the LEDs are the largest
+ *          power draw of the board.
+ *
+ * ### Control Law
+ *  Every LEDCTL_WINDOW_SAMPLES samples, the mean DC of each channel is compared with the
+ *  ADC full scale FS of the active range:
+ *  - **Hysteresis**: nothing changes while every channel is within
+ *    [LEDCTL_LOW_FRAC, LEDCTL_HIGH_FRAC] · FS and none clipped (≥ LEDCTL_CLIP_FRAC · FS)
+ *  - **Step**: otherwise each channel outside the band has its drive scaled so its DC
+ *    lands on LEDCTL_TARGET_FRAC · FS, since the detected current is proportional to the
+ *    LED current (a clipped channel counts as FS, so it is at least halved)
+ *  - **Range**: the smallest range (best resolution, lowest target current, lowest LED
+ *    power) in which no channel needs less than LEDCTL_MIN_CODE is chosen; a range change
+ *    retargets every channel. A channel needing more than LEDCTL_MAX_CODE is clamped
+ *
+ *  After a request the window restarts only once blocks show the new settings, so each
+ *  decision sees a single operating point.
+ *
+ * ### Gain Steps
+ *  Changes are applied by acquisition between two FIFO drains and flagged on the next
+ *  block (SB_FLAG_GAIN, with its led[] codes and adc_range). The currents in nA already
+ *  account for the range; the pipeline rescales its state by the LED current ratio
+ *  instead of reinitializing.
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Pipeline_ProcessBlock, Acquisition_SetLed
+ */
+
+#ifndef LEDCONTROL_H_
+#define LEDCONTROL_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "SampleBlock.h"
+
+#define     LEDCTL_TARGET_FRAC      0.5f    /**< Target DC as a fraction of the ADC full scale */
+#define     LEDCTL_LOW_FRAC         0.2f    /**< Lower hysteresis bound (fraction of full scale) */
+#define     LEDCTL_HIGH_FRAC        0.8f    /**< Upper hysteresis bound (fraction of full scale) */
+#define     LEDCTL_CLIP_FRAC        0.98f   /**< Sample level treated as clipped (fraction of full scale) */
+#define     LEDCTL_MIN_CODE         5u      /**< Lowest LED drive code (1.0 mA) */
+#define     LEDCTL_MAX_CODE         250u    /**< Highest LED drive code (50.0 mA) */
+#define     LEDCTL_MAX_RANGE        3u      /**< Largest ADC range setting (MAX30101_ADC_RGE_16384NA) */
+#define     LEDCTL_WINDOW_SAMPLES   50u     /**< Samples averaged per decision (1 s at 50 Hz) */
+
+/**
+ * @struct LedCtl_Context
+ * @brief LED controller state (one per sensor)
+ */
+typedef struct {
+    float32_t sum[SAMPLE_BLOCK_CHANNELS];   /**< Sum of raw currents in the window (nA) */
+    float32_t peak[SAMPLE_BLOCK_CHANNELS];  /**< Largest raw current in the window (nA) */
+    uint16_t  count;                        /**< Samples in the window */
+    uint8_t   valid;                        /**< Settings known (first block seen) */
+    uint8_t   code[SAMPLE_BLOCK_CHANNELS];  /**< Requested LED drive codes */
+    uint8_t   range;                        /**< Requested ADC range */
+} LedCtl_Context;
+
+/**
+ * @brief Initialize an LED controller
+ * @details The settings are taken from the first block passed to LedCtl_Update().
+ * @param lc - [out] LED controller
+ * @return void
+ */
+void LedCtl_Init(LedCtl_Context *lc);
+
+/**
+ * @brief Add a block of raw currents and decide when the window is complete
+ * @param lc - [in,out] LED controller
+ * @param block - [in] Block with raw currents (nA), led[] and adc_range
+ * @param first - First sample to include
+ * @return 1 if the requested settings changed
+ */
+uint8_t LedCtl_Update(LedCtl_Context *lc, const SampleBlock *block, uint8_t first);
+
+#endif /* LEDCONTROL_H_ */
@@ -11,102 +11,228 @@
 #include "MAX30101.h"
 #include "I2C.h"
 #include "arm_math_types.h"
+#include "cmsis_compiler.h"
+#include <stddef.h>
 #include <stdint.h>
 
+static uint8_t mux_selected_addr = MUX_ADDR_NONE; /**< Mux whose channel is currently enabled */
+static uint8_t mux_selected_channel = 0xFF;       /**< Channel currently enabled on that mux */
+
+/**
+ * @brief Route the I2C bus to the given sensor
+ * @details Writes the mux control byte only when the selection changes, so consecutive
+ *          accesses to the same sensor cost no extra transaction. Directly wired sensors
+ *          need no selection at all.
+ * @param dev - [in] Sensor handle
+ * @return I2C_OK, or the mux write error (selection cache is invalidated)
+ */
+static I2C_Status MAX30101_Select(const MAX30101_Handle *dev) {
+    I2C_Status status = I2C_OK;
+    if (dev->mux_addr == MUX_ADDR_NONE) {
+        return I2C_OK;
+    }
+    if (dev->mux_addr != mux_selected_addr || dev->mux_channel != mux_selected_channel) {
+        // Disable the previously selected mux so two sensors never share the bus
+        if (mux_selected_addr != MUX_ADDR_NONE && mux_selected_addr != dev->mux_addr) {
+            status = I2C1_WriteByte(mux_selected_addr, 0x00);
+        }
+        if (status == I2C_OK) {
+            status = I2C1_WriteByte(dev->mux_addr, (uint8_t)(1u << dev->mux_channel));
+        }
+        if (status != I2C_OK) {
+            // Mux state unknown: force a fresh selection on the next access
+            mux_selected_addr = MUX_ADDR_NONE;
+            mux_selected_channel = 0xFF;
+            return status;
+        }
+        mux_selected_addr = dev->mux_addr;
+        mux_selected_channel = dev->mux_channel;
+    }
+    return I2C_OK;
+}
+
+#define MAX30101_CFG_MAX_RUN    8   /**< Longest register run coalesced into one burst */
+
+/** NIRS Lite profile, typed view */
+const MAX30101_Profile MAX30101_NIRSLiteProfile =
+    MAX30101_PROFILE_APPLY(MAX30101_PROFILE_INIT, MAX30101_PROFILE_NIRS_LITE);
+
+/** NIRS Lite profile, register table generated from the same argument list */
+static const MAX30101_RegEntry nirs_lite_regs[] =
+    MAX30101_PROFILE_APPLY(MAX30101_PROFILE_REGS, MAX30101_PROFILE_NIRS_LITE);
+
+const MAX30101_ConfigTable MAX30101_NIRSLiteConfig = {
+    nirs_lite_regs, (uint8_t)(sizeof(nirs_lite_regs) / sizeof(nirs_lite_regs[0]))
+};
+
+/**
+ * @brief Length of the run of consecutive register addresses starting at entry i
+ * @param cfg - [in] Register table
+ * @param i - [in] Index of the first entry of the run
+ * @return Run length (1 to MAX30101_CFG_MAX_RUN)
+ */
+static uint8_t MAX30101_RunLength(const MAX30101_ConfigTable *cfg, uint8_t i) {
+    uint8_t n = 1;
+    while ((uint8_t)(i + n) < cfg->count && n < MAX30101_CFG_MAX_RUN &&
+           cfg->entries[i + n].reg == (uint8_t)(cfg->entries[i].reg + n)) {
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Apply a configuration table with burst writes and burst read-back verification
+ * @details Two passes over the table, both walking runs of consecutive registers:
+ *          1. **Write**: each run is sent as one auto-increment burst (I2C1_WriteBurst)
+ *          2. **Verify**: each run containing verified registers is read back in one
+ *             burst and compared under each entry's verify_mask
+ *
+ *          For the NIRS Lite table this is 3 writes + 2 reads instead of 7 single-register
+ *          writes, each with its own START/address/STOP.
+ *
+ * @param dev - [in] Sensor handle
+ * @param cfg - [in] Register table, entries in application order
+ * @param mismatches - [out] Number of registers whose read-back differed (may be NULL)
+ * @return I2C_OK, or the error of the first failed transaction (application stops there)
+ * @see MAX30101_PROFILE_REGS
+ */
+I2C_Status MAX30101_ApplyConfig(const MAX30101_Handle *dev, const MAX30101_ConfigTable *cfg, uint8_t *mismatches) {
+    uint8_t buf[MAX30101_CFG_MAX_RUN];
+    uint8_t bad = 0;
+    uint8_t i, n, k;
+    I2C_Status status = MAX30101_Select(dev);
+
+    // Pass 1: burst-write each run of consecutive registers
+    for (i = 0; i < cfg->count && status == I2C_OK; i += n) {
+        n = MAX30101_RunLength(cfg, i);
+        for (k = 0; k < n; k++) {
+            buf[k] = cfg->entries[i + k].value;
+        }
+        status = I2C1_WriteBurst(dev->addr, cfg->entries[i].reg, buf, n);
+    }
+    // Pass 2: burst-read each run that holds verified registers and compare
+    for (i = 0; i < cfg->count && status == I2C_OK; i += n) {
+        uint8_t mask_any = 0;
+        n = MAX30101_RunLength(cfg, i);
+        for (k = 0; k < n; k++) {
+            mask_any |= cfg->entries[i + k].verify_mask;
+        }
+        if (!mask_any) {
+            continue;
+        }
+        status = I2C1_Read(dev->addr, cfg->entries[i].reg, buf, n);
+        for (k = 0; k < n && status == I2C_OK; k++) {
+            const MAX30101_RegEntry *e = &cfg->entries[i + k];
+            if ((buf[k] ^ e->value) & e->verify_mask) {
+                bad++;
+            }
+        }
+    }
+    if (mismatches) {
+        *mismatches = bad;
+    }
+    return status;
+}
+
 /**
  * @brief Initialize MAX30101 in SpO2 mode (dual-LED: Red + IR)
- * @details Configures sensor for blood oxygen (SpO2) measurement with low power consumption.
+ * @details Applies the NIRS Lite profile (MAX30101_PROFILE_NIRS_LITE):
  *          - Mode: SpO2 (Red + IR LEDs)
- *          - Sample Rate: 50 Hz (SPO2_CONFIG = 0x01, bits [4:2] = 000)
+ *          - Sample Rate: 50 Hz (SPO2_CONFIG bits [4:2] = 000)
  *          - ADC Resolution: 18-bit, 411 µs pulse width (SPO2_CONFIG bits [1:0] = 11)
  *          - ADC Range: 4096 nA full-scale (SPO2_CONFIG bits [6:5] = 01)
  *          - FIFO Configuration: No averaging, rollover enabled
- * @param ledPower_red - Red LED drive current in milliamps (0.0 to 51.0 mA, ~0.2 mA steps)
- *                       Converted to register value as: reg = (uint8_t)(mA / 0.2)
- *                       Example: 1.6 mA → reg 0x08; 10 mA → reg 0x32
- * @param ledPower_ir  - IR LED drive current in milliamps (same range and conversion)
- * @return void
+ *          - LED current: 10 mA per LED (reg 0x32, 0.2 mA steps)
+ *          - FIFO pointers cleared last
+ * @param dev - [in] Sensor handle
+ * @param mismatches - [out] Number of registers whose read-back differed (may be NULL)
+ * @return I2C_OK, or the error of the first failed transaction
  * @note Suitable for battery-powered wearable applications.
- *       Call once during initialization before reading samples.
- * @see MAX30101_InitMuscleOx
+ *       Call once during initialization before reading samples; retry or leave the
+ *       sensor out on an error or a mismatch.
+ * @see MAX30101_ApplyConfig, MAX30101_NIRSLiteConfig
  * @example
- *   MAX30101_InitSPO2Lite(1.6f, 1.6f);  // 1.6 mA per LED, low power
- *   uint8_t samples = MAX30101_GetNumAvailableSamples();
- */
-void MAX30101_InitNIRSLite(float32_t ledPower_red, float32_t ledPower_ir) {
-    // Configure FIFO: no averaging, rollover enabled
-    I2C1_Write(SENSOR_ADDR, FIFO_CONFIG, 0x10);
-    // Select SpO2 mode (Red + IR)
-    I2C1_Write(SENSOR_ADDR, MODE_CONFIG, 0x03);
-    // SpO2 config: 4096 nA range, 50 Hz sample rate, 411 µs pulse width
-    I2C1_Write(SENSOR_ADDR, SPO2_CONFIG, 0x23);
-    // Reset FIFO read pointer
-    I2C1_Write(SENSOR_ADDR, FIFO_READPTR, 0x0);
-    // Reset FIFO write pointer
-    I2C1_Write(SENSOR_ADDR, FIFO_WRITPTR, 0x0);
-    // Set Red LED power
-    I2C1_Write(SENSOR_ADDR, LED1_PAMPLI, (uint8_t)(ledPower_red / 0.2f));  // Convert mA to register value (0.2 mA steps)
-    // Set IR LED power
-    I2C1_Write(SENSOR_ADDR, LED2_PAMPLI, (uint8_t)(ledPower_ir / 0.2f));  // Same LED power for IR
+ *   uint8_t bad;
+ *   if (MAX30101_InitNIRSLite(&sensor, &bad) == I2C_OK && bad == 0) {
+ *       MAX30101_GetNumAvailableSamples(&sensor, &samples);
+ *   }
+ */
+I2C_Status MAX30101_InitNIRSLite(const MAX30101_Handle *dev, uint8_t *mismatches) {
+    return MAX30101_ApplyConfig(dev, &MAX30101_NIRSLiteConfig, mismatches);
 }
 
 /**
  * @brief Query FIFO status from MAX30101 sensor
- * @details Reads FIFO write and read pointer registers to determine number of unread samples.
+ * @details Reads FIFO write pointer, overflow counter and read pointer (contiguous registers
+ *          0x04-0x06) in a single burst to determine number of unread samples.
  *          Accounts for circular 32-sample FIFO with pointer wrap-around.
- * @param None
- * @return uint8_t Number of complete samples available (0 to 32)
- *         - Returns 0 if FIFO empty or pointers equal
- *         - Returns 1 to 32 for available samples
+ * @param dev - [in] Sensor handle
+ * @param num_samples - [out] Number of complete samples available (0 to 32)
+ *         - 0 if FIFO empty (pointers equal, no overflow), or on I2C error
+ *         - 32 if FIFO full (pointers equal, overflow counter non-zero)
+ *         - 1 to 31 for available samples
+ * @return I2C_OK, or the I2C error of the pointer read
  * @note Call before MAX30101_ReadSingleCurrent()
  *       to confirm new data is ready.
  * @warning Multiple fast consecutive reads may show inconsistent results
  *          due to FIFO updates during pointer reads.
  * @see MAX30101_ReadSingleCurrent, MAX30101_UpdateReadPointer
  * @example
- *   uint8_t count = MAX30101_GetNumAvailableSamples();
- *   if (count > 0) {
- *       MAX30101_ReadSingleCurrent(&sample);
- *       MAX30101_UpdateReadPointer(count);  
+ *   uint8_t count;
+ *   if (MAX30101_GetNumAvailableSamples(&sensor, &count) == I2C_OK && count > 0) {
+ *       MAX30101_ReadSingleCurrent(&sensor, &sample);
+ *       MAX30101_UpdateReadPointer(&sensor, count);  
  *   }
  */
-uint8_t MAX30101_GetNumAvailableSamples(void) {
-    uint8_t write_ptr = 0;
-    uint8_t read_ptr = 0;
-    uint8_t num_samples = 0;
+I2C_Status MAX30101_GetNumAvailableSamples(const MAX30101_Handle *dev, uint8_t *num_samples) {
+    uint8_t fifo_ptrs[3]; // [0] = FIFO_WRITPTR, [1] = OVRF_COUNTER, [2] = FIFO_READPTR
+    uint8_t write_ptr;
+    uint8_t read_ptr;
+    I2C_Status status;
     
-    // Read FIFO write and read pointers from sensor
-    I2C1_Read(SENSOR_ADDR, FIFO_WRITPTR, &write_ptr, 1);
-    I2C1_Read(SENSOR_ADDR, FIFO_READPTR, &read_ptr, 1);
+    *num_samples = 0;
+    status = MAX30101_Select(dev);
+    // Read FIFO write pointer, overflow counter and read pointer in one transaction
+    if (status == I2C_OK) status = I2C1_Read(dev->addr, FIFO_WRITPTR, fifo_ptrs, 3);
+    if (status != I2C_OK) {
+        return status;
+    }
     
     // Mask to 5 bits (FIFO pointers are 5-bit: 0-31)
-    write_ptr &= 0x1F;
-    read_ptr &= 0x1F;
+    write_ptr = fifo_ptrs[0] & 0x1F;
+    read_ptr = fifo_ptrs[2] & 0x1F;
     
     // Calculate number of available samples (handles wrap-around)
-    if (write_ptr >= read_ptr) {
-        num_samples = write_ptr - read_ptr;
+    if (write_ptr == read_ptr) {
+        *num_samples = (fifo_ptrs[1] & 0x1F) ? MAX30101_FIFO_DEPTH : 0;
+    } else if (write_ptr > read_ptr) {
+        *num_samples = write_ptr - read_ptr;
     } else {
-        num_samples = (32 - read_ptr) + write_ptr;
+        *num_samples = (32 - read_ptr) + write_ptr;
     }
     
-    return num_samples;
+    return I2C_OK;
 }
 
 /**
  * @brief Update the FIFO read pointer
  * @details Advances the read pointer by a specified number of samples, wrapping around at 32.
+ * @param dev - [in] Sensor handle
  * @param num_samples - [in] Number of samples to advance the read pointer
- * @return void
+ * @return I2C_OK, or the I2C error (pointer left unchanged if the read failed)
  */
-void MAX30101_UpdateReadPointer(uint8_t num_samples) {
+I2C_Status MAX30101_UpdateReadPointer(const MAX30101_Handle *dev, uint8_t num_samples) {
     uint8_t read_ptr = 0;
+    I2C_Status status = MAX30101_Select(dev);
     // Read current FIFO read pointer
-    I2C1_Read(SENSOR_ADDR, FIFO_READPTR, &read_ptr, 1);
+    if (status == I2C_OK) status = I2C1_Read(dev->addr, FIFO_READPTR, &read_ptr, 1);
+    if (status != I2C_OK) {
+        return status;
+    }
     // Advance pointer by num_samples with wrap-around at 32
     read_ptr = (read_ptr + num_samples) % 32;
     // Write updated pointer back to sensor
-    I2C1_Write(SENSOR_ADDR, FIFO_READPTR, read_ptr);
+    return I2C1_Write(dev->addr, FIFO_READPTR, read_ptr);
 }
 
 /**
@@ -142,26 +268,131 @@ void MAX30101_ConvertUint32ToCurrent(MAX30101_DataSample *sample_in, MAX30101_Cu
     sample_out->ir = (float32_t)sample_in->ir * MAX30101_CURRENT_LSB_NA;
 }
 
+/**
+ * @brief Load 4 FIFO bytes as a big-endian word
+ * @details On Cortex-M4 an unaligned LDR plus REV; elsewhere byte composition.
+ * @param p - [in] Byte pointer (any alignment)
+ * @return p[0]<<24 | p[1]<<16 | p[2]<<8 | p[3]
+ */
+static inline uint32_t MAX30101_LoadBE32(const uint8_t *p) {
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+    return __REV(__UNALIGNED_UINT32_READ(p));
+#else
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+#endif
+}
+
+/**
+ * @brief Unpack two FIFO samples (12 bytes) into 18-bit counts
+ * @details Three big-endian words cover two Red/IR pairs:
+ *          w0 = r0 r1 r2 i0 | w1 = i1 i2 R0 R1 | w2 = R2 I0 I1 I2
+ *          so each count is one or two shifts and a mask instead of three byte loads.
+ * @param fifo - [in] 12 FIFO bytes
+ * @param c - [out] { red0, ir0, red1, ir1 }
+ * @return void
+ */
+static inline void MAX30101_UnpackPair(const uint8_t *fifo, uint32_t c[4]) {
+    uint32_t w0 = MAX30101_LoadBE32(fifo);
+    uint32_t w1 = MAX30101_LoadBE32(fifo + 4);
+    uint32_t w2 = MAX30101_LoadBE32(fifo + 8);
+    c[0] = (w0 >> 8) & MAX30101_ADC_MASK;
+    c[1] = ((w0 << 16) | (w1 >> 16)) & MAX30101_ADC_MASK;
+    c[2] = ((w1 << 8) | (w2 >> 24)) & MAX30101_ADC_MASK;
+    c[3] = w2 & MAX30101_ADC_MASK;
+}
+
+/**
+ * @brief Unpack one FIFO sample (6 bytes) bytewise, for an odd last sample
+ * @param fifo - [in] 6 FIFO bytes
+ * @param c - [out] { red, ir }
+ * @return void
+ */
+static inline void MAX30101_UnpackOne(const uint8_t *fifo, uint32_t c[2]) {
+    c[0] = (((uint32_t)fifo[0] << 16) | ((uint32_t)fifo[1] << 8) | fifo[2]) & MAX30101_ADC_MASK;
+    c[1] = (((uint32_t)fifo[3] << 16) | ((uint32_t)fifo[4] << 8) | fifo[5]) & MAX30101_ADC_MASK;
+}
+
+/**
+ * @brief Unpack a FIFO burst into SoA arrays of 18-bit ADC counts
+ * @param fifo - [in] num_samples × 6 bytes as read from FIFO_DATA
+ * @param red - [out] Red counts
+ * @param ir - [out] IR counts
+ * @param num_samples - Number of samples
+ * @return void
+ */
+void MAX30101_UnpackBurstCounts(const uint8_t *fifo, uint32_t *red, uint32_t *ir, uint32_t num_samples) {
+    uint32_t c[4];
+    uint32_t i = 0;
+    for (; i + 2u <= num_samples; i += 2u) {
+        MAX30101_UnpackPair(fifo, c);
+        red[i] = c[0];
+        ir[i] = c[1];
+        red[i + 1u] = c[2];
+        ir[i + 1u] = c[3];
+        fifo += 2u * MAX30101_BYTES_PER_SAMPLE;
+    }
+    if (i < num_samples) {
+        MAX30101_UnpackOne(fifo, c);
+        red[i] = c[0];
+        ir[i] = c[1];
+    }
+}
+
+/**
+ * @brief Unpack a FIFO burst into strided arrays of currents in nA
+ * @details Counts are converted with one VCVT + VMUL per value right after unpacking.
+ * @param fifo - [in] num_samples × 6 bytes as read from FIFO_DATA
+ * @param red - [out] Red current (nA), element i at red[i * stride]
+ * @param ir - [out] IR current (nA), element i at ir[i * stride]
+ * @param stride - Output stride in elements (1 = SoA arrays, 2 = MAX30101_CurrentSample array)
+ * @param num_samples - Number of samples
+ * @return void
+ */
+void MAX30101_UnpackBurstCurrent(const uint8_t *fifo, float32_t *red, float32_t *ir,
+                                 uint32_t stride, uint32_t num_samples) {
+    uint32_t c[4];
+    uint32_t i = 0;
+    for (; i + 2u <= num_samples; i += 2u) {
+        MAX30101_UnpackPair(fifo, c);
+        red[i * stride]        = (float32_t)c[0] * MAX30101_CURRENT_LSB_NA;
+        ir[i * stride]         = (float32_t)c[1] * MAX30101_CURRENT_LSB_NA;
+        red[(i + 1u) * stride] = (float32_t)c[2] * MAX30101_CURRENT_LSB_NA;
+        ir[(i + 1u) * stride]  = (float32_t)c[3] * MAX30101_CURRENT_LSB_NA;
+        fifo += 2u * MAX30101_BYTES_PER_SAMPLE;
+    }
+    if (i < num_samples) {
+        MAX30101_UnpackOne(fifo, c);
+        red[i * stride] = (float32_t)c[0] * MAX30101_CURRENT_LSB_NA;
+        ir[i * stride]  = (float32_t)c[1] * MAX30101_CURRENT_LSB_NA;
+    }
+}
+
 /**
  * @brief Read single NIRS sample from MAX30101 FIFO as 18-bit ADC counts
  * @details Optimized function for reading one sample at a time.
  *          Reads 6 bytes from FIFO and returns as raw 18-bit ADC values (0-262143).
  *
- * @param sample - [out] Pointer to MAX30101_DataSample for result
- * @return void
+ * @param dev - [in] Sensor handle
+ * @param sample - [out] Pointer to MAX30101_DataSample for result (unchanged on error)
+ * @return I2C_OK, or the I2C error of the FIFO read
  * @see MAX30101_GetNumAvailableSamples
  */
-void MAX30101_ReadSingleData(MAX30101_DataSample *sample) {
+I2C_Status MAX30101_ReadSingleData(const MAX30101_Handle *dev, MAX30101_DataSample *sample) {
     uint8_t fifo_data[6];
+    I2C_Status status = MAX30101_Select(dev);
 
     // Read 6 bytes from FIFO data register
-    I2C1_Read(SENSOR_ADDR, FIFO_DATAREG, fifo_data, 6);
+    if (status == I2C_OK) status = I2C1_Read(dev->addr, FIFO_DATAREG, fifo_data, 6);
+    if (status != I2C_OK) {
+        return status;
+    }
 
     // Convert Red LED: combine bytes to 32-bit unsigned value
     sample->red = ((uint32_t)(fifo_data[0] & 0x3) << 16) | ((uint32_t)fifo_data[1] << 8) | fifo_data[2];
     
     // Convert IR LED: combine bytes to 32-bit unsigned value
     sample->ir = ((uint32_t)(fifo_data[3] & 0x3) << 16) | ((uint32_t)fifo_data[4] << 8) | fifo_data[5];
+    return I2C_OK;
 }
 
 /**
@@ -169,16 +400,21 @@ void MAX30101_ReadSingleData(MAX30101_DataSample *sample) {
  * @details Optimized function for reading one sample at a time.
  *          Reads 6 bytes from FIFO, extracts 18-bit ADC counts, and converts to nA.
  *
- * @param sample - [out] Pointer to MAX30101_CurrentSample for result
- * @return void
+ * @param dev - [in] Sensor handle
+ * @param sample - [out] Pointer to MAX30101_CurrentSample for result (unchanged on error)
+ * @return I2C_OK, or the I2C error of the FIFO read
  * @see MAX30101_GetNumAvailableSamples
  */
-void MAX30101_ReadSingleCurrentData(MAX30101_CurrentSample *sample) {
+I2C_Status MAX30101_ReadSingleCurrentData(const MAX30101_Handle *dev, MAX30101_CurrentSample *sample) {
     uint8_t fifo_data[6];
     uint32_t temp;
+    I2C_Status status = MAX30101_Select(dev);
 
     // Read 6 bytes from FIFO data register
-    I2C1_Read(SENSOR_ADDR, FIFO_DATAREG, fifo_data, 6);
+    if (status == I2C_OK) status = I2C1_Read(dev->addr, FIFO_DATAREG, fifo_data, 6);
+    if (status != I2C_OK) {
+        return status;
+    }
 
     // Convert Red LED: extract 18-bit ADC value and scale to nanoamps
     temp = ((uint32_t)(fifo_data[0] & 0x3) << 16) | ((uint32_t)fifo_data[1] << 8) | fifo_data[2];
@@ -187,5 +423,228 @@ void MAX30101_ReadSingleCurrentData(MAX30101_CurrentSample *sample) {
     // Convert IR LED: extract 18-bit ADC value and scale to nanoamps
     temp = ((uint32_t)(fifo_data[3] & 0x3) << 16) | ((uint32_t)fifo_data[4] << 8) | fifo_data[5];
     sample->ir = (float32_t)temp * MAX30101_CURRENT_LSB_NA;
+    return I2C_OK;
+}
+
+/**
+ * @brief Read a burst of NIRS samples into strided Red/IR current arrays
+ * @details Reads num_samples × 6 bytes from FIFO_DATA in a single I2C transaction,
+ *          saving the START/address/repeated-START overhead of per-sample reads.
+ *          The FIFO read pointer auto-increments per sample read, so the caller must
+ *          not call MAX30101_UpdateReadPointer() afterwards.
+ *
+ * @param dev - [in] Sensor handle
+ * @param red - [out] Red current (nA), element i at red[i * stride]
+ * @param ir - [out] IR current (nA), element i at ir[i * stride]
+ * @param stride - Output stride in elements
+ * @param num_samples - [in] Samples to read (1-32, at most the number available)
+ * @return I2C_OK, or the I2C error of the FIFO read (outputs unchanged)
+ * @note Uses a static FIFO byte buffer (192 bytes) to keep ISR stack usage low; not reentrant.
+ */
+static I2C_Status MAX30101_ReadBurst(const MAX30101_Handle *dev, float32_t *red, float32_t *ir,
+                                     uint32_t stride, uint8_t num_samples) {
+    static uint8_t fifo_data[MAX30101_FIFO_DEPTH * MAX30101_BYTES_PER_SAMPLE] __ALIGNED(4);
+    I2C_Status status;
+
+    if (num_samples > MAX30101_FIFO_DEPTH) {
+        num_samples = MAX30101_FIFO_DEPTH;
+    }
+    status = MAX30101_Select(dev);
+    // Read all requested samples from FIFO data register in one transaction
+    if (status == I2C_OK) status = I2C1_Read(dev->addr, FIFO_DATAREG, fifo_data, num_samples * MAX30101_BYTES_PER_SAMPLE);
+    if (status != I2C_OK) {
+        return status;
+    }
+    MAX30101_UnpackBurstCurrent(fifo_data, red, ir, stride, num_samples);
+    return I2C_OK;
+}
+
+/**
+ * @brief Read a burst of NIRS samples from MAX30101 FIFO with current conversion
+ * @param dev - [in] Sensor handle
+ * @param samples - [out] Array of at least num_samples MAX30101_CurrentSample
+ * @param num_samples - [in] Samples to read (1-32, at most the number available)
+ * @return I2C_OK, or the I2C error of the FIFO read (samples[] unchanged)
+ * @see MAX30101_GetNumAvailableSamples
+ */
+I2C_Status MAX30101_ReadBurstCurrentData(const MAX30101_Handle *dev, MAX30101_CurrentSample *samples, uint8_t num_samples) {
+    // Batch unpack straight into the MAX30101_CurrentSample array (stride 2 floats)
+    return MAX30101_ReadBurst(dev, &samples[0].red, &samples[0].ir, 2, num_samples);
+}
+
+/**
+ * @brief Read a burst of NIRS samples into separate Red and IR current arrays
+ * @param dev - [in] Sensor handle
+ * @param red - [out] At least num_samples Red currents (nA)
+ * @param ir - [out] At least num_samples IR currents (nA)
+ * @param num_samples - [in] Samples to read (1-32, at most the number available)
+ * @return I2C_OK, or the I2C error of the FIFO read (arrays unchanged)
+ * @see MAX30101_GetNumAvailableSamples
+ */
+I2C_Status MAX30101_ReadBurstCurrentSoA(const MAX30101_Handle *dev, float32_t *red, float32_t *ir, uint8_t num_samples) {
+    return MAX30101_ReadBurst(dev, red, ir, 1, num_samples);
+}
+
+/**
+ * @brief Change the on-chip sample averaging while sampling
+ * @details Rewrites FIFO_CONFIG with the new SMP_AVE and the profile's rollover bit
+ *          (FIFO_A_FULL stays 0, as in the profile table). Samples already in the FIFO
+ *          keep the previous averaging.
+ * @param dev - [in] Sensor handle
+ * @param avg - Averaging setting
+ * @return I2C_OK, or the I2C error
+ */
+I2C_Status MAX30101_SetSampleAverage(const MAX30101_Handle *dev, MAX30101_SampleAvg avg) {
+    uint8_t value = (uint8_t)((avg << MAX30101_SMP_AVE_Pos) |
+                              (MAX30101_NIRSLiteProfile.fifo_rollover ? MAX30101_FIFO_ROLLOVER_EN : 0));
+    I2C_Status status = MAX30101_Select(dev);
+    if (status == I2C_OK) status = I2C1_Write(dev->addr, FIFO_CONFIG, value);
+    return status;
+}
+
+/**
+ * @brief Change the Red and IR LED drive currents while sampling
+ * @param dev - [in] Sensor handle
+ * @param red_reg - LED1 (Red) register code
+ * @param ir_reg - LED2 (IR) register code
+ * @return I2C_OK, or the I2C error
+ */
+I2C_Status MAX30101_SetLedAmplitudes(const MAX30101_Handle *dev, uint8_t red_reg, uint8_t ir_reg) {
+    uint8_t value[2] = { red_reg, ir_reg };
+    I2C_Status status = MAX30101_Select(dev);
+    if (status == I2C_OK) status = I2C1_WriteBurst(dev->addr, LED1_PAMPLI, value, 2);
+    return status;
+}
+
+/**
+ * @brief Change the ADC full-scale range while sampling
+ * @param dev - [in] Sensor handle
+ * @param range - ADC range
+ * @return I2C_OK, or the I2C error
+ */
+I2C_Status MAX30101_SetAdcRange(const MAX30101_Handle *dev, MAX30101_AdcRange range) {
+    uint8_t value = (uint8_t)((range << MAX30101_ADC_RGE_Pos) |
+                              (MAX30101_NIRSLiteProfile.sample_rate << MAX30101_SR_Pos) |
+                              (MAX30101_NIRSLiteProfile.pulse_width << MAX30101_LED_PW_Pos));
+    I2C_Status status = MAX30101_Select(dev);
+    if (status == I2C_OK) status = I2C1_Write(dev->addr, SPO2_CONFIG, value);
+    return status;
 }
 
+/**
+ * @brief Value a configuration table writes to a register
+ * @param cfg - [in] Register table
+ * @param reg - Register address
+ * @return Value of the last entry for reg, or the power-on value 0x00 if the table does not write it
+ */
+static uint8_t MAX30101_TableValue(const MAX30101_ConfigTable *cfg, uint8_t reg) {
+    uint8_t value = 0x00;
+    for (uint8_t i = 0; i < cfg->count; i++) {
+        if (cfg->entries[i].reg == reg) {
+            value = cfg->entries[i].value;
+        }
+    }
+    return value;
+}
+
+/**
+ * @brief Put a sensor in proximity mode (off-body standby)
+ * @details The profile values are looked up by register address in MAX30101_NIRSLiteConfig,
+ *          so the order of MAX30101_PROFILE_REGS does not matter. A stale PROX_INT is
+ *          cleared first, PROX_INT_EN must be set before the mode write that starts
+ *          proximity mode, and the pointer reset comes last so the FIFO holds only samples
+ *          taken after the wake-up.
+ * @param dev - [in] Sensor handle
+ * @param pilot_reg - Pilot LED register code
+ * @param thresh_reg - Wake-up threshold code
+ * @return I2C_OK, or the error of the first failed transaction
+ */
+I2C_Status MAX30101_EnterProximity(const MAX30101_Handle *dev, uint8_t pilot_reg, uint8_t thresh_reg) {
+    const MAX30101_ConfigTable *profile = &MAX30101_NIRSLiteConfig;
+    uint8_t config[3] = { MAX30101_TableValue(profile, FIFO_CONFIG), MAX30101_TableValue(profile, MODE_CONFIG),
+                          MAX30101_TableValue(profile, SPO2_CONFIG) };
+    uint8_t led[2] = { MAX30101_TableValue(profile, LED1_PAMPLI), MAX30101_TableValue(profile, LED2_PAMPLI) };
+    uint8_t pointers[3] = { 0x00, 0x00, 0x00 };
+    uint8_t stale;
+    I2C_Status status = MAX30101_Select(dev);
+
+    if (status == I2C_OK) status = I2C1_Read(dev->addr, INTR_STATUS1, &stale, 1);
+    if (status == I2C_OK) status = I2C1_Write(dev->addr, PILOT_PA, pilot_reg);
+    if (status == I2C_OK) status = I2C1_Write(dev->addr, PROX_INT_THRESH, thresh_reg);
+    if (status == I2C_OK) status = I2C1_Write(dev->addr, INTR_ENABLE1, MAX30101_INT_PROX);
+    if (status == I2C_OK) status = I2C1_WriteBurst(dev->addr, LED1_PAMPLI, led, 2);
+    if (status == I2C_OK) status = I2C1_WriteBurst(dev->addr, FIFO_CONFIG, config, 3);
+    if (status == I2C_OK) status = I2C1_WriteBurst(dev->addr, FIFO_WRITPTR, pointers, 3);
+    return status;
+}
+
+/**
+ * @brief Disable the proximity interrupt once the sensor has woken up
+ * @param dev - [in] Sensor handle
+ * @return I2C_OK, or the I2C error
+ */
+I2C_Status MAX30101_LeaveProximity(const MAX30101_Handle *dev) {
+    I2C_Status status = MAX30101_Select(dev);
+    if (status == I2C_OK) status = I2C1_Write(dev->addr, INTR_ENABLE1, 0x00);
+    return status;
+}
+
+/**
+ * @brief Read (and thereby clear) INTR_STATUS1
+ * @param dev - [in] Sensor handle
+ * @param status - [out] INTR_STATUS1
+ * @return I2C_OK, or the I2C error
+ */
+I2C_Status MAX30101_ReadInterruptStatus1(const MAX30101_Handle *dev, uint8_t *status) {
+    I2C_Status result = MAX30101_Select(dev);
+    if (result == I2C_OK) result = I2C1_Read(dev->addr, INTR_STATUS1, status, 1);
+    return result;
+}
+
+/**
+ * @brief FIFO output rate of a profile
+ * @param profile - [in] Profile
+ * @return Output rate (Hz)
+ */
+float32_t MAX30101_OutputRateHz(const MAX30101_Profile *profile) {
+    static const uint16_t rate_hz[] = { 50, 100, 200, 400, 800, 1000, 1600, 3200 };
+    return (float32_t)rate_hz[profile->sample_rate & 0x07u] / (float32_t)(1u << profile->sample_avg);
+}
+
+/**
+ * @brief Trigger a die temperature conversion (non-blocking)
+ * @details Writes TEMP_EN to DIE_TEMPCFG. The conversion runs in parallel with the
+ *          optical measurement and TEMP_EN self-clears when the result is ready.
+ * @param dev - [in] Sensor handle
+ * @return I2C_OK, or the I2C error
+ * @see MAX30101_PollTemperature
+ */
+I2C_Status MAX30101_StartTemperature(const MAX30101_Handle *dev) {
+    I2C_Status status = MAX30101_Select(dev);
+    if (status == I2C_OK) status = I2C1_Write(dev->addr, DIE_TEMPCFG, MAX30101_TEMP_EN);
+    return status;
+}
+
+/**
+ * @brief Fetch a die temperature result if the conversion has finished (non-blocking)
+ * @details Reads DIE_TEMPINT (0x1F, two's complement °C), DIE_TEMPFRC (0x20, 0.0625 °C
+ *          steps in bits [3:0]) and DIE_TEMPCFG (0x21) in one burst. If TEMP_EN is still
+ *          set the conversion is in progress and ready is 0; nothing waits.
+ * @param dev - [in] Sensor handle
+ * @param ready - [out] 1 if deg_c holds a new result
+ * @param deg_c - [out] Die temperature in °C
+ * @return I2C_OK, or the I2C error
+ */
+I2C_Status MAX30101_PollTemperature(const MAX30101_Handle *dev, uint8_t *ready, float32_t *deg_c) {
+    uint8_t temp_regs[3]; // [0] = DIE_TEMPINT, [1] = DIE_TEMPFRC, [2] = DIE_TEMPCFG
+    I2C_Status status = MAX30101_Select(dev);
+
+    *ready = 0;
+    if (status == I2C_OK) status = I2C1_Read(dev->addr, DIE_TEMPINT, temp_regs, 3);
+    if (status != I2C_OK || (temp_regs[2] & MAX30101_TEMP_EN)) {
+        return status;
+    }
+    *deg_c = (float32_t)(int8_t)temp_regs[0] + (float32_t)(temp_regs[1] & 0x0F) * MAX30101_TEMP_FRAC_DEGC;
+    *ready = 1;
+    return I2C_OK;
+}
@@ -17,8 +17,11 @@
 
 #include <stdint.h>
 #include "arm_math_types.h"
+#include "I2C.h"
 
-#define		SENSOR_ADDR 		0xAE
+#define		SENSOR_ADDR 		0xAE  /**< Fixed MAX30101 I2C address (8-bit form); multiple sensors need an I2C mux */
+#define		MUX_ADDR_NONE		0x00  /**< Handle mux_addr value for a sensor wired directly to the bus */
+#define		MUX_ADDR_TCA9548A	0xE0  /**< Default TCA9548A 8-channel I2C mux address (7-bit 0x70, 8-bit form) */
 
 #define		INTR_STATUS1		0x00
 #define		INTR_STATUS2		0x01
@@ -36,19 +39,183 @@
 #define     LED2_PAMPLI			0x0D
 #define     LED3_PAMPLI			0x0E
 #define     LED4_PAMPLI			0x0F
+#define     PILOT_PA			0x10
 #define     MLED_CONFG1			0x11
 #define     MLED_CONFG2			0x12
 #define     DIE_TEMPINT			0x1F
 #define     DIE_TEMPFRC			0x20
 #define     DIE_TEMPCFG			0x21
+#define     PROX_INT_THRESH		0x30
 
 #define     BUFFERBLOCKSIZE     0x8
+#define     MAX30101_FIFO_DEPTH 32          /**< Number of samples held by the on-chip FIFO */
+#define     MAX30101_BYTES_PER_SAMPLE 6     /**< FIFO bytes per Red/IR sample (2 channels x 3 bytes) */
 #define     MAX30101_ADC_VREF   3.3f        /**< ADC reference voltage in volts */
 #define     MAX30101_ADC_BITS   18          /**< ADC resolution in bits */
 #define     MAX30101_ADC_MAX    ((1 << MAX30101_ADC_BITS) - 1)  /**< Max ADC count (262143 for 18-bit) */
 #define     MAX30101_CURRENT_LSB_PA  15.625f  /**< LSB size in picoamps (pA): 4096 nA / 2^18 */
 #define     MAX30101_CURRENT_LSB_NA  (MAX30101_CURRENT_LSB_PA / 1000.0f)  /**< LSB size in nanoamps (nA) */
 #define     MAX30101_CURRENT_FULLSCALE  4096.0f  /**< Full scale current range in nanoamps (nA) */
+#define     MAX30101_ADC_MASK           0x3FFFFu /**< 18-bit ADC count mask */
+
+/* INTR_STATUS1 (0x00) / INTR_ENABLE1 (0x02) fields */
+#define     MAX30101_INT_PROX           (1 << 4)    /**< Proximity threshold crossed (PROX_INT / PROX_INT_EN) */
+/* FIFO_CONFIG (0x08) fields */
+#define     MAX30101_SMP_AVE_Pos        5           /**< Sample averaging, bits [7:5] */
+#define     MAX30101_FIFO_ROLLOVER_EN   (1 << 4)    /**< FIFO rolls over when full */
+/* MODE_CONFIG (0x09) fields */
+#define     MAX30101_MODE_SHDN          (1 << 7)    /**< Power-save shutdown */
+#define     MAX30101_MODE_RESET         (1 << 6)    /**< Power-on reset (self-clearing) */
+/* SPO2_CONFIG (0x0A) fields */
+#define     MAX30101_ADC_RGE_Pos        5           /**< ADC full-scale range, bits [6:5] */
+#define     MAX30101_SR_Pos             2           /**< Sample rate, bits [4:2] */
+#define     MAX30101_LED_PW_Pos         0           /**< LED pulse width / ADC resolution, bits [1:0] */
+
+/* DIE_TEMPCFG (0x21) fields */
+#define     MAX30101_TEMP_EN            (1 << 0)    /**< Start one die temperature conversion (self-clearing) */
+#define     MAX30101_TEMP_FRAC_DEGC     0.0625f     /**< DIE_TEMPFRC LSB (°C) */
+#define     MAX30101_TEMP_CONV_MS       29          /**< Typical die temperature conversion time (ms) */
+
+/** LED drive current in mA to LEDx_PA register code (0.2 mA steps, 0-51 mA) */
+#define     MAX30101_LED_MA_TO_REG(ma)  ((uint8_t)((ma) / 0.2f))
+/** LEDx_PA register code to LED drive current in mA */
+#define     MAX30101_LED_REG_TO_MA(reg) ((float32_t)(reg) * 0.2f)
+/** ADC full-scale current (nA) of a MAX30101_AdcRange setting */
+#define     MAX30101_RANGE_FULLSCALE_NA(range)  (2048.0f * (float32_t)(1u << (range)))
+/** IR current (nA) to PROX_INT_THRESH code in a MAX30101_AdcRange (8 MSBs of the ADC count) */
+#define     MAX30101_PROX_NA_TO_REG(na, range)  ((uint8_t)((na) * 256.0f / MAX30101_RANGE_FULLSCALE_NA(range)))
+
+/** @brief On-chip sample averaging (FIFO_CONFIG SMP_AVE) */
+typedef enum {
+    MAX30101_SMP_AVE_1 = 0,     /**< No averaging */
+    MAX30101_SMP_AVE_2,         /**< 2 samples averaged per FIFO sample */
+    MAX30101_SMP_AVE_4,         /**< 4 samples averaged per FIFO sample */
+    MAX30101_SMP_AVE_8,         /**< 8 samples averaged per FIFO sample */
+    MAX30101_SMP_AVE_16,        /**< 16 samples averaged per FIFO sample */
+    MAX30101_SMP_AVE_32         /**< 32 samples averaged per FIFO sample */
+} MAX30101_SampleAvg;
+
+/** @brief Operating mode (MODE_CONFIG MODE[2:0]) */
+typedef enum {
+    MAX30101_MODE_HR = 0x02,        /**< Heart-rate mode: Red only */
+    MAX30101_MODE_SPO2 = 0x03,      /**< SpO2 mode: Red + IR */
+    MAX30101_MODE_MULTI_LED = 0x07  /**< Multi-LED mode: slots from MLED_CONFG1/2 */
+} MAX30101_Mode;
+
+/** @brief ADC full-scale range (SPO2_CONFIG ADC_RGE) */
+typedef enum {
+    MAX30101_ADC_RGE_2048NA = 0,    /**< 2048 nA full scale (7.81 pA LSB) */
+    MAX30101_ADC_RGE_4096NA,        /**< 4096 nA full scale (15.63 pA LSB) */
+    MAX30101_ADC_RGE_8192NA,        /**< 8192 nA full scale (31.25 pA LSB) */
+    MAX30101_ADC_RGE_16384NA        /**< 16384 nA full scale (62.5 pA LSB) */
+} MAX30101_AdcRange;
+
+/** @brief ADC sample rate (SPO2_CONFIG SR) */
+typedef enum {
+    MAX30101_SR_50HZ = 0,
+    MAX30101_SR_100HZ,
+    MAX30101_SR_200HZ,
+    MAX30101_SR_400HZ,
+    MAX30101_SR_800HZ,
+    MAX30101_SR_1000HZ,
+    MAX30101_SR_1600HZ,
+    MAX30101_SR_3200HZ
+} MAX30101_SampleRate;
+
+/** @brief LED pulse width and ADC resolution (SPO2_CONFIG LED_PW) */
+typedef enum {
+    MAX30101_PW_69US = 0,       /**< 69 µs, 15-bit */
+    MAX30101_PW_118US,          /**< 118 µs, 16-bit */
+    MAX30101_PW_215US,          /**< 215 µs, 17-bit */
+    MAX30101_PW_411US           /**< 411 µs, 18-bit */
+} MAX30101_PulseWidth;
+
+/**
+ * @struct MAX30101_Profile
+ * @brief Typed sensor configuration profile
+ * @details Declared through a profile argument list (see MAX30101_PROFILE_NIRS_LITE) so the
+ *          same definition yields both this struct and its register table at compile time.
+ */
+typedef struct {
+    MAX30101_SampleAvg  sample_avg;     /**< On-chip averaging */
+    uint8_t             fifo_rollover;  /**< 1 = FIFO rolls over when full */
+    MAX30101_Mode       mode;           /**< Operating mode */
+    MAX30101_AdcRange   adc_range;      /**< ADC full-scale range */
+    MAX30101_SampleRate sample_rate;    /**< ADC sample rate */
+    MAX30101_PulseWidth pulse_width;    /**< LED pulse width / resolution */
+    float32_t           led_red_ma;     /**< LED1 (Red) drive current in mA */
+    float32_t           led_ir_ma;      /**< LED2 (IR) drive current in mA */
+} MAX30101_Profile;
+
+/**
+ * @struct MAX30101_RegEntry
+ * @brief One register write of a configuration table
+ */
+typedef struct {
+    uint8_t reg;            /**< Register address */
+    uint8_t value;          /**< Value to write */
+    uint8_t verify_mask;    /**< Bits compared on read-back (0 = not verified, e.g. FIFO pointers) */
+} MAX30101_RegEntry;
+
+/**
+ * @struct MAX30101_ConfigTable
+ * @brief Register/value list applied by MAX30101_ApplyConfig()
+ * @details Entries are written in table order; runs of consecutive register addresses
+ *          are coalesced into single auto-increment burst writes.
+ */
+typedef struct {
+    const MAX30101_RegEntry *entries;   /**< Register writes, in application order */
+    uint8_t count;                      /**< Number of entries */
+} MAX30101_ConfigTable;
+
+/** Expand a profile argument list into a profile macro (m args) */
+#define     MAX30101_PROFILE_APPLY(m, args)     m args
+
+/** Profile argument list → MAX30101_Profile initializer */
+#define     MAX30101_PROFILE_INIT(avg, rollover, mode, range, rate, pw, red_ma, ir_ma) \
+    { (avg), (rollover), (mode), (range), (rate), (pw), (red_ma), (ir_ma) }
+
+/**
+ * Profile argument list → MAX30101_RegEntry table initializer
+ * Order: FIFO/mode/SpO2 config (one 3-byte burst), LED amplitudes (one 2-byte burst),
+ * then FIFO pointer reset last (one 3-byte burst) so samples taken while the
+ * configuration was incomplete are discarded.
+ */
+#define     MAX30101_PROFILE_REGS(avg, rollover, mode, range, rate, pw, red_ma, ir_ma) { \
+    { FIFO_CONFIG,  (uint8_t)(((avg) << MAX30101_SMP_AVE_Pos) | ((rollover) ? MAX30101_FIFO_ROLLOVER_EN : 0)), 0xFF }, \
+    { MODE_CONFIG,  (uint8_t)(mode), (uint8_t)~MAX30101_MODE_RESET }, \
+    { SPO2_CONFIG,  (uint8_t)(((range) << MAX30101_ADC_RGE_Pos) | ((rate) << MAX30101_SR_Pos) | ((pw) << MAX30101_LED_PW_Pos)), 0x7F }, \
+    { LED1_PAMPLI,  MAX30101_LED_MA_TO_REG(red_ma), 0xFF }, \
+    { LED2_PAMPLI,  MAX30101_LED_MA_TO_REG(ir_ma), 0xFF }, \
+    { FIFO_WRITPTR, 0x00, 0x00 }, \
+    { OVRF_COUNTER, 0x00, 0x00 }, \
+    { FIFO_READPTR, 0x00, 0x00 } }
+
+/**
+ * NIRS Lite profile: SpO2 mode (Red + IR), no averaging, FIFO rollover,
+ * 4096 nA range, 50 Hz, 411 µs (18-bit), 10 mA per LED
+ */
+#define     MAX30101_PROFILE_NIRS_LITE \
+    (MAX30101_SMP_AVE_1, 1, MAX30101_MODE_SPO2, MAX30101_ADC_RGE_4096NA, MAX30101_SR_50HZ, MAX30101_PW_411US, 10.0f, 10.0f)
+
+extern const MAX30101_Profile MAX30101_NIRSLiteProfile;     /**< NIRS Lite profile (typed) */
+extern const MAX30101_ConfigTable MAX30101_NIRSLiteConfig;  /**< NIRS Lite profile (register table) */
+
+/**
+ * @struct MAX30101_Handle
+ * @brief Device handle for one MAX30101 on the I2C1 bus
+ * @details The MAX30101 address is fixed, so several sensors share the bus through
+ *          an I2C mux (TCA9548A-style: one control byte selects the downstream channel).
+ *          A sensor wired directly to the bus uses mux_addr = MUX_ADDR_NONE.
+ *          The id is carried with every sample drained by the acquisition scheduler.
+ * @see Acquisition_Init
+ */
+typedef struct {
+    uint8_t id;          /**< Sensor ID tagged onto every acquired sample */
+    uint8_t addr;        /**< Sensor I2C address (8-bit form, normally SENSOR_ADDR) */
+    uint8_t mux_addr;    /**< I2C mux address (8-bit form), MUX_ADDR_NONE if not muxed */
+    uint8_t mux_channel; /**< Mux downstream channel (0-7) the sensor is wired to */
+} MAX30101_Handle;
 
 /**
  * @struct MAX30101_Sample
@@ -84,30 +251,48 @@ typedef struct {
     float32_t ir;        /**< IR current (0–4096 nA) */
 } MAX30101_CurrentSample;
 
+/**
+ * @brief Apply a configuration table with burst writes and burst read-back verification
+ * @details Consecutive register addresses are coalesced into one auto-increment write;
+ *          every run is then read back in one burst and compared under verify_mask.
+ * @param dev - Sensor handle
+ * @param cfg - Register table (e.g. MAX30101_NIRSLiteConfig)
+ * @param mismatches - [out] Number of registers that failed verification (may be NULL)
+ * @return I2C_OK, or the error of the first failed transaction
+ */
+I2C_Status MAX30101_ApplyConfig(const MAX30101_Handle *dev, const MAX30101_ConfigTable *cfg, uint8_t *mismatches);
+
 /**
  * @brief Initialize MAX30101 for NIRS muscle oxygenation (dual-LED: Red + IR)
- * @details Configures sensor for blood oxygen measurement with low power consumption.
- *          Sample rate: 50 Hz, FIFO rollover enabled, configurable LED power.
- * @param ledPower_red - Red LED current value (0.0 to 51 mA range)
- * @param ledPower_ir - IR LED current value (0.0 to 51 mA range)
- * @note Call once at startup before MAX30101_ReadSingleCurrent()
- * @see MAX30101_InitNIRSLite, MAX30101_ReadSingleCurrent
+ * @details Applies MAX30101_NIRSLiteConfig: SpO2 mode, 50 Hz, 18-bit, 4096 nA range,
+ *          FIFO rollover enabled, 10 mA per LED.
+ * @param dev - Sensor handle
+ * @param mismatches - [out] Number of registers that failed read-back verification (may be NULL)
+ * @return I2C_OK, or the error of the first failed transaction
+ * @note Call once at startup before MAX30101_ReadSingleCurrent(). The sensor is configured
+ *       as intended only when the result is I2C_OK and mismatches is 0.
+ * @see MAX30101_ApplyConfig, MAX30101_PROFILE_NIRS_LITE
  * @example
- *   MAX30101_InitNIRSLite(1.6f, 1.6f);  // 1.6 mA per LED for low power operation
+ *   uint8_t bad;
+ *   if (MAX30101_InitNIRSLite(&sensor, &bad) != I2C_OK || bad != 0) { ... }
  */
-void MAX30101_InitNIRSLite(float32_t ledPower_red, float32_t ledPower_ir);
+I2C_Status MAX30101_InitNIRSLite(const MAX30101_Handle *dev, uint8_t *mismatches);
 
 /**
  * @brief Get number of available samples in FIFO
- * @return Number of unread samples (0-32)
+ * @param dev - Sensor handle
+ * @param num_samples - [out] Number of unread samples (0-32), 0 on error
+ * @return I2C_OK, or the I2C error of the pointer read
  */
-uint8_t MAX30101_GetNumAvailableSamples(void);
+I2C_Status MAX30101_GetNumAvailableSamples(const MAX30101_Handle *dev, uint8_t *num_samples);
 
 /**
  * @brief Update FIFO read pointer
+ * @param dev - Sensor handle
  * @param num_samples Number of samples to advance read pointer
+ * @return I2C_OK, or the I2C error
  */
-void MAX30101_UpdateReadPointer(uint8_t num_samples);
+I2C_Status MAX30101_UpdateReadPointer(const MAX30101_Handle *dev, uint8_t num_samples);
 /**
  * @brief Convert raw NIRS sample bytes to 32-bit ADC counts
  * @param sample_in Pointer to MAX30101_Sample with raw byte data
@@ -122,21 +307,163 @@ void MAX30101_ConvertSampleToUint32(MAX30101_Sample *sample_in, MAX30101_DataSam
  */
 void MAX30101_ConvertUint32ToCurrent(MAX30101_DataSample *sample_in, MAX30101_CurrentSample *sample_out);
 
+/**
+ * @brief Unpack a FIFO burst into SoA arrays of 18-bit ADC counts
+ * @details Two samples per step from three big-endian words (LDR + REV on Cortex-M4,
+ *          portable byte loads elsewhere).
+ * @param fifo - [in] num_samples × 6 bytes as read from FIFO_DATA
+ * @param red - [out] Red counts
+ * @param ir - [out] IR counts
+ * @param num_samples - Number of samples
+ */
+void MAX30101_UnpackBurstCounts(const uint8_t *fifo, uint32_t *red, uint32_t *ir, uint32_t num_samples);
+
+/**
+ * @brief Unpack a FIFO burst into currents in nA
+ * @param fifo - [in] num_samples × 6 bytes as read from FIFO_DATA
+ * @param red - [out] Red current, element i at red[i * stride]
+ * @param ir - [out] IR current, element i at ir[i * stride]
+ * @param stride - Output stride in elements: 1 for SoA arrays, 2 for a MAX30101_CurrentSample
+ *                 array (red = &s[0].red, ir = &s[0].ir)
+ * @param num_samples - Number of samples
+ */
+void MAX30101_UnpackBurstCurrent(const uint8_t *fifo, float32_t *red, float32_t *ir,
+                                 uint32_t stride, uint32_t num_samples);
+
 /**
  * @brief Read single NIRS sample from FIFO as 32-bit ADC counts
  * @details Optimized single-sample read returning raw ADC values (0-4294967295)
+ * @param dev - Sensor handle
  * @param sample - [out] MAX30101_DataSample with 32-bit ADC counts
+ * @return I2C_OK, or the I2C error of the FIFO read
  * @see MAX30101_GetNumAvailableSamples to check for available data
  */
-void MAX30101_ReadSingleData(MAX30101_DataSample *sample);
+I2C_Status MAX30101_ReadSingleData(const MAX30101_Handle *dev, MAX30101_DataSample *sample);
 
 /**
  * @brief Read single NIRS sample from FIFO with current conversion
  * @details Optimized single-sample read converting 4 bytes directly to nanoamps
+ * @param dev - Sensor handle
  * @param sample - [out] MAX30101_CurrentSample (Red, IR nA values)
+ * @return I2C_OK, or the I2C error of the FIFO read
+ * @see MAX30101_GetNumAvailableSamples to check for available data
+ */
+I2C_Status MAX30101_ReadSingleCurrentData(const MAX30101_Handle *dev, MAX30101_CurrentSample *sample);
+
+/**
+ * @brief Read a burst of NIRS samples from FIFO with current conversion
+ * @details Reads num_samples × 6 bytes in one I2C transaction. The sensor advances its
+ *          FIFO read pointer on every FIFO_DATA byte, so no pointer update is needed.
+ * @param dev - Sensor handle
+ * @param samples - [out] Array of at least num_samples MAX30101_CurrentSample
+ * @param num_samples - Number of samples to read (1-32, must not exceed available)
+ * @return I2C_OK, or the I2C error of the FIFO read
  * @see MAX30101_GetNumAvailableSamples to check for available data
  */
-void MAX30101_ReadSingleCurrentData(MAX30101_CurrentSample *sample);
+I2C_Status MAX30101_ReadBurstCurrentData(const MAX30101_Handle *dev, MAX30101_CurrentSample *samples, uint8_t num_samples);
+
+/**
+ * @brief Read a burst of NIRS samples from FIFO into separate Red and IR arrays
+ * @details Same transaction as MAX30101_ReadBurstCurrentData(); the FIFO bytes are
+ *          unpacked straight into the two arrays (e.g. the channel rows of a SampleBlock).
+ * @param dev - Sensor handle
+ * @param red - [out] At least num_samples Red currents (nA)
+ * @param ir - [out] At least num_samples IR currents (nA)
+ * @param num_samples - Number of samples to read (1-32, must not exceed available)
+ * @return I2C_OK, or the I2C error of the FIFO read
+ */
+I2C_Status MAX30101_ReadBurstCurrentSoA(const MAX30101_Handle *dev, float32_t *red, float32_t *ir, uint8_t num_samples);
+
+/**
+ * @brief Change the on-chip sample averaging (FIFO_CONFIG SMP_AVE) while sampling
+ * @details One register write; FIFO rollover is kept as in MAX30101_NIRSLiteProfile.
+ *          The FIFO output rate becomes the ADC sample rate divided by 2^avg.
+ * @param dev - Sensor handle
+ * @param avg - Averaging setting
+ * @return I2C_OK, or the I2C error
+ */
+I2C_Status MAX30101_SetSampleAverage(const MAX30101_Handle *dev, MAX30101_SampleAvg avg);
+
+/**
+ * @brief Change the Red and IR LED drive currents while sampling
+ * @details One 2-byte burst write to LED1_PA/LED2_PA.
+ * @param dev - Sensor handle
+ * @param red_reg - LED1 (Red) register code (0.2 mA steps)
+ * @param ir_reg - LED2 (IR) register code (0.2 mA steps)
+ * @return I2C_OK, or the I2C error
+ */
+I2C_Status MAX30101_SetLedAmplitudes(const MAX30101_Handle *dev, uint8_t red_reg, uint8_t ir_reg);
+
+/**
+ * @brief Change the ADC full-scale range while sampling
+ * @details One register write to SPO2_CONFIG; sample rate and pulse width are kept as in
+ *          MAX30101_NIRSLiteProfile. The burst readers convert with the 4096 nA LSB, so
+ *          samples taken in another range must be scaled by
+ *          MAX30101_RANGE_FULLSCALE_NA(range) / MAX30101_CURRENT_FULLSCALE.
+ * @param dev - Sensor handle
+ * @param range - ADC range
+ * @return I2C_OK, or the I2C error
+ */
+I2C_Status MAX30101_SetAdcRange(const MAX30101_Handle *dev, MAX30101_AdcRange range);
+
+/**
+ * @brief Put a sensor in proximity mode (off-body standby)
+ * @details Restores the profile averaging, ADC range and LED currents, arms PROX_INT with
+ *          the pilot LED and threshold, rewrites MODE_CONFIG (which starts proximity mode)
+ *          and resets the FIFO pointers. Only the IR pilot pulses and no samples are stored
+ *          until the IR current exceeds the threshold; the sensor then returns to the
+ *          profile mode by itself and sets PROX_INT in INTR_STATUS1.
+ *          Seven transactions, 12 register bytes.
+ * @param dev - Sensor handle
+ * @param pilot_reg - Pilot LED register code (0.2 mA steps)
+ * @param thresh_reg - Wake-up threshold (MAX30101_PROX_NA_TO_REG)
+ * @return I2C_OK, or the error of the first failed transaction
+ * @see MAX30101_ReadInterruptStatus1, MAX30101_LeaveProximity
+ */
+I2C_Status MAX30101_EnterProximity(const MAX30101_Handle *dev, uint8_t pilot_reg, uint8_t thresh_reg);
+
+/**
+ * @brief Disable the proximity interrupt once the sensor has woken up
+ * @param dev - Sensor handle
+ * @return I2C_OK, or the I2C error
+ */
+I2C_Status MAX30101_LeaveProximity(const MAX30101_Handle *dev);
+
+/**
+ * @brief Read (and thereby clear) INTR_STATUS1
+ * @param dev - Sensor handle
+ * @param status - [out] INTR_STATUS1 (MAX30101_INT_PROX, ...)
+ * @return I2C_OK, or the I2C error
+ */
+I2C_Status MAX30101_ReadInterruptStatus1(const MAX30101_Handle *dev, uint8_t *status);
+
+/**
+ * @brief FIFO output rate of a profile
+ * @details ADC sample rate divided by the on-chip averaging (2^sample_avg).
+ * @param profile - [in] Profile
+ * @return Output rate (Hz)
+ */
+float32_t MAX30101_OutputRateHz(const MAX30101_Profile *profile);
+
+/**
+ * @brief Trigger a die temperature conversion (non-blocking)
+ * @details Sets TEMP_EN; the result is available ~29 ms later while sampling continues.
+ * @param dev - Sensor handle
+ * @return I2C_OK, or the I2C error
+ * @see MAX30101_PollTemperature
+ */
+I2C_Status MAX30101_StartTemperature(const MAX30101_Handle *dev);
+
+/**
+ * @brief Fetch a die temperature result if the conversion has finished (non-blocking)
+ * @details One 3-byte burst read of DIE_TEMPINT, DIE_TEMPFRC and DIE_TEMPCFG.
+ *          The conversion is complete once TEMP_EN has self-cleared.
+ * @param dev - Sensor handle
+ * @param ready - [out] 1 if deg_c holds a new result, 0 if still converting
+ * @param deg_c - [out] Die temperature in °C (valid when ready = 1)
+ * @return I2C_OK, or the I2C error (ready = 0)
+ */
+I2C_Status MAX30101_PollTemperature(const MAX30101_Handle *dev, uint8_t *ready, float32_t *deg_c);
 
 /** @brief First-order IIR DC-Blocker filter function
  * @details Implements a simple first-order IIR high-pass filter to remove DC offset from the raw current samples.
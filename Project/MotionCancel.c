@@ -0,0 +1,97 @@
+/**
+ * @file MotionCancel.c
+ * @brief Adaptive motion-artifact cancellation implementation
+ * @details Normalized LMS canceller (arm_lms_norm_f32) and motion reference generator.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "MotionCancel.h"
+#include "MAX30101.h"
+#include "arm_math.h"
+#include <stdint.h>
+
+/**
+ * @brief Initialize a canceller with zero weights
+ * @param mc - [out] Canceller
+ * @param mu - Normalized step size
+ * @return void
+ */
+void Motion_Init(Motion_Canceller *mc, float32_t mu) {
+    for (uint32_t i = 0; i < MOTION_NUM_TAPS; i++) {
+        mc->coeffs[i] = 0.0f;
+    }
+    // arm_lms_norm_init_f32 clears the state buffer
+    arm_lms_norm_init_f32(&mc->lms, MOTION_NUM_TAPS, mc->coeffs, mc->state, mu, MOTION_MAX_BLOCK);
+}
+
+/**
+ * @brief Initialize a reference generator at the given DC levels
+ * @param ref - [out] Reference generator
+ * @param red_dc - Initial Red DC level (nA)
+ * @param ir_dc - Initial IR DC level (nA)
+ * @return void
+ */
+void Motion_ReferenceInit(Motion_Reference *ref, float32_t red_dc, float32_t ir_dc) {
+    ref->red_dc = red_dc;
+    ref->ir_dc = ir_dc;
+    ref->w_hp = 0.0f;
+    ref->lp = 0.0f;
+}
+
+/**
+ * @brief Compute the next motion reference sample from raw Red/IR currents
+ * @details
+ *  1. Track each channel's DC with a slow one-pole average
+ *  2. Common mode of the normalized intensities: red/red_dc + ir/ir_dc
+ *  3. DC blocker (MOTION_REF_HP_ALPHA) removes the slow hemodynamic band
+ *  4. One-pole low-pass (MOTION_REF_LP_ALPHA) limits the reference to the motion band
+ * @param ref - [in,out] Reference generator
+ * @param red - Raw Red current (nA)
+ * @param ir - Raw IR current (nA)
+ * @return Motion reference sample
+ */
+float32_t Motion_ReferenceUpdate(Motion_Reference *ref, float32_t red, float32_t ir) {
+    ref->red_dc += (1.0f - MOTION_REF_DC_ALPHA) * (red - ref->red_dc);
+    ref->ir_dc  += (1.0f - MOTION_REF_DC_ALPHA) * (ir - ref->ir_dc);
+    if (ref->red_dc <= 0.0f || ref->ir_dc <= 0.0f) {
+        return 0.0f;
+    }
+    float32_t common = red / ref->red_dc + ir / ref->ir_dc;
+    float32_t hp = MAX30101_FirstOrderDC_Blocker(common, &ref->w_hp, MOTION_REF_HP_ALPHA);
+    ref->lp += MOTION_REF_LP_ALPHA * (hp - ref->lp);
+    return ref->lp;
+}
+
+/**
+ * @brief Cancel the reference-correlated component from a block of samples
+ * @details Runs arm_lms_norm_f32 with the motion reference as input and the channel as
+ *          desired signal; the NLMS error output is the cleaned channel.
+ *
+ *          arm_lms_norm_f32 keeps the window energy as a running sum (add the newest
+ *          square, subtract the oldest). Its float rounding error does not decay: once the
+ *          motion stops and the true energy falls below it, the sum goes negative and the
+ *          normalized step explodes. The energy is therefore recomputed from the delay line
+ *          before every block (MOTION_NUM_TAPS multiply-adds).
+ * @param mc - [in,out] Canceller
+ * @param primary - [in] High-passed channel samples (nA)
+ * @param reference - [in] Motion reference samples
+ * @param out - [out] Cleaned samples
+ * @param block_size - Number of samples (1 to MOTION_MAX_BLOCK)
+ * @return void
+ */
+void Motion_Cancel(Motion_Canceller *mc, const float32_t *primary, const float32_t *reference,
+                   float32_t *out, uint32_t block_size) {
+    float32_t estimate[MOTION_MAX_BLOCK];
+    if (block_size > MOTION_MAX_BLOCK) {
+        block_size = MOTION_MAX_BLOCK;
+    }
+    // Window at entry: the sample leaving next (x0) and the newest MOTION_NUM_TAPS - 1 inputs
+    float32_t energy = mc->lms.x0 * mc->lms.x0;
+    for (uint32_t i = 0; i < MOTION_NUM_TAPS - 1u; i++) {
+        energy += mc->state[i] * mc->state[i];
+    }
+    mc->lms.energy = energy;
+    arm_lms_norm_f32(&mc->lms, reference, (float32_t *)primary, estimate, out, block_size);
+}
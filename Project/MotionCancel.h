@@ -0,0 +1,103 @@
+/**
+ * @file MotionCancel.h
+ * @brief Adaptive motion-artifact cancellation (normalized LMS, CMSIS-DSP)
+ * @details Removes from each high-passed Red/IR channel the component that is linearly
+ *          correlated with a motion reference, using arm_lms_norm_f32:
+ *
+ *          y[n] = wᵀ·r[n]          (artifact estimate from the last MOTION_NUM_TAPS reference samples)
+ *          e[n] = x[n] - y[n]      (cleaned output)
+ *          w   += μ·e[n]·r[n] / (rᵀr)
+ *
+ * ### Motion Reference
+ *  Movement changes the optical coupling of both LEDs by roughly the same relative
+ *  amount, while muscle hemodynamics moves Red and IR differently and mostly below
+ *  0.1 Hz. The reference is therefore the normalized common-mode intensity
+ *  red/red_dc + ir/ir_dc, band-limited to the motion band:
+ *  - high-pass (first-order DC blocker, MOTION_REF_HP_ALPHA, fc ≈ 0.4 Hz at 50 Hz)
+ *    so slow hemodynamic trends are not part of the reference
+ *  - low-pass (first-order, MOTION_REF_LP_ALPHA, fc ≈ 5 Hz at 50 Hz) against noise
+ *
+ * ### Cost
+ *  - Fixed per sample: ~2·MOTION_NUM_TAPS MACs + one normalization divide per channel,
+ *    independent of signal content (no data-dependent branches)
+ *  - Memory: (2·MOTION_NUM_TAPS + MOTION_MAX_BLOCK - 1) floats per channel
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see arm_lms_norm_f32
+ */
+
+#ifndef MOTIONCANCEL_H_
+#define MOTIONCANCEL_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+
+#define     MOTION_NUM_TAPS         8       /**< NLMS filter length (160 ms at 50 Hz) */
+#define     MOTION_MAX_BLOCK        8       /**< Largest block size accepted by Motion_Cancel() */
+#define     MOTION_MU               0.05f   /**< Normalized step size (0 < μ < 2; small = slow, stable) */
+#define     MOTION_REF_DC_ALPHA     0.995f  /**< DC tracker for reference normalization (fc ≈ 0.04 Hz at 50 Hz) */
+#define     MOTION_REF_HP_ALPHA     0.95f   /**< Reference high-pass DC blocker (fc ≈ 0.4 Hz at 50 Hz) */
+#define     MOTION_REF_LP_ALPHA     0.47f   /**< Reference low-pass smoothing, 1 - exp(-2π·5/50) (fc ≈ 5 Hz) */
+
+/**
+ * @struct Motion_Canceller
+ * @brief NLMS canceller state for one channel
+ */
+typedef struct {
+    arm_lms_norm_instance_f32 lms;                              /**< CMSIS-DSP NLMS instance */
+    float32_t coeffs[MOTION_NUM_TAPS];                          /**< Adaptive weights */
+    float32_t state[MOTION_NUM_TAPS + MOTION_MAX_BLOCK - 1];    /**< Reference delay line */
+} Motion_Canceller;
+
+/**
+ * @struct Motion_Reference
+ * @brief Motion reference generator state (one per sensor)
+ */
+typedef struct {
+    float32_t red_dc;       /**< Tracked Red DC level (nA) */
+    float32_t ir_dc;        /**< Tracked IR DC level (nA) */
+    float32_t w_hp;         /**< High-pass DC blocker state */
+    float32_t lp;           /**< Low-pass output state */
+} Motion_Reference;
+
+/**
+ * @brief Initialize a canceller with zero weights
+ * @param mc - [out] Canceller
+ * @param mu - Normalized step size (e.g. MOTION_MU)
+ * @return void
+ */
+void Motion_Init(Motion_Canceller *mc, float32_t mu);
+
+/**
+ * @brief Initialize a reference generator at the given DC levels
+ * @param ref - [out] Reference generator
+ * @param red_dc - Initial Red DC level (nA, > 0)
+ * @param ir_dc - Initial IR DC level (nA, > 0)
+ * @return void
+ */
+void Motion_ReferenceInit(Motion_Reference *ref, float32_t red_dc, float32_t ir_dc);
+
+/**
+ * @brief Compute the next motion reference sample from raw Red/IR currents
+ * @param ref - [in,out] Reference generator
+ * @param red - Raw Red current (nA)
+ * @param ir - Raw IR current (nA)
+ * @return Band-limited normalized common-mode intensity (dimensionless)
+ */
+float32_t Motion_ReferenceUpdate(Motion_Reference *ref, float32_t red, float32_t ir);
+
+/**
+ * @brief Cancel the reference-correlated component from a block of samples
+ * @param mc - [in,out] Canceller
+ * @param primary - [in] High-passed channel samples (nA)
+ * @param reference - [in] Motion reference samples (same length)
+ * @param out - [out] Cleaned samples (may alias primary)
+ * @param block_size - Number of samples (1 to MOTION_MAX_BLOCK)
+ * @return void
+ */
+void Motion_Cancel(Motion_Canceller *mc, const float32_t *primary, const float32_t *reference,
+                   float32_t *out, uint32_t block_size);
+
+#endif /* MOTIONCANCEL_H_ */
@@ -0,0 +1,256 @@
+/**
+ * @file Occlusion.c
+ * @brief Streaming occlusion / reperfusion detector implementation
+ * @details HbDiff trend bins, rest/occlusion/reperfusion state machine and incremental kinetics fits.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Occlusion.h"
+#include <stdint.h>
+
+#define OCCL_BIN_S  ((float32_t)OCCL_BIN_SAMPLES / OCCL_SAMPLE_HZ)  /**< Bin spacing (s) */
+
+/**
+ * @brief Initialize an occlusion detector
+ * @param oc - [out] Detector
+ * @return void
+ */
+void Occl_Init(Occl_Context *oc) {
+    Stats_Init(&oc->trend, 1, OCCL_TREND_BINS, oc->trend_hist, oc->trend_min, oc->trend_max);
+    oc->bin_sum = 0.0f;
+    oc->bin_periods = 0;
+    oc->bin = 0;
+    oc->phase = OCCL_PHASE_REST;
+    oc->baseline_valid = 0;
+    oc->baseline = 0.0f;
+    oc->event.phase = OCCL_PHASE_REST;  // No record yet
+}
+
+/**
+ * @brief Add a point to an incremental least-squares line (Welford form)
+ * @param n - [in,out] Points
+ * @param mx - [in,out] Mean of x
+ * @param my - [in,out] Mean of y
+ * @param sxx - [in,out] Σ(x − x̄)²
+ * @param sxy - [in,out] Σ(x − x̄)(y − ȳ)
+ * @param x - Abscissa
+ * @param y - Ordinate
+ * @return void
+ */
+static void Occl_FitAdd(float32_t *n, float32_t *mx, float32_t *my, float32_t *sxx, float32_t *sxy,
+                        float32_t x, float32_t y) {
+    *n += 1.0f;
+    float32_t dx = x - *mx;
+    *mx += dx / *n;
+    *my += (y - *my) / *n;
+    *sxx += dx * (x - *mx);
+    *sxy += dx * (y - *my);
+}
+
+/**
+ * @brief Time where the trend line through the window crossed a level
+ * @param oc - [in] Detector (window full, newest bin at oc->bin)
+ * @param r - [in] Trend window statistics
+ * @param level - Level (µM)
+ * @return Time (bins), not later than the newest bin nor earlier than bin 0
+ */
+static float32_t Occl_Crossing(const Occl_Context *oc, const Stats_Result *r, float32_t level) {
+    float32_t newest = (float32_t)oc->bin;
+    float32_t t = newest - 0.5f * (float32_t)(OCCL_TREND_BINS - 1u) + (level - r->mean) / r->slope;
+    if (t > newest) t = newest;
+    if (t < 0.0f) t = 0.0f;
+    return t;
+}
+
+/**
+ * @brief Add one reperfusion point: half recovery, peak and recovery-rate fit
+ * @param oc - [in,out] Detector
+ * @param t - Time (bins)
+ * @param y - HbDiff (µM)
+ * @return void
+ */
+static void Occl_ReperfusionPoint(Occl_Context *oc, float32_t t, float32_t y) {
+    float32_t drop = oc->baseline - oc->min;
+    float32_t half = oc->min + 0.5f * drop;
+    if (!oc->half_done && y >= half) {
+        // Crossed between the previous point (below half) and this one
+        oc->t_half = oc->prev_t + (half - oc->prev_y) / (y - oc->prev_y) * (t - oc->prev_t);
+        oc->half_done = 1;
+    }
+    if (!oc->peak_passed) {
+        if (y > oc->peak) {
+            oc->peak = y;
+            oc->t_peak = t;
+        }
+        if (t > oc->prev_t) {
+            Occl_FitAdd(&oc->tau_n, &oc->tau_y, &oc->tau_d, &oc->tau_yy, &oc->tau_yd,
+                        0.5f * (y + oc->prev_y), (y - oc->prev_y) / (t - oc->prev_t));
+        }
+        if (y < oc->peak - OCCL_PEAK_FRAC * drop) {
+            oc->peak_passed = 1;
+        }
+    }
+    oc->prev_t = t;
+    oc->prev_y = y;
+}
+
+/**
+ * @brief Close the occlusion at the release and start the reperfusion
+ * @details The release is the lowest bin: the fall ends there and the recovery is much
+ *          steeper. Fills the occlusion record, then replays the window bins after it.
+ * @param oc - [in,out] Detector
+ * @return void
+ */
+static void Occl_Release(Occl_Context *oc) {
+    oc->t_release = oc->t_min;
+
+    oc->event.phase = OCCL_PHASE_OCCLUSION;
+    oc->event.duration_s = (oc->t_release - oc->t_onset) * OCCL_BIN_S;
+    oc->event.baseline = oc->baseline;
+    oc->event.level = oc->min;
+    oc->event.slope = (oc->fit_n >= 2.0f && oc->fit_tt > 0.0f) ? oc->fit_ty / oc->fit_tt / OCCL_BIN_S : 0.0f;
+    oc->event.t_half_s = 0.0f;
+    oc->event.t_peak_s = 0.0f;
+    oc->event.tau_s = 0.0f;
+
+    oc->phase = OCCL_PHASE_REPERFUSION;
+    oc->peak = oc->min;
+    oc->t_peak = oc->t_release;
+    oc->t_half = 0.0f;
+    oc->prev_t = oc->t_release;
+    oc->prev_y = oc->min;
+    oc->half_done = 0;
+    oc->peak_passed = 0;
+    oc->tau_n = 0.0f;
+    oc->tau_y = 0.0f;
+    oc->tau_d = 0.0f;
+    oc->tau_yy = 0.0f;
+    oc->tau_yd = 0.0f;
+    float32_t oldest = (float32_t)(oc->bin - (OCCL_TREND_BINS - 1u));
+    for (uint16_t k = 0; k < OCCL_TREND_BINS; k++) {
+        if (oldest + (float32_t)k > oc->t_release) {
+            Occl_ReperfusionPoint(oc, oldest + (float32_t)k, Stats_Value(&oc->trend, 0, k));
+        }
+    }
+}
+
+/**
+ * @brief Close the reperfusion and fill its record
+ * @param oc - [in,out] Detector
+ * @return void
+ */
+static void Occl_Recovered(Occl_Context *oc) {
+    float32_t b = (oc->tau_n >= 3.0f && oc->tau_yy > 0.0f) ? oc->tau_yd / oc->tau_yy : 0.0f;
+    oc->event.phase = OCCL_PHASE_REPERFUSION;
+    oc->event.duration_s = ((float32_t)oc->bin - oc->t_release) * OCCL_BIN_S;
+    oc->event.baseline = oc->baseline;
+    oc->event.level = oc->peak;
+    oc->event.slope = 0.0f;
+    oc->event.t_half_s = oc->half_done ? (oc->t_half - oc->t_release) * OCCL_BIN_S : 0.0f;
+    oc->event.t_peak_s = (oc->t_peak - oc->t_release) * OCCL_BIN_S;
+    oc->event.tau_s = (b < 0.0f) ? -OCCL_BIN_S / b : 0.0f;
+    oc->phase = OCCL_PHASE_REST;   // Baseline kept: the hyperemia decays toward it
+}
+
+/**
+ * @brief Phase decisions for a completed bin
+ * @param oc - [in,out] Detector (bin already pushed into the trend window)
+ * @param y - Bin level (µM)
+ * @return 1 if a phase ended
+ */
+static uint8_t Occl_Bin(Occl_Context *oc, float32_t y) {
+    Stats_Result r;
+    if (oc->trend.count < OCCL_TREND_BINS) {
+        return 0;
+    }
+    Stats_Get(&oc->trend, 0, &r);
+    float32_t t = (float32_t)oc->bin;
+
+    switch (oc->phase) {
+    case OCCL_PHASE_REST:
+        if (!oc->baseline_valid) {
+            oc->baseline = r.mean;
+            oc->baseline_valid = 1;
+        } else if (r.slope < -OCCL_ONSET_SLOPE_UM_S * OCCL_BIN_S && r.mean < oc->baseline - OCCL_ONSET_DROP_UM) {
+            oc->phase = OCCL_PHASE_OCCLUSION;
+            oc->t_onset = Occl_Crossing(oc, &r, oc->baseline);
+            oc->min = y;
+            oc->t_min = t;
+            oc->fit_n = 0.0f;
+            oc->fit_t = 0.0f;
+            oc->fit_y = 0.0f;
+            oc->fit_tt = 0.0f;
+            oc->fit_ty = 0.0f;
+        } else if (r.slope >= -OCCL_ONSET_SLOPE_UM_S * OCCL_BIN_S) {
+            oc->baseline += OCCL_BASELINE_ALPHA * (y - oc->baseline);
+        }
+        return 0;
+
+    case OCCL_PHASE_OCCLUSION: {
+        // The oldest window bin is final once it cannot belong to the release any more
+        float32_t t_old = t - (float32_t)(OCCL_TREND_BINS - 1u);
+        if (t_old >= oc->t_onset) {
+            Occl_FitAdd(&oc->fit_n, &oc->fit_t, &oc->fit_y, &oc->fit_tt, &oc->fit_ty,
+                        t_old - oc->t_onset, Stats_Value(&oc->trend, 0, 0));
+        }
+        if (y < oc->min) {
+            oc->min = y;
+            oc->t_min = t;
+        }
+        float32_t elapsed = (t - oc->t_onset) * (float32_t)OCCL_BIN_SAMPLES;
+        if (r.slope > OCCL_RELEASE_SLOPE_UM_S * OCCL_BIN_S
+            && y > oc->min + OCCL_RELEASE_FRAC * (oc->baseline - oc->min)) {
+            if (elapsed < (float32_t)OCCL_MIN_OCCLUSION_SAMPLES) {
+                oc->phase = OCCL_PHASE_REST;    // Too short: a transient, not an occlusion
+                return 0;
+            }
+            Occl_Release(oc);
+            return 1;
+        }
+        if (elapsed > (float32_t)OCCL_MAX_OCCLUSION_SAMPLES) {
+            oc->phase = OCCL_PHASE_REST;        // No release: drop it and learn a new baseline
+            oc->baseline_valid = 0;
+        }
+        return 0;
+    }
+
+    case OCCL_PHASE_REPERFUSION:
+    default:
+        Occl_ReperfusionPoint(oc, t, y);
+        if ((oc->peak_passed && (oc->peak <= oc->baseline || y <= 0.5f * (oc->peak + oc->baseline)))
+            || (t - oc->t_release) * (float32_t)OCCL_BIN_SAMPLES > (float32_t)OCCL_MAX_RECOVERY_SAMPLES) {
+            Occl_Recovered(oc);
+            return 1;
+        }
+        return 0;
+    }
+}
+
+/**
+ * @brief Add MBLL samples
+ * @param oc - [in,out] Detector
+ * @param hbo2 - [in] ΔHbO2 samples (µM)
+ * @param hhb - [in] ΔHHb samples (µM)
+ * @param n - Number of samples
+ * @param decim - ADC sample periods per sample
+ * @return 1 if a phase ended
+ */
+uint8_t Occl_Update(Occl_Context *oc, const float32_t *hbo2, const float32_t *hhb, uint32_t n, uint8_t decim) {
+    uint8_t ended = 0;
+    float32_t w = (float32_t)decim;
+    for (uint32_t i = 0; i < n; i++) {
+        oc->bin_sum += w * (hbo2[i] - hhb[i]);
+        oc->bin_periods += decim;
+        if (oc->bin_periods >= OCCL_BIN_SAMPLES) {
+            float32_t y = oc->bin_sum / (float32_t)oc->bin_periods;
+            oc->bin_sum = 0.0f;
+            oc->bin_periods = 0;
+            Stats_Push(&oc->trend, &y);
+            ended |= Occl_Bin(oc, y);
+            oc->bin++;
+        }
+    }
+    return ended;
+}
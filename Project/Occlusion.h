@@ -0,0 +1,149 @@
+/**
+ * @file Occlusion.h
+ * @brief Streaming arterial occlusion / reperfusion detector with kinetics per phase
+ * @details Segments an arterial occlusion protocol on the oxygenation index
+ *          HbDiff = ΔHbO2 − ΔHHb and reports, when each phase ends, the values usually
+ *          taken offline from the full-rate stream: desaturation slope and minimum, time
+ *          to half recovery, hyperemic peak/overshoot and the recovery time constant.
+ *
+ * ### Trend
+ *  HbDiff is averaged into bins of OCCL_BIN_SAMPLES ADC sample periods (weighted by the
+ *  decimation, so bins stay equally spaced under the adaptive rate). The last
+ *  OCCL_TREND_BINS bins feed a Stats_Window, whose mean and least-squares slope drive the
+ *  phase decisions.
+ *
+ * ### Phases
+ *  - **Rest**: the baseline follows the trend (exponential mean, OCCL_BASELINE_ALPHA per
+ *    bin) while it is not falling. Onset when the trend falls faster than
+ *    OCCL_ONSET_SLOPE_UM_S and lies OCCL_ONSET_DROP_UM below the baseline; the onset time
+ *    is where the fitted trend line crosses the baseline
+ *  - **Occlusion**: minimum tracked; the desaturation slope is an incremental least-squares
+ *    line over the bins from the onset on, each bin added once it leaves the trend window
+ *    (so the bins of the release never enter it). Release when the trend rises faster
+ *    than OCCL_RELEASE_SLOPE_UM_S and is OCCL_RELEASE_FRAC of the drop above the minimum;
+ *    the release time is the lowest bin (the recovery is much steeper than the fall). A release
+ *    earlier than OCCL_MIN_OCCLUSION_SAMPLES after the onset was not an occlusion (back
+ *    to rest, no record); no release within OCCL_MAX_OCCLUSION_SAMPLES abandons it
+ *  - **Reperfusion**: the bins from the release on (including the ones already in the
+ *    trend window) give the time to half recovery (minimum + half the drop, interpolated
+ *    between bins) and the peak. While rising, each pair of bins adds the point
+ *    (level, rate of change) to an incremental line fit dy/dt = a + b·y: for an
+ *    exponential recovery b = −1/τ. The phase ends once the peak has passed
+ *    (OCCL_PEAK_FRAC of the drop below it) and the hyperemia is half resolved, or
+ *    OCCL_MAX_RECOVERY_SAMPLES after the release
+ *
+ *  The baseline is kept across episodes, so the decay of the hyperemia is not taken for a
+ *  new onset. Thresholds are in µM of the MBLL output and scale with 1 / (d · DPF).
+ *
+ * ### Cost
+ *  A multiply-add per sample, O(1) work per bin (O(OCCL_TREND_BINS) at the release).
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Occl_Update, Stats_Window
+ */
+
+#ifndef OCCLUSION_H_
+#define OCCLUSION_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "Stats.h"
+
+#define     OCCL_SAMPLE_HZ              50.0f   /**< ADC sample rate (Hz), converts sample periods to seconds */
+#define     OCCL_BIN_SAMPLES            32u     /**< ADC sample periods per trend bin (0.64 s at 50 Hz, a multiple of every decimation) */
+#define     OCCL_TREND_BINS             8u      /**< Trend window in bins (5.12 s) */
+#define     OCCL_BASELINE_ALPHA         0.05f   /**< Baseline smoothing per bin (τ ≈ 13 s) */
+#define     OCCL_ONSET_SLOPE_UM_S       0.05f   /**< HbDiff fall rate that starts an occlusion (µM/s) */
+#define     OCCL_ONSET_DROP_UM          1.0f    /**< HbDiff below the baseline that starts an occlusion (µM) */
+#define     OCCL_RELEASE_SLOPE_UM_S     0.5f    /**< HbDiff rise rate that marks the release (µM/s) */
+#define     OCCL_RELEASE_FRAC           0.2f    /**< Rise above the minimum that marks the release (fraction of the drop) */
+#define     OCCL_PEAK_FRAC              0.05f   /**< Fall below the peak that marks it as passed (fraction of the drop) */
+#define     OCCL_MIN_OCCLUSION_SAMPLES  1500u   /**< Shortest occlusion reported (30 s at 50 Hz) */
+#define     OCCL_MAX_OCCLUSION_SAMPLES  30000u  /**< Longest occlusion followed (10 min at 50 Hz) */
+#define     OCCL_MAX_RECOVERY_SAMPLES   9000u   /**< Longest reperfusion followed (3 min at 50 Hz) */
+
+/**
+ * @enum Occl_Phase
+ * @brief Protocol phase
+ */
+typedef enum {
+    OCCL_PHASE_REST = 0,        /**< Baseline tracking, waiting for an onset */
+    OCCL_PHASE_OCCLUSION,       /**< Cuff inflated: desaturation */
+    OCCL_PHASE_REPERFUSION      /**< Cuff released: recovery and hyperemia */
+} Occl_Phase;
+
+/**
+ * @struct Occl_Event
+ * @brief Record of a completed phase
+ */
+typedef struct {
+    uint8_t   phase;            /**< Phase that ended: OCCL_PHASE_OCCLUSION or OCCL_PHASE_REPERFUSION */
+    float32_t duration_s;       /**< Onset to release, or release to end of reperfusion (s) */
+    float32_t baseline;         /**< Pre-occlusion HbDiff (µM) */
+    float32_t level;            /**< Occlusion: minimum; reperfusion: peak HbDiff (µM) */
+    float32_t slope;            /**< Occlusion: desaturation slope (µM/s); reperfusion: 0 */
+    float32_t t_half_s;         /**< Reperfusion: release to half recovery (s, 0 if not reached) */
+    float32_t t_peak_s;         /**< Reperfusion: release to peak (s) */
+    float32_t tau_s;            /**< Reperfusion: recovery time constant (s, 0 if not fitted) */
+} Occl_Event;
+
+/**
+ * @struct Occl_Context
+ * @brief Occlusion detector state (one per sensor)
+ */
+typedef struct {
+    Stats_Window trend;                         /**< Trend window over the bins */
+    float32_t trend_hist[OCCL_TREND_BINS];      /**< Trend window history */
+    uint16_t  trend_min[OCCL_TREND_BINS];       /**< Trend window min deque */
+    uint16_t  trend_max[OCCL_TREND_BINS];       /**< Trend window max deque */
+    float32_t bin_sum;                          /**< Weighted HbDiff sum of the open bin */
+    uint32_t  bin_periods;                      /**< ADC sample periods in the open bin */
+    uint32_t  bin;                              /**< Index of the open bin (time unit of the phases) */
+    uint8_t   phase;                            /**< Occl_Phase */
+    uint8_t   baseline_valid;                   /**< Baseline set (first full trend window) */
+    float32_t baseline;                         /**< Pre-occlusion HbDiff (µM) */
+    float32_t t_onset;                          /**< Onset (bins) */
+    float32_t t_release;                        /**< Release (bins) */
+    float32_t min;                              /**< Lowest bin of the occlusion (µM) */
+    float32_t t_min;                            /**< Lowest bin time (bins) */
+    float32_t fit_n;                            /**< Desaturation fit: points */
+    float32_t fit_t;                            /**< Desaturation fit: mean time (bins from the onset) */
+    float32_t fit_y;                            /**< Desaturation fit: mean level */
+    float32_t fit_tt;                           /**< Desaturation fit: Σ(t − t̄)² */
+    float32_t fit_ty;                           /**< Desaturation fit: Σ(t − t̄)(y − ȳ) */
+    float32_t peak;                             /**< Highest bin of the reperfusion (µM) */
+    float32_t t_peak;                           /**< Peak time (bins) */
+    float32_t t_half;                           /**< Half-recovery time (bins) */
+    float32_t prev_t;                           /**< Previous reperfusion point: time (bins) */
+    float32_t prev_y;                           /**< Previous reperfusion point: level (µM) */
+    uint8_t   half_done;                        /**< Half recovery reached */
+    uint8_t   peak_passed;                      /**< Peak passed (recovery fit closed) */
+    float32_t tau_n;                            /**< Recovery fit: points */
+    float32_t tau_y;                            /**< Recovery fit: mean level */
+    float32_t tau_d;                            /**< Recovery fit: mean rate (µM/bin) */
+    float32_t tau_yy;                           /**< Recovery fit: Σ(y − ȳ)² */
+    float32_t tau_yd;                           /**< Recovery fit: Σ(y − ȳ)(d − d̄) */
+    Occl_Event event;                           /**< Last completed phase */
+} Occl_Context;
+
+/**
+ * @brief Initialize an occlusion detector (rest, no baseline)
+ * @param oc - [out] Detector
+ * @return void
+ */
+void Occl_Init(Occl_Context *oc);
+
+/**
+ * @brief Add MBLL samples
+ * @param oc - [in,out] Detector
+ * @param hbo2 - [in] ΔHbO2 samples (µM)
+ * @param hhb - [in] ΔHHb samples (µM)
+ * @param n - Number of samples
+ * @param decim - ADC sample periods per sample
+ * @return 1 if a phase ended (record in oc->event), 0 otherwise
+ */
+uint8_t Occl_Update(Occl_Context *oc, const float32_t *hbo2, const float32_t *hhb, uint32_t n, uint8_t decim);
+
+#endif /* OCCLUSION_H_ */
@@ -1,5 +1,32 @@
 #include "PLL.h"
 #include "stm32f303x8.h"
+#include "system_stm32f3xx.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define CLK_I2C_TAF_MIN_NS      50u     /**< Analog filter delay, minimum */
+#define CLK_I2C_TAF_MAX_NS      260u    /**< Analog filter delay, maximum */
+
+/**
+ * @struct Clock_I2CMode
+ * @brief I2C-bus specification limits of one speed mode (ns)
+ */
+typedef struct {
+    uint32_t scl_max_hz;    /**< Highest SCL frequency of the mode */
+    uint16_t t_low;         /**< SCL low period, minimum */
+    uint16_t t_high;        /**< SCL high period, minimum */
+    uint16_t t_su_dat;      /**< Data setup time, minimum */
+    uint16_t t_hd_dat;      /**< Data valid time, maximum */
+    uint16_t t_r;           /**< Rise time, maximum */
+    uint16_t t_f;           /**< Fall time, maximum */
+} Clock_I2CMode;
+
+/** Standard, Fast and Fast-mode Plus limits (UM10204 Table 10) */
+static const Clock_I2CMode clock_i2c_modes[] = {
+    {  100000u, 4700u, 4000u, 250u, 3450u, 1000u, 300u },
+    {  400000u, 1300u,  600u, 100u,  900u,  300u, 300u },
+    { 1000000u,  500u,  260u,  50u,  450u,  120u, 120u },
+};
 
 /**
  * @brief Configure system clock to 64 MHz using PLL
@@ -30,18 +57,162 @@
  * @return void
  */
 void clk_config(void) {
-    // Set PLLMUL to 16: (8 MHz / 2) × 16 = 64 MHz system clock
-    RCC->CFGR |= 0xE << 18;
-    // Configure Flash for 2 wait states (required for 64 MHz operation)
-    FLASH->ACR |= 0x2;
+    // Set PLLMUL: (8 MHz / 2) × CLK_PLL_MUL = CLK_SYSCLK_HZ
+    RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_PLLMUL) | ((CLK_PLL_MUL - 2u) << RCC_CFGR_PLLMUL_Pos);
+    // Configure Flash wait states for CLK_SYSCLK_HZ (2 at 64 MHz) before switching
+    FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY) | CLK_FLASH_LATENCY;
     // Enable PLL
     RCC->CR |= RCC_CR_PLLON;
     // Wait for PLL to lock
     while (!(RCC->CR & RCC_CR_PLLRDY));
-    // Switch SYSCLK to PLL, set APB1 prescaler to 2 (32 MHz)
-    RCC->CFGR |= 0x402;
+    // Switch SYSCLK to PLL, APB1 prescaler 2 when SYSCLK exceeds the 36 MHz APB1 limit
+    RCC->CFGR = (RCC->CFGR & ~(RCC_CFGR_PPRE1 | RCC_CFGR_SW)) | RCC_CFGR_SW_PLL |
+                ((CLK_SYSCLK_HZ > CLK_APB1_MAX_HZ) ? RCC_CFGR_PPRE1_DIV2 : RCC_CFGR_PPRE1_DIV1);
     // Wait for system clock to switch to PLL
-    while (!(RCC->CFGR & RCC_CFGR_SWS_PLL));
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL);
     // Update SystemCoreClock global variable
     SystemCoreClockUpdate();
 }
+
+/**
+ * @brief Read the active clock tree from RCC
+ * @details SYSCLK from RCC_CFGR.SWS (HSI, HSE or PLL with its source, PREDIV and PLLMUL),
+ *          bus clocks from the AHB/APB prescalers, kernel clocks from RCC_CFGR3.
+ * @param tree - [out] Clock frequencies
+ * @return void
+ */
+void Clock_GetTree(Clock_Tree *tree) {
+    uint32_t cfgr = RCC->CFGR;
+    uint32_t sysclk;
+    switch (cfgr & RCC_CFGR_SWS) {
+        case RCC_CFGR_SWS_HSE:
+            sysclk = HSE_VALUE;
+            break;
+        case RCC_CFGR_SWS_PLL: {
+            uint32_t mul = ((cfgr & RCC_CFGR_PLLMUL) >> RCC_CFGR_PLLMUL_Pos) + 2u;
+            if (mul > 16u) {
+                mul = 16u;  // PLLMUL 0b1111 is also ×16
+            }
+            uint32_t in = (cfgr & RCC_CFGR_PLLSRC) ? HSE_VALUE / ((RCC->CFGR2 & RCC_CFGR2_PREDIV) + 1u)
+                                                   : HSI_VALUE / 2u;
+            sysclk = in * mul;
+            break;
+        }
+        default:
+            sysclk = HSI_VALUE;
+            break;
+    }
+    tree->sysclk = sysclk;
+    tree->hclk  = sysclk >> AHBPrescTable[(cfgr & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos];
+    tree->pclk1 = tree->hclk >> APBPrescTable[(cfgr & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos];
+    tree->pclk2 = tree->hclk >> APBPrescTable[(cfgr & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos];
+    tree->i2c1_ck = (RCC->CFGR3 & RCC_CFGR3_I2C1SW) ? sysclk : HSI_VALUE;
+    switch ((RCC->CFGR3 & RCC_CFGR3_USART2SW) >> RCC_CFGR3_USART2SW_Pos) {
+        case 1u:  tree->usart2_ck = sysclk;      break;
+        case 2u:  tree->usart2_ck = LSE_VALUE;   break;
+        case 3u:  tree->usart2_ck = HSI_VALUE;   break;
+        default:  tree->usart2_ck = tree->pclk1; break;
+    }
+}
+
+/**
+ * @brief Duration in kernel clock cycles, rounded up
+ * @param ns - Duration (ns)
+ * @param hz - Clock frequency (Hz)
+ * @return ceil(ns × hz / 1e9)
+ */
+static uint32_t Clock_NsToCycles(uint32_t ns, uint32_t hz) {
+    return (uint32_t)(((uint64_t)ns * hz + 999999999u) / 1000000000u);
+}
+
+/**
+ * @brief Compute an I2C TIMINGR value
+ * @details Per prescaler PRESC (tPRESC = (PRESC + 1) kernel cycles), RM0316 §28.4.9:
+ *          - SDADEL ≥ (tf − tAF(min) − 3·tI2CCLK) / tPRESC and, where the analog filter
+ *            spread leaves room, ≤ (tHD;DAT(max) − tr − tAF(max) − 4·tI2CCLK) / tPRESC
+ *          - SCLDEL ≥ (tr + tSU;DAT(min)) / tPRESC − 1
+ *          - (SCLL + 1)·tPRESC ≥ tLOW(min), (SCLH + 1)·tPRESC ≥ tHIGH(min), and
+ *            tSCLL + tSCLH + tSYNC1 + tSYNC2 ≥ 1 / scl_hz, with
+ *            tSYNC1 + tSYNC2 ≈ tf + tr + 2·tAF(min) + 4·tI2CCLK
+ * @param i2c_ck_hz - I2C kernel clock (Hz)
+ * @param scl_hz - Target SCL frequency (Hz, ≤ 1 MHz)
+ * @return TIMINGR value, or 0 if the mode cannot be met with this kernel clock
+ */
+uint32_t Clock_I2CTiming(uint32_t i2c_ck_hz, uint32_t scl_hz) {
+    const Clock_I2CMode *mode = NULL;
+    for (uint8_t m = 0; m < sizeof(clock_i2c_modes) / sizeof(clock_i2c_modes[0]); m++) {
+        if (scl_hz <= clock_i2c_modes[m].scl_max_hz) {
+            mode = &clock_i2c_modes[m];
+            break;
+        }
+    }
+    if (mode == NULL || scl_hz == 0u || i2c_ck_hz == 0u) {
+        return 0u;
+    }
+
+    // Constraints in kernel clock cycles
+    int32_t sdadel_min = (int32_t)Clock_NsToCycles(mode->t_f - CLK_I2C_TAF_MIN_NS, i2c_ck_hz) - 3;
+    int32_t sdadel_max = (int32_t)(((uint64_t)(mode->t_hd_dat - mode->t_r - CLK_I2C_TAF_MAX_NS) * i2c_ck_hz) / 1000000000u) - 4;
+    uint32_t scldel_min = Clock_NsToCycles(mode->t_r + mode->t_su_dat, i2c_ck_hz);
+    uint32_t low_min = Clock_NsToCycles(mode->t_low, i2c_ck_hz);
+    uint32_t high_min = Clock_NsToCycles(mode->t_high, i2c_ck_hz);
+    uint32_t sync = Clock_NsToCycles(mode->t_f + mode->t_r + 2u * CLK_I2C_TAF_MIN_NS, i2c_ck_hz) + 4u;
+    uint32_t period = (i2c_ck_hz + scl_hz - 1u) / scl_hz;
+    if (sdadel_min < 0) {
+        sdadel_min = 0;
+    }
+
+    for (uint32_t presc = 1; presc <= 16u; presc++) {
+        uint32_t sdadel = ((uint32_t)sdadel_min + presc - 1u) / presc;
+        uint32_t scldel = (scldel_min + presc - 1u) / presc;
+        scldel = (scldel > 0u) ? scldel - 1u : 0u;
+        if (sdadel > 15u || scldel > 15u) {
+            continue;
+        }
+        if (sdadel_max >= sdadel_min && (int32_t)(sdadel * presc) > sdadel_max) {
+            continue;
+        }
+        uint32_t low = (low_min + presc - 1u) / presc;
+        uint32_t high = (high_min + presc - 1u) / presc;
+        uint32_t used = (low + high) * presc + sync;
+        if (used < period) {
+            // Stretch to the target period, extra time mostly on the low phase
+            uint32_t add = (period - used + presc - 1u) / presc;
+            low += add - add / 2u;
+            high += add / 2u;
+        }
+        if (low > 256u || high > 256u) {
+            continue;
+        }
+        return ((presc - 1u) << 28) | (scldel << 20) | (sdadel << 16) | ((high - 1u) << 8) | (low - 1u);
+    }
+    return 0u;
+}
+
+/**
+ * @brief Compute a USART BRR value
+ * @details OVER16: BRR = USARTDIV = f_ck / baud. OVER8: USARTDIV = 2·f_ck / baud,
+ *          BRR[15:4] = USARTDIV[15:4], BRR[2:0] = USARTDIV[3:1], BRR[3] = 0. USARTDIV[0]
+ *          is not stored, so OVER8 uses the nearest even USARTDIV (rounding 2·f_ck / baud
+ *          and then dropping bit 0 can be a whole step off).
+ * @param usart_ck_hz - USART kernel clock (Hz)
+ * @param baud - Baud rate
+ * @param over8 - [out] 1 if CR1.OVER8 must be set
+ * @return BRR value, or 0 if baud > usart_ck_hz / 8
+ */
+uint32_t Clock_UsartDivider(uint32_t usart_ck_hz, uint32_t baud, uint8_t *over8) {
+    if (baud == 0u) {
+        return 0u;
+    }
+    uint32_t div16 = (usart_ck_hz + baud / 2u) / baud;
+    if (div16 >= 16u) {
+        *over8 = 0;
+        return (div16 > 0xFFFFu) ? 0xFFFFu : div16;
+    }
+    uint32_t div8 = 2u * div16;
+    if (div8 < 16u) {
+        return 0u;
+    }
+    *over8 = 1;
+    return (div8 & 0xFFF0u) | ((div8 & 0x000Fu) >> 1);
+}
@@ -22,6 +22,16 @@
  * @author Julio Fajardo
  * @date 2024-06-01
  * @version 1.0
+ * ### Clock-Aware Peripheral Timing
+ *  - Clock_GetTree() reads the active clock tree back from RCC (SYSCLK, HCLK, PCLK1/2)
+ *    and the kernel clocks of I2C1 and USART2 (RCC_CFGR3 selections)
+ *  - Clock_I2CTiming() computes I2C TIMINGR for Standard (100 kHz), Fast (400 kHz)
+ *    and Fast-mode Plus (1 MHz) from the I2C kernel clock, against the I2C-bus
+ *    specification limits (RM0316 §28.4.9 formulas)
+ *  - Clock_UsartDivider() computes the USART BRR (oversampling by 16, or by 8 for
+ *    baud rates above f_ck / 16)
+ *  Both are pure functions, so they can be checked off target.
+ *
  * @note Configures for 64 MHz, allowing I2C1 to operate at 400 kHz with APB1 @ 32 MHz
  * @note Call clk_config() before initializing any peripheral that depends on system clock
  */
@@ -31,6 +41,24 @@
 
 #include <stdint.h>
 
+#define     CLK_PLL_MUL         16u     /**< PLL multiplier on HSI/2 (2..16) */
+#define     CLK_SYSCLK_HZ       ((8000000u / 2u) * CLK_PLL_MUL) /**< Resulting SYSCLK (Hz) */
+#define     CLK_FLASH_LATENCY   ((CLK_SYSCLK_HZ <= 24000000u) ? 0u : (CLK_SYSCLK_HZ <= 48000000u) ? 1u : 2u) /**< Flash wait states */
+#define     CLK_APB1_MAX_HZ     36000000u /**< APB1 upper limit */
+
+/**
+ * @struct Clock_Tree
+ * @brief Active clock frequencies (Hz)
+ */
+typedef struct {
+    uint32_t sysclk;        /**< SYSCLK */
+    uint32_t hclk;          /**< AHB / core clock */
+    uint32_t pclk1;         /**< APB1 */
+    uint32_t pclk2;         /**< APB2 */
+    uint32_t i2c1_ck;       /**< I2C1 kernel clock (HSI or SYSCLK) */
+    uint32_t usart2_ck;     /**< USART2 kernel clock (PCLK1, SYSCLK, LSE or HSI) */
+} Clock_Tree;
+
 /**
  * @brief Configure system clock to 64 MHz using PLL
  * @details Complete PLL and RCC configuration sequence:
@@ -59,5 +87,36 @@
  */
 void clk_config(void);
 
+/**
+ * @brief Read the active clock tree from RCC
+ * @param tree - [out] Clock frequencies
+ * @return void
+ */
+void Clock_GetTree(Clock_Tree *tree);
+
+/**
+ * @brief Compute an I2C TIMINGR value
+ * @details Chooses the smallest prescaler (best resolution) for which SCLDEL, SDADEL,
+ *          SCLL and SCLH meet the I2C-bus minimum low/high, data setup and data hold
+ *          times of the mode selected by scl_hz (≤ 100 kHz Standard, ≤ 400 kHz Fast,
+ *          ≤ 1 MHz Fast-mode Plus), with the analog filter on and the digital filter off.
+ *          The resulting SCL frequency never exceeds scl_hz.
+ * @param i2c_ck_hz - I2C kernel clock (Hz)
+ * @param scl_hz - Target SCL frequency (Hz, ≤ 1 MHz)
+ * @return TIMINGR value, or 0 if the mode cannot be met with this kernel clock
+ */
+uint32_t Clock_I2CTiming(uint32_t i2c_ck_hz, uint32_t scl_hz);
+
+/**
+ * @brief Compute a USART BRR value
+ * @details Oversampling by 16 when f_ck / baud ≥ 16, otherwise by 8 (up to f_ck / 8).
+ *          The divider is rounded to nearest.
+ * @param usart_ck_hz - USART kernel clock (Hz)
+ * @param baud - Baud rate
+ * @param over8 - [out] 1 if CR1.OVER8 must be set
+ * @return BRR value, or 0 if baud > usart_ck_hz / 8
+ */
+uint32_t Clock_UsartDivider(uint32_t usart_ck_hz, uint32_t baud, uint8_t *over8);
+
 #endif /* PLL_H_ */
 
@@ -0,0 +1,414 @@
+/**
+ * @file Pipeline.c
+ * @brief Per-sensor signal processing pipeline implementation
+ * @details Warm-up, high-pass filtering, optional motion cancellation and MBLL for one sensor.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Pipeline.h"
+#include "MAX30101.h"
+#include "arm_math.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Biquad sections of a configuration, clamped to the context capacity
+ * @param cfg - [in] Parameters
+ * @return Sections
+ */
+static uint8_t Pipeline_Sections(const Pipeline_Config *cfg) {
+    return (cfg->iir_sections > PIPELINE_MAX_SECTIONS) ? PIPELINE_MAX_SECTIONS : cfg->iir_sections;
+}
+
+/**
+ * @brief Reset every stage to its initial state, up to the next warm-up
+ * @details The MBLL extinction coefficients (die temperature) are kept; its baseline is
+ *          set again by the warm-up.
+ * @param ctx - [in,out] Context with cfg set
+ * @return void
+ */
+static void Pipeline_Restart(Pipeline_Context *ctx) {
+    const Pipeline_Config *cfg = ctx->cfg;
+    uint8_t sections = Pipeline_Sections(cfg);
+    ctx->warmed_up = 0;
+    ctx->pi_ms = 0.0f;
+    ctx->alpha = cfg->alpha;
+    ctx->pi_alpha = PIPELINE_PI_ALPHA;
+    ctx->decim = 1;
+    Rate_Init(&ctx->rate, cfg->adaptive_decim);
+    Quality_Init(&ctx->quality, MAX30101_RANGE_FULLSCALE_NA(MAX30101_NIRSLiteProfile.adc_range));
+    LedCtl_Init(&ctx->led_ctl);
+    Wear_Init(&ctx->wear);
+    Occl_Init(&ctx->occl);
+    ctx->adc_range = (uint8_t)MAX30101_NIRSLiteProfile.adc_range;
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        ctx->w[c] = 0.0f;
+        ctx->dc[c] = 0.0f;
+        ctx->led[c] = 0;
+        for (uint8_t i = 0; i < 2 * PIPELINE_MAX_SECTIONS; i++) {
+            ctx->iir_state[c][i] = 0.0f;
+        }
+        if (cfg->filter == PIPELINE_FILTER_BIQUAD) {
+            arm_biquad_cascade_df2T_init_f32(&ctx->iir[c], sections, cfg->iir_coeffs, ctx->iir_state[c]);
+        }
+        if (cfg->motion_cancel) {
+            Motion_Init(&ctx->motion[c], MOTION_MU);
+        }
+        if (cfg->hampel_window) {
+            Hampel_Init(&ctx->hampel[c], cfg->hampel_window, cfg->hampel_threshold);
+        }
+    }
+}
+
+/**
+ * @brief Initialize a processing context
+ * @param ctx - [out] Context
+ * @param cfg - [in] Parameters
+ * @return void
+ */
+void Pipeline_Init(Pipeline_Context *ctx, const Pipeline_Config *cfg) {
+    ctx->cfg = cfg;
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        ctx->spikes[c] = 0;     // Kept across restarts
+    }
+    Pipeline_Restart(ctx);
+    Hb_Init(&ctx->hb, HB_DEFAULT_DISTANCE_CM, HB_DEFAULT_DPF, cfg->hb_temp_comp);
+}
+
+/**
+ * @brief Run the high-pass filter of one channel in place, optionally with its baseline
+ * @details The baseline is the complementary low-pass x − HP(x), produced in the same pass:
+ *          for the DC blocker x − y = (1 − α)·w[n−1], read from the filter state before the
+ *          update; for the biquad the cascade writes into the baseline row, which is then
+ *          swapped against the input in one loop.
+ * @param ctx - [in,out] Context
+ * @param c - Channel
+ * @param x - [in,out] Samples
+ * @param baseline - [out] Baseline samples, or NULL
+ * @param n - Number of samples
+ * @return void
+ */
+static void Pipeline_HighPass(Pipeline_Context *ctx, uint8_t c, float32_t *x, float32_t *baseline, uint32_t n) {
+    if (ctx->cfg->filter == PIPELINE_FILTER_BIQUAD) {
+        if (baseline == NULL) {
+            arm_biquad_cascade_df2T_f32(&ctx->iir[c], x, x, n);
+            return;
+        }
+        arm_biquad_cascade_df2T_f32(&ctx->iir[c], x, baseline, n);
+        for (uint32_t i = 0; i < n; i++) {
+            float32_t hp = baseline[i];
+            baseline[i] = x[i] - hp;
+            x[i] = hp;
+        }
+    } else {
+        float32_t alpha = ctx->alpha;
+        if (baseline == NULL) {
+            for (uint32_t i = 0; i < n; i++) {
+                x[i] = MAX30101_FirstOrderDC_Blocker(x[i], &ctx->w[c], alpha);
+            }
+            return;
+        }
+        float32_t gain = 1.0f - alpha;
+        for (uint32_t i = 0; i < n; i++) {
+            baseline[i] = gain * ctx->w[c];
+            x[i] = MAX30101_FirstOrderDC_Blocker(x[i], &ctx->w[c], alpha);
+        }
+    }
+}
+
+/**
+ * @brief Perfusion index of the IR channel
+ * @details PI = 100 · AC_rms / DC, AC_rms tracked as an exponential mean square of the
+ *          high-passed IR; 0 while the baseline is not positive.
+ * @param ctx - [in,out] Context
+ * @param ac - [in] High-passed IR
+ * @param dc - [in] IR baseline
+ * @param pi - [out] Perfusion index (%)
+ * @param n - Number of samples
+ * @return void
+ */
+static void Pipeline_PerfusionIndex(Pipeline_Context *ctx, const float32_t *ac, const float32_t *dc,
+                                    float32_t *pi, uint32_t n) {
+    float32_t ms = ctx->pi_ms;
+    for (uint32_t i = 0; i < n; i++) {
+        float32_t rms;
+        ms = ctx->pi_alpha * ms + (1.0f - ctx->pi_alpha) * ac[i] * ac[i];
+        arm_sqrt_f32(ms, &rms);
+        pi[i] = (dc[i] > 0.0f) ? 100.0f * rms / dc[i] : 0.0f;
+    }
+    ctx->pi_ms = ms;
+}
+
+/**
+ * @brief Move the filters to a new sample rate
+ * @details Keeps the responses in Hz and the current baseline (see Rate Changes in
+ *          Pipeline.h). Before the warm-up only the rate-dependent constants are set.
+ * @param ctx - [in,out] Context
+ * @param decim - Decimation of the following samples
+ * @return void
+ */
+static void Pipeline_SetDecimation(Pipeline_Context *ctx, uint8_t decim) {
+    const Pipeline_Config *cfg = ctx->cfg;
+    float32_t alpha = (decim > 1u) ? powf(cfg->alpha, (float32_t)decim) : cfg->alpha;
+    ctx->pi_alpha = (decim > 1u) ? powf(PIPELINE_PI_ALPHA, (float32_t)decim) : PIPELINE_PI_ALPHA;
+
+    if (cfg->filter == PIPELINE_FILTER_BIQUAD) {
+        const float32_t *coeffs = (decim > 1u && cfg->iir_coeffs_decim != NULL) ? cfg->iir_coeffs_decim : cfg->iir_coeffs;
+        for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+            float32_t *state = ctx->iir_state[c];
+            arm_biquad_cascade_df2T_init_f32(&ctx->iir[c], Pipeline_Sections(cfg), coeffs, state);
+            for (uint8_t i = 0; i < 2 * PIPELINE_MAX_SECTIONS; i++) {
+                state[i] = 0.0f;
+            }
+            if (ctx->warmed_up) {
+                // DF2T steady state for a constant input dc (zero output, DC gain 0):
+                // d2 = b2·dc, d1 = (b1 + b2)·dc; later sections see zero input
+                state[0] = (coeffs[1] + coeffs[2]) * ctx->dc[c];
+                state[1] = coeffs[2] * ctx->dc[c];
+            }
+        }
+    } else if (ctx->warmed_up) {
+        for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+            ctx->w[c] *= (1.0f - ctx->alpha) / (1.0f - alpha);
+        }
+    }
+    ctx->alpha = alpha;
+    ctx->decim = decim;
+}
+
+/**
+ * @brief Follow an LED current or ADC range change
+ * @details Scales the channel state by the LED current ratio (see Gain Steps in Pipeline.h).
+ * @param ctx - [in,out] Context
+ * @param block - [in] First block with the new settings
+ * @return void
+ */
+static void Pipeline_GainStep(Pipeline_Context *ctx, const SampleBlock *block) {
+    float32_t g[SAMPLE_BLOCK_CHANNELS];
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        g[c] = (ctx->led[c] != 0u && block->led[c] != 0u) ? (float32_t)block->led[c] / (float32_t)ctx->led[c] : 1.0f;
+        ctx->led[c] = block->led[c];
+        ctx->w[c] *= g[c];
+        ctx->dc[c] *= g[c];
+        if (ctx->cfg->hampel_window) {
+            Hampel_Scale(&ctx->hampel[c], g[c]);
+        }
+        for (uint8_t i = 0; i < 2 * PIPELINE_MAX_SECTIONS; i++) {
+            ctx->iir_state[c][i] *= g[c];
+        }
+    }
+    ctx->pi_ms *= g[SB_CH_IR] * g[SB_CH_IR];
+    Hb_SetBaseline(&ctx->hb, ctx->hb.red0 * g[SB_CH_RED], ctx->hb.ir0 * g[SB_CH_IR]);
+    ctx->motion_ref.red_dc *= g[SB_CH_RED];
+    ctx->motion_ref.ir_dc *= g[SB_CH_IR];
+    if (block->adc_range != ctx->adc_range) {
+        ctx->adc_range = block->adc_range;
+        Quality_SetFullScale(&ctx->quality, MAX30101_RANGE_FULLSCALE_NA(block->adc_range));
+    }
+}
+
+/**
+ * @brief Reload the filters after their coefficients were redesigned
+ * @param ctx - [in,out] Context
+ * @return void
+ */
+void Pipeline_Reconfigure(Pipeline_Context *ctx) {
+    Pipeline_SetDecimation(ctx, ctx->decim);
+}
+
+/**
+ * @brief Filter warm-up on the first sample
+ * @details Runs the filter warmup_samples times on the first sample to fill its state
+ *          and avoid the start-up transient; also sets the MBLL baseline and the motion
+ *          reference DC levels.
+ * @param ctx - [in,out] Context
+ * @param block - [in] Block starting with the first raw sample
+ * @return void
+ */
+static void Pipeline_Warmup(Pipeline_Context *ctx, const SampleBlock *block) {
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        float32_t x = block->ch[c][0];
+        for (uint16_t i = 0; i < ctx->cfg->warmup_samples; i++) {
+            float32_t dummy = x;
+            Pipeline_HighPass(ctx, c, &dummy, NULL, 1);
+        }
+    }
+    float32_t red = block->ch[SB_CH_RED][0];
+    float32_t ir  = block->ch[SB_CH_IR][0];
+    Hb_SetBaseline(&ctx->hb, red, ir); // First sample is the MBLL reference I0
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        ctx->led[c] = block->led[c];        // Drive the state corresponds to
+    }
+    if (block->adc_range != ctx->adc_range) {
+        ctx->adc_range = block->adc_range;
+        Quality_SetFullScale(&ctx->quality, MAX30101_RANGE_FULLSCALE_NA(block->adc_range));
+    }
+    if (ctx->cfg->motion_cancel) {
+        Motion_ReferenceInit(&ctx->motion_ref, red, ir);
+    }
+    ctx->warmed_up = 1;
+}
+
+/**
+ * @brief Process a block of raw samples in place
+ * @param ctx - [in,out] Context
+ * @param block - [in,out] Raw currents (nA) of the context's sensor
+ * @return void
+ */
+void Pipeline_ProcessBlock(Pipeline_Context *ctx, SampleBlock *block) {
+    float32_t motion[SAMPLE_BLOCK_LEN];
+    uint8_t first = 0;
+    uint8_t decim = (block->decimation != 0u) ? block->decimation : 1u;
+    if (block->flags & SB_FLAG_RESUME) {
+        Pipeline_Restart(ctx);  // Back on the skin: warm up again on this block
+    }
+    if (decim != ctx->decim) {
+        Pipeline_SetDecimation(ctx, decim);
+    }
+    if (!ctx->warmed_up) {
+        Pipeline_Warmup(ctx, block);
+        first = 1;  // The warm-up sample has no output
+    } else if (block->adc_range != ctx->adc_range) {
+        Pipeline_GainStep(ctx, block);
+    } else {
+        for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+            if (block->led[c] != ctx->led[c]) {
+                Pipeline_GainStep(ctx, block);
+                break;
+            }
+        }
+    }
+    block->first = first;
+    block->quality = 0;
+    if (first >= block->count) {
+        return;
+    }
+    uint32_t n = block->count - first;
+    float32_t *red = &block->ch[SB_CH_RED][first];
+    float32_t *ir  = &block->ch[SB_CH_IR][first];
+
+    // Stages on the raw currents, before the rows are high-passed in place
+    if (ctx->cfg->hampel_window) {
+        for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+            uint32_t replaced = Hampel_Process(&ctx->hampel[c], &block->ch[c][first], n);
+            if (replaced) {
+                ctx->spikes[c] += replaced;
+                block->flags |= SB_FLAG_SPIKE;
+            }
+        }
+    }
+    if (ctx->cfg->quality_output) {
+        Quality_BeginBlock(&ctx->quality, block, first);
+    }
+    if (ctx->cfg->wear_detect && Wear_Update(&ctx->wear, block, first)) {
+        block->flags |= SB_FLAG_OFF_BODY;
+    }
+    if (ctx->cfg->led_control && !ctx->wear.off) {
+        LedCtl_Update(&ctx->led_ctl, block, first);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (ctx->cfg->hb_output) {
+            Hb_Sample hb;
+            Hb_Compute(&ctx->hb, red[i], ir[i], &hb);
+            block->ch[SB_CH_HBO2][first + i] = hb.hbo2;
+            block->ch[SB_CH_HHB][first + i] = hb.hhb;
+        } else {
+            block->ch[SB_CH_HBO2][first + i] = 0.0f;
+            block->ch[SB_CH_HHB][first + i] = 0.0f;
+        }
+        if (ctx->cfg->motion_cancel) {
+            motion[i] = Motion_ReferenceUpdate(&ctx->motion_ref, red[i], ir[i]);
+        }
+    }
+    if (ctx->cfg->occlusion_detect && ctx->cfg->hb_output
+        && Occl_Update(&ctx->occl, &block->ch[SB_CH_HBO2][first], &block->ch[SB_CH_HHB][first], n, decim)) {
+        block->flags |= SB_FLAG_OCCL_EVENT;
+    }
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        float32_t *x = &block->ch[c][first];
+        float32_t *baseline = ctx->cfg->baseline_output ? &block->ch[SB_CH_BASELINE(c)][first] : NULL;
+        float32_t last = x[n - 1u];
+        Pipeline_HighPass(ctx, c, x, baseline, n);
+        ctx->dc[c] = last - x[n - 1u];
+        if (ctx->cfg->motion_cancel && decim == 1u) {
+            // Remove the part of each channel correlated with the motion reference
+            Motion_Cancel(&ctx->motion[c], x, motion, x, n);
+        }
+    }
+    if (ctx->cfg->baseline_output) {
+        Pipeline_PerfusionIndex(ctx, &block->ch[SB_CH_IR][first], &block->ch[SB_CH_BASELINE(SB_CH_IR)][first],
+                                &block->ch[SB_CH_PI][first], n);
+    }
+    if (ctx->cfg->quality_output) {
+        block->quality = Quality_EndBlock(&ctx->quality, &block->ch[SB_CH_IR][first], n);
+    }
+    if (ctx->cfg->adaptive_decim > 1u) {
+        Rate_Update(&ctx->rate, &block->ch[SB_CH_IR][first], ctx->dc[SB_CH_IR], n, decim);
+    }
+}
+
+/**
+ * @brief Decimation the adaptive rate asks acquisition for
+ * @param ctx - [in] Context
+ * @return Requested decimation (1 = full rate)
+ */
+uint8_t Pipeline_GetRateRequest(const Pipeline_Context *ctx) {
+    return (ctx->cfg->adaptive_decim > 1u) ? ctx->rate.request : 1u;
+}
+
+/**
+ * @brief LED drive and ADC range the LED controller asks acquisition for
+ * @param ctx - [in] Context
+ * @param codes - [out] LED drive register codes
+ * @param range - [out] ADC range
+ * @return 1 if a request is available
+ */
+uint8_t Pipeline_GetLedRequest(const Pipeline_Context *ctx, uint8_t *codes, uint8_t *range) {
+    if (!ctx->cfg->led_control || !ctx->led_ctl.valid) {
+        return 0;
+    }
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        codes[c] = ctx->led_ctl.code[c];
+    }
+    *range = ctx->led_ctl.range;
+    return 1;
+}
+
+/**
+ * @brief Samples replaced by the spike filter since Pipeline_Init
+ * @param ctx - [in] Context
+ * @param counts - [out] Count per optical channel
+ * @return void
+ */
+void Pipeline_GetSpikeCounts(const Pipeline_Context *ctx, uint32_t *counts) {
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        counts[c] = ctx->spikes[c];
+    }
+}
+
+/**
+ * @brief Record of the phase that ended in the last SB_FLAG_OCCL_EVENT block
+ * @param ctx - [in] Context
+ * @param event - [out] Record
+ * @return 1 if a record is available
+ */
+uint8_t Pipeline_GetOcclusionEvent(const Pipeline_Context *ctx, Occl_Event *event) {
+    if (!ctx->cfg->occlusion_detect || ctx->occl.event.phase == OCCL_PHASE_REST) {
+        return 0;
+    }
+    *event = ctx->occl.event;
+    return 1;
+}
+
+/**
+ * @brief Update the die temperature used by the MBLL stage
+ * @param ctx - [in,out] Context
+ * @param temp_degc - Die temperature (°C)
+ * @return void
+ */
+void Pipeline_SetTemperature(Pipeline_Context *ctx, float32_t temp_degc) {
+    Hb_SetTemperature(&ctx->hb, temp_degc);
+}
@@ -0,0 +1,234 @@
+/**
+ * @file Pipeline.h
+ * @brief Per-sensor signal processing pipeline (warm-up → high-pass → motion → MBLL)
+ * @details Self-contained processing context extracted from the main loop. All state
+ *          lives in a Pipeline_Context, so several sensors (or a replay harness feeding
+ *          recorded raw samples off target) can run independent pipelines. Depends only
+ *          on CMSIS-DSP and the processing modules, not on any peripheral.
+ *          Works on whole SampleBlocks in place: each stage runs once per block over the
+ *          contiguous channel arrays (CMSIS block calls), for every optical channel.
+ *
+ * ### Stages
+ *  1. **Warm-up** (first sample only): the filter is run warmup_samples times on
+ *     the first sample to settle its state; the sample is the MBLL baseline I0 and the
+ *     motion reference DC. No output is produced for it (block->first = 1).
+ *  2. **Spike rejection** (optional): Hampel filter on every optical channel, in place on
+ *     the raw currents, so every later stage sees the cleaned samples; the rows are
+ *     delayed by hampel_window / 2 samples (see Hampel.h). Blocks with replaced samples
+ *     are flagged SB_FLAG_SPIKE, counts per channel in Pipeline_GetSpikeCounts()
+ *  3. **MBLL** (optional): ΔHbO2/ΔHHb from the raw currents into SB_CH_HBO2/SB_CH_HHB,
+ *     and the motion reference, both before the raw rows are overwritten
+ *  4. **High-pass**: first-order DC blocker (PIPELINE_FILTER_DC_BLOCKER) or biquad
+ *     cascade (PIPELINE_FILTER_BIQUAD), in place on every optical channel. With
+ *     baseline_output the same pass writes the complementary low-pass x − HP(x) to
+ *     SB_CH_BASELINE(c): (1 − α)·w[n−1] straight from the DC blocker state, or the
+ *     difference to the biquad output
+ *  5. **Motion cancellation** (optional): NLMS on the high-passed channels
+ *  6. **Perfusion index** (with baseline_output): 100 · AC_rms / DC of the IR channel,
+ *     AC_rms from an exponential mean square of the high-passed IR (PIPELINE_PI_ALPHA)
+ *  7. **Signal quality** (optional): raw-current metrics before the high-pass, AC metrics
+ *     after it, one quality word per block in block->quality (see Quality.h)
+ *  8. **Adaptive rate** (optional): the activity of the high-passed IR decides the
+ *     decimation requested from acquisition (see AdaptiveRate.h)
+ *  9. **LED control** (optional): the raw DC decides the LED drive and ADC range
+ *     requested from acquisition (see LedControl.h)
+ * 10. **Wear detection** (optional): a raw IR current below the off-body threshold flags
+ *     the block SB_FLAG_OFF_BODY once (see Wear.h); LED control holds while off-body
+ * 11. **Occlusion kinetics** (optional, with hb_output): ΔHbO2 − ΔHHb segmented into
+ *     occlusion and reperfusion phases; the block in which a phase ends is flagged
+ *     SB_FLAG_OCCL_EVENT and its record read with Pipeline_GetOcclusionEvent() (see Occlusion.h)
+ *
+ * ### Rate Changes
+ *  Every block carries the decimation it was sampled with. When it changes, the filters
+ *  are moved to the new rate before the block is processed, keeping the same responses
+ *  in Hz and the current baseline:
+ *  - DC blocker: pole α^D, and w rescaled so the baseline (1 − α)·w is unchanged
+ *  - Biquad: iir_coeffs_decim (the same analog design mapped to the reduced rate), with
+ *    the DF2T state of the first section set to its steady state for the baseline,
+ *    the later sections cleared (as after the warm-up)
+ *  - Perfusion index smoothing: PIPELINE_PI_ALPHA^D
+ *  - Motion cancellation is bypassed while decimated (the reduced rate is only entered
+ *    when there is no motion)
+ *
+ * ### Gain Steps
+ *  Every block carries the LED codes it was sampled with. When they change, the detected
+ *  currents of a channel scale by g = code_new / code_old from that block on, so all state
+ *  derived linearly from the channel is scaled by g before the block is processed: the
+ *  high-pass state (DC blocker w or biquad DF2T state), the baseline, the MBLL reference
+ *  I0, the motion reference DC and the spike filter window (and g² for the perfusion
+ *  index mean square). The
+ *  filters then continue as if the whole history had been recorded at the new drive; no
+ *  warm-up or transient. A range change needs nothing beyond the clipping threshold.
+ *
+ * ### Off-Body Suspension
+ *  A block flagged SB_FLAG_RESUME follows a suspension in proximity mode: the baseline
+ *  and every filter state are stale, and acquisition is back at the profile settings.
+ *  The context restarts (as after Pipeline_Init, keeping the die temperature) and the
+ *  warm-up seeds the filters, I0 and the motion reference from the first sample of that
+ *  block, so output resumes without a start-up transient.
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Pipeline_Init, Pipeline_ProcessBlock, SampleBlock
+ */
+
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "SampleBlock.h"
+#include "Hemoglobin.h"
+#include "MotionCancel.h"
+#include "Quality.h"
+#include "AdaptiveRate.h"
+#include "LedControl.h"
+#include "Wear.h"
+#include "Occlusion.h"
+#include "Hampel.h"
+
+#if SAMPLE_BLOCK_LEN > MOTION_MAX_BLOCK
+#error "SAMPLE_BLOCK_LEN must not exceed MOTION_MAX_BLOCK"
+#endif
+
+#define     PIPELINE_MAX_SECTIONS   4   /**< Largest biquad cascade per channel */
+#define     PIPELINE_PI_ALPHA       0.98f /**< Perfusion index mean-square smoothing (τ ≈ 1 s at 50 Hz) */
+
+/**
+ * @enum Pipeline_Filter
+ * @brief High-pass (DC removal) filter type
+ */
+typedef enum {
+    PIPELINE_FILTER_DC_BLOCKER = 0,     /**< H(z) = (1 - z^-1) / (1 - alpha·z^-1) */
+    PIPELINE_FILTER_BIQUAD = 1          /**< CMSIS-DSP DF2T biquad cascade */
+} Pipeline_Filter;
+
+/**
+ * @struct Pipeline_Config
+ * @brief Pipeline parameters (shared by all sensors, must stay valid)
+ */
+typedef struct {
+    Pipeline_Filter  filter;            /**< High-pass filter type */
+    const float32_t *iir_coeffs;        /**< Biquad coefficients {b0,b1,b2,a1,a2} per section (CMSIS sign convention) */
+    uint8_t          iir_sections;      /**< Number of biquad sections (≤ PIPELINE_MAX_SECTIONS) */
+    float32_t        alpha;             /**< DC blocker pole */
+    uint16_t         warmup_samples;    /**< Filter iterations on the first sample */
+    uint8_t          motion_cancel;     /**< 1 = NLMS motion-artifact cancellation */
+    uint8_t          hb_output;         /**< 1 = compute ΔHbO2/ΔHHb */
+    uint8_t          hb_temp_comp;      /**< 1 = temperature-compensated extinction coefficients */
+    uint8_t          baseline_output;   /**< 1 = baseline rows and perfusion index */
+    uint8_t          quality_output;    /**< 1 = signal-quality word per block */
+    uint8_t          adaptive_decim;    /**< Reduced-rate decimation of the adaptive rate (0 = full rate only) */
+    const float32_t *iir_coeffs_decim;  /**< Biquad coefficients for the reduced rate (NULL = iir_coeffs) */
+    uint8_t          led_control;       /**< 1 = automatic LED current and ADC range control */
+    uint8_t          wear_detect;       /**< 1 = off-body detection (SB_FLAG_OFF_BODY) */
+    uint8_t          occlusion_detect;  /**< 1 = occlusion/reperfusion records (SB_FLAG_OCCL_EVENT, needs hb_output) */
+    uint8_t          hampel_window;     /**< Spike filter window in samples (odd, 0 = off) */
+    float32_t        hampel_threshold;  /**< Spike threshold in robust standard deviations (1.4826 · MAD) */
+} Pipeline_Config;
+
+/**
+ * @struct Pipeline_Context
+ * @brief Processing state of one sensor
+ */
+typedef struct {
+    const Pipeline_Config *cfg;                                 /**< Parameters */
+    uint8_t   warmed_up;                                        /**< 0 until the first sample was processed */
+    arm_biquad_cascade_df2T_instance_f32 iir[SAMPLE_BLOCK_CHANNELS];       /**< Biquad cascade per channel */
+    float32_t iir_state[SAMPLE_BLOCK_CHANNELS][2 * PIPELINE_MAX_SECTIONS]; /**< DF2T state per channel */
+    float32_t w[SAMPLE_BLOCK_CHANNELS];                         /**< DC blocker state per channel */
+    float32_t dc[SAMPLE_BLOCK_CHANNELS];                        /**< Latest baseline per channel (adaptive rate) */
+    float32_t alpha;                                            /**< DC blocker pole at the current rate */
+    float32_t pi_alpha;                                         /**< Perfusion index smoothing at the current rate */
+    uint8_t   decim;                                            /**< Decimation of the samples being processed */
+    Motion_Canceller motion[SAMPLE_BLOCK_CHANNELS];             /**< NLMS canceller per channel */
+    Motion_Reference motion_ref;                                /**< Motion reference generator */
+    Hb_Context hb;                                              /**< MBLL state */
+    float32_t pi_ms;                                            /**< Mean square of the high-passed IR (perfusion index) */
+    Quality_Context quality;                                    /**< Signal-quality window */
+    Rate_Context rate;                                          /**< Adaptive rate controller */
+    uint8_t   led[SAMPLE_BLOCK_CHANNELS];                       /**< LED codes the state corresponds to */
+    uint8_t   adc_range;                                        /**< ADC range of the last block */
+    LedCtl_Context led_ctl;                                     /**< LED current controller */
+    Wear_Context wear;                                          /**< Off-body detector */
+    Occl_Context occl;                                          /**< Occlusion/reperfusion detector */
+    Hampel_Filter hampel[SAMPLE_BLOCK_CHANNELS];                /**< Spike filter per channel */
+    uint32_t  spikes[SAMPLE_BLOCK_CHANNELS];                    /**< Samples replaced per channel since Pipeline_Init */
+} Pipeline_Context;
+
+/**
+ * @brief Initialize a processing context
+ * @param ctx - [out] Context
+ * @param cfg - [in] Parameters (must stay valid for the lifetime of the context)
+ * @return void
+ */
+void Pipeline_Init(Pipeline_Context *ctx, const Pipeline_Config *cfg);
+
+/**
+ * @brief Process a block of raw samples in place
+ * @details On return the optical rows hold the high-passed (and motion-cancelled)
+ *          currents, SB_CH_HBO2/SB_CH_HHB the MBLL outputs (0 if hb_output is off),
+ *          SB_CH_BASELINE(c)/SB_CH_PI the baselines and perfusion index (if baseline_output)
+ *          block->quality the signal-quality word (0 if quality_output is off) and
+ *          block->first the index of the first valid output sample.
+ * @param ctx - [in,out] Context
+ * @param block - [in,out] Raw currents (nA) of the context's sensor
+ * @return void
+ */
+void Pipeline_ProcessBlock(Pipeline_Context *ctx, SampleBlock *block);
+
+/**
+ * @brief Reload the filters after their coefficients were redesigned
+ * @details For a cutoff or sample-rate change at run time: rewrite the arrays behind
+ *          iir_coeffs / iir_coeffs_decim (e.g. with Design_Filter()) and alpha, then call
+ *          this between blocks. The cascade is re-initialized with iir_sections and the
+ *          coefficients of the current rate, the baseline is kept as on a rate change
+ *          (see Rate Changes). The steady-state seed assumes a first section with zero
+ *          DC gain, as in every high-pass design.
+ * @param ctx - [in,out] Context
+ * @return void
+ */
+void Pipeline_Reconfigure(Pipeline_Context *ctx);
+
+/**
+ * @brief Decimation the adaptive rate asks acquisition for
+ * @param ctx - [in] Context
+ * @return Requested decimation (1 = full rate; always 1 with adaptive_decim off)
+ */
+uint8_t Pipeline_GetRateRequest(const Pipeline_Context *ctx);
+
+/**
+ * @brief LED drive and ADC range the LED controller asks acquisition for
+ * @param ctx - [in] Context
+ * @param codes - [out] LED drive register code per optical channel
+ * @param range - [out] MAX30101_AdcRange
+ * @return 1 if a request is available (led_control on and a block was seen), 0 otherwise
+ */
+uint8_t Pipeline_GetLedRequest(const Pipeline_Context *ctx, uint8_t *codes, uint8_t *range);
+
+/**
+ * @brief Samples replaced by the spike filter since Pipeline_Init
+ * @param ctx - [in] Context
+ * @param counts - [out] Count per optical channel
+ * @return void
+ */
+void Pipeline_GetSpikeCounts(const Pipeline_Context *ctx, uint32_t *counts);
+
+/**
+ * @brief Record of the phase that ended in the last SB_FLAG_OCCL_EVENT block
+ * @param ctx - [in] Context
+ * @param event - [out] Record
+ * @return 1 if a record is available (occlusion_detect on and a phase ended), 0 otherwise
+ */
+uint8_t Pipeline_GetOcclusionEvent(const Pipeline_Context *ctx, Occl_Event *event);
+
+/**
+ * @brief Update the die temperature used by the MBLL stage
+ * @param ctx - [in,out] Context
+ * @param temp_degc - Die temperature (°C)
+ * @return void
+ */
+void Pipeline_SetTemperature(Pipeline_Context *ctx, float32_t temp_degc);
+
+#endif /* PIPELINE_H_ */
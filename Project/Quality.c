@@ -0,0 +1,183 @@
+/**
+ * @file Quality.c
+ * @brief Incremental signal-quality index implementation
+ * @details Per-block partial sums in a ring, window evaluation once per block.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Quality.h"
+#include "arm_math.h"
+#include <math.h>
+#include <stdint.h>
+
+/**
+ * @brief Clear the window and the sample history
+ * @param q - [in,out] Quality engine
+ * @return void
+ */
+static void Quality_Reset(Quality_Context *q) {
+    q->head = 0;
+    q->filled = 0;
+    q->has_prev = 0;
+    q->has_ac = 0;
+    q->prev_raw = 0.0f;
+    q->prev_ac = 0.0f;
+}
+
+/**
+ * @brief Initialize a quality engine with an empty window
+ * @param q - [out] Quality engine
+ * @param full_scale_na - ADC full-scale current (nA)
+ * @return void
+ */
+void Quality_Init(Quality_Context *q, float32_t full_scale_na) {
+    q->clip_na = QUALITY_CLIP_LEVEL * full_scale_na;
+    q->metrics.clip_rate = 0.0f;
+    q->metrics.dc = 0.0f;
+    q->metrics.pi = 0.0f;
+    q->metrics.snr_db = 0.0f;
+    q->metrics.flat_rate = 0.0f;
+    Quality_Reset(q);
+}
+
+/**
+ * @brief Change the ADC full scale used for the clipping threshold
+ * @param q - [in,out] Quality engine
+ * @param full_scale_na - ADC full-scale current (nA)
+ * @return void
+ */
+void Quality_SetFullScale(Quality_Context *q, float32_t full_scale_na) {
+    q->clip_na = QUALITY_CLIP_LEVEL * full_scale_na;
+}
+
+/**
+ * @brief Start a block: accumulate the raw-current metrics
+ * @param q - [in,out] Quality engine
+ * @param block - [in] Block with raw currents (nA)
+ * @param first - First sample to include
+ * @return void
+ */
+void Quality_BeginBlock(Quality_Context *q, const SampleBlock *block, uint8_t first) {
+    if (block->flags & (SB_FLAG_GAP | SB_FLAG_GAIN)) {
+        Quality_Reset(q);   // Differences across lost samples or a gain step are meaningless
+    }
+    Quality_Partial *p = &q->window[q->head];
+    p->samples = 0;
+    p->clipped = 0;
+    p->flat = 0;
+    p->dc_sum = 0.0f;
+    p->ac_sq = 0.0f;
+    p->diff_sq = 0.0f;
+
+    for (uint8_t i = first; i < block->count; i++) {
+        uint8_t clipped = 0;
+        for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+            clipped |= (block->ch[c][i] >= q->clip_na);
+        }
+        float32_t raw = block->ch[SB_CH_IR][i];
+        p->clipped += clipped;
+        p->flat += (q->has_prev && raw == q->prev_raw);
+        p->dc_sum += raw;
+        q->prev_raw = raw;
+        q->has_prev = 1;
+    }
+    p->samples = (uint16_t)(block->count - first);
+}
+
+/**
+ * @brief Finish a block: accumulate the AC metrics and evaluate the window
+ * @param q - [in,out] Quality engine
+ * @param ac - [in] High-passed IR samples of the block
+ * @param n - Number of samples
+ * @return Quality word
+ */
+uint16_t Quality_EndBlock(Quality_Context *q, const float32_t *ac, uint32_t n) {
+    Quality_Partial *p = &q->window[q->head];
+    if (!q->has_ac && n > 0u) {
+        q->prev_ac = ac[0];     // No first difference for the first sample of a window
+        q->has_ac = 1;
+    }
+    float32_t prev = q->prev_ac;
+    float32_t ac_sq = 0.0f;
+    float32_t diff_sq = 0.0f;
+    for (uint32_t i = 0; i < n; i++) {
+        float32_t d = ac[i] - prev;
+        ac_sq += ac[i] * ac[i];
+        diff_sq += d * d;
+        prev = ac[i];
+    }
+    q->prev_ac = prev;
+    p->ac_sq = ac_sq;
+    p->diff_sq = diff_sq;
+
+    q->head = (uint8_t)((q->head + 1u) % QUALITY_WINDOW_BLOCKS);
+    if (q->filled < QUALITY_WINDOW_BLOCKS) {
+        q->filled++;
+    }
+
+    // Window totals (the current block is the newest completed entry)
+    uint32_t samples = 0, clipped = 0, flat = 0;
+    float32_t dc_sum = 0.0f, ac_total = 0.0f, diff_total = 0.0f;
+    for (uint8_t k = 0; k < q->filled; k++) {
+        const Quality_Partial *w = &q->window[k];
+        samples += w->samples;
+        clipped += w->clipped;
+        flat += w->flat;
+        dc_sum += w->dc_sum;
+        ac_total += w->ac_sq;
+        diff_total += w->diff_sq;
+    }
+
+    Quality_Metrics *m = &q->metrics;
+    uint16_t word = 0;
+    if (samples > 0u) {
+        float32_t inv = 1.0f / (float32_t)samples;
+        float32_t ac_ms = ac_total * inv;
+        float32_t noise_ms = 0.5f * diff_total * inv;
+        float32_t ac_rms;
+        arm_sqrt_f32(ac_ms, &ac_rms);
+        m->clip_rate = (float32_t)clipped * inv;
+        m->flat_rate = (float32_t)flat * inv;
+        m->dc = dc_sum * inv;
+        m->pi = (m->dc > 0.0f) ? 100.0f * ac_rms / m->dc : 0.0f;
+        if (noise_ms > 0.0f) {
+            float32_t signal_ms = ac_ms - noise_ms;
+            m->snr_db = (signal_ms > 0.0f) ? 10.0f * log10f(signal_ms / noise_ms) : 0.0f;
+        } else {
+            m->snr_db = 0.0f;   // No variation at all: flatline, not a clean signal
+        }
+    }
+
+    if (m->clip_rate > QUALITY_CLIP_RATE) {
+        word |= QUALITY_FLAG_CLIPPING;
+    }
+    if (m->dc < QUALITY_MIN_DC_NA) {
+        word |= QUALITY_FLAG_LOW_DC;
+    }
+    if (m->pi < QUALITY_MIN_PI) {
+        word |= QUALITY_FLAG_LOW_PI;
+    }
+    if (m->snr_db < QUALITY_MIN_SNR_DB) {
+        word |= QUALITY_FLAG_LOW_SNR;
+    }
+    if (m->flat_rate > QUALITY_FLAT_RATE) {
+        word |= QUALITY_FLAG_FLATLINE;
+    }
+    if (q->filled < QUALITY_WINDOW_BLOCKS) {
+        word |= QUALITY_FLAG_PARTIAL;
+    }
+    float32_t snr = m->snr_db + 0.5f;
+    uint16_t snr_byte = (snr <= 0.0f) ? 0u : (snr >= 255.0f) ? 255u : (uint16_t)snr;
+    return (uint16_t)(word | (snr_byte << QUALITY_SNR_SHIFT));
+}
+
+/**
+ * @brief Window metrics behind the latest quality word
+ * @param q - [in] Quality engine
+ * @return Metrics
+ */
+const Quality_Metrics *Quality_GetMetrics(const Quality_Context *q) {
+    return &q->metrics;
+}
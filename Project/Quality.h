@@ -0,0 +1,142 @@
+/**
+ * @file Quality.h
+ * @brief Incremental signal-quality index over a sliding window of sample blocks
+ * @details Tracks, per sensor, the clipping rate, DC level, perfusion index, an SNR
+ *          estimate and a flatline rate over the last QUALITY_WINDOW_BLOCKS blocks, and
+ *          condenses them into a 16-bit quality word per block.
+ *
+ * ### Metrics (IR channel unless noted)
+ *  - **Clipping rate**: fraction of samples with any optical channel at or above
+ *    QUALITY_CLIP_LEVEL of the ADC full scale (saturation near MAX30101_ADC_MAX)
+ *  - **DC**: mean raw current; below QUALITY_MIN_DC_NA the sensor is off-skin or unlit
+ *  - **Perfusion index**: 100 · AC_rms / DC (%), AC from the high-passed samples
+ *  - **SNR**: the first difference of a 50 Hz PPG is dominated by broadband noise, so
+ *    noise power ≈ mean((x[n] − x[n−1])²) / 2 and signal power = AC power − noise power
+ *  - **Flatline rate**: fraction of raw samples identical to the previous one (stuck
+ *    or saturated ADC, disconnected sensor)
+ *
+ * ### Cost
+ *  O(1) per sample: each sample only adds to the running partial sums of its block.
+ *  Once per block the partials of the window (QUALITY_WINDOW_BLOCKS entries) are summed
+ *  and the metrics evaluated (one sqrtf, one log10f), so there is no drift from
+ *  subtracting old samples. Memory: QUALITY_WINDOW_BLOCKS · 16 bytes per sensor.
+ *
+ * ### Quality Word
+ *  Bits 0..7 are QUALITY_FLAG_* (0 = good segment), bits 8..15 the SNR in dB saturated
+ *  to 0..255. A block is usable when (word & QUALITY_FLAGS_MASK) == 0.
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Pipeline_ProcessBlock
+ */
+
+#ifndef QUALITY_H_
+#define QUALITY_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "SampleBlock.h"
+
+#define     QUALITY_WINDOW_BLOCKS   8       /**< Window length in blocks (64 samples, 1.28 s at 50 Hz) */
+#define     QUALITY_CLIP_LEVEL      0.98f   /**< Clipping threshold as a fraction of the ADC full scale */
+#define     QUALITY_CLIP_RATE       0.01f   /**< Clipped sample fraction that flags the window */
+#define     QUALITY_MIN_DC_NA       100.0f  /**< Lowest plausible on-skin IR DC (nA) */
+#define     QUALITY_MIN_PI          0.02f   /**< Lowest usable perfusion index (%) */
+#define     QUALITY_MIN_SNR_DB      3.0f    /**< Lowest usable SNR estimate (dB) */
+#define     QUALITY_FLAT_RATE       0.5f    /**< Repeated-sample fraction that flags a flatline */
+
+#define     QUALITY_FLAG_CLIPPING   (1u << 0)   /**< Clipping rate above QUALITY_CLIP_RATE */
+#define     QUALITY_FLAG_LOW_DC     (1u << 1)   /**< DC below QUALITY_MIN_DC_NA (off-skin) */
+#define     QUALITY_FLAG_LOW_PI     (1u << 2)   /**< Perfusion index below QUALITY_MIN_PI */
+#define     QUALITY_FLAG_LOW_SNR    (1u << 3)   /**< SNR estimate below QUALITY_MIN_SNR_DB (noise, motion) */
+#define     QUALITY_FLAG_FLATLINE   (1u << 4)   /**< Flatline rate above QUALITY_FLAT_RATE */
+#define     QUALITY_FLAG_PARTIAL    (1u << 5)   /**< Window not yet full (start-up or after a sample gap) */
+#define     QUALITY_FLAGS_MASK      0x00FFu     /**< Flag bits of the quality word */
+#define     QUALITY_SNR_SHIFT       8           /**< Position of the SNR (dB) byte */
+
+/**
+ * @struct Quality_Partial
+ * @brief Partial sums of one block
+ */
+typedef struct {
+    uint16_t  samples;      /**< Samples in the block */
+    uint8_t   clipped;      /**< Samples with a clipped optical channel */
+    uint8_t   flat;         /**< Raw IR samples equal to the previous one */
+    float32_t dc_sum;       /**< Sum of raw IR (nA) */
+    float32_t ac_sq;        /**< Sum of squared high-passed IR (nA²) */
+    float32_t diff_sq;      /**< Sum of squared high-passed IR first differences (nA²) */
+} Quality_Partial;
+
+/**
+ * @struct Quality_Metrics
+ * @brief Window metrics behind the latest quality word
+ */
+typedef struct {
+    float32_t clip_rate;    /**< Clipped sample fraction (0..1) */
+    float32_t dc;           /**< Mean raw IR current (nA) */
+    float32_t pi;           /**< Perfusion index (%) */
+    float32_t snr_db;       /**< SNR estimate (dB) */
+    float32_t flat_rate;    /**< Repeated-sample fraction (0..1) */
+} Quality_Metrics;
+
+/**
+ * @struct Quality_Context
+ * @brief Quality engine state (one per sensor)
+ */
+typedef struct {
+    Quality_Partial window[QUALITY_WINDOW_BLOCKS];  /**< Partial sums, ring of blocks */
+    uint8_t   head;         /**< Slot of the block being accumulated */
+    uint8_t   filled;       /**< Completed blocks in the window */
+    uint8_t   has_prev;     /**< prev_raw is valid */
+    uint8_t   has_ac;       /**< prev_ac is valid */
+    float32_t clip_na;      /**< Clipping threshold (nA) */
+    float32_t prev_raw;     /**< Last raw IR sample */
+    float32_t prev_ac;      /**< Last high-passed IR sample */
+    Quality_Metrics metrics; /**< Latest window metrics */
+} Quality_Context;
+
+/**
+ * @brief Initialize a quality engine with an empty window
+ * @param q - [out] Quality engine
+ * @param full_scale_na - ADC full-scale current (nA), e.g. MAX30101_CURRENT_FULLSCALE
+ * @return void
+ */
+void Quality_Init(Quality_Context *q, float32_t full_scale_na);
+
+/**
+ * @brief Change the ADC full scale used for the clipping threshold (ADC range change)
+ * @param q - [in,out] Quality engine
+ * @param full_scale_na - ADC full-scale current (nA)
+ * @return void
+ */
+void Quality_SetFullScale(Quality_Context *q, float32_t full_scale_na);
+
+/**
+ * @brief Start a block: accumulate the raw-current metrics
+ * @details Must run before the rows are high-passed in place. A block flagged
+ *          SB_FLAG_GAP or SB_FLAG_GAIN restarts the window.
+ * @param q - [in,out] Quality engine
+ * @param block - [in] Block with raw currents (nA)
+ * @param first - First sample to include
+ * @return void
+ */
+void Quality_BeginBlock(Quality_Context *q, const SampleBlock *block, uint8_t first);
+
+/**
+ * @brief Finish a block: accumulate the AC metrics and evaluate the window
+ * @param q - [in,out] Quality engine
+ * @param ac - [in] High-passed IR samples of the block (from first)
+ * @param n - Number of samples (as passed to Quality_BeginBlock)
+ * @return Quality word (QUALITY_FLAG_* | SNR dB << QUALITY_SNR_SHIFT)
+ */
+uint16_t Quality_EndBlock(Quality_Context *q, const float32_t *ac, uint32_t n);
+
+/**
+ * @brief Window metrics behind the latest quality word
+ * @param q - [in] Quality engine
+ * @return Metrics
+ */
+const Quality_Metrics *Quality_GetMetrics(const Quality_Context *q);
+
+#endif /* QUALITY_H_ */
@@ -17,7 +17,13 @@
 #define __ROM0_BASE 0x08000000
 //   <o> Region size [bytes] <0x0-0xFFFFFFFF:8>
 //   <i> Defines size of memory region. Default: 0x00010000
+//   <i> With RECORDER_ENABLE=1 (linker define in Project.cproject.yml) the last 16 KB
+//   <i> (0x0800C000-0x0800FFFF) are reserved for the session recorder log (Flash.h)
+#if defined(RECORDER_ENABLE) && (RECORDER_ENABLE == 1)
+#define __ROM0_SIZE 0x0000C000
+#else
 #define __ROM0_SIZE 0x00010000
+#endif
 // </h>
 
 // <h> __ROM1 (unused)
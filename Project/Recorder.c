@@ -0,0 +1,335 @@
+/**
+ * @file Recorder.c
+ * @brief On-device session recorder implementation
+ * @details Delta/zigzag-varint sample blocks appended to a log-structured page ring.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Recorder.h"
+#include "Storage.h"
+#include "UART.h"
+#include "Format.h"
+#include "arm_math_types.h"
+#include <stdint.h>
+
+#define REC_PAGE_HDR_BYTES      8u      /**< magic + seq */
+#define REC_SAMPLES_HDR_BYTES   10u     /**< len, type, id, count, rsvd, start index */
+#define REC_SESSION_BYTES       8u      /**< len, type, rsvd, session */
+#define REC_MAX_SAMPLE_BYTES    10u     /**< Worst case of two 32-bit zigzag varints */
+#define REC_DUMP_CHUNK          64u     /**< Bytes per storage read while dumping */
+
+/**
+ * @struct Rec_Block
+ * @brief Block being assembled for one sensor
+ */
+typedef struct {
+    uint8_t  buf[RECORDER_BLOCK_BYTES]; /**< Record image (header + varints) */
+    uint16_t len;                       /**< Bytes used in buf */
+    uint8_t  count;                     /**< Samples in the block */
+    int32_t  prev_red;                  /**< Previous Red count (delta base) */
+    int32_t  prev_ir;                   /**< Previous IR count (delta base) */
+    uint32_t index;                     /**< Samples recorded for this sensor since boot */
+} Rec_Block;
+
+static const Storage_Backend *rec_backend = 0;
+static Rec_Block rec_blocks[RECORDER_MAX_SENSORS];
+static uint16_t rec_page = 0;           /**< Page being written */
+static uint32_t rec_offset = 0;         /**< Write offset in rec_page */
+static uint32_t rec_seq = 0;            /**< seq of rec_page */
+static Storage_Status rec_status = STORAGE_ERR_RANGE;   /**< Not initialized */
+
+/**
+ * @brief Store a 32-bit little-endian value
+ */
+static inline void Rec_PutU32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief Load a 32-bit little-endian value
+ */
+static inline uint32_t Rec_GetU32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Append a zigzag varint (7 bits per byte, MSB = continuation)
+ * @param p - [out] Destination
+ * @param v - Signed value
+ * @return Pointer one past the last byte written
+ */
+static uint8_t *Rec_PutVarint(uint8_t *p, int32_t v) {
+    uint32_t z = ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+    while (z >= 0x80u) {
+        *p++ = (uint8_t)(z | 0x80u);
+        z >>= 7;
+    }
+    *p++ = (uint8_t)z;
+    return p;
+}
+
+/**
+ * @brief Quantize a current to ADC counts (round to nearest)
+ */
+static inline int32_t Rec_Quantize(float32_t na) {
+    float32_t c = na * RECORDER_COUNTS_PER_NA;
+    return (int32_t)(c >= 0.0f ? c + 0.5f : c - 0.5f);
+}
+
+/**
+ * @brief Record a storage error and disable the recorder
+ * @param status - Result of a storage operation
+ * @return status
+ */
+static Storage_Status Rec_Check(Storage_Status status) {
+    if (status != STORAGE_OK) {
+        rec_status = status;
+    }
+    return status;
+}
+
+/**
+ * @brief Erase a page and write its header; it becomes the current page
+ * @param page - Page index
+ * @return Storage_Status
+ */
+static Storage_Status Rec_OpenPage(uint16_t page) {
+    uint8_t hdr[REC_PAGE_HDR_BYTES];
+    Storage_Status status = rec_backend->erase(page);
+    if (status != STORAGE_OK) {
+        return Rec_Check(status);
+    }
+    rec_seq++;
+    Rec_PutU32(&hdr[0], RECORDER_PAGE_MAGIC);
+    Rec_PutU32(&hdr[4], rec_seq);
+    status = rec_backend->program((uint32_t)page * rec_backend->page_size, hdr, REC_PAGE_HDR_BYTES);
+    rec_page = page;
+    rec_offset = REC_PAGE_HDR_BYTES;
+    return Rec_Check(status);
+}
+
+/**
+ * @brief Append a record, moving to the next page if it does not fit
+ * @param rec - [in] Record image (even length)
+ * @param len - Record length in bytes
+ * @return Storage_Status
+ */
+static Storage_Status Rec_Write(const uint8_t *rec, uint16_t len) {
+    if (rec_offset + len > rec_backend->page_size) {
+        Storage_Status status = Rec_OpenPage((uint16_t)((rec_page + 1u) % rec_backend->num_pages));
+        if (status != STORAGE_OK) {
+            return status;
+        }
+    }
+    Storage_Status status = rec_backend->program((uint32_t)rec_page * rec_backend->page_size + rec_offset, rec, len);
+    rec_offset += len;
+    return Rec_Check(status);
+}
+
+/**
+ * @brief Start an empty block for a sensor
+ * @param b - [in,out] Block
+ * @return void
+ */
+static void Rec_ResetBlock(Rec_Block *b) {
+    b->len = REC_SAMPLES_HDR_BYTES;
+    b->count = 0;
+    b->prev_red = 0;    // First sample of a block is stored absolute
+    b->prev_ir = 0;
+}
+
+/**
+ * @brief Finalize the header of a sensor's block and write it
+ * @param id - Sensor ID
+ * @return Storage_Status
+ */
+static Storage_Status Rec_FlushBlock(uint8_t id) {
+    Rec_Block *b = &rec_blocks[id];
+    if (b->count == 0) {
+        return STORAGE_OK;
+    }
+    uint16_t len = b->len;
+    uint16_t rec_len = (uint16_t)(len - 2u);
+    b->buf[0] = (uint8_t)rec_len;
+    b->buf[1] = (uint8_t)(rec_len >> 8);
+    b->buf[2] = RECORDER_REC_SAMPLES;
+    b->buf[3] = id;
+    b->buf[4] = b->count;
+    b->buf[5] = 0;
+    Rec_PutU32(&b->buf[6], b->index - b->count);
+    if (len & 1u) {
+        b->buf[len++] = 0xFF;   // Pad to a half-word
+    }
+    Rec_ResetBlock(b);
+    return Rec_Write(b->buf, len);
+}
+
+/**
+ * @brief Write a session record tagged with the current page seq
+ * @return Storage_Status
+ */
+static Storage_Status Rec_WriteSession(void) {
+    uint8_t session[REC_SESSION_BYTES];
+    session[0] = REC_SESSION_BYTES - 2u;
+    session[1] = 0;
+    session[2] = RECORDER_REC_SESSION;
+    session[3] = 0;
+    Rec_PutU32(&session[4], rec_seq);
+    return Rec_Write(session, REC_SESSION_BYTES);
+}
+
+/**
+ * @brief Open the log on a storage backend
+ * @details Finds the newest page (highest seq) and continues on the page after it.
+ * @param backend - [in] Storage medium
+ * @return Storage_Status
+ */
+Storage_Status Recorder_Init(const Storage_Backend *backend) {
+    uint8_t hdr[REC_PAGE_HDR_BYTES];
+    uint16_t newest = 0;
+    uint8_t found = 0;
+
+    rec_backend = backend;
+    rec_status = STORAGE_OK;
+    rec_seq = 0;
+    for (uint8_t i = 0; i < RECORDER_MAX_SENSORS; i++) {
+        rec_blocks[i].index = 0;
+        Rec_ResetBlock(&rec_blocks[i]);
+    }
+    for (uint16_t p = 0; p < backend->num_pages; p++) {
+        if (backend->read((uint32_t)p * backend->page_size, hdr, REC_PAGE_HDR_BYTES) != STORAGE_OK) {
+            continue;
+        }
+        uint32_t seq = Rec_GetU32(&hdr[4]);
+        if (Rec_GetU32(&hdr[0]) == RECORDER_PAGE_MAGIC && (!found || seq > rec_seq)) {
+            rec_seq = seq;
+            newest = p;
+            found = 1;
+        }
+    }
+    if (Rec_OpenPage(found ? (uint16_t)((newest + 1u) % backend->num_pages) : 0) != STORAGE_OK) {
+        return rec_status;
+    }
+    return Rec_WriteSession();
+}
+
+/**
+ * @brief Append one raw sample to its sensor's block
+ * @param sensor_id - Sensor ID
+ * @param red - Red current (nA)
+ * @param ir - IR current (nA)
+ * @return void
+ */
+void Recorder_Push(uint8_t sensor_id, float32_t red, float32_t ir) {
+    if (rec_status != STORAGE_OK || sensor_id >= RECORDER_MAX_SENSORS) {
+        return;
+    }
+    Rec_Block *b = &rec_blocks[sensor_id];
+    if (b->len + REC_MAX_SAMPLE_BYTES > RECORDER_BLOCK_BYTES || b->count == UINT8_MAX) {
+        if (Rec_FlushBlock(sensor_id) != STORAGE_OK) {
+            return;
+        }
+    }
+    int32_t r = Rec_Quantize(red);
+    int32_t i = Rec_Quantize(ir);
+    uint8_t *p = &b->buf[b->len];
+    p = Rec_PutVarint(p, r - b->prev_red);
+    p = Rec_PutVarint(p, i - b->prev_ir);
+    b->len = (uint16_t)(p - b->buf);
+    b->prev_red = r;
+    b->prev_ir = i;
+    b->count++;
+    b->index++;
+}
+
+/**
+ * @brief Write all partially filled blocks to storage
+ * @return Storage_Status
+ */
+Storage_Status Recorder_Flush(void) {
+    for (uint8_t i = 0; i < RECORDER_MAX_SENSORS && rec_status == STORAGE_OK; i++) {
+        Rec_FlushBlock(i);
+    }
+    return rec_status;
+}
+
+/**
+ * @brief Stream the whole log over USART2, oldest page first
+ * @details The page after the current one is the oldest in the ring; erased or
+ *          foreign pages are skipped (and not counted in the header line).
+ * @return void
+ */
+void Recorder_Dump(void) {
+    uint8_t chunk[REC_DUMP_CHUNK];
+    char line[FMT_UINT_MAX_CHARS * 2 + 4];
+    uint16_t valid = 0;
+
+    if (rec_backend == 0) {
+        return;
+    }
+    Recorder_Flush();
+    uint16_t pages = rec_backend->num_pages;
+    uint32_t page_size = rec_backend->page_size;
+    for (uint16_t p = 0; p < pages; p++) {
+        if (rec_backend->read((uint32_t)p * page_size, chunk, 4) == STORAGE_OK &&
+            Rec_GetU32(chunk) == RECORDER_PAGE_MAGIC) {
+            valid++;
+        }
+    }
+    char *e = Fmt_Uint(line, valid);
+    *e++ = ',';
+    e = Fmt_Uint(e, page_size);
+    *e++ = '\r';
+    *e++ = '\n';
+    USART2_putString("#dump,");
+    USART2_Write(line, (uint16_t)(e - line));
+
+    for (uint16_t n = 1; n <= pages; n++) {
+        uint32_t base = (uint32_t)((rec_page + n) % pages) * page_size;
+        if (rec_backend->read(base, chunk, 4) != STORAGE_OK || Rec_GetU32(chunk) != RECORDER_PAGE_MAGIC) {
+            continue;
+        }
+        for (uint32_t off = 0; off < page_size; off += REC_DUMP_CHUNK) {
+            rec_backend->read(base + off, chunk, REC_DUMP_CHUNK);
+            USART2_Write((const char *)chunk, REC_DUMP_CHUNK);
+        }
+    }
+    USART2_putString("#dump,end\r\n");
+}
+
+/**
+ * @brief Erase the log and start a new session
+ * @details seq keeps counting, so page order stays unambiguous across erases.
+ * @return Storage_Status
+ */
+Storage_Status Recorder_Erase(void) {
+    if (rec_backend == 0) {
+        return STORAGE_ERR_RANGE;
+    }
+    rec_status = STORAGE_OK;
+    for (uint8_t i = 0; i < RECORDER_MAX_SENSORS; i++) {
+        Rec_ResetBlock(&rec_blocks[i]);
+    }
+    for (uint16_t p = 0; p < rec_backend->num_pages; p++) {
+        if (Rec_Check(rec_backend->erase(p)) != STORAGE_OK) {
+            return rec_status;
+        }
+    }
+    if (Rec_OpenPage(0) != STORAGE_OK) {
+        return rec_status;
+    }
+    return Rec_WriteSession();
+}
+
+/**
+ * @brief Last storage status
+ * @return Storage_Status
+ */
+Storage_Status Recorder_GetStatus(void) {
+    return rec_status;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file Recorder.h
+ * @brief On-device session recorder: compressed raw samples in a log-structured page ring
+ * @details Keeps a copy of every raw Red/IR sample in non-volatile storage so a session
+ *          survives a dropped serial link. Storage is reached only through a
+ *          Storage_Backend (internal flash on target).
+ *
+ * ### Compression
+ *  - Currents are quantized to ADC counts (RECORDER_COUNTS_PER_NA, lossless for the
+ *    4096 nA range where 1 LSB = 1/64 nA)
+ *  - Per sensor, consecutive samples are delta coded and stored as zigzag varints
+ *    (typically 1–2 bytes per channel instead of 4)
+ *  - Each block is a self-contained record (absolute first sample, start index), so
+ *    a reader can decode any page on its own
+ *
+ * ### Log Layout
+ *  - Page:   [magic u32 'NIRL'][seq u32][records...][0xFF... erased]
+ *  - Record: [len u16][type u8][payload, len - 1 bytes][pad to even]; len 0xFFFF ends the page
+ *  - RECORDER_REC_SAMPLES: [id u8][count u8][rsvd u8][start index u32][varints: Δred, Δir per sample]
+ *  - RECORDER_REC_SESSION: [rsvd u8][session u32] (written once per boot)
+ *
+ * ### Wear Leveling
+ *  - Pages are written strictly in ring order and each page is erased just before it is
+ *    reused, so every page sees the same number of erase cycles
+ *  - At boot the page with the highest seq is found and logging continues on the next
+ *    page; a page that was being written at power loss is never appended to
+ *
+ * ### Dump
+ *  - Recorder_Dump() streams all valid pages, oldest first, as raw bytes framed by
+ *    text lines: "#dump,<pages>,<page_size>\r\n" <pages × page_size bytes> "#dump,end\r\n"
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Storage_Backend, Flash_Backend
+ */
+
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+#include <stdint.h>
+#include "arm_math_types.h"
+#include "Storage.h"
+
+#define     RECORDER_MAX_SENSORS    4           /**< Sensors with their own block buffer */
+#define     RECORDER_BLOCK_BYTES    64          /**< Record buffer per sensor (header included) */
+#define     RECORDER_COUNTS_PER_NA  64.0f       /**< Quantization: ADC counts per nA at ADC_RGE 4096 nA */
+#define     RECORDER_PAGE_MAGIC     0x4C52494Eu /**< 'NIRL' page header magic */
+#define     RECORDER_REC_SAMPLES    0x01        /**< Record type: sample block */
+#define     RECORDER_REC_SESSION    0x02        /**< Record type: session start */
+
+/**
+ * @brief Open the log on a storage backend
+ * @details Scans the page headers, starts a new page after the newest one and writes a
+ *          session record. Blocks for one page erase.
+ * @param backend - [in] Storage medium (must stay valid)
+ * @return STORAGE_OK, or the storage error that disabled the recorder
+ */
+Storage_Status Recorder_Init(const Storage_Backend *backend);
+
+/**
+ * @brief Append one raw sample to its sensor's block
+ * @details Writes the block to storage when it is full (may erase the next page).
+ * @param sensor_id - Sensor ID (0 to RECORDER_MAX_SENSORS - 1)
+ * @param red - Red current (nA)
+ * @param ir - IR current (nA)
+ * @return void
+ * @note Main-loop context; no-op if the recorder is disabled
+ */
+void Recorder_Push(uint8_t sensor_id, float32_t red, float32_t ir);
+
+/**
+ * @brief Write all partially filled blocks to storage
+ * @return STORAGE_OK or the first storage error
+ */
+Storage_Status Recorder_Flush(void);
+
+/**
+ * @brief Stream the whole log over USART2, oldest page first
+ * @return void
+ * @note Main-loop context; the live output pauses while the log is sent
+ */
+void Recorder_Dump(void);
+
+/**
+ * @brief Erase the log and start a new session
+ * @return STORAGE_OK or the first storage error
+ */
+Storage_Status Recorder_Erase(void);
+
+/**
+ * @brief Last storage status
+ * @return STORAGE_OK while the recorder is running
+ */
+Storage_Status Recorder_GetStatus(void);
+
+#endif /* RECORDER_H_ */
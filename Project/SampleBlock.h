@@ -0,0 +1,75 @@
+/**
+ * @file SampleBlock.h
+ * @brief Structure-of-arrays sample block, the native data layout of the processing chain
+ * @details One block holds up to SAMPLE_BLOCK_LEN consecutive samples of one sensor, one
+ *          contiguous float array per channel, plus metadata. Blocks are written by the
+ *          acquisition ISR (FIFO burst unpacked straight into the channel arrays), processed
+ *          in place by the pipeline and encoded from the same memory; no stage copies or
+ *          re-packs samples, and every channel array can be handed to a CMSIS-DSP block kernel.
+ *
+ * ### Channels
+ *  - Rows 0 .. SAMPLE_BLOCK_CHANNELS-1: optical channels in FIFO order (Red, IR, Green),
+ *    raw currents in nA as read, high-passed in place by the pipeline
+ *  - Rows SB_CH_HBO2, SB_CH_HHB: derived ΔHbO2 / ΔHHb (µM), written by the pipeline
+ *  - Rows SB_CH_BASELINE(c): slow baseline (DC) of each optical channel (nA), the
+ *    complement of its high-pass, written in the same filter pass
+ *  - Row SB_CH_PI: perfusion index (%) of the IR channel
+ *  The encoder selects the rows to output by index.
+ *
+ * ### Channel Count
+ *  SAMPLE_BLOCK_CHANNELS is a compile-time parameter (2 = Red/IR in SpO2 mode,
+ *  3 = Red/IR/Green in multi-LED mode); the pipeline and the encoder loop over it.
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Acquisition_Peek, Pipeline_ProcessBlock, Fmt_WriteBlock
+ */
+
+#ifndef SAMPLE_BLOCK_H_
+#define SAMPLE_BLOCK_H_
+
+#include <stdint.h>
+#include "arm_math_types.h"
+#include "cmsis_compiler.h"
+
+#ifndef SAMPLE_BLOCK_CHANNELS
+#define     SAMPLE_BLOCK_CHANNELS   2   /**< Optical channels per sample (2 = Red/IR, 3 = Red/IR/Green) */
+#endif
+#define     SAMPLE_BLOCK_LEN        8   /**< Samples per block (one FIFO burst) */
+#define     SAMPLE_BLOCK_FIELDS     (2 * SAMPLE_BLOCK_CHANNELS + 3) /**< Optical channels, ΔHbO2, ΔHHb, baselines, PI */
+
+#define     SB_CH_RED               0                           /**< Red (660 nm) row */
+#define     SB_CH_IR                1                           /**< IR (880 nm) row */
+#define     SB_CH_GREEN             2                           /**< Green row (SAMPLE_BLOCK_CHANNELS ≥ 3) */
+#define     SB_CH_HBO2              SAMPLE_BLOCK_CHANNELS       /**< ΔHbO2 row */
+#define     SB_CH_HHB               (SAMPLE_BLOCK_CHANNELS + 1) /**< ΔHHb row */
+#define     SB_CH_BASELINE(c)       (SAMPLE_BLOCK_CHANNELS + 2 + (c)) /**< Baseline row of optical channel c */
+#define     SB_CH_PI                (2 * SAMPLE_BLOCK_CHANNELS + 2)   /**< Perfusion index row */
+
+#define     SB_FLAG_GAP             (1u << 0)   /**< Samples were lost right before this block (seq jumps) */
+#define     SB_FLAG_GAIN            (1u << 1)   /**< LED currents or ADC range changed right before this block */
+#define     SB_FLAG_OFF_BODY        (1u << 2)   /**< Sensor left the skin in this block (set by the pipeline) */
+#define     SB_FLAG_RESUME          (1u << 3)   /**< First block after an off-body suspension (seq continues, tick jumps) */
+#define     SB_FLAG_OCCL_EVENT      (1u << 4)   /**< An occlusion or reperfusion phase ended in this block (set by the pipeline) */
+#define     SB_FLAG_SPIKE           (1u << 5)   /**< The spike filter replaced samples in this block (set by the pipeline) */
+
+/**
+ * @struct SampleBlock
+ * @brief Consecutive samples of one sensor, one aligned array per channel
+ */
+typedef struct {
+    float32_t ch[SAMPLE_BLOCK_FIELDS][SAMPLE_BLOCK_LEN] __ALIGNED(8); /**< Channel arrays (see Channels) */
+    uint32_t seq;           /**< Per-sensor sequence number of sample 0 */
+    uint32_t tick;          /**< Acquisition tick in which the block was read */
+    uint8_t  count;         /**< Valid samples (1..SAMPLE_BLOCK_LEN) */
+    uint8_t  first;         /**< First sample with valid output (set by the pipeline, 1 for the warm-up sample) */
+    uint8_t  sensor_id;     /**< MAX30101_Handle.id of the source sensor */
+    uint8_t  flags;         /**< SB_FLAG_* */
+    uint8_t  decimation;    /**< ADC samples averaged on chip per sample (1 = full rate) */
+    uint8_t  led[SAMPLE_BLOCK_CHANNELS]; /**< LED drive register code per optical channel (0.2 mA steps) */
+    uint8_t  adc_range;     /**< MAX30101_AdcRange the samples were taken with */
+    uint16_t quality;       /**< Signal-quality word of the block (set by the pipeline, 0 if disabled) */
+} SampleBlock;
+
+#endif /* SAMPLE_BLOCK_H_ */
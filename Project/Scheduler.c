@@ -0,0 +1,177 @@
+/**
+ * @file Scheduler.c
+ * @brief Static cooperative task scheduler implementation
+ * @details Fixed task table, priority-ordered dispatch, event/timer release and
+ *          execution-time / deadline accounting.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Scheduler.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @struct Sched_Entry
+ * @brief Runtime state of one registered task
+ */
+typedef struct {
+    const Sched_Task *task;         /**< Static description */
+    volatile uint8_t  pending;      /**< Event release pending (set by Sched_Signal) */
+    volatile uint32_t event_tick;   /**< Tick of the first unserved signal */
+    uint32_t          next_tick;    /**< Next timer release */
+    Sched_Stats       stats;        /**< Accounting */
+} Sched_Entry;
+
+static Sched_Entry sched_tasks[SCHED_MAX_TASKS];   /**< Indexed by task ID */
+static uint8_t sched_order[SCHED_MAX_TASKS];       /**< Task IDs sorted by priority */
+static uint8_t sched_count;
+static Sched_Counter sched_ticks;
+static Sched_Counter sched_cycles;
+
+/**
+ * @brief Reset the task table and set the time sources
+ * @param ticks - Tick counter (deadlines and periods are in these units)
+ * @param cycles - Cycle counter for execution time (NULL disables it)
+ * @return void
+ */
+void Sched_Init(Sched_Counter ticks, Sched_Counter cycles) {
+    sched_ticks = ticks;
+    sched_cycles = cycles;
+    sched_count = 0;
+}
+
+/**
+ * @brief Register a task
+ * @param task - [in] Task description (must stay valid)
+ * @return Task ID, or SCHED_INVALID_TASK if the table is full
+ */
+uint8_t Sched_AddTask(const Sched_Task *task) {
+    if (sched_count >= SCHED_MAX_TASKS) {
+        return SCHED_INVALID_TASK;
+    }
+    uint8_t id = sched_count;
+    Sched_Entry *e = &sched_tasks[id];
+    e->task = task;
+    e->pending = 0;
+    e->event_tick = 0;
+    e->next_tick = sched_ticks() + task->period_ticks;
+    e->stats.runs = 0;
+    e->stats.deadline_misses = 0;
+    e->stats.last_cycles = 0;
+    e->stats.max_cycles = 0;
+
+    // Insertion sort: after every task of the same or a more urgent priority
+    uint8_t pos = sched_count;
+    while (pos > 0 && sched_tasks[sched_order[pos - 1u]].task->priority > task->priority) {
+        sched_order[pos] = sched_order[pos - 1u];
+        pos--;
+    }
+    sched_order[pos] = id;
+    sched_count++;
+    return id;
+}
+
+/**
+ * @brief Release an event-triggered task
+ * @param id - Task ID from Sched_AddTask()
+ * @return void
+ */
+void Sched_Signal(uint8_t id) {
+    if (id >= sched_count) {
+        return;
+    }
+    Sched_Entry *e = &sched_tasks[id];
+    if (!e->pending) {
+        e->event_tick = sched_ticks();
+        e->pending = 1;
+    }
+}
+
+/**
+ * @brief Check whether a task is released and consume the release
+ * @param e - [in,out] Task entry
+ * @param now - Current tick
+ * @param release - [out] Release tick
+ * @return 1 if released, 0 otherwise
+ */
+static uint8_t Sched_TakeRelease(Sched_Entry *e, uint32_t now, uint32_t *release) {
+    if (e->pending) {
+        *release = e->event_tick;   // Stable while pending: Sched_Signal() only writes it when clear
+        e->pending = 0;
+        return 1;
+    }
+    uint16_t period = e->task->period_ticks;
+    if (period != 0u && (int32_t)(now - e->next_tick) >= 0) {
+        // Releases a full period (or more) behind are skipped and counted as misses;
+        // the run serves the latest one
+        uint32_t behind = (now - e->next_tick) / period;
+        e->stats.deadline_misses += behind;
+        *release = e->next_tick + behind * period;
+        e->next_tick = *release + period;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Run the most urgent ready task to completion
+ * @return 1 if a task ran, 0 if none was ready
+ */
+uint8_t Sched_RunOnce(void) {
+    uint32_t now = sched_ticks();
+    for (uint8_t k = 0; k < sched_count; k++) {
+        Sched_Entry *e = &sched_tasks[sched_order[k]];
+        uint32_t release;
+        if (!Sched_TakeRelease(e, now, &release)) {
+            continue;
+        }
+        uint32_t start = (sched_cycles != NULL) ? sched_cycles() : 0u;
+        e->task->run();
+        uint32_t cycles = (sched_cycles != NULL) ? sched_cycles() - start : 0u;
+
+        uint32_t deadline = (e->task->deadline_ticks != 0u) ? e->task->deadline_ticks : e->task->period_ticks;
+        if (deadline != 0u && sched_ticks() - release > deadline) {
+            e->stats.deadline_misses++;
+        }
+        e->stats.runs++;
+        e->stats.last_cycles = cycles;
+        if (cycles > e->stats.max_cycles) {
+            e->stats.max_cycles = cycles;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Get the accounting of a task
+ * @param id - Task ID
+ * @param out - [out] Statistics
+ * @return 1 on success, 0 for an unknown ID
+ */
+uint8_t Sched_GetStats(uint8_t id, Sched_Stats *out) {
+    if (id >= sched_count) {
+        return 0;
+    }
+    *out = sched_tasks[id].stats;
+    return 1;
+}
+
+/**
+ * @brief Name of a task
+ * @param id - Task ID
+ * @return Task name, or NULL for an unknown ID
+ */
+const char *Sched_GetName(uint8_t id) {
+    return (id < sched_count) ? sched_tasks[id].task->name : NULL;
+}
+
+/**
+ * @brief Number of registered tasks
+ * @return Task count
+ */
+uint8_t Sched_GetTaskCount(void) {
+    return sched_count;
+}
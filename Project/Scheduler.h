@@ -0,0 +1,122 @@
+/**
+ * @file Scheduler.h
+ * @brief Static cooperative task scheduler for the main-loop (background) work
+ * @details Run-to-completion tasks with fixed priorities, released by events and/or
+ *          periodic timers, with per-task execution-time and deadline-miss accounting.
+ *
+ * ### Model
+ *  - Tasks are registered once at init into a static table (SCHED_MAX_TASKS entries,
+ *    no heap). Each has a priority (0 = most urgent) and two optional triggers:
+ *    - **Event**: Sched_Signal() (ISR-safe) marks the task ready; repeated signals
+ *      before the task runs are coalesced into one release
+ *    - **Timer**: released every period_ticks ticks, drift-free (next = previous + period)
+ *  - Sched_RunOnce() runs the most urgent ready task to completion, then returns, so
+ *    priority is re-evaluated between every two task runs. Tasks never preempt each other
+ *  - Acquisition is not a task: it stays in SysTick_Handler and therefore preempts
+ *    every task. Background work can delay processing, never sampling
+ *
+ * ### Accounting
+ *  - Execution time per run in cycles (last and maximum)
+ *  - A deadline miss is counted when a run completes more than deadline_ticks after its
+ *    release, or when a timer release is skipped because the task fell a full period behind
+ *
+ * ### Time Sources
+ *  Both the tick and the cycle counter are injected through Sched_Init(), so the same
+ *  scheduler runs on target (SysTick count, DWT->CYCCNT) and on a host tick source.
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Sched_Init, Sched_AddTask, Sched_RunOnce
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdint.h>
+
+#define     SCHED_MAX_TASKS         8       /**< Task table capacity */
+#define     SCHED_INVALID_TASK      0xFFu   /**< Returned by Sched_AddTask() when the table is full */
+
+/**
+ * @brief Monotonic free-running counter (ticks or cycles), wraps at 2^32
+ */
+typedef uint32_t (*Sched_Counter)(void);
+
+/**
+ * @struct Sched_Task
+ * @brief Static task description (must stay valid, typically const)
+ */
+typedef struct {
+    const char *name;           /**< Task name (reporting only) */
+    void      (*run)(void);     /**< Run-to-completion entry */
+    uint8_t     priority;       /**< 0 = most urgent; equal priorities run in registration order */
+    uint16_t    period_ticks;   /**< Timer period in ticks, 0 = event-triggered only */
+    uint16_t    deadline_ticks; /**< Relative deadline from release in ticks, 0 = period_ticks (no check if both are 0) */
+} Sched_Task;
+
+/**
+ * @struct Sched_Stats
+ * @brief Per-task accounting since Sched_Init()
+ */
+typedef struct {
+    uint32_t runs;              /**< Completed runs */
+    uint32_t deadline_misses;   /**< Late completions plus skipped timer releases */
+    uint32_t last_cycles;       /**< Execution time of the latest run (cycles) */
+    uint32_t max_cycles;        /**< Longest run (cycles) */
+} Sched_Stats;
+
+/**
+ * @brief Reset the task table and set the time sources
+ * @param ticks - Tick counter (deadlines and periods are in these units)
+ * @param cycles - Cycle counter for execution time (NULL disables it)
+ * @return void
+ */
+void Sched_Init(Sched_Counter ticks, Sched_Counter cycles);
+
+/**
+ * @brief Register a task
+ * @details Timer tasks are first released one period after registration.
+ * @param task - [in] Task description (must stay valid)
+ * @return Task ID, or SCHED_INVALID_TASK if the table is full
+ */
+uint8_t Sched_AddTask(const Sched_Task *task);
+
+/**
+ * @brief Release an event-triggered task
+ * @details ISR-safe. The release time of a task already pending is kept, so the
+ *          deadline is measured from the first unserved signal.
+ * @param id - Task ID from Sched_AddTask()
+ * @return void
+ */
+void Sched_Signal(uint8_t id);
+
+/**
+ * @brief Run the most urgent ready task to completion
+ * @return 1 if a task ran, 0 if none was ready (caller may idle)
+ * @note Main-loop context only
+ */
+uint8_t Sched_RunOnce(void);
+
+/**
+ * @brief Get the accounting of a task
+ * @param id - Task ID
+ * @param out - [out] Statistics
+ * @return 1 on success, 0 for an unknown ID
+ */
+uint8_t Sched_GetStats(uint8_t id, Sched_Stats *out);
+
+/**
+ * @brief Name of a task
+ * @param id - Task ID
+ * @return Task name, or NULL for an unknown ID
+ */
+const char *Sched_GetName(uint8_t id);
+
+/**
+ * @brief Number of registered tasks (IDs are 0..count-1)
+ * @return Task count
+ */
+uint8_t Sched_GetTaskCount(void);
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,293 @@
+/**
+ * @file Stats.c
+ * @brief Sliding-window statistics implementation
+ * @details Sliding Welford mean/variance, monotonic min/max deques and running regression sums.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Stats.h"
+#include <stdint.h>
+
+/**
+ * @brief Initialize an empty window
+ * @param sw - [out] Window
+ * @param channels - Channels per frame
+ * @param capacity - Window length in frames
+ * @param hist - [in] History storage
+ * @param min_q - [in] Min deque storage
+ * @param max_q - [in] Max deque storage
+ * @return void
+ */
+void Stats_Init(Stats_Window *sw, uint8_t channels, uint16_t capacity,
+                float32_t *hist, uint16_t *min_q, uint16_t *max_q) {
+    if (channels < 1u) channels = 1u;
+    if (channels > STATS_MAX_CHANNELS) channels = STATS_MAX_CHANNELS;
+    if (capacity < 2u) capacity = 2u;
+    sw->hist = hist;
+    sw->min_q = min_q;
+    sw->max_q = max_q;
+    sw->channels = channels;
+    sw->capacity = capacity;
+    Stats_Reset(sw);
+}
+
+/**
+ * @brief Empty the window
+ * @param sw - [in,out] Window
+ * @return void
+ */
+void Stats_Reset(Stats_Window *sw) {
+    sw->count = 0;
+    sw->head = 0;
+    for (uint8_t c = 0; c < STATS_MAX_CHANNELS; c++) {
+        sw->ref[c] = 0.0f;
+        sw->mean[c] = 0.0f;
+        sw->m2[c] = 0.0f;
+        sw->ksum[c] = 0.0f;
+        sw->m2_peak[c] = 0.0f;
+        sw->min_first[c] = 0;
+        sw->min_len[c] = 0;
+        sw->max_first[c] = 0;
+        sw->max_len[c] = 0;
+    }
+}
+
+/**
+ * @brief Recompute the accumulators from the history of a full window
+ * @details Called when the ring has just wrapped or the sum of squares collapsed; the
+ *          oldest frame is at head. The reference moves to the window mean to keep d small
+ *          as the DC drifts.
+ * @param sw - [in,out] Window (count == capacity)
+ * @return void
+ */
+static void Stats_Refresh(Stats_Window *sw) {
+    const uint8_t C = sw->channels;
+    const uint16_t N = sw->capacity;
+    float32_t sum[STATS_MAX_CHANNELS];
+    float32_t ksum[STATS_MAX_CHANNELS];
+    float32_t m2[STATS_MAX_CHANNELS];
+
+    for (uint8_t c = 0; c < C; c++) {
+        sw->ref[c] += sw->mean[c];
+        sum[c] = 0.0f;
+        ksum[c] = 0.0f;
+        m2[c] = 0.0f;
+    }
+    // Two passes: the second one for the squared deviations from the exact mean
+    for (uint16_t k = 0, pos = sw->head; k < N; k++, pos = (uint16_t)((pos + 1u < N) ? pos + 1u : 0u)) {
+        const float32_t *f = &sw->hist[(uint32_t)pos * C];
+        for (uint8_t c = 0; c < C; c++) {
+            float32_t d = f[c] - sw->ref[c];
+            sum[c] += d;
+            ksum[c] += (float32_t)k * d;
+        }
+    }
+    for (uint8_t c = 0; c < C; c++) {
+        sw->mean[c] = sum[c] / (float32_t)N;
+    }
+    for (uint16_t k = 0; k < N; k++) {
+        const float32_t *f = &sw->hist[(uint32_t)k * C];  // Order does not matter here
+        for (uint8_t c = 0; c < C; c++) {
+            float32_t e = f[c] - sw->ref[c] - sw->mean[c];
+            m2[c] += e * e;
+        }
+    }
+    for (uint8_t c = 0; c < C; c++) {
+        sw->ksum[c] = ksum[c];
+        sw->m2[c] = m2[c];
+        sw->m2_peak[c] = m2[c];
+    }
+}
+
+/**
+ * @brief Update the min and max deques with the frame at the head position
+ * @details Evicts the outgoing position from the front when the window is full, then
+ *          pops from the back every position the new value dominates.
+ * @param sw - [in,out] Window (new frame already written at head)
+ * @param full - Window full before this frame (position head is being replaced)
+ * @return void
+ */
+static void Stats_UpdateExtremes(Stats_Window *sw, uint8_t full) {
+    const uint8_t C = sw->channels;
+    const uint16_t N = sw->capacity;
+    const uint16_t pos = sw->head;
+    const float32_t *f = &sw->hist[(uint32_t)pos * C];
+
+    for (uint8_t c = 0; c < C; c++) {
+        uint16_t *mq = &sw->min_q[(uint32_t)c * N];
+        uint16_t *xq = &sw->max_q[(uint32_t)c * N];
+        float32_t x = f[c];
+        uint16_t first, len, back;
+
+        // Minimum: values increasing from front to back
+        first = sw->min_first[c];
+        len = sw->min_len[c];
+        if (full && len > 0u && mq[first] == pos) {
+            first = (uint16_t)((first + 1u < N) ? first + 1u : 0u);
+            len--;
+        }
+        while (len > 0u) {
+            back = (uint16_t)(first + len - 1u);
+            if (back >= N) back = (uint16_t)(back - N);
+            if (sw->hist[(uint32_t)mq[back] * C + c] < x) break;
+            len--;
+        }
+        back = (uint16_t)(first + len);
+        if (back >= N) back = (uint16_t)(back - N);
+        mq[back] = pos;
+        sw->min_first[c] = first;
+        sw->min_len[c] = (uint16_t)(len + 1u);
+
+        // Maximum: values decreasing from front to back
+        first = sw->max_first[c];
+        len = sw->max_len[c];
+        if (full && len > 0u && xq[first] == pos) {
+            first = (uint16_t)((first + 1u < N) ? first + 1u : 0u);
+            len--;
+        }
+        while (len > 0u) {
+            back = (uint16_t)(first + len - 1u);
+            if (back >= N) back = (uint16_t)(back - N);
+            if (sw->hist[(uint32_t)xq[back] * C + c] > x) break;
+            len--;
+        }
+        back = (uint16_t)(first + len);
+        if (back >= N) back = (uint16_t)(back - N);
+        xq[back] = pos;
+        sw->max_first[c] = first;
+        sw->max_len[c] = (uint16_t)(len + 1u);
+    }
+}
+
+/**
+ * @brief Add one frame, dropping the oldest once the window is full
+ * @param sw - [in,out] Window
+ * @param x - [in] One value per channel
+ * @return void
+ */
+void Stats_Push(Stats_Window *sw, const float32_t *x) {
+    const uint8_t C = sw->channels;
+    const uint16_t N = sw->capacity;
+    float32_t *f = &sw->hist[(uint32_t)sw->head * C];
+    uint8_t full = (sw->count == N);
+    uint8_t collapsed = 0;
+
+    if (sw->count == 0u) {
+        for (uint8_t c = 0; c < C; c++) {
+            sw->ref[c] = x[c];  // Accumulators relative to the first value
+        }
+    }
+
+    if (full) {
+        // Slide: the oldest frame (at head) leaves, every index shifts down by one
+        const float32_t inv_n = 1.0f / (float32_t)N;
+        const float32_t last_k = (float32_t)(N - 1u);
+        for (uint8_t c = 0; c < C; c++) {
+            float32_t d_in = x[c] - sw->ref[c];
+            float32_t d_out = f[c] - sw->ref[c];
+            float32_t mean = sw->mean[c];
+            float32_t mean_new = mean + (d_in - d_out) * inv_n;
+            sw->m2[c] += (d_in - d_out) * (d_in - mean_new + d_out - mean);
+            sw->ksum[c] += last_k * d_in - ((float32_t)N * mean - d_out);
+            sw->mean[c] = mean_new;
+            f[c] = x[c];
+            sw->m2_peak[c] = (sw->m2[c] > sw->m2_peak[c]) ? sw->m2[c] : sw->m2_peak[c];
+            collapsed |= (sw->m2[c] < STATS_REFRESH_DROP * sw->m2_peak[c]);
+        }
+    } else {
+        // Grow: Welford insertion at index count
+        const float32_t k = (float32_t)sw->count;
+        const float32_t inv_n = 1.0f / (k + 1.0f);
+        for (uint8_t c = 0; c < C; c++) {
+            float32_t d_in = x[c] - sw->ref[c];
+            float32_t delta = d_in - sw->mean[c];
+            sw->mean[c] += delta * inv_n;
+            sw->m2[c] += delta * (d_in - sw->mean[c]);
+            sw->ksum[c] += k * d_in;
+            f[c] = x[c];
+        }
+        sw->count++;
+    }
+
+    Stats_UpdateExtremes(sw, full);
+
+    sw->head++;
+    if (sw->head >= N) {
+        sw->head = 0;
+        if (sw->count == N) {
+            collapsed = 1;
+        }
+    }
+    if (collapsed) {
+        Stats_Refresh(sw);
+    }
+}
+
+/**
+ * @brief Add n frames given as channel rows
+ * @param sw - [in,out] Window
+ * @param rows - [in] One pointer per channel to n values
+ * @param n - Number of frames
+ * @return void
+ */
+void Stats_PushRows(Stats_Window *sw, const float32_t *const *rows, uint32_t n) {
+    float32_t frame[STATS_MAX_CHANNELS];
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint8_t c = 0; c < sw->channels; c++) {
+            frame[c] = rows[c][i];
+        }
+        Stats_Push(sw, frame);
+    }
+}
+
+/**
+ * @brief One value of the window, oldest first
+ * @param sw - [in] Window
+ * @param c - Channel
+ * @param k - Frame index from the oldest
+ * @return Value
+ */
+float32_t Stats_Value(const Stats_Window *sw, uint8_t c, uint16_t k) {
+    if (c >= sw->channels || k >= sw->count) {
+        return 0.0f;
+    }
+    // The oldest frame is at position 0 until the window is full, then at head
+    uint32_t pos = (sw->count == sw->capacity) ? (uint32_t)sw->head + k : k;
+    if (pos >= sw->capacity) pos -= sw->capacity;
+    return sw->hist[pos * sw->channels + c];
+}
+
+/**
+ * @brief Statistics of one channel over the current window
+ * @details Slope = (n·Σk·d − Σk·Σd) / (n·Σk² − (Σk)²) with Σk = n(n − 1)/2, the
+ *          denominator reducing to n²(n² − 1)/12.
+ * @param sw - [in] Window
+ * @param c - Channel
+ * @param r - [out] Result
+ * @return void
+ */
+void Stats_Get(const Stats_Window *sw, uint8_t c, Stats_Result *r) {
+    r->mean = 0.0f;
+    r->var = 0.0f;
+    r->min = 0.0f;
+    r->max = 0.0f;
+    r->slope = 0.0f;
+    if (c >= sw->channels || sw->count == 0u) {
+        return;
+    }
+
+    const uint16_t N = sw->capacity;
+    const float32_t n = (float32_t)sw->count;
+    r->mean = sw->ref[c] + sw->mean[c];
+    r->min = sw->hist[(uint32_t)sw->min_q[(uint32_t)c * N + sw->min_first[c]] * sw->channels + c];
+    r->max = sw->hist[(uint32_t)sw->max_q[(uint32_t)c * N + sw->max_first[c]] * sw->channels + c];
+    if (sw->count < 2u) {
+        return;
+    }
+    r->var = (sw->m2[c] > 0.0f) ? sw->m2[c] / (n - 1.0f) : 0.0f;
+    float32_t sk = 0.5f * n * (n - 1.0f);
+    float32_t den = n * n * (n * n - 1.0f) * (1.0f / 12.0f);
+    r->slope = (n * sw->ksum[c] - sk * n * sw->mean[c]) / den;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file Stats.h
+ * @brief Sliding-window statistics: mean, variance, min/max and slope in O(1) per sample
+ * @details Trend features over a window of the last capacity frames of up to
+ *          STATS_MAX_CHANNELS channels (e.g. Red, IR, ΔHbO2, ΔHHb), updated per pushed
+ *          frame instead of being recomputed over the window. All memory is static:
+ *          the window context and the caller-provided history and deque arrays.
+ *
+ * ### Algorithms
+ *  - **Mean / variance**: Welford accumulators with the sliding update (the oldest
+ *    sample replaced by the newest); sample variance (n − 1)
+ *  - **Min / max**: monotonic deques of history positions, amortized O(1)
+ *  - **Slope**: least-squares line over the window against the sample index, from the
+ *    running sums Σd and Σk·d (k = 0 for the oldest sample), shifted in O(1) per sample
+ *  - Sums are kept relative to a per-channel reference level so the float accumulators
+ *    stay at the scale of the variation, not of the DC (2000 nA vs a few nA). Each time the
+ *    history ring wraps, the accumulators are recomputed exactly from the history and the
+ *    reference moved to the window mean (O(capacity) once per capacity samples), so
+ *    rounding errors never build up
+ *  - A step or spike leaving the window makes the sliding sum of squares fall by orders of
+ *    magnitude, and its rounding error (relative to the peak) with it. When it drops below
+ *    STATS_REFRESH_DROP of its peak since the last recompute, the accumulators are
+ *    recomputed at once. The values that raised the sum leave a capacity after they
+ *    entered, so these recomputes stay rare (a step costs one)
+ *
+ * ### Layout
+ *  History frames are stored interleaved (one frame = channels contiguous values) and the
+ *  accumulators as per-channel arrays, so the per-frame update is a branch-free loop over
+ *  channels that vectorizes on SIMD hosts; only the deques branch per channel.
+ *
+ * ### Long Windows
+ *  RAM per window is capacity · channels · 8 bytes (history and two deques). Windows of
+ *  tens of seconds should be fed decimated values (e.g. one block mean per block) rather
+ *  than every sample: 60 s of 8-sample block means at 50 Hz is a capacity of 375.
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Stats_Push, Stats_Get
+ */
+
+#ifndef STATS_H_
+#define STATS_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+
+#define     STATS_MAX_CHANNELS      4   /**< Largest number of channels per window */
+#define     STATS_REFRESH_DROP      (1.0f / 256.0f) /**< Recompute once the sum of squares falls below this fraction of its peak (8 of 24 bits lost) */
+
+/** Length of the history array, and of each deque array, for a window (elements) */
+#define     STATS_STORAGE_LEN(capacity, channels)   ((uint32_t)(capacity) * (uint32_t)(channels))
+
+/**
+ * @struct Stats_Result
+ * @brief Statistics of one channel over the current window
+ */
+typedef struct {
+    float32_t mean;     /**< Mean */
+    float32_t var;      /**< Sample variance (0 with fewer than 2 samples) */
+    float32_t min;      /**< Minimum */
+    float32_t max;      /**< Maximum */
+    float32_t slope;    /**< Least-squares slope per sample (0 with fewer than 2 samples) */
+} Stats_Result;
+
+/**
+ * @struct Stats_Window
+ * @brief Sliding window over several channels
+ */
+typedef struct {
+    float32_t *hist;                        /**< History ring, capacity frames (caller storage) */
+    uint16_t  *min_q;                       /**< Min deques, capacity positions per channel (caller storage) */
+    uint16_t  *max_q;                       /**< Max deques, capacity positions per channel (caller storage) */
+    uint16_t  capacity;                     /**< Window length in frames */
+    uint8_t   channels;                     /**< Channels per frame */
+    uint16_t  count;                        /**< Frames in the window */
+    uint16_t  head;                         /**< History position of the next frame */
+    float32_t ref[STATS_MAX_CHANNELS];      /**< Reference level the accumulators are relative to */
+    float32_t mean[STATS_MAX_CHANNELS];     /**< Mean of d = x − ref */
+    float32_t m2[STATS_MAX_CHANNELS];       /**< Sum of squared deviations from the mean */
+    float32_t ksum[STATS_MAX_CHANNELS];     /**< Σ k·d, k = 0 for the oldest frame */
+    float32_t m2_peak[STATS_MAX_CHANNELS];  /**< Largest m2 since the last recompute */
+    uint16_t  min_first[STATS_MAX_CHANNELS]; /**< Min deque front */
+    uint16_t  min_len[STATS_MAX_CHANNELS];  /**< Min deque length */
+    uint16_t  max_first[STATS_MAX_CHANNELS]; /**< Max deque front */
+    uint16_t  max_len[STATS_MAX_CHANNELS];  /**< Max deque length */
+} Stats_Window;
+
+/**
+ * @brief Initialize an empty window
+ * @param sw - [out] Window
+ * @param channels - Channels per frame (1..STATS_MAX_CHANNELS, clamped)
+ * @param capacity - Window length in frames (≥ 2)
+ * @param hist - [in] History storage, STATS_STORAGE_LEN(capacity, channels) floats
+ * @param min_q - [in] Min deque storage, STATS_STORAGE_LEN(capacity, channels) entries
+ * @param max_q - [in] Max deque storage, STATS_STORAGE_LEN(capacity, channels) entries
+ * @return void
+ */
+void Stats_Init(Stats_Window *sw, uint8_t channels, uint16_t capacity,
+                float32_t *hist, uint16_t *min_q, uint16_t *max_q);
+
+/**
+ * @brief Empty the window (e.g. after a sample gap)
+ * @param sw - [in,out] Window
+ * @return void
+ */
+void Stats_Reset(Stats_Window *sw);
+
+/**
+ * @brief Add one frame, dropping the oldest once the window is full
+ * @param sw - [in,out] Window
+ * @param x - [in] One value per channel
+ * @return void
+ */
+void Stats_Push(Stats_Window *sw, const float32_t *x);
+
+/**
+ * @brief Add n frames given as channel rows (e.g. SampleBlock rows)
+ * @param sw - [in,out] Window
+ * @param rows - [in] One pointer per channel to n values
+ * @param n - Number of frames
+ * @return void
+ */
+void Stats_PushRows(Stats_Window *sw, const float32_t *const *rows, uint32_t n);
+
+/**
+ * @brief One value of the window, oldest first
+ * @param sw - [in] Window
+ * @param c - Channel
+ * @param k - Frame index from the oldest (0) to the newest (count − 1)
+ * @return Value (0 if k or c is out of range)
+ */
+float32_t Stats_Value(const Stats_Window *sw, uint8_t c, uint16_t k);
+
+/**
+ * @brief Statistics of one channel over the current window
+ * @param sw - [in] Window
+ * @param c - Channel
+ * @param r - [out] Result (all 0 for an empty window)
+ * @return void
+ */
+void Stats_Get(const Stats_Window *sw, uint8_t c, Stats_Result *r);
+
+#endif /* STATS_H_ */
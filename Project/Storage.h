@@ -0,0 +1,49 @@
+/**
+ * @file Storage.h
+ * @brief Page-erasable storage backend interface
+ * @details Abstracts the medium used by the session recorder: internal flash on target
+ *          (Flash.c), or any other page-erasable device such as external SPI NOR or a
+ *          file-backed stand-in on a host. The recorder only uses these four operations.
+ *
+ * ### Medium Model
+ *  - num_pages pages of page_size bytes, addressed by byte offset from the start
+ *  - erase sets a whole page to 0xFF
+ *  - program only clears bits, in even-length chunks at even offsets (half-word flash)
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Recorder_Init, Flash_Backend
+ */
+
+#ifndef STORAGE_H_
+#define STORAGE_H_
+
+#include <stdint.h>
+
+/**
+ * @enum Storage_Status
+ * @brief Result of a storage operation
+ */
+typedef enum {
+    STORAGE_OK = 0,         /**< Operation completed and verified */
+    STORAGE_ERR_RANGE,      /**< Offset/length outside the medium or misaligned */
+    STORAGE_ERR_ERASE,      /**< Page erase failed */
+    STORAGE_ERR_PROGRAM,    /**< Program failed or read-back mismatch */
+    STORAGE_ERR_WRPROT,     /**< Medium is write protected */
+    STORAGE_ERR_TIMEOUT     /**< Operation did not complete within its deadline */
+} Storage_Status;
+
+/**
+ * @struct Storage_Backend
+ * @brief Storage medium operations and geometry
+ */
+typedef struct {
+    uint32_t page_size;     /**< Erase unit in bytes */
+    uint16_t num_pages;     /**< Number of pages */
+    Storage_Status (*erase)(uint16_t page);                                         /**< Erase one page */
+    Storage_Status (*program)(uint32_t offset, const uint8_t *data, uint16_t len);  /**< Program bytes (even offset and length) */
+    Storage_Status (*read)(uint32_t offset, uint8_t *data, uint16_t len);           /**< Read bytes */
+} Storage_Backend;
+
+#endif /* STORAGE_H_ */
@@ -0,0 +1,46 @@
+/**
+ * @file Telemetry.c
+ * @brief "#tlm" frame encoder implementation
+ * @details Field-by-field encoding with Fmt_Uint() and Fmt_Fixed4(), no intermediate buffer.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Telemetry.h"
+#include <stdint.h>
+
+/**
+ * @brief Encode a frame as one line
+ * @param p - [out] Destination
+ * @param f - [in] Frame
+ * @return Pointer one past the "\r\n"
+ */
+char *Tlm_Format(char *p, const Tlm_Frame *f) {
+    const char *tag = TLM_PREFIX;
+    while (*tag) {
+        *p++ = *tag++;
+    }
+    p = Fmt_Uint(p, f->t_us);
+    *p++ = ',';
+    p = Fmt_Fixed4(p, f->idle_pct);
+    *p++ = ',';
+    p = Fmt_Fixed4(p, f->i2c_pct);
+    *p++ = ',';
+    p = Fmt_Uint(p, f->tx_pending);
+    *p++ = ',';
+    p = Fmt_Uint(p, f->tx_peak);
+    *p++ = ',';
+    p = Fmt_Uint(p, f->ring_peak);
+    *p++ = ',';
+    p = Fmt_Uint(p, f->dropped);
+    *p++ = ',';
+    p = Fmt_Uint(p, f->fifo_ovf);
+    *p++ = ',';
+    p = Fmt_Fixed4(p, f->latency_us);
+    *p++ = ',';
+    p = Fmt_Fixed4(p, f->isr_max_us);
+    *p++ = '\r';
+    *p++ = '\n';
+    return p;
+}
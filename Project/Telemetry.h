@@ -0,0 +1,55 @@
+/**
+ * @file Telemetry.h
+ * @brief "#tlm" runtime telemetry frame: field layout and encoder
+ * @details One definition of the frame for the firmware (Output_Telemetry in main.c) and the
+ *          host decoder (Host/Tools/TelemetryDecode.c):
+ *
+ *          #tlm,<t_us>,<idle_pct>,<i2c_pct>,<tx_pending>,<tx_peak>,<ring_peak>,<dropped>,<fifo_ovf>,<latency_us>,<isr_max_us>\r\n
+ *
+ *          Fields 1 and 4–8 are unsigned decimal integers (Fmt_Uint), fields 2, 3, 9 and
+ *          10 have four decimals (Fmt_Fixed4).
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Tlm_Format, Tlm_Parse
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include "arm_math_types.h"
+#include "Format.h"
+
+#define     TLM_PREFIX          "#tlm,"     /**< Frame tag */
+#define     TLM_FIELDS          10u         /**< Fields after the tag */
+
+/** Longest frame: tag, 6 integers, 4 decimals, 9 separators and "\r\n" */
+#define     TLM_LINE_MAX_CHARS  (sizeof(TLM_PREFIX) - 1u + FMT_UINT_MAX_CHARS * 6u + FMT_FIXED4_MAX_CHARS * 4u + 11u)
+
+/**
+ * @struct Tlm_Frame
+ * @brief Contents of one "#tlm" frame, in field order
+ */
+typedef struct {
+    uint32_t  t_us;         /**< Device time of the frame (µs, same base as "#sync") */
+    float32_t idle_pct;     /**< Main-loop idle time since the previous frame (% of the cycles) */
+    float32_t i2c_pct;      /**< I2C bus time since the previous frame (% of the cycles) */
+    uint32_t  tx_pending;   /**< UART TX ring bytes queued now */
+    uint32_t  tx_peak;      /**< Most UART TX ring bytes queued at once */
+    uint32_t  ring_peak;    /**< Most SampleBlocks queued at once */
+    uint32_t  dropped;      /**< Samples dropped on a full ring */
+    uint32_t  fifo_ovf;     /**< Sensor FIFO overflows */
+    float32_t latency_us;   /**< Worst SysTick entry latency (µs) */
+    float32_t isr_max_us;   /**< Longest SysTick_Handler run (µs) */
+} Tlm_Frame;
+
+/**
+ * @brief Encode a frame as one line
+ * @param p - [out] Destination (at least TLM_LINE_MAX_CHARS bytes, not NUL-terminated)
+ * @param f - [in] Frame
+ * @return Pointer one past the "\r\n"
+ */
+char *Tlm_Format(char *p, const Tlm_Frame *f);
+
+#endif /* TELEMETRY_H_ */
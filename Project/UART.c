@@ -2,26 +2,61 @@
  * @file UART.c
  * @brief USART2 driver implementation for MAX30101 data transmission
  * @details Configures USART2 (PA2=TX, PA15=RX) at variable baud rate
- *          with blocking transmission support.
+ *          with interrupt-driven transmission from a TX ring buffer and circular-DMA
+ *          reception delimited by the IDLE-line interrupt.
  * @author Julio Fajardo, PhD
  * @date 2026-03-26
  * @version 2.0
  */
 
 #include "UART.h"
+#include "PLL.h"
 #include "stm32f303x8.h"
-#include "system_stm32f3xx.h"
+#include <stddef.h>
 #include <stdint.h>
 
+#define UART_TX_MASK    (USART2_TX_RING_SIZE - 1u)
+
+static char uart_tx_ring[USART2_TX_RING_SIZE];      /**< TX ring storage */
+static volatile uint16_t uart_tx_head = 0;          /**< Producer index (main loop) */
+static volatile uint16_t uart_tx_tail = 0;          /**< Consumer index (USART2 ISR) */
+static uint16_t uart_tx_peak = 0;                   /**< Most bytes queued at once (main loop) */
+
+#define UART_RX_MASK    (USART2_RX_DMA_SIZE - 1u)
+#define UART_MSG_MASK   (USART2_RX_MSG_SLOTS - 1u)
+
+/**
+ * @struct UART_RxSlot
+ * @brief Descriptor of one received message
+ */
+typedef struct {
+    uint32_t start;     /**< Byte count (uart_rx_total) at the first byte */
+    uint16_t len;       /**< Message length in bytes */
+    uint32_t cycles;    /**< DWT->CYCCNT at IDLE detection */
+} UART_RxSlot;
+
+static uint8_t uart_rx_buf[USART2_RX_DMA_SIZE];     /**< Circular DMA receive buffer */
+static volatile uint16_t uart_rx_pos = 0;           /**< DMA write index at the last update (ISRs) */
+static volatile uint32_t uart_rx_total = 0;         /**< Bytes received up to uart_rx_pos (ISRs) */
+static uint32_t uart_rx_msg_start = 0;              /**< Byte count at the start of the open message (ISRs) */
+static UART_RxSlot uart_rx_msg[USART2_RX_MSG_SLOTS]; /**< Message descriptor ring */
+static volatile uint8_t uart_msg_head = 0;          /**< Producer index (USART2 ISR) */
+static volatile uint8_t uart_msg_tail = 0;          /**< Consumer index (main loop) */
+static volatile uint32_t uart_rx_dropped = 0;       /**< Messages lost */
+
 /**
  * @brief Initialize USART2 for configurable baud rate transmission
  * @details Complete USART2 setup sequence:
  *          1. Enable GPIOA and USART2 clocks
  *          2. Configure PA2 (TX) and PA15 (RX) as AF7 (Alternate Function 7)
- *          3. Configure BRR for desired baud rate
- *          4. Enable transmitter, receiver, and receiver interrupt
+ *          3. Kernel clock = SYSCLK; BRR (and OVER8 above SYSCLK / 16) from Clock_UsartDivider()
+ *          4. Start DMA1 channel 6 in circular mode from RDR into the receive buffer,
+ *             with half/full-transfer interrupts
+ *          5. Enable transmitter, receiver, DMA reception and the IDLE-line interrupt
+ *          6. Enable the USART2 (TX ring drain, IDLE) and DMA1 channel 6 NVIC lines, both
+ *             at the same (reset) priority so their handlers never nest
  *
- * @param baud_rate - Desired baud rate (e.g., 460800 as used in this project)
+ * @param baud_rate - Desired baud rate (e.g., 460800 as used in this project, up to SYSCLK / 8)
  * @return void
  *
  * @timing
@@ -44,56 +79,282 @@ void UART_Config(uint32_t baud_rate) {
     // Set PA15 alternate function to AF7 (USART2_RX)
     GPIOA->AFR[1] |= (0x07 << 28);
     
-    // Configure baud rate: BRR = (APB1_Clock / baud_rate)
-    // APB1 = 32 MHz (SYSCLK/2), so BRR = 32MHz / baud_rate
-    USART2->BRR = (uint32_t)((SystemCoreClock / 2) / baud_rate);
+    // USART2 kernel clock = SYSCLK: finer divider (460800 baud: -0.08% instead of +0.64% from PCLK1)
+    RCC->CFGR3 = (RCC->CFGR3 & ~RCC_CFGR3_USART2SW) | (1u << RCC_CFGR3_USART2SW_Pos);
+    // Configure baud rate from the active clock tree (BRR = 0x8B at 64 MHz, 460800 baud)
+    Clock_Tree tree;
+    uint8_t over8 = 0;
+    Clock_GetTree(&tree);
+    USART2->BRR = Clock_UsartDivider(tree.usart2_ck, baud_rate, &over8);
+    if (over8) {
+        USART2->CR1 |= USART_CR1_OVER8;  // Baud rates above SYSCLK / 16 (up to 8 Mbaud)
+    }
+    // Circular DMA reception (DMA1 channel 6 = USART2_RX): bytes, memory increment
+    RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+    DMA1_Channel6->CCR = 0;
+    DMA1_Channel6->CPAR = (uint32_t)(uintptr_t)&USART2->RDR;
+    DMA1_Channel6->CMAR = (uint32_t)(uintptr_t)uart_rx_buf;
+    DMA1_Channel6->CNDTR = USART2_RX_DMA_SIZE;
+    DMA1->IFCR = DMA_IFCR_CGIF6;
+    DMA1_Channel6->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_EN;
+    USART2->CR3 |= USART_CR3_DMAR;
     // Enable transmitter and receiver
     USART2->CR1 |= USART_CR1_RE | USART_CR1_TE;
     // Enable USART2
     USART2->CR1 |= USART_CR1_UE;
-    // Enable receiver interrupt for future use
-    USART2->CR1 |= USART_CR1_RXNEIE;
+    // A received burst is closed by the IDLE-line interrupt, not one interrupt per byte
+    USART2->ICR = USART_ICR_IDLECF;
+    USART2->CR1 |= USART_CR1_IDLEIE;
+    // TX ring is drained by USART2_IRQHandler on TXE
+    NVIC_EnableIRQ(USART2_IRQn);
+    NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+}
+
+/**
+ * @brief Queue bytes for transmission
+ * @details Copies the bytes into the TX ring and arms the TXE interrupt. When the ring
+ *          is full, waits for the ISR to free space (the interrupt is armed first).
+ *
+ * @param data - Bytes to transmit
+ * @param len - Number of bytes
+ * @return void
+ *
+ * @note Main-loop context only (single producer)
+ * @see USART2_IRQHandler
+ */
+void USART2_Write(const char *data, uint16_t len) {
+    while (len--) {
+        uint16_t next = (uart_tx_head + 1u) & UART_TX_MASK;
+        if (next == uart_tx_tail) {
+            // Ring full: make sure the drain is running, then wait for space
+            USART2->CR1 |= USART_CR1_TXEIE;
+            while (next == uart_tx_tail);
+        }
+        uart_tx_ring[uart_tx_head] = *data++;
+        __DMB(); // Byte visible before the index that publishes it
+        uart_tx_head = next;
+    }
+    USART2->CR1 |= USART_CR1_TXEIE;
+    uint16_t pending = USART2_GetTxPending();
+    if (pending > uart_tx_peak) {
+        uart_tx_peak = pending;
+    }
+}
+
+/**
+ * @brief Wait until every queued byte has left the shift register
+ * @return void
+ * @note Main-loop context only
+ */
+void USART2_Flush(void) {
+    while (uart_tx_tail != uart_tx_head);
+    while (!(USART2->ISR & USART_ISR_TC));
+}
+
+/**
+ * @brief Account for the bytes the DMA wrote since the last update
+ * @details Called from the DMA half/full-transfer and IDLE interrupts, so at most half a
+ *          buffer (plus interrupt latency) passes between two updates and the position
+ *          difference is unambiguous.
+ * @return void
+ * @note ISR context (USART2 and DMA1 channel 6, same priority)
+ */
+static void USART2_RxAdvance(void) {
+    uint16_t pos = (uint16_t)((USART2_RX_DMA_SIZE - DMA1_Channel6->CNDTR) & UART_RX_MASK);
+    uart_rx_total += (uint16_t)(pos - uart_rx_pos) & UART_RX_MASK;
+    uart_rx_pos = pos;
+}
+
+/**
+ * @brief Bytes received so far, including those not yet accounted for by an interrupt
+ * @return Byte count since UART_Config()
+ * @note Main-loop context; retried if an interrupt updates the count meanwhile
+ */
+static uint32_t USART2_RxTotal(void) {
+    uint32_t total;
+    uint16_t pos;
+    uint16_t now;
+    do {
+        total = uart_rx_total;
+        pos = uart_rx_pos;
+        now = (uint16_t)((USART2_RX_DMA_SIZE - DMA1_Channel6->CNDTR) & UART_RX_MASK);
+    } while (total != uart_rx_total);
+    return total + ((uint16_t)(now - pos) & UART_RX_MASK);
+}
+
+/**
+ * @brief Get the oldest received message without removing it
+ * @details Messages whose first byte was already overwritten are dropped and counted.
+ * @param msg - [out] Message view
+ * @return 1 if a message was returned, 0 if none is pending
+ * @note Main-loop context only (single consumer)
+ */
+uint8_t USART2_PeekMessage(USART2_Message *msg) {
+    for (;;) {
+        uint8_t tail = uart_msg_tail;
+        if (tail == uart_msg_head) {
+            return 0;
+        }
+        __DMB(); // Read the slot only after observing the head index that published it
+        const UART_RxSlot *slot = &uart_rx_msg[tail];
+        if (USART2_RxTotal() - slot->start > USART2_RX_DMA_SIZE) {
+            uart_rx_dropped++;
+            uart_msg_tail = (uint8_t)((tail + 1u) & UART_MSG_MASK);
+            continue;
+        }
+        uint16_t first = (uint16_t)(slot->start & UART_RX_MASK);
+        uint16_t room = (uint16_t)(USART2_RX_DMA_SIZE - first);
+        msg->data = &uart_rx_buf[first];
+        msg->cycles = slot->cycles;
+        if (slot->len > room) {
+            msg->len = room;
+            msg->wrap = uart_rx_buf;
+            msg->wrap_len = (uint16_t)(slot->len - room);
+        } else {
+            msg->len = slot->len;
+            msg->wrap = NULL;
+            msg->wrap_len = 0;
+        }
+        return 1;
+    }
+}
+
+/**
+ * @brief Release the message returned by USART2_PeekMessage()
+ * @return 1 if the view was intact until now, 0 if the DMA overwrote it
+ * @note Main-loop context only
+ */
+uint8_t USART2_ReleaseMessage(void) {
+    uint8_t tail = uart_msg_tail;
+    if (tail == uart_msg_head) {
+        return 0;
+    }
+    uint8_t intact = (USART2_RxTotal() - uart_rx_msg[tail].start <= USART2_RX_DMA_SIZE);
+    if (!intact) {
+        uart_rx_dropped++;
+    }
+    __DMB(); // Finish using the slot before handing it back to the producer
+    uart_msg_tail = (uint8_t)((tail + 1u) & UART_MSG_MASK);
+    return intact;
+}
+
+/**
+ * @brief Number of received messages lost
+ * @return Dropped message count since UART_Config()
+ */
+uint32_t USART2_GetRxDropped(void) {
+    return uart_rx_dropped;
+}
+
+/**
+ * @brief Bytes queued in the TX ring
+ * @return Bytes not yet handed to the shift register
+ */
+uint16_t USART2_GetTxPending(void) {
+    return (uint16_t)((uart_tx_head - uart_tx_tail) & UART_TX_MASK);
+}
+
+/**
+ * @brief Most bytes queued in the TX ring at once
+ * @return High-water mark since UART_Config()
+ */
+uint16_t USART2_GetTxHighWater(void) {
+    return uart_tx_peak;
+}
+
+/**
+ * @brief DMA1 channel 6 (USART2_RX) interrupt handler
+ * @details Half and full transfer: keeps the received byte count current during long
+ *          bursts.
+ * @return void
+ */
+void DMA1_Channel6_IRQHandler(void) {
+    DMA1->IFCR = DMA_IFCR_CGIF6;
+    USART2_RxAdvance();
+}
+
+/**
+ * @brief USART2 interrupt handler
+ * @details
+ *  - TXE: moves the next ring byte to TDR; disables TXEIE once the ring is empty
+ *  - IDLE: closes the message received since the previous IDLE (position, length and
+ *    arrival cycle count into the descriptor ring; dropped when the ring is full)
+ *  - ORE: cleared so a receive overrun cannot retrigger the interrupt forever
+ * @return void
+ */
+void USART2_IRQHandler(void) {
+    uint32_t isr = USART2->ISR;
+
+    if (isr & USART_ISR_IDLE) {
+        uint32_t stamp = DWT->CYCCNT;
+        USART2->ICR = USART_ICR_IDLECF;
+        USART2_RxAdvance();
+        uint32_t len = uart_rx_total - uart_rx_msg_start;
+        if (len > 0u) {
+            uint8_t head = uart_msg_head;
+            uint8_t next = (uint8_t)((head + 1u) & UART_MSG_MASK);
+            if (next == uart_msg_tail || len > USART2_RX_DMA_SIZE) {
+                uart_rx_dropped++;
+            } else {
+                uart_rx_msg[head].start = uart_rx_msg_start;
+                uart_rx_msg[head].len = (uint16_t)len;
+                uart_rx_msg[head].cycles = stamp;
+                __DMB(); // Descriptor visible before the index that publishes it
+                uart_msg_head = next;
+            }
+            uart_rx_msg_start = uart_rx_total;
+        }
+    }
+    if (isr & USART_ISR_ORE) {
+        USART2->ICR = USART_ICR_ORECF;
+    }
+    if ((isr & USART_ISR_TXE) && (USART2->CR1 & USART_CR1_TXEIE)) {
+        uint16_t tail = uart_tx_tail;
+        if (tail != uart_tx_head) {
+            USART2->TDR = (uint8_t)uart_tx_ring[tail];
+            uart_tx_tail = (tail + 1u) & UART_TX_MASK;
+        } else {
+            USART2->CR1 &= ~USART_CR1_TXEIE;
+        }
+    }
 }
 
 /**
  * @brief Send single character via USART2
- * @details Blocks until previous transmission complete, then sends one byte
+ * @details Queues one byte in the TX ring
  *
  * @param c - Character byte to transmit
  * @return void
  *
  * @timing
- *  - Per-byte latency: ~22 µs at 460800 baud (10 bits/byte: 8N1)
+ *  - Returns immediately unless the TX ring is full
+ *  - Line rate: ~22 µs per byte at 460800 baud (10 bits/byte: 8N1)
  *
- * @note Blocking function; waits for TC (transmission complete) flag
- * @see UART_Config, USART2_putString
+ * @see UART_Config, USART2_Write
  */
 void USART2_Send(uint8_t c) {
-    // Wait for previous transmission to complete (TC flag)
-    while (!(USART2->ISR & USART_ISR_TC));
-    // Load character into transmit data register
-    USART2->TDR = c;
+    char ch = (char)c;
+    USART2_Write(&ch, 1);
 }
 
 /**
  * @brief Send null-terminated string via USART2
- * @details Transmits string character-by-character using USART2_Send()
+ * @details Queues the string in the TX ring
  *
- * @param string - Pointer to null-terminated character string
+ * @param string - [in] Pointer to null-terminated character string (not modified)
  * @return void
  *
  * @timing
- *  - Per-character latency: ~22 µs at 460800 baud (10 bits/byte: 8N1)
- *  - Example: 10-character string ≈ 220 µs total; typical CSV frame ~350 µs
+ *  - Returns immediately unless the TX ring is full
+ *  - Line rate: ~22 µs per character at 460800 baud; typical CSV frame ~350 µs
  *
  * @data_format String must be null-terminated (\\0)
- * @note Blocking function; waits for each character's transmission
- * @see UART_Config, USART2_Send
- */
-void USART2_putString(char *string) {
-    // Transmit each character until null terminator
-    while (*string) {
-        USART2_Send(*string);
-        string++;
+ * @see UART_Config, USART2_Write
+ */
+void USART2_putString(const char *string) {
+    const char *end = string;
+    while (*end) {
+        end++;
     }
-}
\ No newline at end of file
+    USART2_Write(string, (uint16_t)(end - string));
+}
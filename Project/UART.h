@@ -1,7 +1,21 @@
 /**
  * @file UART.h
  * @brief USART2 driver for MAX30101 data transmission
- * @details Configures USART2 (PA2=TX, PA15=RX) at variable baud rate with blocking transmission
+ * @details Configures USART2 (PA2=TX, PA15=RX) at variable baud rate. Transmission goes
+ *          through a TX ring drained by the TXE interrupt, so callers only block when
+ *          the ring is full.
+ *
+ * ### Reception
+ *  - DMA1 channel 6 copies every received byte into a circular buffer
+ *    (USART2_RX_DMA_SIZE); the CPU takes no interrupt per byte
+ *  - The IDLE-line interrupt (one idle character after a burst) closes a message: its
+ *    position, length and arrival time go into a small descriptor ring. The DMA
+ *    half/full-transfer interrupts keep the byte count exact within long bursts
+ *  - USART2_PeekMessage() returns a zero-copy view into the DMA buffer (two segments
+ *    when the message wraps around the end); USART2_ReleaseMessage() frees it and
+ *    reports whether the DMA overwrote it meanwhile
+ *  - Messages are dropped and counted when the descriptor ring is full or their bytes
+ *    were overwritten before they were peeked
  * @author Julio Fajardo, PhD
  * @date 2026-03-26
  */
@@ -11,13 +25,40 @@
 
 #include <stdint.h>
 
+#define     USART2_TX_RING_SIZE     512 /**< TX ring capacity in bytes (power of two; ~11 ms of line time at 460800 baud) */
+#define     USART2_RX_DMA_SIZE      256 /**< Circular DMA receive buffer in bytes (power of two) */
+#define     USART2_RX_MSG_SLOTS     8   /**< Message descriptor ring capacity (power of two) */
+
+/**
+ * @struct USART2_Message
+ * @brief Zero-copy view of one received message (the bytes of one burst)
+ */
+typedef struct {
+    const uint8_t *data;    /**< First segment, in the DMA buffer */
+    uint16_t len;           /**< Bytes in the first segment */
+    const uint8_t *wrap;    /**< Second segment (buffer start) if the message wraps, else NULL */
+    uint16_t wrap_len;      /**< Bytes in the second segment */
+    uint32_t cycles;        /**< DWT->CYCCNT at IDLE detection, one character time after the last byte */
+} USART2_Message;
+
+/**
+ * @brief Byte i of a message view
+ * @param msg - [in] Message view
+ * @param i - Byte index (< len + wrap_len)
+ * @return Byte
+ */
+static inline uint8_t USART2_MessageByte(const USART2_Message *msg, uint16_t i) {
+    return (i < msg->len) ? msg->data[i] : msg->wrap[i - msg->len];
+}
+
 /**
  * @brief Initialize USART2 for configurable baud rate transmission
  * @details Configuration sequence:
  *          1. Enable clocks: USART2, GPIOA
  *          2. Configure PA2 (TX) and PA15 (RX) as alternate function AF7
  *          3. Configure USART2: desired baud, 8-bit data, 1 stop bit
- *          4. Enable receiver interrupt
+ *          4. Start circular DMA reception (DMA1 channel 6) with the IDLE-line interrupt
+ *          5. Enable the USART2 and DMA1 channel 6 NVIC lines
  *
  * @param baud_rate - Desired baud rate
  * @return void
@@ -36,47 +77,101 @@
 void UART_Config(uint32_t baud_rate);
 
 /**
- * @brief Send single character via UART
- * @details Blocks until previous transmission complete, then sends one byte
+ * @brief Queue bytes for transmission
+ * @details Copies the bytes into the TX ring and arms the TXE interrupt
  *
- * @param c - Character byte to transmit
+ * @param data - Bytes to transmit
+ * @param len - Number of bytes
  * @return void
- * @retval N/A (blocking)
  *
  * @timing
- *  - Per-byte latency: ~22 µs at 460800 baud (10 bits/byte: 8N1)
+ *  - Returns immediately unless the ring is full; then waits for the ISR to free space
+ *  - Line rate: ~22 µs per byte at 460800 baud (10 bits/byte: 8N1)
+ *
+ * @note Main-loop context only (single producer)
+ * @see USART2_Flush
+ */
+void USART2_Write(const char *data, uint16_t len);
+
+/**
+ * @brief Wait until all queued bytes have been transmitted
+ * @return void
+ */
+void USART2_Flush(void);
+
+/**
+ * @brief Get the oldest received message without removing it
+ * @details The view points into the DMA buffer and stays valid until fewer than
+ *          USART2_RX_DMA_SIZE bytes have arrived after its first byte. The arrival stamp
+ *          uses the DWT cycle counter (enabled by I2C1_Config) and wraps after 2^32
+ *          cycles (67 s at 64 MHz).
+ * @param msg - [out] Message view
+ * @return 1 if a message was returned, 0 if none is pending
+ * @note Main-loop context only (single consumer)
+ */
+uint8_t USART2_PeekMessage(USART2_Message *msg);
+
+/**
+ * @brief Release the message returned by USART2_PeekMessage()
+ * @return 1 if the view was intact until now, 0 if the DMA overwrote it (discard what
+ *         was parsed from it)
+ * @note Main-loop context only
+ */
+uint8_t USART2_ReleaseMessage(void);
+
+/**
+ * @brief Number of received messages lost (descriptor ring full or bytes overwritten)
+ * @return Dropped message count since UART_Config()
+ */
+uint32_t USART2_GetRxDropped(void);
+
+/**
+ * @brief Bytes queued in the TX ring (transmit backlog)
+ * @return Bytes not yet handed to the shift register (0..USART2_TX_RING_SIZE - 1)
+ */
+uint16_t USART2_GetTxPending(void);
+
+/**
+ * @brief Most bytes queued in the TX ring at once
+ * @details Sampled after each USART2_Write(); a value near USART2_TX_RING_SIZE means
+ *          writers have been blocking on a full ring.
+ * @return High-water mark since UART_Config()
+ */
+uint16_t USART2_GetTxHighWater(void);
+
+/**
+ * @brief Send single character via UART
+ * @details Queues one byte in the TX ring
+ *
+ * @param c - Character byte to transmit
+ * @return void
  *
  * @data_format
  *  - UART parameters: 8-bit, 1 stop bit, no parity (8N1)
  *  - Baud rate: configured via UART_Config() — 460800 in this project
  *
- * @see UART_Config, USART2_putString
+ * @see UART_Config, USART2_Write
  */
 void USART2_Send(uint8_t c);
 
 /**
  * @brief Send null-terminated string via UART
- * @details Transmits string character-by-character using USART2_Send()
+ * @details Queues the string in the TX ring
  *
- * @param string - Pointer to null-terminated character string
+ * @param string - [in] Pointer to null-terminated character string (not modified)
  * @return void
- * @retval N/A (blocking)
  *
  * @timing
- *  - Per-character latency: ~22 µs at 460800 baud (10 bits/byte: 8N1)
- *  - For 10-char string: ~220 µs; typical CSV frame ~350 µs
- *
- * @data_format
- *  - String must be null-terminated
- *  - Each character transmitted as 8-bit value
+ *  - Returns immediately unless the TX ring is full
+ *  - Line rate: ~22 µs per character at 460800 baud; typical CSV frame ~350 µs
  *
  * @usage_example
  *  ```
  *  USART2_putString("Hello UART\r");
  *  ```
  *
- * @see UART_Config, USART2_Send
+ * @see UART_Config, USART2_Write
  */
-void USART2_putString(char *string);
+void USART2_putString(const char *string);
 
 #endif /* UART_H_ */
@@ -0,0 +1,50 @@
+/**
+ * @file Wear.c
+ * @brief Wear (skin contact) detection implementation
+ * @details Consecutive-sample IR threshold relative to the IR drive.
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ */
+
+#include "Wear.h"
+#include "MAX30101.h"
+#include <stdint.h>
+
+/**
+ * @brief Initialize a wear detector (on-body)
+ * @param wc - [out] Wear detector
+ * @return void
+ */
+void Wear_Init(Wear_Context *wc) {
+    wc->below = 0;
+    wc->off = 0;
+}
+
+/**
+ * @brief Check a block of raw IR currents
+ * @param wc - [in,out] Wear detector
+ * @param block - [in] Block with raw currents (nA)
+ * @param first - First sample to include
+ * @return 1 if the probe left the skin in this block
+ */
+uint8_t Wear_Update(Wear_Context *wc, const SampleBlock *block, uint8_t first) {
+    if (wc->off) {
+        return 0;
+    }
+    const float32_t *ir = block->ch[SB_CH_IR];
+    float32_t threshold = WEAR_OFF_NA_PER_MA * MAX30101_LED_REG_TO_MA(block->led[SB_CH_IR]);
+    uint8_t decim = (block->decimation != 0u) ? block->decimation : 1u;
+    for (uint8_t i = first; i < block->count; i++) {
+        if (ir[i] < threshold) {
+            wc->below += decim;     // Count time, not FIFO samples
+        } else {
+            wc->below = 0;
+        }
+    }
+    if (wc->below < WEAR_OFF_SAMPLES) {
+        return 0;
+    }
+    wc->off = 1;
+    return 1;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file Wear.h
+ * @brief Wear (skin contact) detection from the raw IR current
+ * @details Decides, per sensor, when the probe has left the skin so acquisition can put
+ *          the sensor in proximity mode instead of streaming and filtering ambient light.
+ *
+ * ### Off-Body Criterion
+ *  The raw IR current is compared with WEAR_OFF_NA_PER_MA times the IR drive of the block
+ *  (so the test holds under LED current control): off-body after WEAR_OFF_SAMPLES
+ *  consecutive ADC sample periods below it. A single sample above restarts the count, so
+ *  short lift-offs and motion do not suspend the sensor.
+ *
+ * ### Return to Skin
+ *  Detected by the sensor itself (MAX30101 proximity interrupt, see Acquisition.h) with a
+ *  higher threshold per mA (ACQ_PROX_THRESH_NA at ACQ_PROX_PILOT_MA) for hysteresis; the
+ *  pipeline restarts on the SB_FLAG_RESUME block and re-arms the detector.
+ *
+ * @author Julio Fajardo, PhD
+ * @date 2026-03-26
+ * @version 2.0
+ * @see Pipeline_ProcessBlock, Acquisition_Suspend
+ */
+
+#ifndef WEAR_H_
+#define WEAR_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "SampleBlock.h"
+
+#define     WEAR_OFF_NA_PER_MA      10.0f   /**< IR current per mA of IR drive below which the probe is off-body (nA/mA; QUALITY_MIN_DC_NA at 10 mA) */
+#define     WEAR_OFF_SAMPLES        100u    /**< Consecutive ADC sample periods below the threshold (2 s at 50 Hz) */
+
+/**
+ * @struct Wear_Context
+ * @brief Wear detector state (one per sensor)
+ */
+typedef struct {
+    uint32_t below;         /**< Consecutive ADC sample periods below the threshold */
+    uint8_t  off;           /**< Off-body reported (until Wear_Init) */
+} Wear_Context;
+
+/**
+ * @brief Initialize a wear detector (on-body)
+ * @param wc - [out] Wear detector
+ * @return void
+ */
+void Wear_Init(Wear_Context *wc);
+
+/**
+ * @brief Check a block of raw IR currents
+ * @param wc - [in,out] Wear detector
+ * @param block - [in] Block with raw currents (nA), led[] and decimation
+ * @param first - First sample to include
+ * @return 1 if the probe left the skin in this block (reported once), 0 otherwise
+ */
+uint8_t Wear_Update(Wear_Context *wc, const SampleBlock *block, uint8_t first);
+
+#endif /* WEAR_H_ */
@@ -14,65 +14,234 @@
 #include "arm_math_types.h"
 #include "stm32f303x8.h"
 #include <stdint.h>
-#include <stdio.h>
+#include <stddef.h>
 
 #include "PLL.h"
 #include "LED.h"
 #include "I2C.h"
 #include "MAX30101.h"
 #include "UART.h"
+#include "Acquisition.h"
+#include "Pipeline.h"
+#include "Format.h"
+#include "Telemetry.h"
+#include "Recorder.h"
+#include "Flash.h"
+#include "Bench.h"
+#include "Scheduler.h"
+#include "FilterDesign.h"
 
 #include "arm_math.h"
 
 #define SYSTICK_FREQ_HZ     50 /**< SysTick interrupt frequency (Hz) */
-#define IIR_NUM_SECTIONS    2  /**< Number of biquad sections in the IIR filter */
+#define SYSTICK_PERIOD_US   (1000000u / SYSTICK_FREQ_HZ) /**< SysTick period (µs), device time base */
+#define UART_BAUD_RATE      460800u /**< USART2 baud rate */
+#define UART_CHAR_US        (10u * 1000000u / UART_BAUD_RATE) /**< One 8N1 character time (µs), the IDLE-line detection delay */
+#define IIR_FAMILY          DESIGN_CHEBY2 /**< High-pass prototype for FILTER_TYPE 1: DESIGN_CHEBY2 or DESIGN_BUTTERWORTH */
+#define IIR_ORDER           4  /**< High-pass prototype order (1..8) */
+#define IIR_EDGE_HZ         0.04f /**< High-pass edge (Hz): stopband edge for Chebyshev II, -3 dB frequency for Butterworth */
+#define IIR_STOP_DB         80.0f /**< Chebyshev II stopband attenuation (dB) */
+#define IIR_NUM_SECTIONS    ((IIR_ORDER + 1) / 2)  /**< Number of biquad sections in the IIR filter */
 #define FILTER_TYPE         1  /**< Filter type identifier (1 for high-pass Chebyshev type II, 0 for First-Order IIR High-Pass (DC-Blocker): H(z) = (1 - z^-1) / (1 - alpha*z^-1) */
 #define ALPHA               0.995f /**< Alpha coefficient for first-order IIR DC-Blocker (0.95 corresponds to fc ~0.4 Hz at 50 Hz sampling, 0.995 corresponds to fc ~0.04 Hz at 50 Hz sampling) */
 #define WARMUP_SAMPLES      600 /**< Number of initial samples to process for filter warm-up before entering normal operation state */
-
-volatile uint8_t data_ready = 0; /**< Flag set by SysTick_Handler when new data is available for processing in main loop */
-uint8_t process_state = 0; /**< State 0 is for filter warm-up, 1 is for normal operation  */
-
-char tx_buffer[128];  /**< General-purpose buffer for UART transmission */
+#define NUM_SENSORS         1  /**< Number of MAX30101 sensors in sensors[] (up to ACQ_MAX_SENSORS); >1 adds a sensor ID column to the CSV output */
+#define HB_OUTPUT           0  /**< 1 appends ΔHbO2,ΔHHb (µM, modified Beer-Lambert law on the raw Red/IR currents) columns to the CSV output */
+#define HB_TEMP_COMP        1  /**< 1 compensates LED wavelength drift in the hemoglobin computation using the die temperature side channel */
+#define BASELINE_OUTPUT     0  /**< 1 appends the per-channel baseline (DC, nA) and the IR perfusion index (%) columns, computed in the high-pass pass */
+#define ADAPTIVE_RATE       0  /**< 1 lowers the output rate by on-chip averaging (ADAPTIVE_DECIM) while the signal is steady and restores full rate on change; "#rate" lines mark each switch */
+#define ADAPTIVE_DECIM      4  /**< Samples averaged on chip in the reduced-rate mode (50 Hz / 4 = 12.5 Hz) */
+#define LED_CONTROL         0  /**< 1 adjusts the LED currents and ADC range toward a target DC at minimum LED power; "#led" lines mark each step */
+#define SENSOR_INIT_ATTEMPTS 3 /**< Profile writes per sensor at boot before it is left out of acquisition ("#init" line) */
+#define WEAR_DETECT         0  /**< 1 suspends a sensor in proximity mode (pilot LED, no streaming) while its probe is off the skin and restarts its pipeline on contact; "#wear" lines mark each change */
+#define OCCLUSION_DETECT    0  /**< 1 segments arterial occlusion/reperfusion on ΔHbO2 − ΔHHb and emits one "#occl" record per completed phase (needs HB_OUTPUT 1) */
+#define SPIKE_FILTER        0  /**< 1 replaces single-sample glitches (I2C errors, light flashes) with a Hampel median/MAD filter before the high-pass; delays the rows by HAMPEL_WINDOW / 2 samples; "#spike" lines report the counts */
+#define HAMPEL_WINDOW       15 /**< Spike filter window in samples (odd, 3..31; 15 = 0.3 s at 50 Hz) */
+#define HAMPEL_THRESHOLD    3.0f /**< Spike threshold in robust standard deviations (1.4826 · MAD) */
+#define QUALITY_OUTPUT      0  /**< 1 emits a "#quality,<id>,<seq>,<word>" side-channel line after every output block (clipping, off-skin, perfusion, SNR, flatline) */
+#define OUTPUT_FORMAT       FMT_CSV /**< Data stream line format: FMT_CSV, FMT_TSV or FMT_JSONL (side-channel "#" lines are unchanged) */
+#ifndef RECORDER_ENABLE
+#define RECORDER_ENABLE     0  /**< 1 also logs every raw sample to the internal flash ring; host commands 'D' dump it, 'E' erase it. Set it in Project.cproject.yml (compiler and linker define): the linker reserves the log pages only then */
+#endif
+#define BENCH_ENABLE        0  /**< 1 runs the DSP micro-benchmark suite at boot and prints "#bench" lines before acquisition starts */
+#define MOTION_CANCEL       0  /**< 1 runs the NLMS motion-artifact canceller on the high-passed Red/IR channels (reference: band-limited common-mode intensity) */
+#define TEMP_TASK_TICKS     5  /**< Temperature side-channel task period in SysTick ticks (100 ms) */
+#define CMD_TASK_TICKS      5  /**< Host command task period in SysTick ticks (100 ms) */
+#define TIME_SYNC           0  /**< 1 answers host 'T' pings with "#pong,<rx_us>,<tx_us>" and emits "#sync,<id>,<seq>,<t_us>" every SYNC_PERIOD_TICKS, to align several boards on one host timeline (host side: Host/Tools/TimeSync.c). Excludes RECORDER_ENABLE */
+#define SYNC_PERIOD_TICKS   50 /**< Ticks between "#sync" frames per sensor (1 s) */
+#define TELEMETRY           0  /**< 1 emits a "#tlm" runtime telemetry frame (idle time, I2C bus time, UART backlog, ring high-water mark, drops, FIFO overflows, SysTick latency) every TELEMETRY_PERIOD_TICKS */
+#define TELEMETRY_PERIOD_TICKS 250 /**< Ticks between "#tlm" frames (5 s; at most 60 s, the cycle counters wrap after 67 s) */
 
 /**
- * @brief FINAL PROCESSED DATA: Calibrated current in nanoamps (nA)
- * @details 32-sample buffer holding calibrated photodiode current values (0–4096nA).
- *          This is the primary output buffer for post-processing and external transmission.
- *          Updated by SysTick ISR approximately every 20 ms (variable latency based on FIFO fill).
- *          @see SysTick_Handler
- *          @note SpO2 mode memory: 8 samples × 8 bytes (2 × float32_t) = 64 bytes
- *          @note Typically accessed in main loop after ISR completion
+ * @brief MAX30101 sensor table
+ * @details One entry per sensor; IDs must be 0..NUM_SENSORS-1 (they index the filter state).
+ *          A single sensor is wired directly to I2C1. Additional sensors go behind a
+ *          TCA9548A mux, e.g. { 1, SENSOR_ADDR, MUX_ADDR_TCA9548A, 1 }.
  */
+const MAX30101_Handle sensors[NUM_SENSORS] = {
+    { 0, SENSOR_ADDR, MUX_ADDR_NONE, 0 },
+};
+
+/** SampleBlock rows written per output line, in column order */
+const uint8_t outputRows[] = {
+    SB_CH_RED, SB_CH_IR,
+    #if SAMPLE_BLOCK_CHANNELS > 2
+        SB_CH_GREEN,
+    #endif
+    #if HB_OUTPUT == 1
+        SB_CH_HBO2, SB_CH_HHB,
+    #endif
+    #if BASELINE_OUTPUT == 1
+        SB_CH_BASELINE(SB_CH_RED), SB_CH_BASELINE(SB_CH_IR),
+        #if SAMPLE_BLOCK_CHANNELS > 2
+            SB_CH_BASELINE(SB_CH_GREEN),
+        #endif
+        SB_CH_PI,
+    #endif
+};
+/** JSONL keys, parallel to outputRows[] */
+const char *const outputNames[] = {
+    "red", "ir",
+    #if SAMPLE_BLOCK_CHANNELS > 2
+        "green",
+    #endif
+    #if HB_OUTPUT == 1
+        "hbo2", "hhb",
+    #endif
+    #if BASELINE_OUTPUT == 1
+        "red_dc", "ir_dc",
+        #if SAMPLE_BLOCK_CHANNELS > 2
+            "green_dc",
+        #endif
+        "pi",
+    #endif
+};
+#define OUTPUT_FIELDS       ((uint8_t)sizeof(outputRows))  /**< Fields per output line */
 
- /** Global variables for storing current samples */
-volatile MAX30101_CurrentSample MAX30101_NIRS_SingleCurrentSample;
-MAX30101_CurrentSample FilteredSample;
+#if OCCLUSION_DETECT == 1 && HB_OUTPUT != 1
+#error "OCCLUSION_DETECT needs HB_OUTPUT 1"
+#endif
 
-/** Chebyshev High-pass (dc-blocker) IIR Filter Coefficients 
-    * @details 4th-order Chebyshev type II high-pass filter with 0.04 Hz cutoff frequency, designed using MATLAB's fdesign.highpass and implemented as a cascade of biquads.
-    *          Coefficients are in the form [b0, b1, b2, a1, a2] for each biquad section, with feedback coefficients negated for CMSIS-DSP compatibility.
+#if TELEMETRY == 1 && TELEMETRY_PERIOD_TICKS > 60 * SYSTICK_FREQ_HZ
+#error "TELEMETRY_PERIOD_TICKS must stay below the 67 s wrap of the cycle counters"
+#endif
+
+#if IIR_NUM_SECTIONS > PIPELINE_MAX_SECTIONS
+#error "IIR_ORDER exceeds PIPELINE_MAX_SECTIONS biquad sections"
+#endif
+
+#if TIME_SYNC == 1 && RECORDER_ENABLE == 1
+#error "TIME_SYNC cannot run with RECORDER_ENABLE: flash erase stalls SysTick and Time_NowUs() loses ticks"
+#endif
+
+/** High-pass (dc-blocker) IIR filter specification
+    * @details Designed at start-up for the sensor output rate by Design_Filter(), so a change of
+    *          sample rate, order or edge needs no offline redesign. The defaults (4th-order
+    *          Chebyshev type II, 0.04 Hz stopband edge, 80 dB) reproduce the former MATLAB
+    *          fdesign.highpass coefficients at 50 Hz.
+    *          @see Design_Filter, iirCoeffs
+*/
+const Design_Spec iirSpec = {
+    IIR_FAMILY, DESIGN_HIGHPASS, IIR_ORDER, IIR_EDGE_HZ, 0.0f, IIR_STOP_DB
+};
+
+/** High-pass biquad coefficients at the sensor output rate
+    * @details Coefficients are in the form [b0, b1, b2, a1, a2] for each biquad section, with feedback
+    *          coefficients negated for CMSIS-DSP compatibility. Filled from iirSpec before Pipeline_Init().
     *          The filter is applied to the raw current samples to remove DC offset and low-frequency drift before further processing.
-    *          @see iir_init, iir
-    *          @note Designed for a sampling frequency of 50 Hz (matching MAX30101 ODR)
     *          @note Coefficients must be in single-precision float format for CMSIS-DSP
 */
-const float32_t iirCoeffs[5 * IIR_NUM_SECTIONS] = {         
-    0.98855555f,    -1.9770899f,    0.98855555f,    1.9766545f,     -0.97754645f,
-    0.97310543f,    -1.9462072f,    0.97310543f,    1.9457787f,     -0.94663936f
- };
+float32_t iirCoeffs[5 * IIR_NUM_SECTIONS];
 
-float32_t iirStatesRed[2 * IIR_NUM_SECTIONS] = {0}; /**< State buffer for the IIR filter, initialized to zero */
-arm_biquad_cascade_df2T_instance_f32 IIR_Red; /**< CMSIS-DSP IIR filter instance structure */
-float32_t iirStatesIR[2 * IIR_NUM_SECTIONS] = {0}; /**< State buffer for the IIR filter, initialized to zero */
-arm_biquad_cascade_df2T_instance_f32 IIR_IR; /**< CMSIS-DSP IIR filter instance structure */
+/** High-pass biquad coefficients for the reduced rate (output rate / ADAPTIVE_DECIM)
+    * @details Same specification as iirCoeffs, designed for the reduced rate; identical
+    *          response in Hz.
+*/
+float32_t iirCoeffsDecim[5 * IIR_NUM_SECTIONS];
+
+/**
+ * @brief Processing parameters shared by every sensor pipeline
+ * @see Pipeline_Config
+ */
+const Pipeline_Config pipelineConfig = {
+    #if FILTER_TYPE == 1
+        PIPELINE_FILTER_BIQUAD,
+    #else
+        PIPELINE_FILTER_DC_BLOCKER,
+    #endif
+    iirCoeffs, IIR_NUM_SECTIONS, ALPHA, WARMUP_SAMPLES, MOTION_CANCEL, HB_OUTPUT, HB_TEMP_COMP,
+    BASELINE_OUTPUT, QUALITY_OUTPUT,
+    #if ADAPTIVE_RATE == 1
+        ADAPTIVE_DECIM,
+    #else
+        0,
+    #endif
+    iirCoeffsDecim, LED_CONTROL, WEAR_DETECT, OCCLUSION_DETECT,
+    #if SPIKE_FILTER == 1
+        HAMPEL_WINDOW,
+    #else
+        0,
+    #endif
+    HAMPEL_THRESHOLD
+};
 
-/* First-order DC-Blocker states */
-float32_t w_red = 0.0f; /**< First-order DC-Blocker intermediate state for red channel */
-float32_t w_ir  = 0.0f; /**< First-order DC-Blocker intermediate state for IR channel */
+Pipeline_Context pipeline[NUM_SENSORS]; /**< Per-sensor processing state (filters, motion canceller, MBLL baseline) */
+static MAX30101_Handle sensorsUp[NUM_SENSORS]; /**< Sensors whose profile was written and verified, handed to Acquisition_Init() */
+#if ADAPTIVE_RATE == 1
+static uint8_t outputDecim[NUM_SENSORS];   /**< Decimation of the last block sent per sensor ("#rate" on change) */
+#endif
+#if TIME_SYNC == 1
+static uint32_t syncTick[NUM_SENSORS];     /**< Acquisition tick of the last "#sync" frame per sensor */
+#endif
+#if TELEMETRY == 1
+static volatile uint32_t isrCycles;        /**< Cycles spent in SysTick_Handler (wraps) */
+static uint32_t isrCyclesMax;              /**< Longest SysTick_Handler run (cycles) */
+static uint32_t isrLatencyMax;             /**< Longest SysTick interrupt entry latency (cycles) */
+static uint32_t idleCycles;                /**< Main-loop cycles with no ready task, SysTick_Handler excluded (wraps) */
+static uint32_t tlmCycles;                 /**< DWT->CYCCNT at the previous "#tlm" frame */
+static uint32_t tlmIdle;                   /**< idleCycles at the previous "#tlm" frame */
+static uint32_t tlmBus;                    /**< I2C1_GetBusyCycles() at the previous "#tlm" frame */
+#endif
 
 /* Function prototypes */
-static inline void IIR_FilterWarmup(const MAX30101_CurrentSample *s);
+static void Output_Temperature(uint8_t id, float32_t temp_degc);
+static void Output_Init(uint8_t id, I2C_Status status, uint8_t mismatches);
+static void Output_Quality(const SampleBlock *block);
+static void Output_Rate(const SampleBlock *block);
+static void Output_Led(const SampleBlock *block);
+static void Output_Wear(const SampleBlock *block, uint8_t on_body);
+static void Output_Occlusion(const SampleBlock *block, const Occl_Event *event);
+static void Output_Spikes(const SampleBlock *block, const uint32_t *counts);
+static void Output_Sync(const SampleBlock *block);
+static void Output_Pong(uint32_t rx_us, uint32_t tx_us);
+static void Output_Telemetry(uint32_t elapsed, uint32_t idle, uint32_t bus, uint32_t latency, uint32_t isr_max);
+static void Task_Process(void);
+static void Task_Temperature(void);
+static void Task_Commands(void);
+static void Task_Telemetry(void);
+static uint32_t Ticks_Get(void);
+static uint32_t Cycles_Get(void);
+static uint32_t Time_NowUs(void);
+
+static volatile uint32_t tickCount; /**< SysTick ticks since boot (scheduler time base) */
+
+/**
+ * @brief Background tasks (main-loop context, run to completion by priority)
+ * @details Acquisition is not listed: it runs in SysTick_Handler and preempts all of them.
+ */
+static const Sched_Task taskProcess = {
+    "process", Task_Process, 0, 0, 1            // Signalled by the ISR, must finish within one tick
+};
+static const Sched_Task taskTemperature = {
+    "temp", Task_Temperature, 1, TEMP_TASK_TICKS, 0
+};
+static const Sched_Task taskCommands = {
+    "cmd", Task_Commands, 2, CMD_TASK_TICKS, 0
+};
+static const Sched_Task taskTelemetry = {
+    "tlm", Task_Telemetry, 3, TELEMETRY_PERIOD_TICKS, 0
+};
+static uint8_t processTaskId = SCHED_INVALID_TASK; /**< Task signalled by SysTick_Handler */
 
 /**
  * @brief System initialization and main control loop
@@ -80,28 +249,35 @@ static inline void IIR_FilterWarmup(const MAX30101_CurrentSample *s);
  *          1. **Clock**: PLL to 64 MHz (HSI 8 MHz × 16)
  *          2. **GPIO**: Status LED on PB3 (push-pull output)
  *          3. **I2C1**: 400 kHz fast-mode on PB6 (SCL), PB7 (SDA)
- *          4. **Sensor**: MAX30101 NIRS Lite mode — Red + IR at 50 Hz, 10.0 mA each
+ *          4. **Sensors**: every MAX30101 in sensors[] in NIRS Lite mode — Red + IR at 50 Hz, 10.0 mA each
  *          5. **UART**: USART2 at 460800 baud (PA2=TX, PA15=RX)
  *          6. **Timer**: SysTick at 50 Hz (20 ms period), enabling the acquisition ISR
  *
- *          After initialization, the main loop waits for data_ready (set by SysTick ISR),
- *          applies the selected high-pass filter to remove DC offset, and transmits each
- *          filtered Red/IR sample pair over UART as a CSV string.
+ *          After initialization, the main loop only dispatches the cooperative scheduler.
+ *          The processing task, signalled by the SysTick ISR whenever it queued samples,
+ *          drains the acquisition ring one SampleBlock (FIFO burst) at a time, runs it in place
+ *          through its sensor's Pipeline_Context (warm-up, high-pass filter, optional motion
+ *          cancellation and MBLL), and transmits each filtered Red/IR sample pair over UART as a
+ *          CSV line (prefixed with the sensor ID when NUM_SENSORS > 1). Fmt_WriteBlock() encodes
+ *          the block's channel arrays straight into the interrupt-driven UART TX ring
+ *          (OUTPUT_FORMAT also selects TSV or JSON lines).
  *          All sensor acquisition runs in the ISR; filtering and transmission run in main.
+ *          Lower-priority timer tasks handle the die temperature side channel, host
+ *          commands and the runtime telemetry; none of them can delay sampling.
  *
  *          Two DC-removal filters are available, selected at compile time via FILTER_TYPE:
  *          - **FILTER_TYPE 0** (default): First-order IIR DC-Blocker H(z) = (1 - z^-1) / (1 - alpha*z^-1),
  *            alpha = 0.95, fc ~= 0.4 Hz, alpha = 0.995, fc ~= 0.04 Hz. Minimal CPU cost, suitable for resource-constrained operation.
  *          - **FILTER_TYPE 1**: 4th-order Chebyshev type II high-pass filter, fc = 0.04 Hz, implemented as a
- *            cascade of 2 biquad sections via CMSIS-DSP. Maximally flat passband; preferred for
+ *            cascade of 2 biquad sections via CMSIS-DSP, designed at start-up for the sensor rate (iirSpec). Maximally flat passband; preferred for
  *            clean PPG signal extraction in NIRS applications.
  *
  * @param None
  * @return int - Never returns (infinite loop)
  * @note Initialization order is critical: I2C must be configured before MAX30101,
  *       and UART before SysTick to avoid transmitting before the port is ready.
- *       When FILTER_TYPE == 1, arm_biquad_cascade_df2T_init_f32() must be called
- *       after clk_config() to ensure the PLL and stack are stable.
+ *       Pipeline_Init() (which initializes the CMSIS-DSP biquad instances when
+ *       FILTER_TYPE == 1) is called after clk_config() to ensure the PLL and stack are stable.
  * @warning Enabling SysTick (last step) immediately arms the ISR. Any initialization
  *          that must complete before the first ISR fires should precede SysTick_Config().
  * @execution
@@ -111,59 +287,111 @@ static inline void IIR_FilterWarmup(const MAX30101_CurrentSample *s);
  * @example
  *   // After init, main loop outputs one filtered line per sample at 50 Hz:
  *   // "1234.567,2345.678\r\n"  (Red nA, IR nA -- DC removed)
+ *   // "1,1234.567,2345.678\r\n"  (with NUM_SENSORS > 1: sensor ID, Red nA, IR nA)
  */
 int main(void) {
     // Configure system clock to 64 MHz via PLL
     clk_config();
-     #if FILTER_TYPE == 1
-        // Coefficients already defined for high-pass Chebyshev type II
-        arm_biquad_cascade_df2T_init_f32(&IIR_Red, IIR_NUM_SECTIONS, iirCoeffs, iirStatesRed);
-        arm_biquad_cascade_df2T_init_f32(&IIR_IR, IIR_NUM_SECTIONS, iirCoeffs, iirStatesIR);
-    #endif
+    // High-pass biquads for the sensor output rate and the reduced adaptive rate
+    float32_t outputRateHz = MAX30101_OutputRateHz(&MAX30101_NIRSLiteProfile);
+    Design_Filter(&iirSpec, outputRateHz, iirCoeffs, IIR_NUM_SECTIONS);
+    if (Design_Filter(&iirSpec, outputRateHz / (float32_t)ADAPTIVE_DECIM, iirCoeffsDecim, IIR_NUM_SECTIONS) == 0u) {
+        // Edge beyond the reduced Nyquist frequency: keep the full-rate design
+        for (uint8_t i = 0; i < 5 * IIR_NUM_SECTIONS; i++) {
+            iirCoeffsDecim[i] = iirCoeffs[i];
+        }
+    }
+    // Per-sensor processing pipelines (high-pass filter, motion canceller, MBLL)
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        Pipeline_Init(&pipeline[i], &pipelineConfig);
+        #if ADAPTIVE_RATE == 1
+            outputDecim[i] = 1;
+        #endif
+        #if TIME_SYNC == 1
+            syncTick[i] = 0u - SYNC_PERIOD_TICKS;  // First block sends a frame
+        #endif
+    }
     // Configure GPIO port B pin 3 as push-pull output for LED
     LED_config();
     // Configure I2C1 (400 kHz) for MAX30101 communication
     I2C1_Config();
-    // Initialize MAX30101 for NIRS measurement with medium LED power
-    MAX30101_InitNIRSLite(10.0f,10.0f);  // 10.0 mA LED current for low power operation (up to 51 mA max)
+    // Initialize every MAX30101 for NIRS measurement with medium LED power
+    // NIRS Lite profile: 10.0 mA LED current for low power operation (up to 51 mA max)
+    I2C_Status initStatus[NUM_SENSORS];
+    uint8_t initMismatches[NUM_SENSORS];
+    uint8_t numUp = 0;
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        uint8_t attempt = 0;
+        do {
+            initStatus[i] = MAX30101_InitNIRSLite(&sensors[i], &initMismatches[i]);
+        } while ((initStatus[i] != I2C_OK || initMismatches[i] != 0u) && ++attempt < SENSOR_INIT_ATTEMPTS);
+        if (initStatus[i] == I2C_OK && initMismatches[i] == 0u) {
+            sensorsUp[numUp++] = sensors[i];
+        }
+    }
+    // Register the verified sensors with the round-robin acquisition scheduler; a sensor
+    // that failed would stream samples labelled with settings it does not have
+    Acquisition_Init(sensorsUp, numUp);
+    #if RECORDER_ENABLE == 1
+        // Session recorder on the internal flash log pages (one page erase)
+        Recorder_Init(&Flash_Backend);
+    #endif
     // Configure USART2 (PA2=TX, PA15=RX) at 460800 baud for data transmission
-    UART_Config(460800);
+    UART_Config(UART_BAUD_RATE);
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        if (initStatus[i] != I2C_OK || initMismatches[i] != 0u) {
+            Output_Init(sensors[i].id, initStatus[i], initMismatches[i]);
+        }
+    }
+    #if BENCH_ENABLE == 1
+        // Kernel micro-benchmarks (cycles per sample at several block sizes)
+        Bench_Run(iirCoeffs, IIR_NUM_SECTIONS);
+    #endif
+    // Background tasks: SysTick count as time base, DWT cycle counter (enabled by I2C1_Config) for run times
+    Sched_Init(Ticks_Get, Cycles_Get);
+    processTaskId = Sched_AddTask(&taskProcess);
+    Sched_AddTask(&taskTemperature);
+    #if RECORDER_ENABLE == 1 || TIME_SYNC == 1
+        Sched_AddTask(&taskCommands);
+    #endif
+    #if TELEMETRY == 1
+        // First frame covers the time from here; the sensor set-up traffic is not counted
+        Sched_AddTask(&taskTelemetry);
+        tlmCycles = DWT->CYCCNT;
+        tlmBus = I2C1_GetBusyCycles();
+    #endif
     // Configure SysTick for 20 ms interrupts (SYSTICK_FREQ_HZ = 50 Hz)
     SysTick_Config(SystemCoreClock / SYSTICK_FREQ_HZ);
     
-    // Main loop: real work happens in SysTick_Handler ISR
+    // Main loop: acquisition happens in SysTick_Handler ISR, everything else in tasks
     for (;;) {
-        if(data_ready) {
-            data_ready = 0; // Clear flag for next ISR cycle
-            uint32_t primask = __get_PRIMASK();
-            __disable_irq(); // Disable interrupts to safely access shared data 
-            MAX30101_CurrentSample sample = (MAX30101_CurrentSample)MAX30101_NIRS_SingleCurrentSample;
-            __set_PRIMASK(primask); // Restore previous interrupt state
-            if(process_state) { // Normal operation: apply IIR filter to incoming samples
-                #if FILTER_TYPE == 1
-                    arm_biquad_cascade_df2T_f32(&IIR_Red, (float32_t *)&sample.red, (float32_t *)&FilteredSample.red, 1);
-                    arm_biquad_cascade_df2T_f32(&IIR_IR, (float32_t *)&sample.ir, (float32_t *)&FilteredSample.ir, 1);
-                #else
-                    FilteredSample.red = MAX30101_FirstOrderDC_Blocker(sample.red, &w_red, ALPHA);
-                    FilteredSample.ir  = MAX30101_FirstOrderDC_Blocker(sample.ir,  &w_ir, ALPHA);
-                #endif
-            } else { // Filter warm-up: process initial samples to fill IIR state buffers before normal operation
-                IIR_FilterWarmup(&sample); // Process initial samples through the IIR filter to fill state buffers
-                process_state = 1; // After warm-up, switch to normal operation
-                continue; // Skip transmission during warm-up phase
+        #if TELEMETRY == 1
+            uint32_t isr0 = isrCycles;
+            uint32_t t0 = DWT->CYCCNT;
+            if (Sched_RunOnce() == 0u) {
+                uint32_t isr1;
+                uint32_t t1;
+                do {
+                    isr1 = isrCycles;
+                    t1 = DWT->CYCCNT;
+                } while (isr1 != isrCycles);
+                // Idle pass: its length minus the SysTick_Handler time inside it
+                idleCycles += (t1 - t0) - (isr1 - isr0);
             }
-            sprintf(tx_buffer, "%.4f,%.4f\r\n", FilteredSample.red, FilteredSample.ir);
-            USART2_putString(tx_buffer);
-        }
+        #else
+            Sched_RunOnce();
+        #endif
     }
 }
 
 /**
  * @brief SysTick Timer Interrupt Service Routine (20 ms period)
  * @details Core real-time data acquisition routine:
- *          1. Queries MAX30101 FIFO for available samples
- *          2. If samples available: reads one sample and converts to nanoamps
- *          3. Advances FIFO read pointer and signals main loop via data_ready flag
+ *          1. Runs the acquisition scheduler: for each sensor (round-robin), queries the
+ *             FIFO level and drains it in bursts within the per-tick sample budget
+ *          2. Converted samples are tagged with the sensor ID and pushed to the ring
+ *             drained by the main loop
+ *          3. Signals the processing task when samples were queued
  *          4. Toggles status LED (visual heartbeat)
  *
  *          This ISR runs non-preemptively (highest priority) every 20 milliseconds,
@@ -173,73 +401,494 @@ int main(void) {
  * @param None
  * @return void
  * @note ISR Context
- *       - Execution time: ~1–2 ms (I2C reads dominate; ~0.5 ms per transaction)
+ *       - Execution time: ~1–2 ms (I2C reads dominate; ~0.5 ms per transaction),
+ *         bounded by ACQ_MAX_SAMPLES_PER_TICK across all sensors
  *       - Called at SysTick interrupt (cannot nest itself)
  *       - All registers preserved; no clobbering of main loop state
  *
  * @data_output
  *       Upon samples available:
- *       - Populates MAX30101_NIRS_SingleCurrentSample (Red, IR fields in nanoamps)
- *       - Sets data_ready = 1 to signal main loop
- *       - Data valid until next ISR fires (~20 ms window)
+ *       - Unpacks each FIFO burst into a SampleBlock of the ring (sensor ID, sequence,
+ *         Red/IR arrays in nanoamps)
+ *       - Ring overflow drops the newest samples (see Acquisition_GetDropped)
  *
  * @timing
  *       - ISR rate: 50 Hz (20 ms period), matching MAX30101 ODR of 50 Hz
- *       - Steady state: exactly 1 sample per interrupt
- *       - At startup: up to 2 samples may be present before the first ISR fires;
- *         only the most recent is read, the pointer advances past all pending samples
+ *       - Steady state: 1 sample per sensor per interrupt
+ *       - Backlog (e.g. at startup): every pending sample is drained, in bursts, up to
+ *         the tick budget; the remainder is read on the following ticks
  *       - Sample age at read: 0–20 ms depending on arrival time within the period
  *
  * @warning
- *       - data_ready is declared volatile so the compiler does not cache it in a
- *         register across the ISR boundary. Without volatile, -O1 or higher can
- *         optimize away the flag check in the main loop (undefined behavior in C).
  *       - I2C blocking: If I2C bus is busy, ISR execution may extend by several ms
  *
- * @see MAX30101_GetNumAvailableSamples, MAX30101_ReadSingleCurrentData, LED_Toggle
+ * @see Acquisition_Poll, MAX30101_ReadBurstCurrentSoA, LED_Toggle
  * @example
  *   // ISR fires every 20 ms (50 Hz), synchronized to sensor output
- *   // MAX30101_NIRS_SingleCurrentSample updated with one fresh Red/IR nA pair
+ *   // One fresh Red/IR nA pair per sensor pushed to the acquisition ring
  *   // LED toggles each tick → 25 Hz blink (20 ms on, 20 ms off)
  */
 
 void SysTick_Handler(void) {
-    uint8_t available_samples = MAX30101_GetNumAvailableSamples();
-    if (available_samples > 0) {
-        MAX30101_ReadSingleCurrentData((MAX30101_CurrentSample *)&MAX30101_NIRS_SingleCurrentSample);
-        MAX30101_UpdateReadPointer(available_samples);
-        data_ready = 1; // Set flag for main loop to process new data
+    #if TELEMETRY == 1
+        uint32_t entry = DWT->CYCCNT;
+        // SysTick counts down from LOAD since the reload that raised this interrupt
+        uint32_t latency = SysTick->LOAD - SysTick->VAL;
+    #endif
+    tickCount++;
+    if (Acquisition_Poll() > 0u) {
+        Sched_Signal(processTaskId);
     }
     LED_Toggle();
+    #if TELEMETRY == 1
+        uint32_t run = DWT->CYCCNT - entry;
+        isrCycles += run;
+        if (run > isrCyclesMax) {
+            isrCyclesMax = run;
+        }
+        if (latency > isrLatencyMax) {
+            isrLatencyMax = latency;
+        }
+    #endif
 }
 
 /**
- * @brief Filter Warm-Up Routine
- * @details This function can be called at startup to process initial samples through the IIR filter
- *          to fill the state buffers before normal operation begins. This helps avoid transient artifacts
- *          in the first few seconds of data.
- *
- * @param s Pointer to the current sample structure containing raw Red and IR values to be processed for warm-up.
+ * @brief Emit a "#temp,<id>,<degC>" side-channel line
+ * @param id Sensor ID
+ * @param temp_degc Die temperature (°C)
  * @return void
- * @note This routine is typically called once at startup, before entering the main loop.
- *       It processes a predefined number of samples (WARMUP_SAMPLES) through the IIR filter
- *       without transmitting data, allowing the filter's internal state to stabilize.
- *       After warm-up, the system transitions to normal operation where filtered data is transmitted.
- *
- * @see IIR_Red, IIR_IR, iirCoeffs, iirStatesRed, iirStatesIR
- */
-static inline void IIR_FilterWarmup(const MAX30101_CurrentSample *s) {
-    float32_t dummy;
-    float32_t red = s->red; // In this way the compiler keeps the sample values in registers across the loop iterations 
-    float32_t ir  = s->ir;  //minimizing memory access and maximizing warm-up speed
-    for (int i = 0; i < WARMUP_SAMPLES; i++) {
-        #if FILTER_TYPE == 1
-            arm_biquad_cascade_df2T_f32(&IIR_Red, &red, &dummy, 1);
-            arm_biquad_cascade_df2T_f32(&IIR_IR,  &ir,  &dummy, 1);
-        #else
-            dummy = MAX30101_FirstOrderDC_Blocker(red, &w_red, ALPHA);
-            dummy = MAX30101_FirstOrderDC_Blocker(ir,  &w_ir,  ALPHA);       
+ */
+static void Output_Temperature(uint8_t id, float32_t temp_degc) {
+    char line[FMT_UINT_MAX_CHARS + FMT_FIXED4_MAX_CHARS + 3];
+    char *p = Fmt_Uint(line, id);
+    *p++ = ',';
+    p = Fmt_Fixed4(p, temp_degc);
+    *p++ = '\r';
+    *p++ = '\n';
+    USART2_putString("#temp,");
+    USART2_Write(line, (uint16_t)(p - line));
+}
+
+/**
+ * @brief Emit a "#init,<id>,<status>,<mismatches>" line for a sensor left out at boot
+ * @details Sent once after UART_Config() for every sensor whose last of SENSOR_INIT_ATTEMPTS
+ *          profile writes failed (<status> is the I2C_Status) or read back differently
+ *          (<mismatches> registers). The sensor streams nothing.
+ * @param id Sensor ID
+ * @param status Result of the last MAX30101_InitNIRSLite()
+ * @param mismatches Registers that failed read-back verification
+ * @return void
+ */
+static void Output_Init(uint8_t id, I2C_Status status, uint8_t mismatches) {
+    char line[FMT_UINT_MAX_CHARS * 3 + 4];
+    char *p = Fmt_Uint(line, id);
+    *p++ = ',';
+    p = Fmt_Uint(p, (uint32_t)status);
+    *p++ = ',';
+    p = Fmt_Uint(p, mismatches);
+    *p++ = '\r';
+    *p++ = '\n';
+    USART2_putString("#init,");
+    USART2_Write(line, (uint16_t)(p - line));
+}
+
+/**
+ * @brief Emit a "#quality,<id>,<seq>,<word>" side-channel line for an output block
+ * @details <seq> is the sequence number of the block's sample 0; the line follows the
+ *          block's data lines and covers them.
+ * @param block - [in] Processed block
+ * @return void
+ */
+static void Output_Quality(const SampleBlock *block) {
+    char line[FMT_UINT_MAX_CHARS * 3 + 4];
+    char *p = Fmt_Uint(line, block->sensor_id);
+    *p++ = ',';
+    p = Fmt_Uint(p, block->seq);
+    *p++ = ',';
+    p = Fmt_Uint(p, block->quality);
+    *p++ = '\r';
+    *p++ = '\n';
+    USART2_putString("#quality,");
+    USART2_Write(line, (uint16_t)(p - line));
+}
+
+/**
+ * @brief Emit a "#rate,<id>,<seq>,<Hz>" side-channel line before the first block of a new rate
+ * @details The rate is the ADC rate of the sensor profile divided by the block's decimation
+ *          (which includes the profile's own averaging), not the SysTick rate.
+ * @param block - [in] First block sampled at the new rate
+ * @return void
+ */
+static void Output_Rate(const SampleBlock *block) {
+    char line[FMT_UINT_MAX_CHARS * 2 + FMT_FIXED4_MAX_CHARS + 4];
+    float32_t adcRateHz = MAX30101_OutputRateHz(&MAX30101_NIRSLiteProfile)
+                          * (float32_t)(1u << MAX30101_NIRSLiteProfile.sample_avg);
+    char *p = Fmt_Uint(line, block->sensor_id);
+    *p++ = ',';
+    p = Fmt_Uint(p, block->seq);
+    *p++ = ',';
+    p = Fmt_Fixed4(p, adcRateHz / (float32_t)block->decimation);
+    *p++ = '\r';
+    *p++ = '\n';
+    USART2_putString("#rate,");
+    USART2_Write(line, (uint16_t)(p - line));
+}
+
+/**
+ * @brief Emit a "#led,<id>,<seq>,<red_mA>,<ir_mA>,<range_nA>" side-channel line before the first block of new LED settings
+ * @param block - [in] First block sampled with the new LED currents or ADC range
+ * @return void
+ */
+static void Output_Led(const SampleBlock *block) {
+    char line[FMT_UINT_MAX_CHARS * 3 + FMT_FIXED4_MAX_CHARS * 2 + 6];
+    char *p = Fmt_Uint(line, block->sensor_id);
+    *p++ = ',';
+    p = Fmt_Uint(p, block->seq);
+    *p++ = ',';
+    p = Fmt_Fixed4(p, MAX30101_LED_REG_TO_MA(block->led[SB_CH_RED]));
+    *p++ = ',';
+    p = Fmt_Fixed4(p, MAX30101_LED_REG_TO_MA(block->led[SB_CH_IR]));
+    *p++ = ',';
+    p = Fmt_Uint(p, (uint32_t)MAX30101_RANGE_FULLSCALE_NA(block->adc_range));
+    *p++ = '\r';
+    *p++ = '\n';
+    USART2_putString("#led,");
+    USART2_Write(line, (uint16_t)(p - line));
+}
+
+/**
+ * @brief Emit a "#wear,<id>,<seq>,<0|1>" side-channel line
+ * @details 0 after the block in which the probe left the skin (the sensor is suspended
+ *          from then on), 1 before the first block after skin contact returned.
+ * @param block - [in] Off-body or resume block
+ * @param on_body - 1 = back on the skin, 0 = off-body
+ * @return void
+ */
+static void Output_Wear(const SampleBlock *block, uint8_t on_body) {
+    char line[FMT_UINT_MAX_CHARS * 2 + 6];
+    char *p = Fmt_Uint(line, block->sensor_id);
+    *p++ = ',';
+    p = Fmt_Uint(p, block->seq);
+    *p++ = ',';
+    *p++ = on_body ? '1' : '0';
+    *p++ = '\r';
+    *p++ = '\n';
+    USART2_putString("#wear,");
+    USART2_Write(line, (uint16_t)(p - line));
+}
+
+/**
+ * @brief Emit an "#occl" side-channel record of a completed occlusion or reperfusion phase
+ * @details Occlusion:   "#occl,<id>,<seq>,1,<duration_s>,<baseline>,<min>,<slope_uM_s>"
+ *          Reperfusion: "#occl,<id>,<seq>,2,<duration_s>,<baseline>,<peak>,<t_half_s>,<t_peak_s>,<tau_s>"
+ *          Levels are ΔHbO2 − ΔHHb in µM; <seq> is the block in which the phase ended.
+ * @param block - [in] Block flagged SB_FLAG_OCCL_EVENT
+ * @param event - [in] Record
+ * @return void
+ */
+static void Output_Occlusion(const SampleBlock *block, const Occl_Event *event) {
+    char line[FMT_UINT_MAX_CHARS * 2 + FMT_FIXED4_MAX_CHARS * 6 + 12];
+    float32_t values[6];
+    uint8_t count;
+    values[0] = event->duration_s;
+    values[1] = event->baseline;
+    values[2] = event->level;
+    if (event->phase == OCCL_PHASE_OCCLUSION) {
+        values[3] = event->slope;
+        count = 4;
+    } else {
+        values[3] = event->t_half_s;
+        values[4] = event->t_peak_s;
+        values[5] = event->tau_s;
+        count = 6;
+    }
+    char *p = Fmt_Uint(line, block->sensor_id);
+    *p++ = ',';
+    p = Fmt_Uint(p, block->seq);
+    *p++ = ',';
+    *p++ = (char)('0' + event->phase);
+    for (uint8_t i = 0; i < count; i++) {
+        *p++ = ',';
+        p = Fmt_Fixed4(p, values[i]);
+    }
+    *p++ = '\r';
+    *p++ = '\n';
+    USART2_putString("#occl,");
+    USART2_Write(line, (uint16_t)(p - line));
+}
+
+/**
+ * @brief Emit a "#spike,<id>,<seq>,<red>,<ir>[,<green>]" side-channel line after a block with replaced samples
+ * @details Counts are totals per optical channel since start-up, so a lost line does not
+ *          lose counts.
+ * @param block - [in] Block flagged SB_FLAG_SPIKE
+ * @param counts - [in] Replaced samples per optical channel
+ * @return void
+ */
+static void Output_Spikes(const SampleBlock *block, const uint32_t *counts) {
+    char line[FMT_UINT_MAX_CHARS * (2 + SAMPLE_BLOCK_CHANNELS) + SAMPLE_BLOCK_CHANNELS + 4];
+    char *p = Fmt_Uint(line, block->sensor_id);
+    *p++ = ',';
+    p = Fmt_Uint(p, block->seq);
+    for (uint8_t c = 0; c < SAMPLE_BLOCK_CHANNELS; c++) {
+        *p++ = ',';
+        p = Fmt_Uint(p, counts[c]);
+    }
+    *p++ = '\r';
+    *p++ = '\n';
+    USART2_putString("#spike,");
+    USART2_Write(line, (uint16_t)(p - line));
+}
+
+/**
+ * @brief Emit a "#sync,<id>,<seq>,<t_us>" side-channel line
+ * @details Pairs the newest sample of the block (<seq>) with the device time of the FIFO
+ *          drain that read it: acquisition tick k runs in the SysTick interrupt that
+ *          starts at (k + 1) · SYSTICK_PERIOD_US. The sample is at most one sample period
+ *          older than the drain; a fit over many frames gives the sensor rate in device time.
+ * @param block - [in] Block just sent
+ * @return void
+ */
+static void Output_Sync(const SampleBlock *block) {
+    char line[FMT_UINT_MAX_CHARS * 3 + 4];
+    char *p = Fmt_Uint(line, block->sensor_id);
+    *p++ = ',';
+    p = Fmt_Uint(p, block->seq + block->count - 1u);
+    *p++ = ',';
+    p = Fmt_Uint(p, (block->tick + 1u) * SYSTICK_PERIOD_US);
+    *p++ = '\r';
+    *p++ = '\n';
+    USART2_putString("#sync,");
+    USART2_Write(line, (uint16_t)(p - line));
+}
+
+/**
+ * @brief Emit a "#pong,<rx_us>,<tx_us>" reply to a host 'T' ping
+ * @param rx_us - Device time at which the ping byte arrived (µs)
+ * @param tx_us - Device time at which the reply is queued (µs)
+ * @return void
+ */
+static void Output_Pong(uint32_t rx_us, uint32_t tx_us) {
+    char line[FMT_UINT_MAX_CHARS * 2 + 3];
+    char *p = Fmt_Uint(line, rx_us);
+    *p++ = ',';
+    p = Fmt_Uint(p, tx_us);
+    *p++ = '\r';
+    *p++ = '\n';
+    USART2_putString("#pong,");
+    USART2_Write(line, (uint16_t)(p - line));
+}
+
+/**
+ * @brief Emit a "#tlm" runtime telemetry frame
+ * @details "#tlm,<t_us>,<idle_pct>,<i2c_pct>,<tx_pending>,<tx_peak>,<ring_peak>,<dropped>,<fifo_ovf>,<latency_us>,<isr_max_us>"
+ *          - <t_us>: device time of the frame (same time base as "#sync")
+ *          - <idle_pct>, <i2c_pct>: main-loop idle time and I2C bus time over the period
+ *            since the previous frame (% of the CPU cycles)
+ *          - <tx_pending>, <tx_peak>: UART TX ring bytes queued now and at most
+ *          - <ring_peak>: most SampleBlocks queued at once
+ *          - <dropped>, <fifo_ovf>: samples dropped on a full ring, sensor FIFO overflows
+ *          - <latency_us>, <isr_max_us>: worst SysTick interrupt entry latency and run time
+ *          Counts, peaks and worst cases are totals since start-up, so a lost frame loses nothing.
+ *          The layout is Tlm_Format()'s (Telemetry.h), shared with the host decoder.
+ * @param elapsed - Cycles since the previous frame
+ * @param idle - Idle cycles since the previous frame
+ * @param bus - I2C transaction cycles since the previous frame
+ * @param latency - Worst SysTick entry latency (cycles)
+ * @param isr_max - Longest SysTick_Handler run (cycles)
+ * @return void
+ */
+static void Output_Telemetry(uint32_t elapsed, uint32_t idle, uint32_t bus, uint32_t latency, uint32_t isr_max) {
+    char line[TLM_LINE_MAX_CHARS];
+    Tlm_Frame f;
+    float32_t cycles_per_us = (float32_t)SystemCoreClock * 1e-6f;
+    float32_t pct = (elapsed > 0u) ? 100.0f / (float32_t)elapsed : 0.0f;
+    f.t_us = Time_NowUs();
+    f.idle_pct = (float32_t)idle * pct;
+    f.i2c_pct = (float32_t)bus * pct;
+    f.tx_pending = USART2_GetTxPending();
+    f.tx_peak = USART2_GetTxHighWater();
+    f.ring_peak = Acquisition_GetRingHighWater();
+    f.dropped = Acquisition_GetDropped();
+    f.fifo_ovf = Acquisition_GetFifoOverflows();
+    f.latency_us = (float32_t)latency / cycles_per_us;
+    f.isr_max_us = (float32_t)isr_max / cycles_per_us;
+    USART2_Write(line, (uint16_t)(Tlm_Format(line, &f) - line));
+}
+
+/**
+ * @brief Processing task: drain the acquisition ring through the pipelines and transmit
+ * @details Signalled by SysTick_Handler. Each block is processed and encoded in place,
+ *          then its ring slot is released.
+ * @return void
+ */
+static void Task_Process(void) {
+    SampleBlock *block;
+    while ((block = Acquisition_Peek()) != NULL) {
+        #if RECORDER_ENABLE == 1
+            for (uint8_t i = 0; i < block->count; i++) {
+                // Raw currents, before any filtering
+                Recorder_Push(block->sensor_id, block->ch[SB_CH_RED][i], block->ch[SB_CH_IR][i]);
+            }
+        #endif
+        #if ADAPTIVE_RATE == 1
+            if (block->decimation != outputDecim[block->sensor_id]) {
+                outputDecim[block->sensor_id] = block->decimation;
+                Output_Rate(block);
+            }
+        #endif
+        #if LED_CONTROL == 1
+            if (block->flags & SB_FLAG_GAIN) {
+                Output_Led(block);
+            }
+        #endif
+        #if WEAR_DETECT == 1
+            if (block->flags & SB_FLAG_RESUME) {
+                Output_Wear(block, 1);
+            }
+        #endif
+        Pipeline_ProcessBlock(&pipeline[block->sensor_id], block);
+        Fmt_WriteBlock(OUTPUT_FORMAT, outputNames, outputRows, OUTPUT_FIELDS, block, NUM_SENSORS > 1);
+        #if WEAR_DETECT == 1
+            if (block->flags & SB_FLAG_OFF_BODY) {
+                Output_Wear(block, 0);
+                Acquisition_Suspend(block->sensor_id);
+            }
+        #endif
+        #if SPIKE_FILTER == 1
+            if (block->flags & SB_FLAG_SPIKE) {
+                uint32_t spikeCounts[SAMPLE_BLOCK_CHANNELS];
+                Pipeline_GetSpikeCounts(&pipeline[block->sensor_id], spikeCounts);
+                Output_Spikes(block, spikeCounts);
+            }
+        #endif
+        #if OCCLUSION_DETECT == 1
+            Occl_Event occlEvent;
+            if ((block->flags & SB_FLAG_OCCL_EVENT) && Pipeline_GetOcclusionEvent(&pipeline[block->sensor_id], &occlEvent)) {
+                Output_Occlusion(block, &occlEvent);
+            }
         #endif
+        #if QUALITY_OUTPUT == 1
+            if (block->first < block->count) {
+                Output_Quality(block);
+            }
+        #endif
+        #if TIME_SYNC == 1
+            if (block->tick - syncTick[block->sensor_id] >= SYNC_PERIOD_TICKS) {
+                syncTick[block->sensor_id] = block->tick;
+                Output_Sync(block);
+            }
+        #endif
+        #if ADAPTIVE_RATE == 1
+            Acquisition_SetDecimation(block->sensor_id, Pipeline_GetRateRequest(&pipeline[block->sensor_id]));
+        #endif
+        #if LED_CONTROL == 1
+            uint8_t ledCodes[SAMPLE_BLOCK_CHANNELS];
+            uint8_t adcRange;
+            if (Pipeline_GetLedRequest(&pipeline[block->sensor_id], ledCodes, &adcRange)) {
+                Acquisition_SetLed(block->sensor_id, ledCodes, adcRange);
+            }
+        #endif
+        Acquisition_Release();
     }
 }
 
+/**
+ * @brief Temperature task: one "#temp" line per new die temperature conversion
+ * @return void
+ */
+static void Task_Temperature(void) {
+    float32_t temp_degc;
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        if (Acquisition_GetTemperature(sensors[i].id, &temp_degc)) {
+            Pipeline_SetTemperature(&pipeline[sensors[i].id], temp_degc);
+            Output_Temperature(sensors[i].id, temp_degc);
+        }
+    }
+}
+
+/**
+ * @brief Host command task: 'D' dumps the flash log, 'E' erases it, 'T' is a time-sync ping
+ * @details Each received message (one host burst) is read in place from the DMA buffer;
+ *          every byte is a command. The ping is stamped by the IDLE-line interrupt, so
+ *          the arrival time in the "#pong" reply does not depend on the task period; the
+ *          host sends 'T' on its own for the stamp to refer to it.
+ * @return void
+ */
+static void Task_Commands(void) {
+    #if RECORDER_ENABLE == 1 || TIME_SYNC == 1
+        USART2_Message msg;
+        while (USART2_PeekMessage(&msg)) {
+            for (uint16_t i = 0; i < msg.len + msg.wrap_len; i++) {
+                uint8_t cmd = USART2_MessageByte(&msg, i);
+                #if RECORDER_ENABLE == 1
+                    if (cmd == 'D') {
+                        Recorder_Dump();
+                    } else if (cmd == 'E') {
+                        Recorder_Erase();
+                    }
+                #endif
+                #if TIME_SYNC == 1
+                    if (cmd == 'T') {
+                        // Arrival: now minus the time since the IDLE interrupt, minus the idle character
+                        uint32_t elapsed = DWT->CYCCNT - msg.cycles;
+                        uint32_t now = Time_NowUs();
+                        Output_Pong(now - elapsed / (SystemCoreClock / 1000000u) - UART_CHAR_US, now);
+                    }
+                #endif
+            }
+            USART2_ReleaseMessage();
+        }
+    #endif
+}
+
+/**
+ * @brief Telemetry task: one "#tlm" frame per TELEMETRY_PERIOD_TICKS
+ * @details Runs at the lowest priority, so a period in which it is late shows up as a
+ *          longer interval of the idle and bus percentages, never as a gap in the counts.
+ * @return void
+ */
+static void Task_Telemetry(void) {
+    #if TELEMETRY == 1
+        uint32_t now = DWT->CYCCNT;
+        uint32_t idle = idleCycles;
+        uint32_t bus = I2C1_GetBusyCycles();
+        Output_Telemetry(now - tlmCycles, idle - tlmIdle, bus - tlmBus, isrLatencyMax, isrCyclesMax);
+        tlmCycles = now;
+        tlmIdle = idle;
+        tlmBus = bus;
+    #endif
+}
+
+/**
+ * @brief Scheduler tick source
+ * @return SysTick ticks since boot
+ */
+static uint32_t Ticks_Get(void) {
+    return tickCount;
+}
+
+/**
+ * @brief Device time for host synchronization
+ * @details SysTick ticks plus the elapsed part of the current period (SysTick counts
+ *          down from LOAD), read consistently against a concurrent tick. Starts at
+ *          SysTick_Config() and wraps after 2^32 µs (71.6 min).
+ * @return Device time (µs)
+ */
+static uint32_t Time_NowUs(void) {
+    uint32_t ticks;
+    uint32_t val;
+    do {
+        ticks = tickCount;
+        val = SysTick->VAL;
+    } while (ticks != tickCount);
+    return ticks * SYSTICK_PERIOD_US + (SysTick->LOAD - val) / (SystemCoreClock / 1000000u);
+}
+
+/**
+ * @brief Scheduler cycle source
+ * @return DWT cycle counter
+ */
+static uint32_t Cycles_Get(void) {
+    return DWT->CYCCNT;
+}